@@ -279,6 +279,15 @@ static bool opt_set_Verbose(struct preparser_args *args, const char *arg)
     return true;
 }
 
+static bool opt_set_Serdes(struct preparser_args *args, const char *arg)
+{
+    assert(args != NULL);
+    assert(arg != NULL);
+
+    args->serdes = arg;
+    return true;
+}
+
 struct preparser_opt {
     const char *name;
     const char *text;
@@ -317,6 +326,7 @@ static const struct preparser_opt options[] = {
     opt_add_string("output-format", opt_set_OutputFormat, "Format of the thumbnail (png/jp[e]g/webp)"),
     opt_add_bool("output-crop", opt_set_OutputCrop, "Crop the thumbnail"),
     opt_add_integer("verbose", opt_set_Verbose, "Verbosity (0,1,2)"),
+    opt_add_string("serdes", opt_set_Serdes, "Message serializer used in daemon mode (binary/json)"),
 };
 
 static const char vlc_preparser_usage[] = N_(
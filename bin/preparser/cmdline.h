@@ -33,6 +33,7 @@ struct preparser_args {
     } output;
 
     const char *verbosity;
+    const char *serdes;
 
     int arg_idx;
     bool error;
@@ -12,6 +12,9 @@
 #endif
 
 #include <assert.h>
+#ifndef _WIN32
+# include <sys/socket.h>
+#endif
 
 #include <vlc/vlc.h>
 #include <vlc_common.h>
@@ -280,6 +283,41 @@ static ssize_t read_cbs(void *data, size_t size, void *userdata)
     return ret;
 }
 
+#ifndef _WIN32
+static ssize_t write_fd_cbs(const void *data, size_t size, int fd,
+                            void *userdata)
+{
+    int sock = STDOUT_FILENO;
+    if (userdata != NULL) {
+        sock = vlc_tls_GetFD(userdata);
+    }
+
+    struct iovec iov = { .iov_base = (void *)data, .iov_len = size };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof(control.buf),
+    };
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+    return sendmsg(sock, &msg, flags);
+}
+#endif
+
 /****************************************************************************
  * Cmd line arg
  *****************************************************************************/
@@ -427,6 +465,10 @@ preparser_daemon_Loop(vlc_object_t *obj, vlc_preparser_t *preparser)
     static const struct vlc_preparser_msg_serdes_cbs deamon_cbs = {
         .write = write_cbs,
         .read = read_cbs,
+#ifndef _WIN32
+        /* stdout is a socket, see vlc_process_Spawn() */
+        .write_fd = write_fd_cbs,
+#endif
     };
 
     pp.serdes = vlc_preparser_msg_serdes_Create(obj, &deamon_cbs, true);
@@ -512,6 +554,7 @@ int main(int argc, char **argv)
         .output.width = 0,
         .output.crop = false,
         .verbosity = "-1",
+        .serdes = NULL,
     };
 
     int ret = preparser_cmdline_Parse(argc, argv, &args);
@@ -521,10 +564,15 @@ int main(int argc, char **argv)
 
     const char *libvlc_args[] = {
         "--verbose", args.verbosity, "--vout=vdummy", "--aout=adummy",
-        "--text-renderer=tdummy",
+        "--text-renderer=tdummy", "--preparser-serdes", args.serdes,
     };
+    /* Only forward the serializer if one was requested */
+    int libvlc_argc = ARRAY_SIZE(libvlc_args);
+    if (args.serdes == NULL) {
+        libvlc_argc -= 2;
+    }
 
-    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(libvlc_args), libvlc_args);
+    libvlc_instance_t *vlc = libvlc_new(libvlc_argc, libvlc_args);
     if (vlc == NULL) {
         return 1;
     }
@@ -50,6 +50,10 @@ typedef struct bs_s
     bool     b_read_only;
     bool     b_error;
 
+    /* bytes before it are contiguous and can be read without forwarding,
+     * set by the forward callback */
+    const uint8_t *p_fast_end;
+
     bs_byte_callbacks_t cb;
     void    *p_priv;
 } bs_t;
@@ -59,6 +63,7 @@ static size_t bs_impl_bytes_forward( bs_t *s, size_t i_count )
     if( s->p == NULL )
     {
         s->p = s->p_start;
+        s->p_fast_end = s->p_end;
         return 1;
     }
 
@@ -88,6 +93,7 @@ static inline void bs_init_custom( bs_t *s, const void *p_data, size_t i_data,
     s->i_left  = 0;
     s->b_read_only = true;
     s->b_error = false;
+    s->p_fast_end = s->p_start;
     s->p_priv = priv;
     s->cb = *cb;
 }
@@ -120,6 +126,38 @@ static inline int bs_refill( bs_t *s )
     return s->i_left > 0 ? 0 : 1;
 }
 
+/* Loads the next 56 bits at least, left aligned, when the 8 bytes from the
+ * current one can be read directly. */
+static inline bool bs_impl_peek( const bs_t *s, uint64_t *bits )
+{
+    if( s->p == NULL || s->p_fast_end <= s->p
+     || (size_t)(s->p_fast_end - s->p) < 8 )
+        return false;
+    *bits = GetQWBE( s->p ) << (8 - s->i_left);
+    return true;
+}
+
+/* Consumes bits previously peeked */
+static inline void bs_impl_consume( bs_t *s, unsigned i_count )
+{
+    unsigned i_bits = 8 - s->i_left + i_count;
+
+    s->p += (i_bits - 1) / 8;
+    s->i_left = -i_bits & 7;
+}
+
+static inline unsigned bs_impl_clz64( uint64_t x )
+{
+#if defined (__GNUC__) || defined (__clang__)
+    return __builtin_clzll( x );
+#else
+    unsigned i = 0;
+    for( ; !(x & (UINT64_C(1) << 63)); x <<= 1 )
+        i++;
+    return i;
+#endif
+}
+
 static inline bool bs_error( const bs_t *s )
 {
     return s->b_error;
@@ -172,6 +210,13 @@ static inline uint32_t bs_read( bs_t *s, uint8_t i_count )
 {
     uint8_t  i_shr, i_drop = 0;
     uint32_t i_result = 0;
+    uint64_t i_bits;
+
+    if( i_count > 0 && i_count <= 32 && bs_impl_peek( s, &i_bits ) )
+    {
+        bs_impl_consume( s, i_count );
+        return i_bits >> (64 - i_count);
+    }
 
     if( i_count > 32 )
     {
@@ -280,6 +325,16 @@ static inline void bs_write_align( bs_t *s, uint8_t v )
 static inline uint_fast32_t bs_read_ue( bs_t * bs )
 {
     unsigned i = 0;
+    uint64_t i_bits;
+
+    /* Codes of up to 27 leading zeros fit in the peeked bits */
+    if( !bs->b_error && bs_impl_peek( bs, &i_bits )
+     && i_bits >= (UINT64_C(1) << 36) )
+    {
+        i = 2 * bs_impl_clz64( i_bits ) + 1;
+        bs_impl_consume( bs, i );
+        return (i_bits >> (64 - i)) - 1;
+    }
 
     while( !bs->b_error &&
            bs_read1( bs ) == 0 &&
@@ -115,6 +115,10 @@ struct decoder_t
     /* Tell the decoder if it is allowed to drop frames */
     bool                b_frame_drop_allowed;
 
+    /* Tell the decoder that the input plays fast (trick-play): it mostly
+     * gets keyframes, and should favour speed over quality */
+    bool                b_trick_play;
+
     /**
      * Number of extra (ie in addition to the DPB) picture buffers
      * needed for decoding.
@@ -427,6 +431,25 @@ VLC_API void decoder_Destroy( decoder_t *p_dec );
  */
 VLC_API void decoder_Clean( decoder_t *p_dec );
 
+/**
+ * Request threads from the decoder thread budget.
+ *
+ * The budget ("dec-threads" option) is shared by all the decoders of the
+ * process requesting threads: each of them gets an equal share, capped by
+ * the number of threads it wants. The shares are updated when a decoder
+ * requests threads, and periodically while decoding once a decoder left.
+ * The video decoders whose share changed significantly are reloaded by the
+ * core at their next keyframe, at most every few seconds.
+ *
+ * To be used by decoder modules, when opening, if the number of threads
+ * is not set explicitly. The request is released by decoder_Clean().
+ *
+ * @param dec the decoder
+ * @param wanted number of threads the decoder would use on its own
+ * @return the number of threads to use, at least 1
+ */
+VLC_API unsigned decoder_RequestThreads( decoder_t *dec, unsigned wanted );
+
 /**
  * This function queues a single picture to the video output.
  *
@@ -252,6 +252,15 @@ enum demux_query_e
      * arg1= bool arg2= string */
     DEMUX_SET_RECORD_STATE,
 
+    /**
+     * Tells the demuxer whether the input plays fast (trick-play). While it
+     * does, the demuxer should only output the sync samples of the video
+     * tracks, and skip the other samples without reading them if it can.
+     * Can fail.
+     *
+     * arg1= bool */
+    DEMUX_SET_TRICK_PLAY,
+
     /* II. Specific access_demux queries */
 
     /* DEMUX_CAN_CONTROL_RATE is called only if DEMUX_CAN_CONTROL_PACE has
@@ -49,6 +49,8 @@ struct filter_video_callbacks
 
 struct filter_audio_callbacks
 {
+    block_t *(*buffer_new)(filter_t *, size_t size);
+
     struct
     {
         void (*on_changed)(filter_t *,
@@ -271,6 +273,29 @@ static inline picture_t *filter_NewPicture( filter_t *p_filter )
     return pic;
 }
 
+/**
+ * This function will return a new audio buffer usable by p_filter as an
+ * output buffer. You have to release it using block_Release or by returning
+ * it to the caller as a ops->filter_audio return value.
+ * Provided for convenience.
+ *
+ * The owner may recycle buffers, so filters producing a new block for each
+ * input block should use this rather than block_Alloc().
+ *
+ * \param p_filter filter_t object
+ * \param i_size payload size in bytes
+ * \return new block on success or NULL on failure
+ */
+static inline block_t *filter_NewAudioBuffer( filter_t *p_filter, size_t i_size )
+{
+    block_t *block = NULL;
+    if ( p_filter->owner.audio != NULL && p_filter->owner.audio->buffer_new != NULL)
+        block = p_filter->owner.audio->buffer_new( p_filter, i_size );
+    if ( block == NULL )
+        block = block_Alloc( i_size );
+    return block;
+}
+
 /**
  * Flush a filter
  *
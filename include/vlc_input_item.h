@@ -556,6 +556,8 @@ struct input_stats_t
     /* Decoders */
     uint64_t i_decoded_audio;
     uint64_t i_decoded_video;
+    vlc_tick_t i_decoding_time; /**< time spent in multi-threaded decoders */
+    vlc_tick_t i_decoding_cpu; /**< CPU time used by their decoding threads */
 
     /* Vout */
     uint64_t i_displayed_pictures;
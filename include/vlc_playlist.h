@@ -484,6 +484,37 @@ vlc_playlist_Get(vlc_playlist_t *playlist, size_t index);
 VLC_API void
 vlc_playlist_Clear(vlc_playlist_t *playlist);
 
+/**
+ * Start a batch of insertions.
+ *
+ * Until the matching vlc_playlist_CommitBatch(), consecutive insertions are
+ * not notified one by one: the listeners receive a single on_items_added()
+ * event for the whole range on commit, and the randomizer update and the
+ * preparser submission are deferred until then.
+ *
+ * Any other modification of the playlist notifies the pending insertions
+ * first, so the listeners always receive a consistent sequence of events.
+ *
+ * The current index and vlc_playlist_HasPrev()/vlc_playlist_HasNext() are
+ * kept up to date during the batch, except that in random order, the pending
+ * items are only candidates for the next item once committed. The changes
+ * are notified on commit.
+ *
+ * Batches may be nested. The playlist must remain locked until the commit.
+ *
+ * \param playlist the playlist, locked
+ */
+VLC_API void
+vlc_playlist_BeginBatch(vlc_playlist_t *playlist);
+
+/**
+ * Commit a batch of insertions started by vlc_playlist_BeginBatch().
+ *
+ * \param playlist the playlist, locked
+ */
+VLC_API void
+vlc_playlist_CommitBatch(vlc_playlist_t *playlist);
+
 /**
  * Insert a list of media at a given index.
  *
@@ -689,6 +720,14 @@ vlc_playlist_Shuffle(vlc_playlist_t *playlist);
 /**
  * Sort the playlist by a list of criteria.
  *
+ * The sort keys are cached in the playlist items, so that sorting again is
+ * cheap. They are refreshed when an item is preparsed or updated by the
+ * player, but not when its media metadata is modified directly (e.g. by
+ * input_item_SetMeta()): such an item is sorted by its former metadata.
+ *
+ * If only a few items are moved, the listeners are notified by
+ * on_items_moved() events; otherwise, by a single on_items_reset().
+ *
  * \param playlist the playlist, locked
  * \param criteria the sort criteria (in order)
  * \param count    the number of criteria
@@ -699,6 +738,83 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
                   const struct vlc_playlist_sort_criterion criteria[],
                   size_t count);
 
+/**
+ * Opaque structure giving a read-only view of a (subset of a) playlist.
+ *
+ * The items are not copied: the view only references the playlist items
+ * accepted by its filter, in the playlist order.
+ *
+ * A view cannot notify its users of changes: they must register their own
+ * playlist listener (see vlc_playlist_AddListener()) to know when to read it
+ * again.
+ */
+struct vlc_playlist_view;
+
+/**
+ * Create a filtered view of the playlist.
+ *
+ * The filter is called with the playlist locked, and must not modify the
+ * playlist. The view content is recomputed on the next access after the
+ * playlist content changes, but nothing is reported to the caller.
+ *
+ * \param playlist the playlist, locked
+ * \param filter   the predicate selecting the items to expose (NULL to expose
+ *                 all the items)
+ * \param userdata data passed to the filter
+ * \return a new view, or NULL on allocation failure
+ */
+VLC_API struct vlc_playlist_view *
+vlc_playlist_view_New(vlc_playlist_t *playlist,
+                      bool (*filter)(vlc_playlist_item_t *item, void *userdata),
+                      void *userdata);
+
+/**
+ * Delete a playlist view.
+ *
+ * \param view the playlist view (the underlying playlist must be locked)
+ */
+VLC_API void
+vlc_playlist_view_Delete(struct vlc_playlist_view *view);
+
+/**
+ * Return the number of items in the view.
+ *
+ * The underlying playlist must be locked.
+ *
+ * \param view the playlist view
+ */
+VLC_API size_t
+vlc_playlist_view_Count(struct vlc_playlist_view *view);
+
+/**
+ * Return the item at a given index.
+ *
+ * The index must be in range (less than vlc_playlist_view_Count()).
+ *
+ * The underlying playlist must be locked.
+ *
+ * \param view  the playlist view
+ * \param index the index
+ * \return the playlist item
+ */
+VLC_API vlc_playlist_item_t *
+vlc_playlist_view_Get(struct vlc_playlist_view *view, size_t index);
+
+/**
+ * Return the index in the playlist of the item at a given view index.
+ *
+ * The index must be in range (less than vlc_playlist_view_Count()).
+ *
+ * The underlying playlist must be locked.
+ *
+ * \param view  the playlist view
+ * \param index the index in the view
+ * \return the index in the playlist
+ */
+VLC_API size_t
+vlc_playlist_view_GetPlaylistIndex(struct vlc_playlist_view *view,
+                                   size_t index);
+
 /**
  * Return the index of a given item.
  *
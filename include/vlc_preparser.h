@@ -222,6 +222,31 @@ struct vlc_thumbnailer_arg
     bool hw_dec;
 };
 
+/**
+ * Thumbnail sheet argument
+ *
+ * Used by vlc_preparser_GenerateThumbnailSheet()
+ */
+struct vlc_thumbnailer_sheet_arg
+{
+    /** Number of thumbnails, evenly spaced over the media */
+    unsigned count;
+
+    /** Number of thumbnails per row, 0 for a sheet as square as possible */
+    unsigned columns;
+
+    /**
+     * Size of each tile of the sheet
+     *
+     * Thumbnails are scaled to fit in a tile, preserving their aspect ratio.
+     */
+    unsigned tile_width;
+    unsigned tile_height;
+
+    /** True to enable hardware decoder (false by default) */
+    bool hw_dec;
+};
+
 /**
  * Thumbnailer output format
  */
@@ -406,6 +431,35 @@ vlc_preparser_GenerateThumbnailToFiles( vlc_preparser_t *preparser, input_item_t
                                         const struct vlc_thumbnailer_to_files_cbs *cbs,
                                         void *cbs_userdata );
 
+/**
+ * This function generates a sheet of thumbnails spread over the media
+ *
+ * The input is opened only once. Each thumbnail is taken from the keyframe
+ * closest to its position, and non-reference frames are not decoded, so the
+ * cost mostly depends on the number of thumbnails, not on the media length.
+ *
+ * The sheet is a RGBA picture of sheet_arg->tile_width * columns by
+ * sheet_arg->tile_height * rows pixels, thumbnails being laid out from left
+ * to right, then top to bottom. Tiles that could not be generated (end of
+ * media reached early) are left transparent.
+ *
+ * @param preparser the preparser object
+ * @param item a valid item to generate the thumbnails for
+ * @param sheet_arg pointer to the sheet arguments (can't be NULL)
+ * @param cbs callback to listen to events (can't be NULL), the picture
+ * passed to on_ended is the sheet
+ * @param cbs_userdata opaque pointer used by the callbacks
+ * @return NULL in case of error, or if the preparser does not support sheets
+ * (external process), or a valid request handle if the item was scheduled
+ * for thumbnailing. If this returns an error, the thumbnailer.on_ended
+ * callback will *not* be invoked
+ */
+VLC_API vlc_preparser_req *
+vlc_preparser_GenerateThumbnailSheet( vlc_preparser_t *preparser, input_item_t *item,
+                                      const struct vlc_thumbnailer_sheet_arg *sheet_arg,
+                                      const struct vlc_thumbnailer_cbs *cbs,
+                                      void *cbs_userdata );
+
 /**
  * This function cancels ongoing or queued preparsing/thumbnail generation
  * for a given request handle.
@@ -465,6 +519,51 @@ VLC_API void vlc_preparser_req_Release( vlc_preparser_req *req );
  */
 VLC_API void vlc_preparser_Delete( vlc_preparser_t *preparser );
 
+/**
+ * Statistics of an external preparser process slot
+ *
+ * Each slot runs one process at a time, replaced when it fails or reaches
+ * the limits set by the "preparser-process-tasks" and
+ * "preparser-process-memory" options.
+ */
+struct vlc_preparser_process_stats
+{
+    /** Pool of the slot: VLC_PREPARSER_TYPE_PARSE or
+     * VLC_PREPARSER_TYPE_THUMBNAIL */
+    int type;
+
+    /** Number of tasks run, and how many of them failed */
+    size_t tasks;
+    size_t failures;
+
+    /** Number of processes started, and how many of them replaced a
+     * process that reached its limits */
+    size_t spawns;
+    size_t recycles;
+
+    /** Time spent running tasks, and the longest task */
+    vlc_tick_t busy;
+    vlc_tick_t max_latency;
+
+    /** Last resident size of the process measured, in bytes, 0 if
+     * unknown */
+    size_t rss;
+};
+
+/**
+ * Get the statistics of the external process slots of a preparser.
+ *
+ * @param preparser the preparser object
+ * @param stats array filled with the statistics of the slots
+ * @param count size of the stats array
+ * @return the number of slots, that may be larger than count, 0 if the
+ * preparser does not use external processes
+ */
+VLC_API size_t
+vlc_preparser_GetProcessStats( vlc_preparser_t *preparser,
+                               struct vlc_preparser_process_stats *stats,
+                               size_t count );
+
 /**
  * Do not use, libVLC only fonction, will be removed soon
  */
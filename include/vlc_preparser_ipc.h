@@ -199,6 +199,37 @@ struct vlc_preparser_msg_serdes_cbs {
      * @return      the number of bytes read or an error code on failure.
      */
     ssize_t (*read)(void *data, size_t size, void *userdata);
+
+    /**
+     * Write callback passing a file descriptor along with the data
+     * (optional, can be NULL).
+     *
+     * The file descriptor is sent with the first byte of `data` and stays
+     * owned by the caller.
+     *
+     * @param [in]  data        buffer to write.
+     * @param [in]  size        number of bytes to write.
+     * @param [in]  fd          file descriptor to send.
+     * @param [in]  userdata    callback userdata.
+     *
+     * @return      the number of bytes writen or an error code on failure.
+     */
+    ssize_t (*write_fd)(const void *data, size_t size, int fd,
+                        void *userdata);
+
+    /**
+     * Read callback also receiving the file descriptors sent with
+     * `write_fd` (optional, can be NULL).
+     *
+     * @param [out] data        buffer to read into.
+     * @param [in]  size        number of bytes to read.
+     * @param [out] fd          received file descriptor, owned by the
+     *                          caller, or -1.
+     * @param [in]  userdata    callback userdata.
+     *
+     * @return      the number of bytes read or an error code on failure.
+     */
+    ssize_t (*read_fd)(void *data, size_t size, int *fd, void *userdata);
 };
 
 struct vlc_preparser_msg_serdes;
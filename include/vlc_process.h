@@ -60,6 +60,34 @@ vlc_process_Spawn(const char *path, int argc, const char *const *argv);
 VLC_API int
 vlc_process_Terminate(struct vlc_process *process, bool kill_process);
 
+/**
+ * Stop a vlc_process gracefully, within a time limit.
+ *
+ * Closes its file descriptors, so that the process can exit on its own, and
+ * waits for it to exit. If it is still running after the timeout, it is
+ * killed.
+ *
+ * @param [in]  process     Pointer to the vlc_process instance. Must not be
+ *                          NULL.
+ * @param [in]  timeout     Time to wait for the process to exit before
+ *                          killing it.
+ *
+ * @return      The exit status of the process, or -1 on error.
+ */
+VLC_API int
+vlc_process_Stop(struct vlc_process *process, vlc_tick_t timeout);
+
+/**
+ * Get the process identifier of a vlc_process.
+ *
+ * @param [in]  process     Pointer to the vlc_process instance. Must not be
+ *                          NULL.
+ *
+ * @return      The process identifier of the spawned process.
+ */
+VLC_API pid_t
+vlc_process_GetPid(const struct vlc_process *process);
+
 /**
  * Read data from the process's standard output with a timeout.
  *
@@ -83,6 +111,26 @@ VLC_API ssize_t
 vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
                     vlc_tick_t timeout_ms);
 
+/**
+ * Read data and a file descriptor from the process's standard output.
+ *
+ * Same as vlc_process_fd_Read(), but also receives a file descriptor the
+ * process passed along with the data, on systems supporting it.
+ *
+ * @param [in]  process     Pointer to the vlc_process instance.
+ * @param [out] buf         Buffer where the read data will be stored.
+ * @param [in]  size        Maximum number of bytes to read.
+ * @param [in]  timeout_ms  Timeout in milliseconds to wait for data.
+ * @param [out] fd          Received file descriptor, owned by the caller, or
+ *                          -1 if none was received.
+ *
+ * @return      The number of bytes read on success,
+ *              -1 on error, and errno is set to indicate the error.
+ */
+VLC_API ssize_t
+vlc_process_fd_ReadFd(struct vlc_process *process, uint8_t *buf, size_t size,
+                      vlc_tick_t timeout_ms, int *fd);
+
 /**
  * Write data to the process's standard input with a timeout.
  *
@@ -104,6 +104,7 @@ struct vlc_stream_operations {
             int (*set_next_demux_time)(demux_t *, vlc_tick_t);
             int (*set_record_state)(demux_t *, bool, const char *);
             int (*set_rate)(demux_t *, float *);
+            int (*set_trick_play)(demux_t *, bool);
             int (*set_group_default)(demux_t *);
             int (*set_group_all)(demux_t *);
             int (*set_group_list)(demux_t *, size_t, const int *);
@@ -231,6 +231,15 @@ struct vlc_render_subpicture
 {
     struct VLC_VECTOR(struct subpicture_region_rendered *) regions; /**< list of regions to render */
     int64_t      i_order;                    /** an increasing unique number */
+    /**
+     * Regions differ from the previous rendering of the same SPU unit.
+     *
+     * Consumers that skip unchanged renderings must draw again whenever they
+     * discarded their own output in between.
+     */
+    bool         b_changed;
+    vout_display_place_t damage; /**< union of the changed areas in display
+                                      coordinates, empty if unknown */
 };
 
 typedef struct vlc_render_subpicture vlc_render_subpicture;
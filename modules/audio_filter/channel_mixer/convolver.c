@@ -0,0 +1,598 @@
+/*****************************************************************************
+ * convolver.c: impulse response convolution channel mixer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_aout.h>
+#include <vlc_filter.h>
+#include <vlc_fs.h>
+#include <vlc_strings.h>
+
+#ifdef HAVE_MYSOFA
+# include <mysofa.h>
+#endif
+
+#include "../convolution.h"
+
+/*****************************************************************************
+ * Local prototypes
+ *****************************************************************************/
+static int  Open ( vlc_object_t * );
+static void Close( filter_t * );
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+#define MODULE_DESCRIPTION N_( \
+     "Renders the speakers to headphones by convolving each of them with " \
+     "the impulse responses measured at the ears of a listener, in a room " \
+     "or in an anechoic chamber.")
+
+#define CONVOLVER_IR_TEXT N_("Impulse responses file")
+#define CONVOLVER_IR_LONGTEXT N_( \
+     "SOFA file, or WAV file with a pair of channels per speaker holding " \
+     "the left and right ear responses, in the WAV channel order: front " \
+     "left, front right, center, LFE, rear left, rear right, side left " \
+     "and side right.")
+
+#define CONVOLVER_PARTITION_TEXT N_("Partition size")
+#define CONVOLVER_PARTITION_LONGTEXT N_( \
+     "Number of samples processed at once. This is the latency of the " \
+     "filter: smaller partitions reduce it, at a higher processing cost.")
+
+vlc_module_begin ()
+    set_description( N_("Impulse response convolver") )
+    set_shortname( N_("Convolver") )
+    set_help( MODULE_DESCRIPTION )
+    set_subcategory( SUBCAT_AUDIO_AFILTER )
+
+    add_loadfile( "convolver-ir", NULL, CONVOLVER_IR_TEXT,
+                  CONVOLVER_IR_LONGTEXT )
+    add_integer_with_range( "convolver-partition", 256, 32, 8192,
+                            CONVOLVER_PARTITION_TEXT,
+                            CONVOLVER_PARTITION_LONGTEXT )
+
+    set_capability( "audio filter", 0 )
+    set_callback( Open )
+    add_shortcut( "convolver" )
+vlc_module_end ()
+
+/*****************************************************************************
+ * Impulse responses
+ *****************************************************************************/
+#define IR_MAX_FRAMES (1 << 20)
+#define IR_MAX_BYTES  (64 << 20)
+
+typedef struct
+{
+    float *samples;  /* left and right ear of each speaker, interleaved */
+    size_t frames;
+    unsigned rate;
+    unsigned count;  /* speakers */
+    uint32_t speakers[AOUT_CHAN_MAX];
+} impulse_t;
+
+/* Channel order of the WAV files */
+static const uint32_t wav_speakers[] =
+{
+    AOUT_CHAN_LEFT, AOUT_CHAN_RIGHT, AOUT_CHAN_CENTER, AOUT_CHAN_LFE,
+    AOUT_CHAN_REARLEFT, AOUT_CHAN_REARRIGHT,
+    AOUT_CHAN_MIDDLELEFT, AOUT_CHAN_MIDDLERIGHT,
+};
+
+static float WavSample( const uint8_t *p, unsigned i_bits, bool b_float )
+{
+    switch( i_bits )
+    {
+        case 16:
+            return (int16_t)GetWLE( p ) / 32768.f;
+        case 24:
+            return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16)
+                             | ((uint32_t)p[2] << 24)) / 2147483648.f;
+        default:
+        {
+            uint32_t u = GetDWLE( p );
+            if( b_float )
+            {
+                float f;
+                memcpy( &f, &u, sizeof (f) );
+                return f;
+            }
+            return (int32_t)u / 2147483648.f;
+        }
+    }
+}
+
+static int LoadWav( filter_t *p_filter, FILE *file, impulse_t *p_ir )
+{
+    uint8_t hdr[12];
+    unsigned i_channels = 0, i_bits = 0, i_rate = 0;
+    bool b_float = false;
+
+    if( fread( hdr, 1, 12, file ) != 12
+     || memcmp( hdr, "RIFF", 4 ) || memcmp( hdr + 8, "WAVE", 4 ) )
+    {
+        msg_Err( p_filter, "not a WAV file" );
+        return VLC_EGENERIC;
+    }
+
+    for( ;; )
+    {
+        if( fread( hdr, 1, 8, file ) != 8 )
+        {
+            msg_Err( p_filter, "no data in the WAV file" );
+            return VLC_EGENERIC;
+        }
+
+        uint32_t i_size = GetDWLE( hdr + 4 );
+
+        if( !memcmp( hdr, "fmt ", 4 ) )
+        {
+            uint8_t fmt[40] = { 0 };
+
+            if( i_size < 16
+             || fread( fmt, 1, __MIN(i_size, sizeof (fmt)), file )
+                    != __MIN(i_size, sizeof (fmt)) )
+                return VLC_EGENERIC;
+
+            unsigned i_tag = GetWLE( fmt );
+            if( i_tag == 0xFFFE /* WAVE_FORMAT_EXTENSIBLE */ && i_size >= 26 )
+                i_tag = GetWLE( fmt + 24 );
+            i_channels = GetWLE( fmt + 2 );
+            i_rate = GetDWLE( fmt + 4 );
+            i_bits = GetWLE( fmt + 14 );
+            b_float = i_tag == 3 /* WAVE_FORMAT_IEEE_FLOAT */;
+
+            if( !( (i_tag == 1 && (i_bits == 16 || i_bits == 24
+                                   || i_bits == 32))
+                || (b_float && i_bits == 32) ) )
+            {
+                msg_Err( p_filter, "unsupported WAV sample format %u/%u",
+                         i_tag, i_bits );
+                return VLC_EGENERIC;
+            }
+            if( i_channels == 0 || i_channels % 2
+             || i_channels > 2 * ARRAY_SIZE(wav_speakers) )
+            {
+                msg_Err( p_filter, "unsupported WAV channels count %u",
+                         i_channels );
+                return VLC_EGENERIC;
+            }
+            i_size -= __MIN(i_size, sizeof (fmt));
+        }
+        else if( !memcmp( hdr, "data", 4 ) )
+        {
+            if( i_channels == 0 )
+                return VLC_EGENERIC;
+
+            const size_t i_frame = i_channels * i_bits / 8;
+            size_t i_frames = __MIN(i_size, IR_MAX_BYTES) / i_frame;
+            if( i_frames > IR_MAX_FRAMES )
+            {
+                msg_Warn( p_filter, "impulse responses truncated to %u "
+                          "samples", IR_MAX_FRAMES );
+                i_frames = IR_MAX_FRAMES;
+            }
+
+            uint8_t *p_data = vlc_alloc( i_frames, i_frame );
+            p_ir->samples = vlc_alloc( i_frames * i_channels,
+                                       sizeof (float) );
+            if( p_data == NULL || p_ir->samples == NULL )
+            {
+                free( p_data );
+                return VLC_ENOMEM;
+            }
+
+            i_frames = fread( p_data, i_frame, i_frames, file );
+            for( size_t i = 0; i < i_frames * i_channels; i++ )
+                p_ir->samples[i] = WavSample( &p_data[i * i_bits / 8],
+                                              i_bits, b_float );
+            free( p_data );
+
+            p_ir->frames = i_frames;
+            p_ir->rate = i_rate;
+            p_ir->count = i_channels / 2;
+            for( unsigned i = 0; i < p_ir->count; i++ )
+                p_ir->speakers[i] = wav_speakers[i];
+            return i_frames > 0 ? VLC_SUCCESS : VLC_EGENERIC;
+        }
+
+        /* Chunks are padded to an even size */
+        if( fseek( file, i_size + (i_size & 1), SEEK_CUR ) )
+            return VLC_EGENERIC;
+    }
+}
+
+#ifdef HAVE_MYSOFA
+/* Speaker positions, in degrees counterclockwise from the front */
+static float SpeakerAzimuth( uint32_t i_speaker, uint32_t i_layout )
+{
+    /* Without side speakers, the rear ones are the surround ones */
+    const float f_rear = i_layout & AOUT_CHANS_MIDDLE ? 145.f : 110.f;
+
+    switch( i_speaker )
+    {
+        case AOUT_CHAN_LEFT:        return 30.f;
+        case AOUT_CHAN_RIGHT:       return -30.f;
+        case AOUT_CHAN_MIDDLELEFT:  return 90.f;
+        case AOUT_CHAN_MIDDLERIGHT: return -90.f;
+        case AOUT_CHAN_REARLEFT:    return f_rear;
+        case AOUT_CHAN_REARRIGHT:   return -f_rear;
+        case AOUT_CHAN_REARCENTER:  return 180.f;
+        default:                    return 0.f;
+    }
+}
+
+static int LoadSofa( filter_t *p_filter, const char *psz_path,
+                     unsigned i_rate, uint32_t i_layout, impulse_t *p_ir )
+{
+    int i_length, i_err;
+    struct MYSOFA_EASY *p_hrtf = mysofa_open( psz_path, i_rate, &i_length,
+                                              &i_err );
+    if( p_hrtf == NULL )
+    {
+        msg_Err( p_filter, "cannot open SOFA file (error %d)", i_err );
+        return VLC_EGENERIC;
+    }
+
+    p_ir->count = 0;
+    for( unsigned i = 0; pi_vlc_chan_order_wg4[i]; i++ )
+        if( i_layout & pi_vlc_chan_order_wg4[i] )
+            p_ir->speakers[p_ir->count++] = pi_vlc_chan_order_wg4[i];
+
+    float *p_responses = vlc_alloc( 2 * p_ir->count,
+                                    i_length * sizeof (float) );
+    unsigned pi_delays[2 * AOUT_CHAN_MAX];
+    unsigned i_delay_max = 0;
+    if( p_responses == NULL )
+    {
+        mysofa_close( p_hrtf );
+        return VLC_ENOMEM;
+    }
+
+    for( unsigned i = 0; i < p_ir->count; i++ )
+    {
+        float pos[3] = { SpeakerAzimuth( p_ir->speakers[i], i_layout ),
+                         0.f, 1.f };
+        float f_delay_left, f_delay_right;
+
+        mysofa_s2c( pos );
+        mysofa_getfilter_float( p_hrtf, pos[0], pos[1], pos[2],
+                                &p_responses[2 * i * i_length],
+                                &p_responses[(2 * i + 1) * i_length],
+                                &f_delay_left, &f_delay_right );
+        pi_delays[2 * i] = lroundf( f_delay_left * i_rate );
+        pi_delays[2 * i + 1] = lroundf( f_delay_right * i_rate );
+        i_delay_max = __MAX(i_delay_max,
+                            __MAX(pi_delays[2 * i], pi_delays[2 * i + 1]));
+    }
+    mysofa_close( p_hrtf );
+
+    /* Apply the interaural delays, and interleave */
+    p_ir->frames = i_length + i_delay_max;
+    p_ir->rate = i_rate;
+    p_ir->samples = vlc_alloc( p_ir->frames,
+                               2 * p_ir->count * sizeof (float) );
+    if( p_ir->samples == NULL )
+    {
+        free( p_responses );
+        return VLC_ENOMEM;
+    }
+    memset( p_ir->samples, 0,
+            p_ir->frames * 2 * p_ir->count * sizeof (float) );
+
+    for( unsigned c = 0; c < 2 * p_ir->count; c++ )
+        for( int i = 0; i < i_length; i++ )
+            p_ir->samples[(pi_delays[c] + i) * 2 * p_ir->count + c] =
+                p_responses[c * i_length + i];
+    free( p_responses );
+    return VLC_SUCCESS;
+}
+#endif
+
+static int LoadImpulses( filter_t *p_filter, unsigned i_rate,
+                         uint32_t i_layout, impulse_t *p_ir )
+{
+    char *psz_path = var_InheritString( p_filter, "convolver-ir" );
+    if( psz_path == NULL || *psz_path == '\0' )
+    {
+        msg_Err( p_filter, "no impulse responses file specified" );
+        free( psz_path );
+        return VLC_EGENERIC;
+    }
+
+    int i_ret = VLC_EGENERIC;
+    const char *psz_ext = strrchr( psz_path, '.' );
+
+    if( psz_ext != NULL && !strcasecmp( psz_ext, ".sofa" ) )
+    {
+#ifdef HAVE_MYSOFA
+        i_ret = LoadSofa( p_filter, psz_path, i_rate, i_layout, p_ir );
+#else
+        VLC_UNUSED(i_rate); VLC_UNUSED(i_layout);
+        msg_Err( p_filter, "SOFA files are not supported" );
+#endif
+    }
+    else
+    {
+        FILE *file = vlc_fopen( psz_path, "rb" );
+        if( file != NULL )
+        {
+            i_ret = LoadWav( p_filter, file, p_ir );
+            fclose( file );
+        }
+        else
+            msg_Err( p_filter, "cannot open %s: %s", psz_path,
+                     vlc_strerror_c( errno ) );
+    }
+
+    if( i_ret == VLC_SUCCESS )
+        msg_Dbg( p_filter, "loaded %u speakers, %zu samples at %u Hz from "
+                 "%s", p_ir->count, p_ir->frames, p_ir->rate, psz_path );
+    free( psz_path );
+    return i_ret;
+}
+
+/*****************************************************************************
+ * Internal data structures
+ *****************************************************************************/
+typedef struct
+{
+    audio_conv_t *conv;
+    unsigned i_inputs;
+    unsigned i_pos;      /* frames buffered in the current partition */
+    float *p_in;         /* current input partition */
+    float *p_out;        /* output of the previous partition */
+    vlc_tick_t i_delay;  /* duration of a partition */
+    vlc_tick_t i_next_pts;
+} filter_sys_t;
+
+/*****************************************************************************
+ * Convolve: delays the signal by one partition, and convolves it
+ *****************************************************************************/
+static void Convolve( filter_sys_t *p_sys, const float *p_src, float *p_dst,
+                      size_t i_frames )
+{
+    const unsigned i_partition = audio_conv_Partition( p_sys->conv );
+
+    while( i_frames > 0 )
+    {
+        const size_t i_count = __MIN(i_partition - p_sys->i_pos, i_frames);
+        float *p_in = &p_sys->p_in[p_sys->i_pos * p_sys->i_inputs];
+
+        if( p_src != NULL )
+        {
+            memcpy( p_in, p_src, i_count * p_sys->i_inputs * sizeof (float) );
+            p_src += i_count * p_sys->i_inputs;
+        }
+        else
+            memset( p_in, 0, i_count * p_sys->i_inputs * sizeof (float) );
+
+        memcpy( p_dst, &p_sys->p_out[2 * p_sys->i_pos],
+                2 * i_count * sizeof (float) );
+        p_dst += 2 * i_count;
+
+        p_sys->i_pos += i_count;
+        i_frames -= i_count;
+        if( p_sys->i_pos == i_partition )
+        {
+            audio_conv_Process( p_sys->conv, p_sys->p_in, p_sys->p_out );
+            p_sys->i_pos = 0;
+        }
+    }
+}
+
+static block_t *Process( filter_t *p_filter, block_t *p_block )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    block_t *p_out = filter_NewAudioBuffer( p_filter,
+                                            p_block->i_nb_samples * 2 *
+                                            sizeof (float) );
+    if( p_out == NULL )
+    {
+        block_Release( p_block );
+        return NULL;
+    }
+
+    /* The output is late by one partition: date it back, so that the
+     * convolved signal stays in sync with the video */
+    p_out->i_nb_samples = p_block->i_nb_samples;
+    p_out->i_dts = p_out->i_pts = p_block->i_pts - p_sys->i_delay;
+    p_out->i_length = p_block->i_length;
+
+    Convolve( p_sys, (const float *)p_block->p_buffer,
+              (float *)p_out->p_buffer, p_block->i_nb_samples );
+
+    p_sys->i_next_pts = p_out->i_pts + p_out->i_length;
+    block_Release( p_block );
+    return p_out;
+}
+
+/* Outputs the last partition, which is still in the convolver */
+static block_t *Drain( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->i_next_pts == VLC_TICK_INVALID )
+        return NULL;
+
+    const unsigned i_partition = audio_conv_Partition( p_sys->conv );
+    block_t *p_out = filter_NewAudioBuffer( p_filter,
+                                            i_partition * 2 *
+                                            sizeof (float) );
+    if( p_out == NULL )
+        return NULL;
+
+    p_out->i_nb_samples = i_partition;
+    p_out->i_dts = p_out->i_pts = p_sys->i_next_pts;
+    p_out->i_length = vlc_tick_from_samples( i_partition,
+                                             p_filter->fmt_in.audio.i_rate );
+
+    Convolve( p_sys, NULL, (float *)p_out->p_buffer, i_partition );
+    p_sys->i_next_pts = VLC_TICK_INVALID;
+    return p_out;
+}
+
+static void Flush( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const unsigned i_partition = audio_conv_Partition( p_sys->conv );
+
+    audio_conv_Reset( p_sys->conv );
+    memset( p_sys->p_out, 0, i_partition * 2 * sizeof (float) );
+    p_sys->i_pos = 0;
+    p_sys->i_next_pts = VLC_TICK_INVALID;
+}
+
+/*****************************************************************************
+ * Open:
+ *****************************************************************************/
+static int Open( vlc_object_t *p_this )
+{
+    filter_t *p_filter = (filter_t *)p_this;
+
+    /* Activate this filter only with stereo devices */
+    if( p_filter->fmt_out.audio.i_physical_channels
+            != (AOUT_CHAN_LEFT|AOUT_CHAN_RIGHT) )
+    {
+        msg_Dbg( p_filter, "filter discarded (incompatible format)" );
+        return VLC_EGENERIC;
+    }
+
+    const unsigned i_rate = p_filter->fmt_in.audio.i_rate;
+    impulse_t ir = { .samples = NULL };
+    if( LoadImpulses( p_filter, i_rate,
+                      p_filter->fmt_in.audio.i_physical_channels, &ir ) )
+    {
+        free( ir.samples );
+        return VLC_EGENERIC;
+    }
+    if( ir.rate != i_rate )
+    {
+        msg_Err( p_filter, "impulse responses sampled at %u Hz instead of "
+                 "%u Hz", ir.rate, i_rate );
+        free( ir.samples );
+        return VLC_EGENERIC;
+    }
+
+    /* Convolve the speakers of the responses, in the VLC channel order */
+    uint32_t i_layout = 0;
+    for( unsigned i = 0; i < ir.count; i++ )
+        i_layout |= ir.speakers[i];
+
+    filter_sys_t *p_sys = malloc( sizeof (*p_sys) );
+    if( unlikely(p_sys == NULL) )
+    {
+        free( ir.samples );
+        return VLC_ENOMEM;
+    }
+
+    unsigned i_partition = 1;
+    unsigned i_size = var_InheritInteger( p_filter, "convolver-partition" );
+    while( i_partition < i_size )
+        i_partition <<= 1;
+
+    p_sys->i_inputs = vlc_popcount( i_layout );
+    p_sys->i_pos = 0;
+    p_sys->i_delay = vlc_tick_from_samples( i_partition,
+                                            p_filter->fmt_in.audio.i_rate );
+    p_sys->i_next_pts = VLC_TICK_INVALID;
+    p_sys->conv = audio_conv_New( i_partition, p_sys->i_inputs, 2,
+                                  ir.frames );
+    p_sys->p_in = vlc_alloc( i_partition,
+                             p_sys->i_inputs * sizeof (float) );
+    p_sys->p_out = calloc( i_partition, 2 * sizeof (float) );
+    if( unlikely(p_sys->conv == NULL || p_sys->p_in == NULL
+              || p_sys->p_out == NULL) )
+    {
+        if( p_sys->conv != NULL )
+            audio_conv_Delete( p_sys->conv );
+        free( p_sys->p_in );
+        free( p_sys->p_out );
+        free( p_sys );
+        free( ir.samples );
+        return VLC_ENOMEM;
+    }
+
+    unsigned i_input = 0;
+    for( unsigned i = 0; pi_vlc_chan_order_wg4[i]; i++ )
+    {
+        if( !(i_layout & pi_vlc_chan_order_wg4[i]) )
+            continue;
+
+        unsigned s = 0;
+        while( ir.speakers[s] != pi_vlc_chan_order_wg4[i] )
+            s++;
+        for( unsigned ear = 0; ear < 2; ear++ )
+            audio_conv_SetResponse( p_sys->conv, i_input, ear,
+                                    &ir.samples[2 * s + ear], ir.frames,
+                                    2 * ir.count );
+        i_input++;
+    }
+    free( ir.samples );
+
+    msg_Dbg( p_filter, "convolving %u channels, %u samples latency",
+             p_sys->i_inputs, i_partition );
+
+    /* Request a specific format if not already compatible */
+    p_filter->p_sys = p_sys;
+    p_filter->fmt_in.audio.i_format = VLC_CODEC_FL32;
+    p_filter->fmt_in.audio.i_physical_channels = i_layout;
+    p_filter->fmt_in.audio.i_chan_mode = p_filter->fmt_out.audio.i_chan_mode;
+    p_filter->fmt_out.audio.i_format = VLC_CODEC_FL32;
+    p_filter->fmt_out.audio.i_rate = i_rate;
+    aout_FormatPrepare( &p_filter->fmt_in.audio );
+    aout_FormatPrepare( &p_filter->fmt_out.audio );
+
+    static const struct vlc_filter_operations filter_ops =
+    {
+        .filter_audio = Process, .drain_audio = Drain, .flush = Flush,
+        .close = Close,
+    };
+    p_filter->ops = &filter_ops;
+
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Close: deallocate data structures
+ *****************************************************************************/
+static void Close( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    audio_conv_Delete( p_sys->conv );
+    free( p_sys->p_in );
+    free( p_sys->p_out );
+    free( p_sys );
+}
@@ -86,7 +86,7 @@ static int Open(vlc_object_t *object)
 /*** from U8 ***/
 static block_t *U8toS16(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 2);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -97,13 +97,12 @@ static block_t *U8toS16(filter_t *filter, block_t *bsrc)
         *dst++ = ((*src++) << 8) - 0x8000;
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
 static block_t *U8toFl32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 4);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -114,13 +113,12 @@ static block_t *U8toFl32(filter_t *filter, block_t *bsrc)
         *dst++ = ((float)((*src++) - 128)) / 128.f;
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
 static block_t *U8toS32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 4);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -131,13 +129,12 @@ static block_t *U8toS32(filter_t *filter, block_t *bsrc)
         *dst++ = ((*src++) << 24) - 0x80000000;
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
 static block_t *U8toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 8);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 8);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -148,7 +145,6 @@ static block_t *U8toFl64(filter_t *filter, block_t *bsrc)
         *dst++ = ((double)((*src++) - 128)) / 128.;
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
@@ -168,7 +164,7 @@ static block_t *S16toU8(filter_t *filter, block_t *b)
 
 static block_t *S16toFl32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 2);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -190,13 +186,12 @@ static block_t *S16toFl32(filter_t *filter, block_t *bsrc)
 #endif
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
 static block_t *S16toS32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 2);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -207,13 +202,12 @@ static block_t *S16toS32(filter_t *filter, block_t *bsrc)
         *dst++ = *src++ << 16;
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
 static block_t *S16toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 4);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -224,7 +218,6 @@ static block_t *S16toFl64(filter_t *filter, block_t *bsrc)
         *dst++ = (double)*src++ / 32768.;
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
@@ -299,7 +292,7 @@ static block_t *Fl32toS32(filter_t *filter, block_t *b)
 
 static block_t *Fl32toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 2);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -310,7 +303,6 @@ static block_t *Fl32toFl64(filter_t *filter, block_t *bsrc)
         *(dst++) = *(src++);
 out:
     block_Release(bsrc);
-    VLC_UNUSED(filter);
     return bdst;
 }
 
@@ -352,7 +344,7 @@ static block_t *S32toFl32(filter_t *filter, block_t *b)
 
 static block_t *S32toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    block_t *bdst = filter_NewAudioBuffer(filter, bsrc->i_buffer * 2);
     if (unlikely(bdst == NULL))
         goto out;
 
@@ -362,7 +354,6 @@ static block_t *S32toFl64(filter_t *filter, block_t *bsrc)
     for (size_t i = bsrc->i_buffer / 4; i--;)
         *dst++ = (double)(*src++) / -(double)INT32_MIN;
 out:
-    VLC_UNUSED(filter);
     block_Release(bsrc);
     return bdst;
 }
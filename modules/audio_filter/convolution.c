@@ -0,0 +1,317 @@
+/*****************************************************************************
+ * convolution.c: uniformly partitioned FFT convolution
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include <vlc_common.h>
+
+#include "convolution.h"
+#include "fft.h"
+
+/* Spectra of real signals are stored as bins 0 to partition (included) of
+ * an FFT of twice the partition size, real and imaginary parts apart. */
+struct audio_conv
+{
+    audio_fft_t *fft;
+    unsigned partition;
+    unsigned bins;
+    unsigned inputs;
+    unsigned outputs;
+    unsigned count;   /* partitions per response */
+    unsigned head;    /* newest input spectrum in the delay line */
+    unsigned *used;   /* non-silent partitions, per input and output */
+    float *responses; /* [inputs][outputs][count] spectra */
+    float *fdl;       /* [inputs][count] spectra of the past inputs */
+    float *history;   /* [inputs][partition] previous input partition */
+    float *acc;       /* [outputs] spectra */
+    float *work;      /* FFT buffer */
+};
+
+static size_t SpectrumSize(const audio_conv_t *conv)
+{
+    return 2 * conv->bins;
+}
+
+audio_conv_t *audio_conv_New(unsigned partition, unsigned inputs,
+                             unsigned outputs, size_t frames)
+{
+    assert(partition > 0 && (partition & (partition - 1)) == 0);
+    assert(inputs > 0 && outputs > 0);
+
+    audio_conv_t *conv = malloc(sizeof (*conv));
+    if (unlikely(conv == NULL))
+        return NULL;
+
+    conv->partition = partition;
+    conv->bins = partition + 1;
+    conv->inputs = inputs;
+    conv->outputs = outputs;
+    conv->count = frames > 0 ? (frames + partition - 1) / partition : 1;
+    conv->head = 0;
+
+    const size_t spectrum = SpectrumSize(conv);
+    const size_t paths = (size_t)inputs * outputs;
+
+    conv->fft = audio_fft_New(2 * partition);
+    conv->used = vlc_alloc(paths, sizeof (*conv->used));
+    conv->responses = paths * conv->count <= SIZE_MAX / spectrum
+        ? vlc_alloc(paths * conv->count * spectrum, sizeof (float)) : NULL;
+    conv->fdl = vlc_alloc((size_t)inputs * conv->count,
+                          spectrum * sizeof (float));
+    conv->history = vlc_alloc(inputs, partition * sizeof (float));
+    conv->acc = vlc_alloc(outputs, spectrum * sizeof (float));
+    conv->work = vlc_alloc(4 * partition, sizeof (float));
+
+    if (unlikely(conv->fft == NULL || conv->used == NULL
+              || conv->responses == NULL || conv->fdl == NULL
+              || conv->history == NULL || conv->acc == NULL
+              || conv->work == NULL))
+    {
+        audio_conv_Delete(conv);
+        return NULL;
+    }
+
+    memset(conv->used, 0, paths * sizeof (*conv->used));
+    audio_conv_Reset(conv);
+    return conv;
+}
+
+void audio_conv_Delete(audio_conv_t *conv)
+{
+    if (conv->fft != NULL)
+        audio_fft_Delete(conv->fft);
+    free(conv->used);
+    free(conv->responses);
+    free(conv->fdl);
+    free(conv->history);
+    free(conv->acc);
+    free(conv->work);
+    free(conv);
+}
+
+unsigned audio_conv_Partition(const audio_conv_t *conv)
+{
+    return conv->partition;
+}
+
+void audio_conv_Reset(audio_conv_t *conv)
+{
+    const size_t spectrum = SpectrumSize(conv);
+
+    memset(conv->fdl, 0,
+           (size_t)conv->inputs * conv->count * spectrum * sizeof (float));
+    memset(conv->history, 0,
+           (size_t)conv->inputs * conv->partition * sizeof (float));
+    conv->head = 0;
+}
+
+void audio_conv_SetResponse(audio_conv_t *conv, unsigned input,
+                            unsigned output, const float *ir, size_t frames,
+                            size_t stride)
+{
+    const unsigned p = conv->partition;
+    const unsigned n = 2 * p;
+    const size_t spectrum = SpectrumSize(conv);
+    float *work = conv->work;
+    unsigned used = 0;
+
+    assert(input < conv->inputs && output < conv->outputs);
+    if (frames > (size_t)conv->count * p)
+        frames = (size_t)conv->count * p;
+
+    /* The input spectra are stored scaled by two (see Process()), and
+     * neither direction of the FFT is normalized. */
+    const float scale = .5f / n;
+    const size_t path = (size_t)input * conv->outputs + output;
+    float *spectra = &conv->responses[path * conv->count * spectrum];
+
+    for (unsigned j = 0; j < conv->count; j++)
+    {
+        const size_t offset = (size_t)j * p;
+        const size_t len = offset < frames ? __MIN(frames - offset, p) : 0;
+        bool silent = true;
+
+        memset(work, 0, 2 * n * sizeof (*work));
+        for (size_t i = 0; i < len; i++)
+        {
+            work[2 * i] = ir[(offset + i) * stride];
+            if (work[2 * i] != 0.f)
+                silent = false;
+        }
+        if (!silent)
+        {
+            audio_fft_Forward(conv->fft, work);
+            used = j + 1;
+        }
+
+        float *re = &spectra[j * spectrum];
+        float *im = re + conv->bins;
+        for (unsigned k = 0; k < conv->bins; k++)
+        {
+            re[k] = silent ? 0.f : work[2 * k] * scale;
+            im[k] = silent ? 0.f : work[2 * k + 1] * scale;
+        }
+    }
+    conv->used[path] = used;
+}
+
+/* Transforms two input channels at once, the first one as the real part
+ * and the second one as the imaginary part, then splits the spectra using
+ * their hermitian symmetry. Both spectra come out scaled by two. */
+static void Analyse(audio_conv_t *conv, const float *in, unsigned ch)
+{
+    const unsigned p = conv->partition;
+    const unsigned n = 2 * p;
+    const unsigned bins = conv->bins;
+    const size_t spectrum = SpectrumSize(conv);
+    const bool pair = ch + 1 < conv->inputs;
+    float *restrict work = conv->work;
+    float *hist0 = &conv->history[(size_t)ch * p];
+    float *hist1 = pair ? hist0 + p : NULL;
+
+    for (unsigned i = 0; i < p; i++)
+    {
+        work[2 * i] = hist0[i];
+        work[2 * i + 1] = pair ? hist1[i] : 0.f;
+    }
+    for (unsigned i = 0; i < p; i++)
+    {
+        const float *frame = &in[(size_t)i * conv->inputs + ch];
+
+        work[2 * (p + i)] = hist0[i] = frame[0];
+        work[2 * (p + i) + 1] = pair ? (hist1[i] = frame[1]) : 0.f;
+    }
+
+    audio_fft_Forward(conv->fft, work);
+
+    float *re0 = &conv->fdl[((size_t)ch * conv->count + conv->head)
+                            * spectrum];
+    float *im0 = re0 + bins;
+    float *re1 = pair ? re0 + conv->count * spectrum : NULL;
+    float *im1 = pair ? re1 + bins : NULL;
+
+    for (unsigned k = 0; k < bins; k++)
+    {
+        const unsigned m = (n - k) & (n - 1);
+        const float xr = work[2 * k], xi = work[2 * k + 1];
+        const float yr = work[2 * m], yi = work[2 * m + 1];
+
+        re0[k] = xr + yr;
+        im0[k] = xi - yi;
+        if (pair)
+        {
+            re1[k] = xi + yi;
+            im1[k] = yr - xr;
+        }
+    }
+}
+
+/* Transforms two output spectra back at once, the first one as the real
+ * part and the second one as the imaginary part, and keeps the last
+ * partition of the circular convolution. */
+static void Synthesize(audio_conv_t *conv, float *out, unsigned ch)
+{
+    const unsigned p = conv->partition;
+    const unsigned n = 2 * p;
+    const unsigned bins = conv->bins;
+    const size_t spectrum = SpectrumSize(conv);
+    const bool pair = ch + 1 < conv->outputs;
+    float *restrict work = conv->work;
+    const float *ar = &conv->acc[(size_t)ch * spectrum];
+    const float *ai = ar + bins;
+    const float *br = pair ? ai + bins : NULL;
+    const float *bi = pair ? br + bins : NULL;
+
+    for (unsigned k = 0; k < bins; k++)
+    {
+        work[2 * k] = ar[k] - (pair ? bi[k] : 0.f);
+        work[2 * k + 1] = ai[k] + (pair ? br[k] : 0.f);
+    }
+    for (unsigned k = bins; k < n; k++)
+    {
+        const unsigned m = n - k;
+
+        work[2 * k] = ar[m] + (pair ? bi[m] : 0.f);
+        work[2 * k + 1] = (pair ? br[m] : 0.f) - ai[m];
+    }
+
+    audio_fft_Inverse(conv->fft, work);
+
+    for (unsigned i = 0; i < p; i++)
+    {
+        float *frame = &out[(size_t)i * conv->outputs + ch];
+
+        frame[0] = work[2 * (p + i)];
+        if (pair)
+            frame[1] = work[2 * (p + i) + 1];
+    }
+}
+
+void audio_conv_Process(audio_conv_t *conv, const float *in, float *out)
+{
+    const unsigned bins = conv->bins;
+    const unsigned count = conv->count;
+    const size_t spectrum = SpectrumSize(conv);
+
+    for (unsigned ch = 0; ch < conv->inputs; ch += 2)
+        Analyse(conv, in, ch);
+
+    memset(conv->acc, 0, conv->outputs * spectrum * sizeof (float));
+
+    for (unsigned o = 0; o < conv->outputs; o++)
+    {
+        float *restrict accr = &conv->acc[o * spectrum];
+        float *restrict acci = accr + bins;
+
+        for (unsigned ch = 0; ch < conv->inputs; ch++)
+        {
+            const size_t path = (size_t)ch * conv->outputs + o;
+            const float *h = &conv->responses[path * count * spectrum];
+            const float *x = &conv->fdl[(size_t)ch * count * spectrum];
+
+            /* Partition j of the response applies to the input from j
+             * partitions ago. */
+            for (unsigned j = 0; j < conv->used[path]; j++)
+            {
+                const unsigned slot = (conv->head + count - j) % count;
+                const float *restrict hr = &h[j * spectrum];
+                const float *restrict hi = hr + bins;
+                const float *restrict xr = &x[slot * spectrum];
+                const float *restrict xi = xr + bins;
+
+                for (unsigned k = 0; k < bins; k++)
+                {
+                    accr[k] += xr[k] * hr[k] - xi[k] * hi[k];
+                    acci[k] += xr[k] * hi[k] + xi[k] * hr[k];
+                }
+            }
+        }
+    }
+
+    for (unsigned ch = 0; ch < conv->outputs; ch += 2)
+        Synthesize(conv, out, ch);
+
+    conv->head = (conv->head + 1) % count;
+}
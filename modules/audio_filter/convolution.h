@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * convolution.h: uniformly partitioned FFT convolution
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_AUDIO_FILTER_CONVOLUTION_H
+#define VLC_AUDIO_FILTER_CONVOLUTION_H
+
+#include <stddef.h>
+
+/**
+ * Multichannel convolution engine.
+ *
+ * Every output channel is the sum of the input channels convolved with one
+ * impulse response per input and output pair. The impulse responses are
+ * cut into partitions of a fixed size, each convolved in the frequency
+ * domain (overlap-save), so that the cost per sample grows with the number
+ * of partitions rather than with the length of the responses.
+ *
+ * Samples are processed one partition at a time, without any latency of
+ * their own: callers buffering their input by partitions delay the signal
+ * by one partition.
+ */
+typedef struct audio_conv audio_conv_t;
+
+/**
+ * Creates a convolution engine.
+ *
+ * \param partition number of frames per partition, must be a power of two
+ * \param inputs number of input channels
+ * \param outputs number of output channels
+ * \param frames maximum length of the impulse responses
+ *
+ * All the impulse responses are silent initially.
+ */
+audio_conv_t *audio_conv_New(unsigned partition, unsigned inputs,
+                             unsigned outputs, size_t frames);
+void audio_conv_Delete(audio_conv_t *);
+
+unsigned audio_conv_Partition(const audio_conv_t *);
+
+/**
+ * Sets the impulse response from one input to one output channel.
+ *
+ * The response has frames samples, stride samples apart. Trailing silent
+ * partitions are skipped when processing.
+ */
+void audio_conv_SetResponse(audio_conv_t *, unsigned input, unsigned output,
+                            const float *ir, size_t frames, size_t stride);
+
+/**
+ * Convolves one partition of interleaved frames.
+ *
+ * in holds partition * inputs samples, out partition * outputs samples.
+ */
+void audio_conv_Process(audio_conv_t *, const float *in, float *out);
+
+/**
+ * Forgets the past input.
+ */
+void audio_conv_Reset(audio_conv_t *);
+
+#endif
@@ -0,0 +1,200 @@
+/*****************************************************************************
+ * dsp.c: vectorised floating point DSP kernels for the audio filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+
+#include "dsp.h"
+
+/* The kernels are written once with the GCC vector extensions, and built
+ * for the baseline instruction set (SSE2 on x86-64, NEON on AArch64) as
+ * well as for the wider units that need run-time detection. */
+#if defined __has_attribute
+# if __has_attribute(__vector_size__)
+#  define DSP_VECTORS
+# endif
+#endif
+
+static inline float dsp_Flush(float f)
+{
+    return fabsf(f) < FLT_MIN ? 0.f : f;
+}
+
+#define DSP_FN_(name, isa) name##_##isa
+#define DSP_FN__(name, isa) DSP_FN_(name, isa)
+#define DSP_FN(name) DSP_FN__(name, DSP_ISA)
+
+/* Plain scalar code, also used where the vectors would mostly be empty */
+#define DSP_VF     float
+#define DSP_VI     int32_t
+#define DSP_LANES  1
+#define DSP_TARGET
+#define DSP_ISA    scalar
+#include "dsp_kernels.h"
+#undef DSP_VF
+#undef DSP_VI
+#undef DSP_LANES
+#undef DSP_TARGET
+#undef DSP_ISA
+
+#ifdef DSP_VECTORS
+typedef float dsp_v4sf __attribute__((__vector_size__(16)));
+typedef int32_t dsp_v4si __attribute__((__vector_size__(16)));
+
+# define DSP_VF     dsp_v4sf
+# define DSP_VI     dsp_v4si
+# define DSP_LANES  4
+# define DSP_TARGET
+# define DSP_ISA    c
+# include "dsp_kernels.h"
+# undef DSP_VF
+# undef DSP_VI
+# undef DSP_LANES
+# undef DSP_TARGET
+# undef DSP_ISA
+
+# if defined (__i386__) && !defined (__SSE2__)
+#  define DSP_SSE2
+#  define DSP_VF     dsp_v4sf
+#  define DSP_VI     dsp_v4si
+#  define DSP_LANES  4
+#  define DSP_TARGET __attribute__ ((__target__ ("sse2")))
+#  define DSP_ISA    sse2
+#  include "dsp_kernels.h"
+#  undef DSP_VF
+#  undef DSP_VI
+#  undef DSP_LANES
+#  undef DSP_TARGET
+#  undef DSP_ISA
+# endif
+
+# if (defined (__i386__) || defined (__x86_64__)) && !defined (__AVX2__)
+typedef float dsp_v8sf __attribute__((__vector_size__(32)));
+typedef int32_t dsp_v8si __attribute__((__vector_size__(32)));
+
+#  define DSP_AVX2
+#  define DSP_VF     dsp_v8sf
+#  define DSP_VI     dsp_v8si
+#  define DSP_LANES  8
+#  define DSP_TARGET __attribute__ ((__target__ ("avx2")))
+#  define DSP_ISA    avx2
+#  include "dsp_kernels.h"
+#  undef DSP_VF
+#  undef DSP_VI
+#  undef DSP_LANES
+#  undef DSP_TARGET
+#  undef DSP_ISA
+# endif
+
+# define DSP_TRY_C(name, ...) \
+    do { \
+        name##_c(__VA_ARGS__); \
+        return; \
+    } while (0)
+#else
+# define DSP_TRY_C(name, ...)
+#endif
+
+#ifdef DSP_AVX2
+# define DSP_TRY_AVX2(name, ...) \
+    if (vlc_CPU_AVX2()) \
+    { \
+        name##_avx2(__VA_ARGS__); \
+        return; \
+    }
+#else
+# define DSP_TRY_AVX2(name, ...)
+#endif
+
+#ifdef DSP_SSE2
+# define DSP_TRY_SSE2(name, ...) \
+    if (vlc_CPU_SSE2()) \
+    { \
+        name##_sse2(__VA_ARGS__); \
+        return; \
+    }
+#else
+# define DSP_TRY_SSE2(name, ...)
+#endif
+
+#define DSP_DISPATCH(name, ...) \
+    do { \
+        DSP_TRY_AVX2(name, __VA_ARGS__) \
+        DSP_TRY_SSE2(name, __VA_ARGS__) \
+        DSP_TRY_C(name, __VA_ARGS__); \
+        name##_scalar(__VA_ARGS__); \
+    } while (0)
+
+/* The per-channel kernels only fill one lane per channel: with too few
+ * channels, the lane shuffling costs more than the vectors gain. */
+#define DSP_NARROW_CHANNELS 3
+
+void dsp_ResonatorBank(const struct dsp_resonator_bank *bank,
+                       struct dsp_resonator_state *state, const float *in,
+                       float *out, size_t frames, unsigned stride,
+                       float dry, float scale)
+{
+    DSP_DISPATCH(ResonatorBank, bank, state, in, out, frames, stride, dry,
+                 scale);
+}
+
+void dsp_BiquadCascade(const struct dsp_biquad *sections, unsigned stages,
+                       struct dsp_biquad_state *state, float *buf,
+                       size_t frames, unsigned channels)
+{
+    if (channels < DSP_NARROW_CHANNELS)
+    {
+        BiquadCascade_scalar(sections, stages, state, buf, frames, channels);
+        return;
+    }
+    DSP_DISPATCH(BiquadCascade, sections, stages, state, buf, frames,
+                 channels);
+}
+
+void dsp_CombAccumulate(float *line, const float *in, float *acc, size_t n,
+                        float damp, float feedback)
+{
+    DSP_DISPATCH(CombAccumulate, line, in, acc, n, damp, feedback);
+}
+
+void dsp_Allpass(float *line, float *io, size_t n, float feedback)
+{
+    DSP_DISPATCH(Allpass, line, io, n, feedback);
+}
+
+void dsp_Gate(const struct dsp_gate *gate, struct dsp_gate_state *state,
+              float *buf, size_t frames, unsigned channels)
+{
+    if (channels < DSP_NARROW_CHANNELS)
+    {
+        Gate_scalar(gate, state, buf, frames, channels);
+        return;
+    }
+    DSP_DISPATCH(Gate, gate, state, buf, frames, channels);
+}
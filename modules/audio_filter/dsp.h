@@ -0,0 +1,156 @@
+/*****************************************************************************
+ * dsp.h: vectorised floating point DSP kernels for the audio filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_AUDIO_FILTER_DSP_H
+#define VLC_AUDIO_FILTER_DSP_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Floating point DSP kernels shared by the audio filters.
+ *
+ * Each kernel picks the widest vector unit supported by the CPU at run
+ * time. Recursive filters are vectorised across independent filters or
+ * channels, never across time, so results match the scalar code up to the
+ * order of the final sums.
+ */
+
+#define DSP_BANK_MAX     16 /**< maximum resonators in a bank */
+#define DSP_BIQUAD_MAX    8 /**< maximum sections in a biquad cascade */
+#define DSP_CHANNELS_MAX 16 /**< maximum channels of the per-channel kernels */
+
+/**
+ * Bank of parallel second order resonators fed by the same input.
+ *
+ * Each resonator computes
+ *   y[n] = alpha * (x[n] - x[n-2]) + gamma * y[n-1] - beta * y[n-2]
+ * and the bank outputs scale * (dry * x[n] + sum(gain * y[n])).
+ * The coefficients of the unused resonators must be zero.
+ */
+struct dsp_resonator_bank
+{
+    float alpha[DSP_BANK_MAX];
+    float beta[DSP_BANK_MAX];
+    float gamma[DSP_BANK_MAX];
+    float gain[DSP_BANK_MAX];
+    unsigned count;
+};
+
+/** State of a resonator bank for one channel, zero initially */
+struct dsp_resonator_state
+{
+    float x[2];
+    float y[2][DSP_BANK_MAX];
+};
+
+/**
+ * Runs one channel through a resonator bank.
+ *
+ * in and out may be the same buffer. stride is the distance in samples
+ * between two consecutive frames.
+ */
+void dsp_ResonatorBank(const struct dsp_resonator_bank *,
+                       struct dsp_resonator_state *, const float *in,
+                       float *out, size_t frames, unsigned stride,
+                       float dry, float scale);
+
+/**
+ * Direct form I biquad section, normalized so that a0 is 1:
+ *   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ */
+struct dsp_biquad
+{
+    float b0, b1, b2, a1, a2;
+};
+
+/** State of a biquad cascade, per section and channel, zero initially */
+struct dsp_biquad_state
+{
+    float x1[DSP_BIQUAD_MAX][DSP_CHANNELS_MAX];
+    float x2[DSP_BIQUAD_MAX][DSP_CHANNELS_MAX];
+    float y1[DSP_BIQUAD_MAX][DSP_CHANNELS_MAX];
+    float y2[DSP_BIQUAD_MAX][DSP_CHANNELS_MAX];
+};
+
+/**
+ * Runs interleaved samples through a cascade of biquads, in place.
+ *
+ * All channels go through the same sections with their own state.
+ */
+void dsp_BiquadCascade(const struct dsp_biquad *, unsigned stages,
+                       struct dsp_biquad_state *, float *buf,
+                       size_t frames, unsigned channels);
+
+/**
+ * Feedback comb filter over n consecutive samples of its delay line:
+ *   out = line[i]; acc[i] += out; line[i] = in[i] + feedback * damp * out
+ *
+ * Denormal values are flushed to zero. n must not reach past the end of
+ * the delay line: callers split their buffers where the line wraps.
+ */
+void dsp_CombAccumulate(float *line, const float *in, float *acc, size_t n,
+                        float damp, float feedback);
+
+/**
+ * Schroeder allpass filter over n consecutive samples of its delay line,
+ * in place:
+ *   out = line[i] - io[i]; line[i] = io[i] + feedback * line[i]
+ *
+ * Same constraints as dsp_CombAccumulate().
+ */
+void dsp_Allpass(float *line, float *io, size_t n, float feedback);
+
+/**
+ * Noise gate envelope follower.
+ *
+ * The power of each channel is smoothed with a one-pole filter. The gain
+ * of a channel moves towards 1 when its power reaches the threshold, and
+ * towards 0 otherwise, with separate attack and release rates.
+ */
+struct dsp_gate
+{
+    float alpha;     /**< power smoothing factor */
+    float threshold; /**< power threshold (linear) */
+    float attack;    /**< gain smoothing factor when opening */
+    float release;   /**< gain smoothing factor when closing */
+};
+
+/** Per-channel gate state: the power should start at 0, the gain at 1 */
+struct dsp_gate_state
+{
+    float power[DSP_CHANNELS_MAX];
+    float gain[DSP_CHANNELS_MAX];
+};
+
+/**
+ * Applies the gate to interleaved samples, in place.
+ */
+void dsp_Gate(const struct dsp_gate *, struct dsp_gate_state *, float *buf,
+              size_t frames, unsigned channels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
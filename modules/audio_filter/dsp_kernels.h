@@ -0,0 +1,318 @@
+/*****************************************************************************
+ * dsp_kernels.h: DSP kernels template, see dsp.c
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* This file is included once per instruction set, with:
+ *  - DSP_VF:     float vector type (or float),
+ *  - DSP_VI:     integer vector type of the same size (or int32_t),
+ *  - DSP_LANES:  number of floats in DSP_VF,
+ *  - DSP_TARGET: function attributes selecting the instruction set,
+ *  - DSP_FN(n):  name of the function n for this instruction set. */
+
+DSP_TARGET
+static inline DSP_VF DSP_FN(Load)(const float *p)
+{
+    DSP_VF v;
+    memcpy(&v, p, sizeof (v));
+    return v;
+}
+
+DSP_TARGET
+static inline void DSP_FN(Store)(float *p, DSP_VF v)
+{
+    memcpy(p, &v, sizeof (v));
+}
+
+DSP_TARGET
+static inline DSP_VF DSP_FN(Splat)(float f)
+{
+    DSP_VF v = { 0 };
+    return v + f;
+}
+
+DSP_TARGET
+static inline float DSP_FN(Sum)(DSP_VF v)
+{
+    float lanes[DSP_LANES];
+    float sum = 0.f;
+
+    memcpy(lanes, &v, sizeof (v));
+    for (unsigned i = 0; i < DSP_LANES; i++)
+        sum += lanes[i];
+    return sum;
+}
+
+#if DSP_LANES > 1
+/* Bitwise a where the mask is set, b elsewhere */
+DSP_TARGET
+static inline DSP_VF DSP_FN(Select)(DSP_VI mask, DSP_VF a, DSP_VF b)
+{
+    return (DSP_VF)(((DSP_VI)a & mask) | ((DSP_VI)b & ~mask));
+}
+
+DSP_TARGET
+static inline DSP_VF DSP_FN(Flush)(DSP_VF v)
+{
+    const DSP_VF min = DSP_FN(Splat)(FLT_MIN);
+    const DSP_VI tiny = (v < min) & (v > -min);
+
+    return (DSP_VF)((DSP_VI)v & ~tiny);
+}
+#else
+DSP_TARGET
+static inline float DSP_FN(Select)(int32_t mask, float a, float b)
+{
+    return mask ? a : b;
+}
+
+DSP_TARGET
+static inline float DSP_FN(Flush)(float v)
+{
+    return dsp_Flush(v);
+}
+#endif
+
+/* Gathers up to DSP_LANES channels of an interleaved frame */
+DSP_TARGET
+static inline DSP_VF DSP_FN(LoadFrame)(const float *frame, unsigned count)
+{
+    float lanes[DSP_LANES] = { 0.f };
+
+#if DSP_LANES == 1
+    (void) count;
+    return *frame;
+#endif
+    for (unsigned i = 0; i < count; i++)
+        lanes[i] = frame[i];
+    return DSP_FN(Load)(lanes);
+}
+
+DSP_TARGET
+static inline void DSP_FN(StoreFrame)(float *frame, unsigned count,
+                                      DSP_VF v)
+{
+    float lanes[DSP_LANES];
+
+#if DSP_LANES == 1
+    (void) count;
+    *frame = v;
+    return;
+#endif
+    DSP_FN(Store)(lanes, v);
+    for (unsigned i = 0; i < count; i++)
+        frame[i] = lanes[i];
+}
+
+DSP_TARGET
+static void DSP_FN(ResonatorBank)(const struct dsp_resonator_bank *bank,
+                                  struct dsp_resonator_state *state,
+                                  const float *in, float *out, size_t frames,
+                                  unsigned stride, float dry, float scale)
+{
+    enum { VECTORS = DSP_BANK_MAX / DSP_LANES };
+    const unsigned count = (bank->count + DSP_LANES - 1) / DSP_LANES;
+    DSP_VF alpha[VECTORS], beta[VECTORS], gamma[VECTORS], gain[VECTORS];
+    DSP_VF y0[VECTORS], y1[VECTORS];
+    float x1 = state->x[0], x2 = state->x[1];
+
+    assert(bank->count <= DSP_BANK_MAX);
+
+    for (unsigned j = 0; j < count; j++)
+    {
+        alpha[j] = DSP_FN(Load)(&bank->alpha[j * DSP_LANES]);
+        beta[j] = DSP_FN(Load)(&bank->beta[j * DSP_LANES]);
+        gamma[j] = DSP_FN(Load)(&bank->gamma[j * DSP_LANES]);
+        gain[j] = DSP_FN(Load)(&bank->gain[j * DSP_LANES]);
+        y0[j] = DSP_FN(Load)(&state->y[0][j * DSP_LANES]);
+        y1[j] = DSP_FN(Load)(&state->y[1][j * DSP_LANES]);
+    }
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        const float x = in[i * stride];
+        const DSP_VF dx = DSP_FN(Splat)(x - x2);
+        DSP_VF acc = DSP_FN(Splat)(0.f);
+
+        for (unsigned j = 0; j < count; j++)
+        {
+            const DSP_VF y = alpha[j] * dx + gamma[j] * y0[j]
+                           - beta[j] * y1[j];
+            y1[j] = y0[j];
+            y0[j] = y;
+            acc += y * gain[j];
+        }
+        x2 = x1;
+        x1 = x;
+
+        out[i * stride] = scale * (dry * x + DSP_FN(Sum)(acc));
+    }
+
+    state->x[0] = x1;
+    state->x[1] = x2;
+    for (unsigned j = 0; j < count; j++)
+    {
+        DSP_FN(Store)(&state->y[0][j * DSP_LANES], y0[j]);
+        DSP_FN(Store)(&state->y[1][j * DSP_LANES], y1[j]);
+    }
+}
+
+DSP_TARGET
+static void DSP_FN(BiquadCascade)(const struct dsp_biquad *sections,
+                                  unsigned stages,
+                                  struct dsp_biquad_state *state, float *buf,
+                                  size_t frames, unsigned channels)
+{
+    assert(stages <= DSP_BIQUAD_MAX);
+    assert(channels <= DSP_CHANNELS_MAX);
+
+    /* Each group of channels fills one vector */
+    for (unsigned ch = 0; ch < channels; ch += DSP_LANES)
+    {
+        const unsigned count = channels - ch < DSP_LANES ? channels - ch
+                                                         : DSP_LANES;
+        DSP_VF x1[DSP_BIQUAD_MAX], x2[DSP_BIQUAD_MAX];
+        DSP_VF y1[DSP_BIQUAD_MAX], y2[DSP_BIQUAD_MAX];
+
+        for (unsigned s = 0; s < stages; s++)
+        {
+            x1[s] = DSP_FN(Load)(&state->x1[s][ch]);
+            x2[s] = DSP_FN(Load)(&state->x2[s][ch]);
+            y1[s] = DSP_FN(Load)(&state->y1[s][ch]);
+            y2[s] = DSP_FN(Load)(&state->y2[s][ch]);
+        }
+
+        float *frame = buf + ch;
+        for (size_t i = 0; i < frames; i++, frame += channels)
+        {
+            DSP_VF x = DSP_FN(LoadFrame)(frame, count);
+
+            for (unsigned s = 0; s < stages; s++)
+            {
+                const struct dsp_biquad *c = &sections[s];
+                const DSP_VF y = x * c->b0 + x1[s] * c->b1 + x2[s] * c->b2
+                               - y1[s] * c->a1 - y2[s] * c->a2;
+                x2[s] = x1[s];
+                x1[s] = x;
+                y2[s] = y1[s];
+                y1[s] = y;
+                x = y;
+            }
+            DSP_FN(StoreFrame)(frame, count, x);
+        }
+
+        for (unsigned s = 0; s < stages; s++)
+        {
+            DSP_FN(Store)(&state->x1[s][ch], x1[s]);
+            DSP_FN(Store)(&state->x2[s][ch], x2[s]);
+            DSP_FN(Store)(&state->y1[s][ch], y1[s]);
+            DSP_FN(Store)(&state->y2[s][ch], y2[s]);
+        }
+    }
+}
+
+DSP_TARGET
+static void DSP_FN(CombAccumulate)(float *restrict line,
+                                   const float *restrict in,
+                                   float *restrict acc, size_t n,
+                                   float damp, float feedback)
+{
+    size_t i = 0;
+
+    for (; i + DSP_LANES <= n; i += DSP_LANES)
+    {
+        const DSP_VF out = DSP_FN(Flush)(DSP_FN(Load)(&line[i]));
+        const DSP_VF store = DSP_FN(Flush)(out * damp);
+
+        DSP_FN(Store)(&acc[i], DSP_FN(Load)(&acc[i]) + out);
+        DSP_FN(Store)(&line[i], DSP_FN(Load)(&in[i]) + store * feedback);
+    }
+    for (; i < n; i++)
+    {
+        const float out = dsp_Flush(line[i]);
+
+        acc[i] += out;
+        line[i] = in[i] + dsp_Flush(out * damp) * feedback;
+    }
+}
+
+DSP_TARGET
+static void DSP_FN(Allpass)(float *restrict line, float *restrict io,
+                            size_t n, float feedback)
+{
+    size_t i = 0;
+
+    for (; i + DSP_LANES <= n; i += DSP_LANES)
+    {
+        const DSP_VF out = DSP_FN(Flush)(DSP_FN(Load)(&line[i]));
+        const DSP_VF x = DSP_FN(Load)(&io[i]);
+
+        DSP_FN(Store)(&line[i], x + out * feedback);
+        DSP_FN(Store)(&io[i], out - x);
+    }
+    for (; i < n; i++)
+    {
+        const float out = dsp_Flush(line[i]);
+        const float x = io[i];
+
+        line[i] = x + out * feedback;
+        io[i] = out - x;
+    }
+}
+
+DSP_TARGET
+static void DSP_FN(Gate)(const struct dsp_gate *gate,
+                         struct dsp_gate_state *state, float *buf,
+                         size_t frames, unsigned channels)
+{
+    const DSP_VF alpha = DSP_FN(Splat)(gate->alpha);
+    const DSP_VF keep = DSP_FN(Splat)(1.f - gate->alpha);
+    const DSP_VF threshold = DSP_FN(Splat)(gate->threshold);
+    const DSP_VF attack = DSP_FN(Splat)(gate->attack);
+    const DSP_VF release = DSP_FN(Splat)(gate->release);
+    const DSP_VF zero = DSP_FN(Splat)(0.f);
+    const DSP_VF one = DSP_FN(Splat)(1.f);
+
+    assert(channels <= DSP_CHANNELS_MAX);
+
+    for (unsigned ch = 0; ch < channels; ch += DSP_LANES)
+    {
+        const unsigned count = channels - ch < DSP_LANES ? channels - ch
+                                                         : DSP_LANES;
+        DSP_VF power = DSP_FN(Load)(&state->power[ch]);
+        DSP_VF gain = DSP_FN(Load)(&state->gain[ch]);
+
+        float *frame = buf + ch;
+        for (size_t i = 0; i < frames; i++, frame += channels)
+        {
+            const DSP_VF x = DSP_FN(LoadFrame)(frame, count);
+
+            power = keep * power + (x * x) * alpha;
+
+            const DSP_VF target = DSP_FN(Select)(power < threshold,
+                                                 zero, one);
+            const DSP_VF delta = target - gain;
+            gain += DSP_FN(Select)(delta > zero, attack, release) * delta;
+
+            DSP_FN(StoreFrame)(frame, count, x * gain);
+        }
+
+        DSP_FN(Store)(&state->power[ch], power);
+        DSP_FN(Store)(&state->gain[ch], gain);
+    }
+}
@@ -38,9 +38,9 @@
 #include <vlc_filter.h>
 
 #include "equalizer_presets.h"
+#include "dsp.h"
 
 /* TODO:
- *  - optimize a bit (you can hardly do slower ;)
  *  - add tables for more bands (15 and 32 would be cool), maybe with auto coeffs
  *    computation (not too hard once the Q is found).
  *  - support for external preset
@@ -101,24 +101,18 @@ vlc_module_end ()
  *****************************************************************************/
 typedef struct
 {
-    /* Filter static config */
-    int i_band;
-    float *f_alpha;
-    float *f_beta;
-    float *f_gamma;
+    /* Filter config: static coefficients, and per band amp */
+    struct dsp_resonator_bank bank;
 
     /* Filter dyn config */
-    float *f_amp;   /* Per band amp */
     float f_gamp;   /* Global preamp */
     bool b_2eqz;
 
     /* Filter state */
-    float x[32][2];
-    float y[32][128][2];
+    struct dsp_resonator_state state[AOUT_CHAN_MAX];
 
     /* Second filter state */
-    float x2[32][2];
-    float y2[32][128][2];
+    struct dsp_resonator_state state2[AOUT_CHAN_MAX];
 
     vlc_mutex_t lock;
 } filter_sys_t;
@@ -153,6 +147,12 @@ static int Open( vlc_object_t *p_this )
     if( !p_sys )
         return VLC_ENOMEM;
 
+    if( aout_FormatNbChannels( &p_filter->fmt_in.audio ) > AOUT_CHAN_MAX )
+    {
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
     vlc_mutex_init( &p_sys->lock );
     if( EqzInit( p_filter, p_filter->fmt_in.audio.i_rate ) != VLC_SUCCESS )
     {
@@ -280,57 +280,32 @@ static int EqzInit( filter_t *p_filter, int i_rate )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     eqz_config_t cfg;
-    int i, ch;
+    int i;
     vlc_value_t val1, val2, val3;
     vlc_object_t *p_aout = vlc_object_parent(p_filter);
-    int i_ret = VLC_ENOMEM;
 
     bool b_vlcFreqs = var_InheritBool( p_aout, "equalizer-vlcfreqs" );
     EqzCoeffs( i_rate, 1.0f, b_vlcFreqs, &cfg );
 
-    /* Create the static filter config */
-    p_sys->i_band = cfg.i_band;
-    p_sys->f_alpha = vlc_alloc( p_sys->i_band, sizeof(float) );
-    p_sys->f_beta  = vlc_alloc( p_sys->i_band, sizeof(float) );
-    p_sys->f_gamma = vlc_alloc( p_sys->i_band, sizeof(float) );
-    if( !p_sys->f_alpha || !p_sys->f_beta || !p_sys->f_gamma )
-        goto error;
+    static_assert( EQZ_BANDS_MAX <= DSP_BANK_MAX, "too many bands" );
 
-    for( i = 0; i < p_sys->i_band; i++ )
+    /* Create the static filter config, the unused bands stay at zero */
+    memset( &p_sys->bank, 0, sizeof( p_sys->bank ) );
+    p_sys->bank.count = cfg.i_band;
+    for( i = 0; i < cfg.i_band; i++ )
     {
-        p_sys->f_alpha[i] = cfg.band[i].f_alpha;
-        p_sys->f_beta[i]  = cfg.band[i].f_beta;
-        p_sys->f_gamma[i] = cfg.band[i].f_gamma;
+        p_sys->bank.alpha[i] = cfg.band[i].f_alpha;
+        p_sys->bank.beta[i]  = cfg.band[i].f_beta;
+        p_sys->bank.gamma[i] = cfg.band[i].f_gamma;
     }
 
     /* Filter dyn config */
     p_sys->b_2eqz = false;
     p_sys->f_gamp = 1.0f;
-    p_sys->f_amp  = vlc_alloc( p_sys->i_band, sizeof(float) );
-    if( !p_sys->f_amp )
-        goto error;
-
-    for( i = 0; i < p_sys->i_band; i++ )
-    {
-        p_sys->f_amp[i] = 0.0f;
-    }
 
     /* Filter state */
-    for( ch = 0; ch < 32; ch++ )
-    {
-        p_sys->x[ch][0]  =
-        p_sys->x[ch][1]  =
-        p_sys->x2[ch][0] =
-        p_sys->x2[ch][1] = 0.0f;
-
-        for( i = 0; i < p_sys->i_band; i++ )
-        {
-            p_sys->y[ch][i][0]  =
-            p_sys->y[ch][i][1]  =
-            p_sys->y2[ch][i][0] =
-            p_sys->y2[ch][i][1] = 0.0f;
-        }
-    }
+    memset( p_sys->state, 0, sizeof( p_sys->state ) );
+    memset( p_sys->state2, 0, sizeof( p_sys->state2 ) );
 
     var_Create( p_aout, "equalizer-bands", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
     var_Create( p_aout, "equalizer-preset", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
@@ -356,9 +331,7 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     {
         msg_Err(p_filter, "No preset selected");
         free( val2.psz_string );
-        free( p_sys->f_amp );
-        i_ret = VLC_EGENERIC;
-        goto error;
+        return VLC_EGENERIC;
     }
     free( val2.psz_string );
 
@@ -369,81 +342,40 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     var_AddCallback( p_aout, "equalizer-2pass", TwoPassCallback, p_sys );
 
     msg_Dbg( p_filter, "equalizer loaded for %d Hz with %d bands %d pass",
-                        i_rate, p_sys->i_band, p_sys->b_2eqz ? 2 : 1 );
-    for( i = 0; i < p_sys->i_band; i++ )
+                        i_rate, p_sys->bank.count, p_sys->b_2eqz ? 2 : 1 );
+    for( i = 0; i < cfg.i_band; i++ )
     {
         msg_Dbg( p_filter, "   %.2f Hz -> factor:%f alpha:%f beta:%f gamma:%f",
-                 cfg.band[i].f_frequency, p_sys->f_amp[i],
-                 p_sys->f_alpha[i], p_sys->f_beta[i], p_sys->f_gamma[i]);
+                 cfg.band[i].f_frequency, p_sys->bank.gain[i],
+                 p_sys->bank.alpha[i], p_sys->bank.beta[i],
+                 p_sys->bank.gamma[i]);
     }
     return VLC_SUCCESS;
-
-error:
-    free( p_sys->f_alpha );
-    free( p_sys->f_beta );
-    free( p_sys->f_gamma );
-    return i_ret;
 }
 
 static void EqzFilter( filter_t *p_filter, float *out, float *in,
                        int i_samples, int i_channels )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    int i, ch, j;
 
     vlc_mutex_lock( &p_sys->lock );
-    for( i = 0; i < i_samples; i++ )
+    for( int ch = 0; ch < i_channels; ch++ )
     {
-        for( ch = 0; ch < i_channels; ch++ )
+        /* Each pass adds source PCM + filtered PCM */
+        if( p_sys->b_2eqz )
         {
-            const float x = in[ch];
-            float o = 0.0f;
-
-            for( j = 0; j < p_sys->i_band; j++ )
-            {
-                float y = p_sys->f_alpha[j] * ( x - p_sys->x[ch][1] ) +
-                          p_sys->f_gamma[j] * p_sys->y[ch][j][0] -
-                          p_sys->f_beta[j]  * p_sys->y[ch][j][1];
-
-                p_sys->y[ch][j][1] = p_sys->y[ch][j][0];
-                p_sys->y[ch][j][0] = y;
-
-                o += y * p_sys->f_amp[j];
-            }
-            p_sys->x[ch][1] = p_sys->x[ch][0];
-            p_sys->x[ch][0] = x;
-
-            /* Second filter */
-            if( p_sys->b_2eqz )
-            {
-                const float x2 = EQZ_IN_FACTOR * x + o;
-                o = 0.0f;
-                for( j = 0; j < p_sys->i_band; j++ )
-                {
-                    float y = p_sys->f_alpha[j] * ( x2 - p_sys->x2[ch][1] ) +
-                              p_sys->f_gamma[j] * p_sys->y2[ch][j][0] -
-                              p_sys->f_beta[j]  * p_sys->y2[ch][j][1];
-
-                    p_sys->y2[ch][j][1] = p_sys->y2[ch][j][0];
-                    p_sys->y2[ch][j][0] = y;
-
-                    o += y * p_sys->f_amp[j];
-                }
-                p_sys->x2[ch][1] = p_sys->x2[ch][0];
-                p_sys->x2[ch][0] = x2;
-
-                /* We add source PCM + filtered PCM */
-                out[ch] = p_sys->f_gamp * p_sys->f_gamp *( EQZ_IN_FACTOR * x2 + o );
-            }
-            else
-            {
-                /* We add source PCM + filtered PCM */
-                out[ch] = p_sys->f_gamp *( EQZ_IN_FACTOR * x + o );
-            }
+            /* Second filter, fed by the output of the first one */
+            dsp_ResonatorBank( &p_sys->bank, &p_sys->state[ch], &in[ch],
+                               &out[ch], i_samples, i_channels,
+                               EQZ_IN_FACTOR, 1.0f );
+            dsp_ResonatorBank( &p_sys->bank, &p_sys->state2[ch], &out[ch],
+                               &out[ch], i_samples, i_channels,
+                               EQZ_IN_FACTOR, p_sys->f_gamp * p_sys->f_gamp );
         }
-
-        in  += i_channels;
-        out += i_channels;
+        else
+            dsp_ResonatorBank( &p_sys->bank, &p_sys->state[ch], &in[ch],
+                               &out[ch], i_samples, i_channels,
+                               EQZ_IN_FACTOR, p_sys->f_gamp );
     }
     vlc_mutex_unlock( &p_sys->lock );
 }
@@ -457,12 +389,6 @@ static void EqzClean( filter_t *p_filter )
     var_DelCallback( p_aout, "equalizer-preset", PresetCallback, p_sys );
     var_DelCallback( p_aout, "equalizer-preamp", PreampCallback, p_sys );
     var_DelCallback( p_aout, "equalizer-2pass", TwoPassCallback, p_sys );
-
-    free( p_sys->f_alpha );
-    free( p_sys->f_beta );
-    free( p_sys->f_gamma );
-
-    free( p_sys->f_amp );
 }
 
 
@@ -543,7 +469,7 @@ static int BandsCallback( vlc_object_t *p_this, char const *psz_cmd,
 
     /* Same thing for bands */
     vlc_mutex_lock( &p_sys->lock );
-    while( i < p_sys->i_band )
+    while( i < (int)p_sys->bank.count )
     {
         char *next;
         /* Read dB -20/20 */
@@ -551,14 +477,14 @@ static int BandsCallback( vlc_object_t *p_this, char const *psz_cmd,
         if( next == p || isnan( f ) )
             break; /* no conversion */
 
-        p_sys->f_amp[i++] = EqzConvertdB( f );
+        p_sys->bank.gain[i++] = EqzConvertdB( f );
 
         if( *next == '\0' )
             break; /* end of line */
         p = &next[1];
     }
-    while( i < p_sys->i_band )
-        p_sys->f_amp[i++] = EqzConvertdB( 0.f );
+    while( i < (int)p_sys->bank.count )
+        p_sys->bank.gain[i++] = EqzConvertdB( 0.f );
     vlc_mutex_unlock( &p_sys->lock );
     return VLC_SUCCESS;
 }
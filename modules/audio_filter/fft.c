@@ -0,0 +1,196 @@
+/*****************************************************************************
+ * fft.c: floating point FFT helpers for the audio filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <vlc_common.h>
+
+#include "fft.h"
+
+struct audio_fft
+{
+    unsigned size;
+    unsigned *bitrev;
+    float *twiddle; /* e^(-2*pi*i*k/size) for k in [0, size/2) */
+};
+
+audio_fft_t *audio_fft_New(unsigned size)
+{
+    assert(size > 0 && (size & (size - 1)) == 0);
+
+    audio_fft_t *fft = malloc(sizeof (*fft));
+    if (unlikely(fft == NULL))
+        return NULL;
+
+    fft->size = size;
+    fft->bitrev = vlc_alloc(size, sizeof (*fft->bitrev));
+    fft->twiddle = vlc_alloc(size, sizeof (*fft->twiddle));
+    if (unlikely(fft->bitrev == NULL || fft->twiddle == NULL))
+    {
+        audio_fft_Delete(fft);
+        return NULL;
+    }
+
+    unsigned bits = 0;
+    while ((1u << bits) < size)
+        bits++;
+    for (unsigned i = 0; i < size; i++)
+    {
+        unsigned r = 0;
+        for (unsigned b = 0; b < bits; b++)
+            if (i & (1u << b))
+                r |= 1u << (bits - 1 - b);
+        fft->bitrev[i] = r;
+    }
+
+    for (unsigned k = 0; k < size / 2; k++)
+    {
+        double phase = -2. * M_PI * k / size;
+        fft->twiddle[2 * k] = cos(phase);
+        fft->twiddle[2 * k + 1] = sin(phase);
+    }
+    return fft;
+}
+
+void audio_fft_Delete(audio_fft_t *fft)
+{
+    free(fft->bitrev);
+    free(fft->twiddle);
+    free(fft);
+}
+
+unsigned audio_fft_Size(const audio_fft_t *fft)
+{
+    return fft->size;
+}
+
+unsigned audio_fft_SizeFor(unsigned count)
+{
+    unsigned size = 1;
+    while (size < count)
+        size <<= 1;
+    return size;
+}
+
+static void Transform(const audio_fft_t *fft, float *restrict data,
+                      float sign)
+{
+    const unsigned n = fft->size;
+    const float *restrict tw = fft->twiddle;
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        unsigned j = fft->bitrev[i];
+        if (i < j)
+        {
+            float re = data[2 * i], im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+
+    for (unsigned len = 2; len <= n; len <<= 1)
+    {
+        const unsigned half = len / 2;
+        const unsigned step = n / len;
+
+        for (unsigned i = 0; i < n; i += len)
+        {
+            float *restrict a = &data[2 * i];
+            float *restrict b = &data[2 * (i + half)];
+
+            for (unsigned k = 0; k < half; k++)
+            {
+                const float wr = tw[2 * k * step];
+                const float wi = sign * tw[2 * k * step + 1];
+                const float tr = b[2 * k] * wr - b[2 * k + 1] * wi;
+                const float ti = b[2 * k] * wi + b[2 * k + 1] * wr;
+
+                b[2 * k] = a[2 * k] - tr;
+                b[2 * k + 1] = a[2 * k + 1] - ti;
+                a[2 * k] += tr;
+                a[2 * k + 1] += ti;
+            }
+        }
+    }
+}
+
+void audio_fft_Forward(const audio_fft_t *fft, float *data)
+{
+    Transform(fft, data, 1.f);
+}
+
+void audio_fft_Inverse(const audio_fft_t *fft, float *data)
+{
+    Transform(fft, data, -1.f);
+}
+
+void audio_fft_Correlate(const audio_fft_t *fft, const float *ref,
+                         unsigned ref_frames, const float *sig, unsigned lags,
+                         unsigned channels, float *work, float *acc,
+                         float *corr)
+{
+    const unsigned n = fft->size;
+    const unsigned sig_frames = lags + ref_frames - 1;
+
+    assert(sig_frames <= n);
+    memset(acc, 0, 2 * n * sizeof (*acc));
+
+    for (unsigned c = 0; c < channels; c++)
+    {
+        /* Transform both real signals at once: the reference as the real
+         * part and the searched signal as the imaginary part. */
+        for (unsigned i = 0; i < n; i++)
+        {
+            work[2 * i] = i < ref_frames ? ref[i * channels + c] : 0.f;
+            work[2 * i + 1] = i < sig_frames ? sig[i * channels + c] : 0.f;
+        }
+        audio_fft_Forward(fft, work);
+
+        /* Split the spectra using their hermitian symmetry, and accumulate
+         * conj(REF) * SIG. Both spectra are scaled by 2, hence the 1/4
+         * below. */
+        for (unsigned k = 0; k < n; k++)
+        {
+            const unsigned m = (n - k) & (n - 1);
+            const float xr = work[2 * k], xi = work[2 * k + 1];
+            const float yr = work[2 * m], yi = work[2 * m + 1];
+            const float ar = xr + yr, ai = xi - yi;
+            const float sr = xi + yi, si = yr - xr;
+
+            acc[2 * k] += ar * sr + ai * si;
+            acc[2 * k + 1] += ar * si - ai * sr;
+        }
+    }
+
+    audio_fft_Inverse(fft, acc);
+
+    const float scale = .25f / n;
+    for (unsigned lag = 0; lag < lags; lag++)
+        corr[lag] = acc[2 * lag] * scale;
+}
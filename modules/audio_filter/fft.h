@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * fft.h: floating point FFT helpers for the audio filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_AUDIO_FILTER_FFT_H
+#define VLC_AUDIO_FILTER_FFT_H
+
+/**
+ * Radix-2 complex FFT.
+ *
+ * Buffers hold size complex values, as interleaved real and imaginary
+ * floats. Neither direction is normalized: an inverse transform following a
+ * forward transform scales the input by size.
+ */
+typedef struct audio_fft audio_fft_t;
+
+/**
+ * Creates a transform of the given size, which must be a power of two.
+ */
+audio_fft_t *audio_fft_New(unsigned size);
+void audio_fft_Delete(audio_fft_t *);
+
+unsigned audio_fft_Size(const audio_fft_t *);
+
+void audio_fft_Forward(const audio_fft_t *, float *data);
+void audio_fft_Inverse(const audio_fft_t *, float *data);
+
+/**
+ * Returns the smallest FFT size holding at least count values.
+ */
+unsigned audio_fft_SizeFor(unsigned count);
+
+/**
+ * Cross-correlates interleaved multichannel signals.
+ *
+ * Computes, for each lag in [0, lags), the sum over all the channels of
+ * ref[i] * sig[lag * channels + i] for i in [0, ref_frames * channels).
+ * sig must hold (lags + ref_frames - 1) frames.
+ *
+ * The FFT size must be at least lags + ref_frames - 1. work and acc are
+ * scratch buffers of audio_fft_Size() complex values each.
+ */
+void audio_fft_Correlate(const audio_fft_t *, const float *ref,
+                         unsigned ref_frames, const float *sig, unsigned lags,
+                         unsigned channels, float *work, float *acc,
+                         float *corr);
+
+#endif
@@ -36,6 +36,8 @@
 #include <vlc_plugin.h>
 #include <math.h>
 
+#include "dsp.h"
+
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
@@ -51,15 +53,17 @@ typedef struct
     float attack;	        /* Attack time [ms] */
     float release;	        /* Release time [ms] */
 
-    float *pow;		        /* Estimated power level [dB] - per channel */
-    float *gain;            /* Current gain per channel (for smooth transitions) */
-
     /* additional data - filter state */
     int channels;
-    float alpha;            /* smoothing factor - this is actually the forgetting factor for power estimate of the Anders Johansson approach. */
-    float thresh_linear;    /* Threshold in linear scale */
-    float attack_factor;    /* Attack factor for smoothing */
-    float release_factor;   /* Release factor for smoothing */
+    /* alpha is the forgetting factor for power estimate of the Anders
+     * Johansson approach, the threshold is in linear power scale, and the
+     * attack and release factors smooth the gain transitions. */
+    struct dsp_gate params;
+    /* Estimated power level and current gain per channel */
+    struct dsp_gate_state state;
+    /* Same, for the streams with too many channels for the DSP kernel */
+    float *pow;
+    float *gain;
 } filter_sys_t;
 
 static float db_to_linear(float db)
@@ -132,6 +136,7 @@ static int Open(vlc_object_t *p_this)
 
     /* Initialize parameters */
     p_sys->channels = p_filter->fmt_in.audio.i_channels;
+    p_sys->pow = p_sys->gain = NULL;
     unsigned int sample_rate = p_filter->fmt_in.audio.i_rate;
     if (sample_rate == 0) 
     {
@@ -141,14 +146,14 @@ static int Open(vlc_object_t *p_this)
     }
     p_sys->thresh = var_InheritFloat(p_filter, "gate-threshold");
     float thresh_lin = db_to_linear(p_sys->thresh); /* Convert parameters to linear scale */
-    p_sys->thresh_linear = thresh_lin * thresh_lin; /*Convert to power domain */
+    p_sys->params.threshold = thresh_lin * thresh_lin; /*Convert to power domain */
     p_sys->attack = var_InheritFloat(p_filter, "gate-attack");
     p_sys->release = var_InheritFloat(p_filter, "gate-release");
     float attack_samples = (sample_rate * p_sys->attack) / 1000;
     float release_samples = (sample_rate * p_sys->release) / 1000;
     /* Calculate smoothing factors */
-    p_sys->attack_factor = attack_samples > 0 ? 1.0f / attack_samples : 1.0f;
-    p_sys->release_factor = release_samples > 0 ? 1.0f / release_samples : 1.0f;
+    p_sys->params.attack = attack_samples > 0 ? 1.0f / attack_samples : 1.0f;
+    p_sys->params.release = release_samples > 0 ? 1.0f / release_samples : 1.0f;
     float smoothing_time = var_InheritFloat(p_filter, "smoothing-time");
     if(smoothing_time <= 0.0f)
     {
@@ -156,21 +161,26 @@ static int Open(vlc_object_t *p_this)
         free(p_sys);
         return VLC_EINVAL;
     }
-    p_sys->alpha = set_alpha(sample_rate,smoothing_time);
-    p_sys->pow = (float*)calloc( p_sys->channels,sizeof(float));
-    p_sys->gain = (float*)calloc(p_sys->channels, sizeof(float));
+    p_sys->params.alpha = set_alpha(sample_rate,smoothing_time);
 
-    if (!p_sys->pow || !p_sys->gain) 
+    float *pow = p_sys->state.power, *gain = p_sys->state.gain;
+    if (p_sys->channels > DSP_CHANNELS_MAX)
     {
-        free(p_sys->pow);
-        free(p_sys->gain);
-        free(p_sys);
-        return VLC_ENOMEM;
+        /* Too many channels for the DSP kernel: use the scalar code */
+        pow = p_sys->pow = calloc(p_sys->channels, sizeof(float));
+        gain = p_sys->gain = calloc(p_sys->channels, sizeof(float));
+        if (!p_sys->pow || !p_sys->gain)
+        {
+            free(p_sys->pow);
+            free(p_sys->gain);
+            free(p_sys);
+            return VLC_ENOMEM;
+        }
     }
     for (int i = 0; i < p_sys->channels; i++) 
     {
-        p_sys->pow[i] = 0.0f;
-        p_sys->gain[i] = 1.0f; /* Start with full gain */
+        pow[i] = 0.0f;
+        gain[i] = 1.0f; /* Start with full gain */
     }
         
     p_filter->fmt_out.audio = p_filter->fmt_in.audio;
@@ -200,6 +210,15 @@ static block_t *Process(filter_t *p_filter, block_t *p_block)
     int i_nb_samples = p_block->i_nb_samples;
     int channels = p_sys->channels;
 
+    if (p_sys->pow == NULL)
+    {
+        dsp_Gate(&p_sys->params, &p_sys->state, p_samples, i_nb_samples,
+                 channels);
+        return p_block;
+    }
+
+    const struct dsp_gate *params = &p_sys->params;
+
     /* iterate over interleaved data */
     for (int ch = 0; ch < channels; ch++) {
         for (int i = ch; i < i_nb_samples * channels; i += channels) {
@@ -207,17 +226,17 @@ static block_t *Process(filter_t *p_filter, block_t *p_block)
             float pow = x * x;
 
             /* Update power estimate with low-pass filter */
-            p_sys->pow[ch] = (1.0f - p_sys->alpha) * p_sys->pow[ch] + pow * p_sys->alpha;
-            
+            p_sys->pow[ch] = (1.0f - params->alpha) * p_sys->pow[ch] + pow * params->alpha;
+
             /* Determine target gain */
-            float target_gain = (p_sys->pow[ch] < p_sys->thresh_linear) ? 0.0f : 1.0f;
-            
+            float target_gain = (p_sys->pow[ch] < params->threshold) ? 0.0f : 1.0f;
+
             /* Calculate gain delta */
             float gain_delta = target_gain - p_sys->gain[ch];
 
             /* Apply smoothing to gain changes */
-            float gain_change_factor = ( gain_delta > 0.0f ) ? 
-                                                p_sys->attack_factor : p_sys->release_factor;
+            float gain_change_factor = ( gain_delta > 0.0f ) ?
+                                                params->attack : params->release;
 
             /* Smoothly adjust gain */
             p_sys->gain[ch] += gain_change_factor * gain_delta;
@@ -37,6 +37,8 @@
 #include <string.h> /* for memset */
 #include <limits.h> /* form INT_MIN */
 
+#include "fft.h"
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -86,7 +88,8 @@ vlc_module_end ()
  *
  * Scaletempo smooths the overlap further by searching within the input buffer
  * for the best overlap position.  Scaletempo uses a statistical cross correlation
- * (roughly a dot-product).  Scaletempo consumes most of its CPU cycles here.
+ * (roughly a dot-product).  Scaletempo consumes most of its CPU cycles here,
+ * so the correlation is computed with FFTs unless the search is short.
  *
  * NOTE:
  * sample: a single audio sample for one channel
@@ -128,6 +131,11 @@ typedef struct
     void     *buf_pre_corr;
     void     *table_window;
     unsigned(*best_overlap_offset)( filter_t *p_filter );
+    /* FFT cross correlation */
+    audio_fft_t *fft;
+    float    *buf_fft;
+    float    *buf_fft_acc;
+    float    *buf_corr;
 #ifdef PITCH_SHIFTER
     /* pitch */
     filter_t * resampler;
@@ -138,21 +146,26 @@ typedef struct
 /*****************************************************************************
  * best_overlap_offset: calculate best offset for overlap
  *****************************************************************************/
+static void window_overlap_float( filter_sys_t *p )
+{
+    const float *restrict pw = p->table_window;
+    const float *restrict po = (const float *)p->buf_overlap + p->samples_per_frame;
+    float *restrict ppc = p->buf_pre_corr;
+    unsigned count = p->samples_overlap - p->samples_per_frame;
+
+    for( unsigned i = 0; i < count; i++ )
+        ppc[i] = pw[i] * po[i];
+}
+
 static unsigned best_overlap_offset_float( filter_t *p_filter )
 {
     filter_sys_t *p = p_filter->p_sys;
-    float *pw, *po, *ppc, *search_start;
+    float *ppc, *search_start;
     float best_corr = INT_MIN;
     unsigned best_off = 0;
     unsigned i, off;
 
-    pw  = p->table_window;
-    po  = p->buf_overlap;
-    po += p->samples_per_frame;
-    ppc = p->buf_pre_corr;
-    for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-      *ppc++ = *pw++ * *po++;
-    }
+    window_overlap_float( p );
 
     search_start = (float *)p->buf_queue + p->samples_per_frame;
     for( off = 0; off < p->frames_search; off++ ) {
@@ -172,6 +185,30 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
     return best_off * p->bytes_per_frame;
 }
 
+static unsigned best_overlap_offset_fft( filter_t *p_filter )
+{
+    filter_sys_t *p = p_filter->p_sys;
+    float best_corr = INT_MIN;
+    unsigned best_off = 0;
+
+    window_overlap_float( p );
+
+    audio_fft_Correlate( p->fft, p->buf_pre_corr,
+                         p->samples_overlap / p->samples_per_frame - 1,
+                         (float *)p->buf_queue + p->samples_per_frame,
+                         p->frames_search, p->samples_per_frame,
+                         p->buf_fft, p->buf_fft_acc, p->buf_corr );
+
+    for( unsigned off = 0; off < p->frames_search; off++ ) {
+      if( p->buf_corr[off] > best_corr ) {
+        best_corr = p->buf_corr[off];
+        best_off  = off;
+      }
+    }
+
+    return best_off * p->bytes_per_frame;
+}
+
 /*****************************************************************************
  * output_overlap: blend end of previous stride with beginning of current stride
  *****************************************************************************/
@@ -180,13 +217,12 @@ static void output_overlap_float( filter_t        *p_filter,
                                   unsigned         bytes_off )
 {
     filter_sys_t *p = p_filter->p_sys;
-    float *pout = buf_out;
-    float *pb   = p->table_blend;
-    float *po   = p->buf_overlap;
-    float *pin  = (float *)( p->buf_queue + bytes_off );
-    unsigned i;
-    for( i = 0; i < p->samples_overlap; i++ ) {
-        *pout++ = *po - *pb++ * ( *po - *pin++ ); po++;
+    float *restrict pout      = buf_out;
+    const float *restrict pb  = p->table_blend;
+    const float *restrict po  = p->buf_overlap;
+    const float *restrict pin = (const float *)( p->buf_queue + bytes_off );
+    for( unsigned i = 0; i < p->samples_overlap; i++ ) {
+        pout[i] = po[i] - pb[i] * ( po[i] - pin[i] );
     }
 }
 
@@ -351,6 +387,28 @@ static int reinit_buffers( filter_t *p_filter )
                 *pw++ = v;
         }
         p->best_overlap_offset = best_overlap_offset_float;
+
+        /* Roughly compare the multiply-adds of the direct search with the
+         * cost of one transform per channel plus the inverse one. */
+        unsigned frames_pre_corr = frames_overlap - 1;
+        unsigned fft_size = audio_fft_SizeFor( p->frames_search + frames_pre_corr - 1 );
+        unsigned fft_log2 = 0;
+        while( ( 1u << fft_log2 ) < fft_size )
+            fft_log2++;
+        uint64_t cost_direct = (uint64_t)p->frames_search * frames_pre_corr
+                             * p->samples_per_frame;
+        uint64_t cost_fft = (uint64_t)( p->samples_per_frame + 1 ) * fft_size
+                          * ( fft_log2 + 3 ) * 2;
+        if( cost_fft < cost_direct )
+        {
+            p->fft         = audio_fft_New( fft_size );
+            p->buf_fft     = vlc_alloc( 2 * fft_size, sizeof (float) );
+            p->buf_fft_acc = vlc_alloc( 2 * fft_size, sizeof (float) );
+            p->buf_corr    = vlc_alloc( p->frames_search, sizeof (float) );
+            if( !p->fft || !p->buf_fft || !p->buf_fft_acc || !p->buf_corr )
+                return VLC_ENOMEM;
+            p->best_overlap_offset = best_overlap_offset_fft;
+        }
     }
 
     unsigned new_size = ( p->frames_search + frames_stride + frames_overlap ) * p->bytes_per_frame;
@@ -380,13 +438,14 @@ static int reinit_buffers( filter_t *p_filter )
     p->frames_stride_scaled = p->bytes_stride_scaled / p->bytes_per_frame;
 
     msg_Dbg( VLC_OBJECT(p_filter),
-             "%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode",
+             "%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search%s, %i queue, %s mode",
              p->scale,
              p->frames_stride_scaled,
              (int)( p->bytes_stride / p->bytes_per_frame ),
              (int)( p->bytes_standing / p->bytes_per_frame ),
              (int)( p->bytes_overlap / p->bytes_per_frame ),
              p->frames_search,
+             p->best_overlap_offset == best_overlap_offset_fft ? " (fft)" : "",
              (int)( p->bytes_queue_max / p->bytes_per_frame ),
              "fl32");
 
@@ -429,6 +488,10 @@ static int Open( vlc_object_t *p_this )
     p_sys->table_blend    = NULL;
     p_sys->buf_pre_corr   = NULL;
     p_sys->table_window   = NULL;
+    p_sys->fft            = NULL;
+    p_sys->buf_fft        = NULL;
+    p_sys->buf_fft_acc    = NULL;
+    p_sys->buf_corr       = NULL;
     p_sys->bytes_overlap  = 0;
     p_sys->bytes_queued   = 0;
     p_sys->bytes_to_slide = 0;
@@ -531,6 +594,11 @@ static void Close( filter_t *p_filter )
     free( p_sys->table_blend );
     free( p_sys->buf_pre_corr );
     free( p_sys->table_window );
+    if( p_sys->fft )
+        audio_fft_Delete( p_sys->fft );
+    free( p_sys->buf_fft );
+    free( p_sys->buf_fft_acc );
+    free( p_sys->buf_corr );
     free( p_sys );
 }
 
@@ -574,7 +642,7 @@ static block_t *DoWork( filter_t * p_filter, block_t * p_in_buf )
                                    p_in_buf->i_buffer, 0 );
     if( i_outsize > 0 )
     {
-        p_out_buf = block_Alloc( i_outsize );
+        p_out_buf = filter_NewAudioBuffer( p_filter, i_outsize );
         if( p_out_buf == NULL )
         {
             block_Release( p_in_buf );
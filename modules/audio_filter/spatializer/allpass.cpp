@@ -5,6 +5,7 @@
 // This code is public domain
 
 #include "allpass.hpp"
+#include "../dsp.h"
 #include <stddef.h>
 
 allpass::allpass(float *buf, int size) :
@@ -26,4 +27,22 @@ void allpass::setfeedback(float val)
     feedback = val;
 }
 
+// Filters in place, split where the delay line wraps
+void allpass::processblock(float *io, int n)
+{
+    while (n > 0)
+    {
+        int len = bufsize - bufidx;
+        if (len > n)
+            len = n;
+
+        dsp_Allpass(buffer + bufidx, io, len, feedback);
+
+        io += len;
+        n -= len;
+        bufidx += len;
+        if (bufidx >= bufsize) bufidx = 0;
+    }
+}
+
 //ends
@@ -6,13 +6,12 @@
 
 #ifndef _allpass_
 #define _allpass_
-#include "denormals.h"
 
 class allpass
 {
 public:
     allpass(float *buf, int size);
-    inline float process(float inp);
+    void   processblock(float *io, int n);
     void   mute();
     void   setfeedback(float val);
 private:
@@ -22,24 +21,6 @@ private:
     int    bufidx;
 };
 
-
-// Big to inline - but crucial for speed
-
-inline float allpass::process(float input)
-{
-    float output;
-    float bufout;
-
-    bufout = undenormalise( buffer[bufidx] );
-
-    output = -input + bufout;
-    buffer[bufidx] = input + (bufout*feedback);
-
-    if(++bufidx>=bufsize) bufidx = 0;
-
-    return output;
-}
-
 #endif//_allpass
 
 //ends
@@ -5,11 +5,11 @@
 // This code is public domain
 
 #include "comb.hpp"
+#include "../dsp.h"
 #include <stddef.h>
 
 comb::comb(float *buf, int size) :
     feedback(0.0f),
-    filterstore(0.0f),
     damp1(0.0f),
     damp2(0.0f),
     buffer(buf),
@@ -35,4 +35,23 @@ void comb::setfeedback(float val)
     feedback = val;
 }
 
+// Accumulates the output of the filter, split where the delay line wraps
+void comb::processblock(const float *input, float *acc, int n)
+{
+    while (n > 0)
+    {
+        int len = bufsize - bufidx;
+        if (len > n)
+            len = n;
+
+        dsp_CombAccumulate(buffer + bufidx, input, acc, len, damp2, feedback);
+
+        input += len;
+        acc += len;
+        n -= len;
+        bufidx += len;
+        if (bufidx >= bufsize) bufidx = 0;
+    }
+}
+
 // ends
@@ -7,8 +7,6 @@
 #ifndef _comb_
 #define _comb_
 
-#include "denormals.h"
-
 /**
 * Combination filter
 *Takes multiple audio channels and mix them for one ear
@@ -17,13 +15,12 @@ class comb
 {
 public:
     comb(float *buf, int size);
-    inline float process(float inp);
+    void   processblock(const float *inp, float *acc, int n);
     void   mute();
     void   setdamp(float val);
     void   setfeedback(float val);
 private:
     float  feedback;
-    float  filterstore;
     float  damp1;
     float  damp2;
     float  *buffer;
@@ -31,27 +28,6 @@ private:
     int    bufidx;
 };
 
-
-// Big to inline - but crucial for speed
-
-inline float comb::process(float input)
-{
-/* FIXME
-* comb::process is not really ear-friendly the tunning values must
-* be changed*/
-    float output;
-
-    output = undenormalise( buffer[bufidx] );
-
-    filterstore = undenormalise(output*damp2);
-
-    buffer[bufidx] = input + filterstore*feedback;
-
-    if(++bufidx>=bufsize) bufidx = 0;
-
-    return output;
-}
-
 #endif //_comb_
 
 //ends
@@ -59,6 +59,50 @@ void revmodel::mute()
     }
 }
 
+// Frames run through the comb and allpass filters at once
+static const int blocksize = 256;
+
+/*****************************************************************************
+ *  Runs a block of frames through the filters
+ * /param float *inputL    input buffer
+ * /param int numsamples   number of frames to be processed, up to blocksize
+ * /param int skip         number of channels in the audio stream
+ * /param float *inputR    right channel of the input
+ * /param float *outL      left output of the filters
+ * /param float *outR      right output of the filters
+ *****************************************************************************/
+void revmodel::processblock(const float *inputL, int numsamples, int skip,
+                            float *inputR, float *outL, float *outR)
+{
+    float input[blocksize];
+    int i;
+
+    for (i = 0; i < numsamples; i++)
+    {
+        /* TODO this module supports only 2 audio channels, let's improve this */
+        if (skip > 1)
+           inputR[i] = inputL[i * skip + 1];
+        else
+           inputR[i] = inputL[i * skip];
+        input[i] = (inputL[i * skip] + inputR[i]) * gain;
+        outL[i] = outR[i] = 0;
+    }
+
+    // Accumulate comb filters in parallel
+    for (i = 0; i < numcombs; i++)
+    {
+        combL[i].processblock(input, outL, numsamples);
+        combR[i].processblock(input, outR, numsamples);
+    }
+
+    // Feed through allpasses in series
+    for (i = 0; i < numallpasses; i++)
+    {
+        allpassL[i].processblock(outL, numsamples);
+        allpassR[i].processblock(outR, numsamples);
+    }
+}
+
 /*****************************************************************************
  *  Transforms the audio stream
  * /param float *inputL     input buffer
@@ -66,70 +110,52 @@ void revmodel::mute()
  * /param long numsamples  number of samples to be processed
  * /param int skip             number of channels in the audio stream
  *****************************************************************************/
-void revmodel::processreplace(float *inputL, float *outputL, long /* numsamples */, int skip)
+void revmodel::processreplace(float *inputL, float *outputL, long numsamples, int skip)
 {
-    float outL,outR,input;
-    float inputR;
-    int i;
+    float inputR[blocksize], outL[blocksize], outR[blocksize];
 
-    outL = outR = 0;
-        /* TODO this module supports only 2 audio channels, let's improve this */
-        if (skip > 1)
-           inputR = inputL[1];
-        else
-           inputR = inputL[0];
-        input = (inputL[0] + inputR) * gain;
+    while (numsamples > 0)
+    {
+        int n = numsamples < blocksize ? numsamples : blocksize;
 
-        // Accumulate comb filters in parallel
-        for(i=0; i<numcombs; i++)
-        {
-            outL += combL[i].process(input);
-            outR += combR[i].process(input);
-        }
+        processblock(inputL, n, skip, inputR, outL, outR);
 
-        // Feed through allpasses in series
-        for(i=0; i<numallpasses; i++)
+        // Calculate output REPLACING anything already there
+        for (int i = 0; i < n; i++)
         {
-            outL = allpassL[i].process(outL);
-            outR = allpassR[i].process(outR);
+            outputL[i * skip] = (outL[i]*wet1 + outR[i]*wet2 + inputR[i]*dry);
+            if (skip > 1)
+                outputL[i * skip + 1] = (outR[i]*wet1 + outL[i]*wet2 + inputR[i]*dry);
         }
 
-        // Calculate output REPLACING anything already there
-        outputL[0] = (outL*wet1 + outR*wet2 + inputR*dry);
-           if (skip > 1)
-        outputL[1] = (outR*wet1 + outL*wet2 + inputR*dry);
+        inputL += n * skip;
+        outputL += n * skip;
+        numsamples -= n;
+    }
 }
 
-void revmodel::processmix(float *inputL, float *outputL, long /* numsamples */, int skip)
+void revmodel::processmix(float *inputL, float *outputL, long numsamples, int skip)
 {
-    float outL,outR,input;
-    float inputR;
+    float inputR[blocksize], outL[blocksize], outR[blocksize];
 
-    outL = outR = 0;
-        if (skip > 1)
-           inputR = inputL[1];
-        else
-           inputR = inputL[0];
-        input = (inputL[0] + inputR) * gain;
+    while (numsamples > 0)
+    {
+        int n = numsamples < blocksize ? numsamples : blocksize;
 
-        // Accumulate comb filters in parallel
-        for(int i=0; i<numcombs; i++)
-        {
-            outL += combL[i].process(input);
-            outR += combR[i].process(input);
-        }
+        processblock(inputL, n, skip, inputR, outL, outR);
 
-        // Feed through allpasses in series
-        for(int i=0; i<numallpasses; i++)
+        // Calculate output MIXING with anything already there
+        for (int i = 0; i < n; i++)
         {
-            outL = allpassL[i].process(outL);
-            outR = allpassR[i].process(outR);
+            outputL[i * skip] += (outL[i]*wet1 + outR[i]*wet2 + inputR[i]*dry);
+            if (skip > 1)
+                outputL[i * skip + 1] += (outR[i]*wet1 + outL[i]*wet2 + inputR[i]*dry);
         }
 
-        // Calculate output REPLACING anything already there
-        outputL[0] += (outL*wet1 + outR*wet2 + inputR*dry);
-           if (skip > 1)
-        outputL[1] += (outR*wet1 + outL*wet2 + inputR*dry);
+        inputL += n * skip;
+        outputL += n * skip;
+        numsamples -= n;
+    }
 }
 
 void revmodel::update()
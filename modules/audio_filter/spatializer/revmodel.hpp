@@ -30,6 +30,8 @@ public:
     void    setmode(float value);
 private:
     void    update();
+    void    processblock(const float *inputL, int numsamples, int skip,
+                         float *inputR, float *outL, float *outR);
 private:
     float   gain;
     float   roomsize,roomsize1;
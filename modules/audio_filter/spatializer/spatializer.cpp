@@ -211,16 +211,16 @@ static void SpatFilter( filter_t *p_filter, float *out, float *in,
     filter_sys_t *p_sys = reinterpret_cast<filter_sys_t *>( p_filter->p_sys );
     vlc_mutex_locker locker( &p_sys->lock );
 
+    float *frame = in;
     for( unsigned i = 0; i < i_samples; i++ )
     {
-        for( unsigned ch = 0 ; ch < 2; ch++)
+        for( unsigned ch = 0 ; ch < 2 && ch < i_channels; ch++)
         {
-            in[ch] = in[ch] * SPAT_AMP;
+            frame[ch] = frame[ch] * SPAT_AMP;
         }
-        p_sys->p_reverbm->processreplace( in, out , 1, i_channels);
-        in  += i_channels;
-        out += i_channels;
+        frame += i_channels;
     }
+    p_sys->p_reverbm->processreplace( in, out, i_samples, i_channels );
 }
 
 static block_t *DoWork( filter_t * p_filter, block_t * p_in_buf )
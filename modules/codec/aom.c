@@ -390,7 +390,7 @@ static int OpenDecoder(vlc_object_t *p_this)
     sys->i_next_frame_priv = 0;
 
     struct aom_codec_dec_cfg deccfg = {
-        .threads = __MIN(vlc_GetCPUCount(), 16),
+        .threads = decoder_RequestThreads(dec, __MIN(vlc_GetCPUCount(), 16)),
         .allow_lowbitdepth = 1
     };
 
@@ -91,7 +91,9 @@ typedef struct
     bool b_show_corrupted;
     bool b_from_preroll;
     bool b_hardware_only;
+    bool b_trick_play;
     enum AVDiscard i_skip_frame;
+    enum AVDiscard i_skip_loop_filter;
 
 #if OPAQUE_REF_ONLY
     uint64_t i_next_sequence_number;
@@ -570,11 +572,13 @@ static int InitVideoDecCommon( decoder_t *p_dec )
 #endif
 
     i_val = var_CreateGetInteger( p_dec, "avcodec-skiploopfilter" );
-    if( i_val >= 4 ) p_context->skip_loop_filter = AVDISCARD_ALL;
-    else if( i_val == 3 ) p_context->skip_loop_filter = AVDISCARD_NONKEY;
-    else if( i_val == 2 ) p_context->skip_loop_filter = AVDISCARD_BIDIR;
-    else if( i_val == 1 ) p_context->skip_loop_filter = AVDISCARD_NONREF;
-    else p_context->skip_loop_filter = AVDISCARD_DEFAULT;
+    if( i_val >= 4 ) p_sys->i_skip_loop_filter = AVDISCARD_ALL;
+    else if( i_val == 3 ) p_sys->i_skip_loop_filter = AVDISCARD_NONKEY;
+    else if( i_val == 2 ) p_sys->i_skip_loop_filter = AVDISCARD_BIDIR;
+    else if( i_val == 1 ) p_sys->i_skip_loop_filter = AVDISCARD_NONREF;
+    else p_sys->i_skip_loop_filter = AVDISCARD_DEFAULT;
+    p_context->skip_loop_filter = p_sys->i_skip_loop_filter;
+    p_sys->b_trick_play = false;
 
     /* ***** libavcodec frame skipping ***** */
     p_sys->b_hurry_up = var_CreateGetBool( p_dec, "avcodec-hurry-up" );
@@ -636,6 +640,9 @@ static int InitVideoDecCommon( decoder_t *p_dec )
         max_thread_count = 6 ;
 # endif
 #endif
+        /* Share the CPUs with the other decoders */
+        i_thread_count = decoder_RequestThreads( p_dec,
+                                __MIN( i_thread_count, max_thread_count ) );
     }
     else
         max_thread_count = p_codec->id == AV_CODEC_ID_HEVC ? 32 : 16;
@@ -1396,7 +1403,18 @@ static int DecodeBlock( decoder_t *p_dec, block_t **pp_block )
             p_block = filter_earlydropped_blocks( p_dec, p_block );
     }
 
-    if( !b_need_output_picture || p_sys->framedrop == FRAMEDROP_NONREF )
+    /* In trick-play, the few frames shown do not need the full quality */
+    if( p_dec->b_trick_play != p_sys->b_trick_play )
+    {
+        p_sys->b_trick_play = p_dec->b_trick_play;
+        p_context->skip_loop_filter = p_sys->b_trick_play
+                                    ? AVDISCARD_ALL : p_sys->i_skip_loop_filter;
+        if( !p_sys->b_trick_play )
+            p_context->skip_frame = p_sys->i_skip_frame;
+    }
+
+    if( !b_need_output_picture || p_sys->framedrop == FRAMEDROP_NONREF
+     || p_sys->b_trick_play )
     {
         p_context->skip_frame = __MAX( p_context->skip_frame, AVDISCARD_NONREF );
     }
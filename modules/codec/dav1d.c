@@ -436,7 +436,8 @@ static int OpenDecoder(vlc_object_t *p_this)
 #if DAV1D_API_VERSION_MAJOR >= 6
     p_sys->s.n_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_threads == 0)
-        p_sys->s.n_threads = __MAX(1, vlc_GetCPUCount());
+        p_sys->s.n_threads = decoder_RequestThreads(dec,
+                                        __MAX(1, vlc_GetCPUCount()));
 
 #if DAV1D_API_VERSION_MAJOR > 6 || DAV1D_API_VERSION_MINOR >= 7
     // after dav1d 1.0.0
@@ -464,7 +465,8 @@ static int OpenDecoder(vlc_object_t *p_this)
         p_sys->s.n_tile_threads = VLC_CLIP(vlc_GetCPUCount(), 1, 4);
     p_sys->s.n_frame_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_frame_threads == 0)
-        p_sys->s.n_frame_threads = __MAX(1, vlc_GetCPUCount());
+        p_sys->s.n_frame_threads = decoder_RequestThreads(dec,
+                                        __MAX(1, vlc_GetCPUCount()));
 #endif
     p_sys->s.all_layers = var_InheritBool( p_this, "dav1d-all-layers" );
     p_sys->s.allocator.cookie = dec;
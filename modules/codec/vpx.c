@@ -340,7 +340,8 @@ static int OpenDecoder(vlc_object_t *p_this)
 
     int i_thread_count = var_InheritInteger(p_this, "vpx-threads");
     if (i_thread_count <= 0)
-        i_thread_count = vlc_GetCPUCount();
+        i_thread_count = decoder_RequestThreads(dec,
+                                        __MIN(vlc_GetCPUCount(), 16));
     struct vpx_codec_dec_cfg deccfg = {
         .threads = __MIN(i_thread_count, 16)
     };
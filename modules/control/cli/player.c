@@ -934,6 +934,14 @@ static int Statistics(struct cli_client *cl, const char *const *args,
                    item->p_stats->i_lost_abuffers);
         cli_printf(cl, "|");
 
+        /* Threaded decoders */
+        cli_printf(cl, "%s", _("+-[Decoding Threads]"));
+        cli_printf(cl, _("| decoding time    : %8"PRId64" ms"),
+                   MS_FROM_VLC_TICK(item->p_stats->i_decoding_time));
+        cli_printf(cl, _("| decoding CPU     : %8"PRId64" ms"),
+                   MS_FROM_VLC_TICK(item->p_stats->i_decoding_cpu));
+        cli_printf(cl, "|");
+
         vlc_mutex_unlock(&item->lock);
         cli_printf(cl,  "+----[ end of statistical info ]" );
     }
@@ -26,6 +26,7 @@
 #include "PlaylistManager.h"
 #include "SegmentTracker.hpp"
 #include "SharedResources.hpp"
+#include "http/SegmentCache.hpp"
 #include "playlist/BasePlaylist.hpp"
 #include "playlist/BasePeriod.h"
 #include "playlist/BaseAdaptationSet.h"
@@ -36,6 +37,7 @@
 #include "logic/AlwaysLowestAdaptationLogic.hpp"
 #include "logic/PredictiveAdaptationLogic.hpp"
 #include "logic/NearOptimalAdaptationLogic.hpp"
+#include "logic/HybridAdaptationLogic.hpp"
 #include "logic/BufferingLogic.hpp"
 #include "tools/Debug.hpp"
 #ifdef ADAPTIVE_DEBUGGING_LOGIC
@@ -44,6 +46,7 @@
 #include <vlc_stream.h>
 #include <vlc_demux.h>
 #include <vlc_threads.h>
+#include <vlc_url.h>
 
 #include <algorithm>
 #include <ctime>
@@ -116,6 +119,10 @@ bool PlaylistManager::setupPeriod()
     if(!bufferingLogic && !(bufferingLogic = createBufferingLogic()))
         return false;
 
+    /* live segments are not replayed */
+    if(resources->getSegmentCache())
+        resources->getSegmentCache()->setSegmentsCacheable(!playlist->isLive());
+
     const std::vector<BaseAdaptationSet*> &sets = currentPeriod->getAdaptationSets();
     for(BaseAdaptationSet *set : sets)
     {
@@ -897,6 +904,20 @@ AbstractAdaptationLogic *PlaylistManager::createLogic(AbstractAdaptationLogic::L
             logic = noplogic;
             break;
         }
+        case AbstractAdaptationLogic::LogicType::Hybrid:
+        {
+            std::string host;
+            vlc_url_t url;
+            if(vlc_UrlParse(&url, p_demux->psz_url) == VLC_SUCCESS && url.psz_host)
+                host = url.psz_host;
+            vlc_UrlClean(&url);
+            HybridAdaptationLogic *hybridlogic =
+                    new (std::nothrow) HybridAdaptationLogic(obj, host);
+            if(hybridlogic)
+                conn->setDownloadRateObserver(hybridlogic);
+            logic = hybridlogic;
+            break;
+        }
         case AbstractAdaptationLogic::LogicType::Predictive:
         {
             AbstractAdaptationLogic *predictivelogic =
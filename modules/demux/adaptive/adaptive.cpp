@@ -35,6 +35,7 @@
 #include "SharedResources.hpp"
 #include "logic/BufferingLogic.hpp"
 #include "xml/DOMParser.h"
+#include "xml/Node.h"
 
 #include "../dash/DASHManager.h"
 #include "../dash/DASHStream.hpp"
@@ -84,10 +85,17 @@ static void Close   (vlc_object_t *);
 #define ADAPT_LOWLATENCY_TEXT N_("Low latency")
 #define ADAPT_LOWLATENCY_LONGTEXT N_("Overrides low latency parameters")
 
+#define ADAPT_CACHE_TEXT N_("Segment cache size (MiB)")
+#define ADAPT_CACHE_LONGTEXT N_("Memory used to keep on demand segments for seeking back or replaying")
+
+#define ADAPT_DISKCACHE_TEXT N_("Segment disk cache size (MiB)")
+#define ADAPT_DISKCACHE_LONGTEXT N_("Disk space used to keep segments between sessions. 0 disables it.")
+
 static const AbstractAdaptationLogic::LogicType pi_logics[] = {
                                 AbstractAdaptationLogic::LogicType::Default,
                                 AbstractAdaptationLogic::LogicType::Predictive,
                                 AbstractAdaptationLogic::LogicType::NearOptimal,
+                                AbstractAdaptationLogic::LogicType::Hybrid,
                                 AbstractAdaptationLogic::LogicType::RateBased,
                                 AbstractAdaptationLogic::LogicType::FixedRate,
                                 AbstractAdaptationLogic::LogicType::AlwaysLowest,
@@ -97,6 +105,7 @@ static const char *const ppsz_logics_values[] = {
                                 "",
                                 "predictive",
                                 "nearoptimal",
+                                "hybrid",
                                 "rate",
                                 "fixedrate",
                                 "lowest",
@@ -105,6 +114,7 @@ static const char *const ppsz_logics_values[] = {
 static const char *const ppsz_logics[] = { N_("Default"),
                                            N_("Predictive"),
                                            N_("Near Optimal"),
+                                           N_("Hybrid Throughput/Buffer"),
                                            N_("Bandwidth Adaptive"),
                                            N_("Fixed Bandwidth"),
                                            N_("Lowest Bandwidth/Quality"),
@@ -143,6 +153,10 @@ vlc_module_begin ()
                      ADAPT_MAXBUFFER_TEXT, nullptr )
         add_integer( "adaptive-lowlatency", -1, ADAPT_LOWLATENCY_TEXT, ADAPT_LOWLATENCY_LONGTEXT )
             change_integer_list(rgi_latency, ppsz_latency)
+        add_integer( "adaptive-cache-size", 32, ADAPT_CACHE_TEXT, ADAPT_CACHE_LONGTEXT )
+            change_integer_range( 0, 4096 )
+        add_integer( "adaptive-disk-cache", 0, ADAPT_DISKCACHE_TEXT, ADAPT_DISKCACHE_LONGTEXT )
+            change_integer_range( 0, 65536 )
         set_callbacks( Open, Close )
 vlc_module_end ()
 
@@ -282,13 +296,25 @@ static PlaylistManager * HandleDash(demux_t *p_demux, DOMParser &xmlParser,
                                     const std::string & playlisturl,
                                     AbstractAdaptationLogic::LogicType logic)
 {
-    if(!xmlParser.reset(p_demux->s) || !xmlParser.parse(true))
+    /* Patches need the whole document, timelines included. The
+     * PatchLocation comes before the Periods, so the head is enough */
+    const uint8_t *p_peek;
+    const ssize_t i_peek = vlc_stream_Peek(p_demux->s, &p_peek, 65536);
+    const bool b_patchable = i_peek > 0 && DASHManager::isPatchable(p_peek, i_peek);
+
+    TimelineCollector timelines;
+    if(!b_patchable)
+        timelines.attach(xmlParser);
+    bool b_parsed = xmlParser.reset(p_demux->s) && xmlParser.parse(true);
+    xmlParser.setElementHandler("S", nullptr);
+    if(!b_parsed)
     {
         msg_Err(p_demux, "Cannot parse MPD");
         return nullptr;
     }
     IsoffMainParser mpdparser(xmlParser.getRootNode(), VLC_OBJECT(p_demux),
-                              p_demux->s, playlisturl);
+                              p_demux->s, playlisturl,
+                              b_patchable ? nullptr : &timelines);
     MPD *p_playlist = mpdparser.parse();
     if(p_playlist == nullptr)
     {
@@ -296,17 +322,22 @@ static PlaylistManager * HandleDash(demux_t *p_demux, DOMParser &xmlParser,
         return nullptr;
     }
 
+    /* The first update can then be a patch */
+    Node *root = b_patchable ? xmlParser.releaseRootNode() : nullptr;
+
     SharedResources *resources =
             SharedResources::createDefault(VLC_OBJECT(p_demux), playlisturl);
     DASHStreamFactory *factory = new (std::nothrow) DASHStreamFactory;
     DASHManager *manager = nullptr;
     if(!resources || !factory ||
        !(manager = new (std::nothrow) DASHManager(p_demux, resources,
-                                                  p_playlist, factory, logic)))
+                                                  p_playlist, factory, logic,
+                                                  root)))
     {
         delete resources;
         delete factory;
         delete p_playlist;
+        delete root;
     }
     return manager;
 }
@@ -29,11 +29,14 @@
 #include "HTTPConnection.hpp"
 #include "HTTPConnectionManager.h"
 #include "Downloader.hpp"
+#include "../encryption/CommonEncryption.hpp"
 
 #include <vlc_common.h>
 #include <vlc_block.h>
 
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 
 using namespace adaptive::http;
 using vlc::threads::mutex_locker;
@@ -65,6 +68,11 @@ const std::string & AbstractChunkSource::getContentType() const
     return EmptyStr;
 }
 
+bool AbstractChunkSource::setEncryptionSession(CommonEncryptionSession *)
+{
+    return false;
+}
+
 RequestStatus AbstractChunkSource::getRequestStatus() const
 {
     return requeststatus;
@@ -248,7 +256,7 @@ block_t * HTTPChunkSource::read(size_t readsize)
             connManager->updateDownloadRate(sourceid,
                                             connection->getBytesRead(),
                                             downloadEndTime - requestStartTime,
-                                            downloadEndTime - responseTime);
+                                            responseTime - requestStartTime);
         }
     }
 
@@ -338,7 +346,9 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, Abstrac
     HTTPChunkSource(url, manager, sourceid, type, range, access),
     p_head     (nullptr),
     pp_tail    (&p_head),
-    buffered     (0)
+    buffered     (0),
+    downloaded   (0),
+    encryptionSession(nullptr)
 {
     done = false;
     eof = false;
@@ -365,6 +375,48 @@ HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
         pp_tail = &p_head;
     }
     buffered = 0;
+    delete encryptionSession;
+}
+
+bool HTTPChunkBufferedSource::setEncryptionSession(CommonEncryptionSession *session)
+{
+    assert(!encryptionSession);
+    encryptionSession = session;
+    return true;
+}
+
+block_t * HTTPChunkBufferedSource::decrypt(block_t *p_block, bool b_last)
+{
+    /* CBC works on whole cipher blocks, and the padding can only be
+     * removed from the last one: hold back the tail until the end */
+    if(p_block)
+    {
+        pending.insert(pending.end(), p_block->p_buffer,
+                       p_block->p_buffer + p_block->i_buffer);
+        block_Release(p_block);
+    }
+
+    size_t size = pending.size();
+    if(!b_last)
+        size = (size > 16) ? (size - 1) & ~(size_t)15 : 0;
+    if(size == 0)
+        return nullptr;
+
+    block_t *p_out = block_Alloc(size);
+    if(p_out)
+    {
+        memcpy(p_out->p_buffer, pending.data(), size);
+        p_out->i_buffer = encryptionSession->decrypt(p_out->p_buffer, size, b_last);
+        if(p_out->i_buffer == 0)
+        {
+            block_Release(p_out);
+            p_out = nullptr;
+        }
+    }
+    pending.erase(pending.begin(), pending.begin() + size);
+    if(b_last)
+        encryptionSession->close();
+    return p_out;
 }
 
 bool HTTPChunkBufferedSource::isDone() const
@@ -373,6 +425,13 @@ bool HTTPChunkBufferedSource::isDone() const
     return done;
 }
 
+bool HTTPChunkBufferedSource::isComplete() const
+{
+    mutex_locker locker {lock};
+    return done && requeststatus == RequestStatus::Success &&
+           contentLength && downloaded == contentLength;
+}
+
 void HTTPChunkBufferedSource::hold()
 {
     mutex_locker locker {lock};
@@ -401,8 +460,8 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         if(readsize < HTTPChunkSource::CHUNK_SIZE)
             readsize = HTTPChunkSource::CHUNK_SIZE;
 
-        if(contentLength && readsize > contentLength - buffered)
-            readsize = contentLength - buffered;
+        if(contentLength && readsize > contentLength - downloaded)
+            readsize = contentLength - downloaded;
     }
 
     block_t *p_block = block_Alloc(readsize);
@@ -420,34 +479,37 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
     } rate = {0,0,0};
 
     ssize_t ret = connection->read(p_block->p_buffer, readsize);
+    const bool b_last = (ret <= 0 || (size_t) ret < readsize);
     if(ret <= 0)
     {
         block_Release(p_block);
         p_block = nullptr;
-        mutex_locker locker {lock};
-        done = true;
-        downloadEndTime = vlc_tick_now();
-        rate.size = buffered;
-        rate.time = downloadEndTime - requestStartTime;
-        rate.latency = responseTime - requestStartTime;
-        avail.signal();
     }
-    else
+    else p_block->i_buffer = (size_t) ret;
+
+    /* decrypt on the downloader thread, as the data arrives */
+    if(encryptionSession)
+        p_block = decrypt(p_block, b_last);
+
     {
-        p_block->i_buffer = (size_t) ret;
         mutex_locker locker {lock};
-        buffered += p_block->i_buffer;
-        block_ChainLastAppend(&pp_tail, p_block);
-        if(p_read == nullptr)
+        if(ret > 0)
+            downloaded += ret;
+        if(p_block)
         {
-            p_read = p_block;
-            inblockreadoffset = 0;
+            buffered += p_block->i_buffer;
+            block_ChainLastAppend(&pp_tail, p_block);
+            if(p_read == nullptr)
+            {
+                p_read = p_block;
+                inblockreadoffset = 0;
+            }
         }
-        if((size_t) ret < readsize)
+        if(b_last)
         {
             done = true;
             downloadEndTime = vlc_tick_now();
-            rate.size = buffered;
+            rate.size = downloaded;
             rate.time = downloadEndTime - requestStartTime;
             rate.latency = responseTime - requestStartTime;
         }
@@ -469,10 +531,6 @@ bool HTTPChunkBufferedSource::hasMoreData() const
 
 void HTTPChunkBufferedSource::recycle()
 {
-    p_read = p_head;
-    inblockreadoffset = 0;
-    consumed = 0;
-    contentLength = buffered;
     connManager->recycleSource(this);
 }
 
@@ -542,6 +600,65 @@ block_t * HTTPChunkBufferedSource::read(size_t readsize)
     return p_block;
 }
 
+CachedChunkSource::CachedChunkSource(block_t *p_block, const std::string &type_,
+                                     const StorageID &id, ChunkType t,
+                                     const BytesRange &range)
+    : AbstractChunkSource(t, range)
+    , p_data( p_block )
+    , consumed( 0 )
+    , contentType( type_ )
+{
+    storeid = id;
+    requeststatus = RequestStatus::Success;
+    contentLength = p_block->i_buffer;
+}
+
+CachedChunkSource::~CachedChunkSource()
+{
+    block_Release(p_data);
+}
+
+block_t * CachedChunkSource::readBlock()
+{
+    return read(HTTPChunkSource::CHUNK_SIZE);
+}
+
+block_t * CachedChunkSource::read(size_t readsize)
+{
+    if(readsize > p_data->i_buffer - consumed)
+        readsize = p_data->i_buffer - consumed;
+    if(readsize == 0)
+        return nullptr;
+
+    block_t *p_block = block_Alloc(readsize);
+    if(p_block)
+    {
+        memcpy(p_block->p_buffer, &p_data->p_buffer[consumed], readsize);
+        consumed += readsize;
+    }
+    return p_block;
+}
+
+bool CachedChunkSource::hasMoreData() const
+{
+    return consumed < p_data->i_buffer;
+}
+
+size_t CachedChunkSource::getBytesRead() const
+{
+    return consumed;
+}
+
+const std::string & CachedChunkSource::getContentType() const
+{
+    return contentType;
+}
+
+void CachedChunkSource::recycle()
+{
+    delete this;
+}
+
 HTTPChunk::HTTPChunk(const std::string &url, AbstractConnectionManager *manager,
                      const adaptive::ID &id, ChunkType type, const BytesRange &range):
     AbstractChunk(manager->makeSource(url, id, type, range))
@@ -27,6 +27,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "BytesRange.hpp"
 #include "ConnectionParams.hpp"
@@ -39,8 +40,15 @@ typedef struct vlc_frame_t block_t;
 
 namespace adaptive
 {
+    namespace encryption
+    {
+        class CommonEncryptionSession;
+    }
+
     namespace http
     {
+        using encryption::CommonEncryptionSession;
+
         class AbstractConnection;
         class AbstractConnectionManager;
         class AbstractChunk;
@@ -82,6 +90,8 @@ namespace adaptive
                 const std::string & getContentType  () const override;
                 RequestStatus getRequestStatus() const override;
                 virtual void        recycle() = 0;
+                /* takes ownership when decrypting at download time */
+                virtual bool        setEncryptionSession(CommonEncryptionSession *);
 
             protected:
                 AbstractChunkSource(ChunkType, const BytesRange & = BytesRange());
@@ -171,6 +181,7 @@ namespace adaptive
                 block_t *  read            (size_t)  override;
                 bool       hasMoreData     () const  override;
                 void        recycle() override;
+                bool        setEncryptionSession(CommonEncryptionSession *) override;
 
             protected:
                 HTTPChunkBufferedSource(const std::string &url, AbstractConnectionManager *,
@@ -178,8 +189,10 @@ namespace adaptive
                                         bool = false);
                 void               bufferize(size_t);
                 bool               isDone() const;
+                bool               isComplete() const;
                 void               hold();
                 void               release();
+                block_t *          decrypt(block_t *, bool);
 
             private:
                 block_t            *p_head; /* read cache buffer */
@@ -187,12 +200,39 @@ namespace adaptive
                 const block_t      *p_read;
                 size_t              inblockreadoffset;
                 size_t              buffered; /* read cache size */
+                size_t              downloaded;
+                CommonEncryptionSession *encryptionSession;
+                std::vector<uint8_t> pending; /* not yet decrypted */
                 bool                done;
                 bool                eof;
                 vlc::threads::condition_variable avail;
                 bool                held;
         };
 
+        /* Serves a transfer from the segment cache */
+        class CachedChunkSource : public AbstractChunkSource
+        {
+            friend class HTTPConnectionManager;
+
+            public:
+                virtual ~CachedChunkSource();
+                block_t *   readBlock       ()  override;
+                block_t *   read            (size_t)  override;
+                bool        hasMoreData     () const  override;
+                size_t      getBytesRead    () const  override;
+                const std::string & getContentType() const override;
+                void        recycle() override;
+
+            protected:
+                CachedChunkSource(block_t *, const std::string &, const StorageID &,
+                                  ChunkType, const BytesRange &);
+
+            private:
+                block_t            *p_data;
+                size_t              consumed;
+                std::string         contentType;
+        };
+
         class HTTPChunk : public AbstractChunk
         {
             public:
@@ -29,11 +29,11 @@
 #include "HTTPConnection.hpp"
 #include "ConnectionParams.hpp"
 #include "Downloader.hpp"
+#include "SegmentCache.hpp"
 #include "../tools/Debug.hpp"
 #include <vlc_url.h>
 #include <vlc_http.h>
 
-#include <cassert>
 
 using namespace adaptive::http;
 
@@ -74,28 +74,24 @@ void AbstractConnectionManager::deleteSource(AbstractChunkSource *source)
 
 HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
     : AbstractConnectionManager( p_object_ ),
-      localAllowed(false)
+      localAllowed(false),
+      segmentCache(nullptr)
 {
     vlc_mutex_init(&lock);
     downloader = new Downloader();
     downloaderhp = new Downloader();
     downloader->start();
     downloaderhp->start();
-    cache_total = 0;
-    cache_max = 1 << 19;
 }
 
 HTTPConnectionManager::~HTTPConnectionManager   ()
 {
-    while(!cache.empty())
+    if(segmentCache)
     {
-        HTTPChunkBufferedSource *purged = cache.back();
-        cache.pop_back();
-        assert(cache_total >= purged->contentLength);
-        cache_total -= purged->contentLength;
-        CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
-                            purged->getStorageID().c_str(), cache_total));
-        deleteSource(purged);
+        SegmentCache::Stats stats = segmentCache->getStats();
+        msg_Dbg(p_object, "segment cache %u hits %u misses, usage %zu bytes"
+                          " memory %zu bytes disk", stats.hits, stats.misses,
+                stats.memusage, stats.diskusage);
     }
     delete downloader;
     delete downloaderhp;
@@ -172,70 +168,26 @@ AbstractChunkSource *HTTPConnectionManager::makeSource(const std::string &url,
                                                        const ID &id, ChunkType type,
                                                        const BytesRange &range)
 {
-    StorageID storageid = HTTPChunkSource::makeStorageID(url, range);
-    switch(type)
+    if(segmentCache && segmentCache->isCacheable(type))
     {
-        case ChunkType::Init:
-        case ChunkType::Index:
-            for(HTTPChunkBufferedSource *s : cache)
-            {
-                if(s->getStorageID() == storageid)
-                {
-                    cache.remove(s);
-                    assert(cache_total >= s->contentLength);
-                    cache_total -= s->contentLength;
-                    CacheDebug(msg_Dbg(p_object, "Cache GET '%s' usage %zu bytes",
-                                       storageid.c_str(), cache_total));
-                    return s;
-                }
-            }
-            // fallthrough
-        case ChunkType::Segment:
-        case ChunkType::Key:
-        case ChunkType::Playlist:
-        default:
-            return new HTTPChunkBufferedSource(url, this, id, type, range);
+        StorageID storageid = HTTPChunkSource::makeStorageID(url, range);
+        std::string contenttype;
+        block_t *p_data = segmentCache->get(storageid, &contenttype);
+        if(p_data)
+            return new CachedChunkSource(p_data, contenttype, storageid, type, range);
     }
+    return new HTTPChunkBufferedSource(url, this, id, type, range);
 }
 
 void HTTPConnectionManager::recycleSource(AbstractChunkSource *source)
 {
-    bool b_cacheable;
-    switch(source->getChunkType())
-    {
-        case ChunkType::Index:
-        case ChunkType::Init:
-            b_cacheable = true;
-            break;
-        case ChunkType::Key:
-        case ChunkType::Playlist:
-        case ChunkType::Segment:
-        default:
-            b_cacheable = false;
-            break;
-    }
-
     HTTPChunkBufferedSource *buf = dynamic_cast<HTTPChunkBufferedSource *>(source);
-    if(buf && b_cacheable && !buf->getStorageID().empty() &&
-       buf->contentLength && buf->contentLength < cache_max)
+    if(buf && segmentCache && segmentCache->isCacheable(buf->getChunkType()) &&
+       !buf->getStorageID().empty() && !buf->encryptionSession && buf->isComplete())
     {
-        while(cache_max < cache_total + buf->contentLength)
-        {
-            HTTPChunkBufferedSource *purged = cache.back();
-            cache.pop_back();
-            assert(cache_total >= purged->contentLength);
-            cache_total -= purged->contentLength;
-            CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
-                               purged->getStorageID().c_str(), cache_total));
-            deleteSource(purged);
-        }
-        cache.push_front(buf);
-        cache_total += buf->contentLength;
-        CacheDebug(msg_Dbg(p_object, "Cache PUT '%s' usage %zu bytes",
-                           buf->getStorageID().c_str(), cache_total));
+        segmentCache->put(buf->getStorageID(), buf->p_head, buf->getContentType());
     }
-    else
-        deleteSource(source);
+    deleteSource(source);
 }
 
 Downloader * HTTPConnectionManager::getDownloadQueue(const AbstractChunkSource *source) const
@@ -276,3 +228,8 @@ void HTTPConnectionManager::addFactory(AbstractConnectionFactory *factory)
 {
     factories.push_back(factory);
 }
+
+void HTTPConnectionManager::setSegmentCache(SegmentCache *cache)
+{
+    segmentCache = cache;
+}
@@ -45,6 +45,7 @@ namespace adaptive
         class Downloader;
         class AbstractChunkSource;
         class HTTPChunkBufferedSource;
+        class SegmentCache;
         enum class ChunkType;
 
         class AbstractConnectionManager : public IDownloadRateObserver
@@ -94,6 +95,7 @@ namespace adaptive
                 void cancel(AbstractChunkSource *)  override;
                 void         setLocalConnectionsAllowed();
                 void         addFactory(AbstractConnectionFactory *);
+                void         setSegmentCache(SegmentCache *);
 
             private:
                 void    releaseAllConnections ();
@@ -105,9 +107,7 @@ namespace adaptive
                 bool                                                localAllowed;
                 AbstractConnection * reuseConnection(ConnectionParams &);
                 Downloader * getDownloadQueue(const AbstractChunkSource *) const;
-                std::list<HTTPChunkBufferedSource *> cache;
-                size_t cache_total;
-                size_t cache_max;
+                SegmentCache                                       *segmentCache;
         };
     }
 }
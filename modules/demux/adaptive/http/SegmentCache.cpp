@@ -0,0 +1,428 @@
+/*
+ * SegmentCache.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "SegmentCache.hpp"
+#include "../tools/Debug.hpp"
+
+#include <vlc_block.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_strings.h>
+#include <vlc_configuration.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <vector>
+#include <sys/stat.h>
+
+using namespace adaptive::http;
+
+/* On disk entries are: magic, storage id, content type, each
+ * newline terminated, then the payload */
+#define DISK_MAGIC "VLC adaptive cache 1\n"
+
+SegmentCache::SegmentCache(vlc_object_t *obj_, size_t memmax_,
+                           size_t diskmax_, const std::string &dir_)
+    : obj( obj_ )
+    , memusage( 0 )
+    , memmax( memmax_ )
+    , diskusage( 0 )
+    , diskmax( diskmax_ )
+    , diskserial( 0 )
+    , dir( dir_ )
+    , segmentsCacheable( false )
+    , hits( 0 )
+    , misses( 0 )
+{
+    if(diskmax == 0)
+        dir.clear();
+    if(!dir.empty())
+        loadDiskIndex();
+}
+
+SegmentCache::~SegmentCache()
+{
+    for(Entry &e : memlru)
+        block_Release(e.data);
+}
+
+SegmentCache * SegmentCache::createDefault(vlc_object_t *obj)
+{
+    size_t memmax = (size_t) var_InheritInteger(obj, "adaptive-cache-size") << 20;
+    size_t diskmax = (size_t) var_InheritInteger(obj, "adaptive-disk-cache") << 20;
+    std::string dir;
+    if(diskmax)
+    {
+        char *psz_cachedir = config_GetUserDir(VLC_CACHE_DIR);
+        if(psz_cachedir)
+        {
+            dir = std::string(psz_cachedir) + DIR_SEP "adaptive";
+            free(psz_cachedir);
+        }
+    }
+    return new SegmentCache(obj, memmax, diskmax, dir);
+}
+
+bool SegmentCache::isCacheable(ChunkType type) const
+{
+    switch(type)
+    {
+        case ChunkType::Init:
+        case ChunkType::Index:
+            return true;
+        case ChunkType::Segment:
+        {
+            vlc::threads::mutex_locker locker {lock};
+            return segmentsCacheable;
+        }
+        case ChunkType::Key:
+        case ChunkType::Playlist:
+        default:
+            return false;
+    }
+}
+
+void SegmentCache::setSegmentsCacheable(bool b)
+{
+    vlc::threads::mutex_locker locker {lock};
+    segmentsCacheable = b;
+}
+
+SegmentCache::Stats SegmentCache::getStats() const
+{
+    vlc::threads::mutex_locker locker {lock};
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.memusage = memusage;
+    stats.diskusage = diskusage;
+    return stats;
+}
+
+block_t * SegmentCache::get(const StorageID &id, std::string *contenttype)
+{
+    lock.lock();
+
+    auto it = memindex.find(id);
+    if(it != memindex.end())
+    {
+        memlru.splice(memlru.begin(), memlru, it->second);
+        hits++;
+        CacheDebug(msg_Dbg(obj, "Cache GET '%s' usage %zu bytes",
+                           id.c_str(), memusage));
+        *contenttype = it->second->contenttype;
+        block_t *p_block = block_Duplicate(it->second->data);
+        lock.unlock();
+        return p_block;
+    }
+
+    if(!dir.empty())
+    {
+        /* look the entry up, then read it unlocked */
+        const std::string name = diskName(id);
+        auto dit = diskindex.find(name);
+        if(dit != diskindex.end() && !dit->second->pending)
+        {
+            disklru.splice(disklru.begin(), disklru, dit->second);
+            const DiskEntry entry = *dit->second;
+
+            lock.unlock();
+            block_t *p_block = readDisk(diskPath(name), id, entry.size, contenttype);
+            lock.lock();
+
+            if(p_block)
+            {
+                hits++;
+                CacheDebug(msg_Dbg(obj, "Cache GET '%s' from disk", id.c_str()));
+                block_t *p_copy = memindex.find(id) == memindex.end()
+                                ? block_Duplicate(p_block) : nullptr;
+                if(p_copy)
+                    putMemory(id, p_copy, *contenttype);
+                lock.unlock();
+                return p_block;
+            }
+
+            /* evicted by another instance */
+            dit = diskindex.find(name);
+            if(dit != diskindex.end() && dit->second->serial == entry.serial)
+            {
+                diskusage -= dit->second->size;
+                disklru.erase(dit->second);
+                diskindex.erase(dit);
+            }
+        }
+    }
+
+    misses++;
+    lock.unlock();
+    return nullptr;
+}
+
+void SegmentCache::put(const StorageID &id, const block_t *p_chain,
+                       const std::string &contenttype)
+{
+    size_t size;
+    block_ChainProperties(p_chain, nullptr, &size, nullptr);
+    if(size == 0 || (size > memmax && size > diskmax))
+        return;
+
+    block_t *p_block = nullptr;
+    if(size <= memmax)
+    {
+        p_block = block_Alloc(size);
+        if(!p_block)
+            return;
+        size_t offset = 0;
+        for(const block_t *b = p_chain; b; b = b->p_next)
+        {
+            memcpy(&p_block->p_buffer[offset], b->p_buffer, b->i_buffer);
+            offset += b->i_buffer;
+        }
+    }
+
+    const std::string name = dir.empty() ? std::string() : diskName(id);
+    const std::string header = DISK_MAGIC + id + '\n' + contenttype + '\n';
+    const size_t disksize = header.size() + size;
+
+    lock.lock();
+    if(memindex.find(id) != memindex.end())
+    {
+        lock.unlock();
+        if(p_block)
+            block_Release(p_block);
+        return;
+    }
+
+    if(p_block)
+        putMemory(id, p_block, contenttype);
+
+    if(dir.empty() || disksize > diskmax ||
+       diskindex.find(name) != diskindex.end())
+    {
+        lock.unlock();
+        return;
+    }
+
+    /* reserve the disk entry, then write it unlocked */
+    std::vector<std::string> unlinks;
+    evictDisk(disksize, &unlinks);
+    const uint64_t serial = ++diskserial;
+    disklru.push_front(DiskEntry{name, disksize, serial, true});
+    diskindex[name] = disklru.begin();
+    diskusage += disksize;
+    lock.unlock();
+
+    for(const std::string &path : unlinks)
+        vlc_unlink(path.c_str());
+    const bool b_ok = writeDisk(diskPath(name), header, p_chain);
+
+    vlc::threads::mutex_locker locker {lock};
+    auto it = diskindex.find(name);
+    if(it == diskindex.end() || it->second->serial != serial)
+        return; /* evicted meanwhile */
+    if(b_ok)
+    {
+        it->second->pending = false;
+        return;
+    }
+    diskusage -= it->second->size;
+    disklru.erase(it->second);
+    diskindex.erase(it);
+}
+
+void SegmentCache::putMemory(const StorageID &id, block_t *p_block,
+                             const std::string &contenttype)
+{
+    if(p_block->i_buffer > memmax)
+    {
+        block_Release(p_block);
+        return;
+    }
+    evictMemory(p_block->i_buffer);
+    memlru.push_front(Entry{id, contenttype, p_block});
+    memindex[id] = memlru.begin();
+    memusage += p_block->i_buffer;
+    CacheDebug(msg_Dbg(obj, "Cache PUT '%s' usage %zu bytes",
+                       id.c_str(), memusage));
+}
+
+void SegmentCache::evictMemory(size_t needed)
+{
+    while(!memlru.empty() && memusage + needed > memmax)
+    {
+        Entry &e = memlru.back();
+        memusage -= e.data->i_buffer;
+        CacheDebug(msg_Dbg(obj, "Cache DEL '%s' usage %zu bytes",
+                           e.id.c_str(), memusage));
+        block_Release(e.data);
+        memindex.erase(e.id);
+        memlru.pop_back();
+    }
+}
+
+std::string SegmentCache::diskName(const StorageID &id) const
+{
+    vlc_hash_md5_t md5;
+    vlc_hash_md5_Init(&md5);
+    vlc_hash_md5_Update(&md5, id.c_str(), id.size());
+    char digest[VLC_HASH_MD5_DIGEST_SIZE];
+    vlc_hash_md5_Finish(&md5, digest, sizeof(digest));
+    char hex[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hex_encode_binary(digest, sizeof(digest), hex);
+    return std::string(hex);
+}
+
+std::string SegmentCache::diskPath(const std::string &name) const
+{
+    return dir + DIR_SEP + name;
+}
+
+void SegmentCache::loadDiskIndex()
+{
+    if(vlc_mkdir_parent(dir.c_str(), 0700) != 0 && errno != EEXIST)
+    {
+        msg_Warn(obj, "cannot create segment cache directory %s", dir.c_str());
+        dir.clear();
+        return;
+    }
+
+    vlc_DIR *p_dir = vlc_opendir(dir.c_str());
+    if(!p_dir)
+    {
+        dir.clear();
+        return;
+    }
+
+    struct Found
+    {
+        time_t mtime;
+        DiskEntry entry;
+    };
+    std::vector<Found> found;
+    const char *psz_name;
+    while((psz_name = vlc_readdir(p_dir)) != nullptr)
+    {
+        const std::string name(psz_name);
+        if(name[0] == '.')
+            continue;
+        const std::string path = diskPath(name);
+        if(name.size() != VLC_HASH_MD5_DIGEST_HEX_SIZE - 1 ||
+           name.find_first_not_of("0123456789abcdef") != std::string::npos)
+        {
+            /* interrupted writes */
+            if(name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0)
+                vlc_unlink(path.c_str());
+            continue;
+        }
+        struct stat st;
+        if(vlc_stat(path.c_str(), &st) == 0)
+            found.push_back(Found{st.st_mtime, DiskEntry{name, (size_t) st.st_size, 0, false}});
+    }
+    vlc_closedir(p_dir);
+
+    std::sort(found.begin(), found.end(),
+              [](const Found &a, const Found &b) { return a.mtime > b.mtime; });
+    for(const Found &f : found)
+    {
+        disklru.push_back(f.entry);
+        disklru.back().serial = ++diskserial;
+        diskindex[f.entry.name] = std::prev(disklru.end());
+        diskusage += f.entry.size;
+    }
+    evictDisk(0, nullptr);
+}
+
+block_t * SegmentCache::readDisk(const std::string &path, const StorageID &id,
+                                 size_t filesize, std::string *contenttype)
+{
+    FILE *fp = vlc_fopen(path.c_str(), "rb");
+    if(!fp)
+        return nullptr;
+
+    block_t *p_block = nullptr;
+    std::string header[3];
+    for(std::string &line : header)
+    {
+        int c;
+        while((c = fgetc(fp)) != EOF && c != '\n' && line.size() < 4096)
+            line.push_back(c);
+    }
+    if(header[0] + "\n" == DISK_MAGIC && header[1] == id)
+    {
+        const long start = ftell(fp);
+        if(start >= 0 && (size_t) start < filesize)
+        {
+            const size_t size = filesize - start;
+            p_block = block_Alloc(size);
+            if(p_block && fread(p_block->p_buffer, 1, size, fp) != size)
+            {
+                block_Release(p_block);
+                p_block = nullptr;
+            }
+        }
+    }
+    fclose(fp);
+
+    if(p_block)
+        *contenttype = header[2];
+    return p_block;
+}
+
+bool SegmentCache::writeDisk(const std::string &path, const std::string &header,
+                             const block_t *p_chain)
+{
+    const std::string tmppath = path + ".tmp";
+    FILE *fp = vlc_fopen(tmppath.c_str(), "wb");
+    if(!fp)
+        return false;
+    bool b_ok = fwrite(header.c_str(), 1, header.size(), fp) == header.size();
+    for(const block_t *b = p_chain; b_ok && b; b = b->p_next)
+        b_ok = fwrite(b->p_buffer, 1, b->i_buffer, fp) == b->i_buffer;
+    b_ok = (fclose(fp) == 0) && b_ok;
+    if(!b_ok || vlc_rename(tmppath.c_str(), path.c_str()) != 0)
+    {
+        vlc_unlink(tmppath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void SegmentCache::evictDisk(size_t needed, std::vector<std::string> *unlinks)
+{
+    auto it = disklru.end();
+    while(it != disklru.begin() && diskusage + needed > diskmax)
+    {
+        --it;
+        if(it->pending)
+            continue; /* being written */
+        if(unlinks)
+            unlinks->push_back(diskPath(it->name));
+        else
+            vlc_unlink(diskPath(it->name).c_str());
+        diskusage -= it->size;
+        diskindex.erase(it->name);
+        it = disklru.erase(it);
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * SegmentCache.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef SEGMENTCACHE_HPP
+#define SEGMENTCACHE_HPP
+
+#include "Chunk.h"
+
+#include <vlc_common.h>
+#include <vlc_cxx_helpers.hpp>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace adaptive
+{
+    namespace http
+    {
+        /* Size bounded LRU store of completed transfers, keyed by url
+         * and byte range. Entries are kept in memory and, when a
+         * directory is set, spilled to disk for the next sessions. */
+        class SegmentCache
+        {
+            public:
+                SegmentCache(vlc_object_t *, size_t memmax,
+                             size_t diskmax = 0, const std::string &dir = std::string());
+                ~SegmentCache();
+                SegmentCache(const SegmentCache &) = delete;
+                SegmentCache & operator=(const SegmentCache &) = delete;
+
+                /* returns a copy of the data, or nullptr on miss */
+                block_t * get(const StorageID &, std::string *contenttype);
+                void      put(const StorageID &, const block_t *, const std::string &);
+                bool      isCacheable(ChunkType) const;
+                void      setSegmentsCacheable(bool);
+
+                struct Stats
+                {
+                    unsigned hits;
+                    unsigned misses;
+                    size_t   memusage;
+                    size_t   diskusage;
+                };
+                Stats     getStats() const;
+
+                static SegmentCache * createDefault(vlc_object_t *);
+
+            private:
+                struct Entry
+                {
+                    StorageID   id;
+                    std::string contenttype;
+                    block_t    *data;
+                };
+                struct DiskEntry
+                {
+                    std::string name;
+                    size_t      size;
+                    uint64_t    serial; /* tells reused names apart */
+                    bool        pending; /* being written */
+                };
+                using MemList = std::list<Entry>;
+                using DiskList = std::list<DiskEntry>;
+
+                void        putMemory(const StorageID &, block_t *, const std::string &);
+                void        evictMemory(size_t);
+                /* file I/O, called without the lock */
+                static block_t * readDisk(const std::string &, const StorageID &,
+                                          size_t, std::string *);
+                static bool writeDisk(const std::string &, const std::string &,
+                                      const block_t *);
+                void        evictDisk(size_t, std::vector<std::string> *);
+                void        loadDiskIndex();
+                std::string diskName(const StorageID &) const;
+                std::string diskPath(const std::string &) const;
+
+                vlc_object_t *obj;
+                mutable vlc::threads::mutex lock;
+                MemList     memlru; /* most recent first */
+                std::unordered_map<StorageID, MemList::iterator> memindex;
+                size_t      memusage;
+                size_t      memmax;
+                DiskList    disklru;
+                std::unordered_map<std::string, DiskList::iterator> diskindex;
+                size_t      diskusage;
+                size_t      diskmax;
+                uint64_t    diskserial;
+                std::string dir;
+                bool        segmentsCacheable;
+                unsigned    hits;
+                unsigned    misses;
+        };
+    }
+}
+
+#endif // SEGMENTCACHE_HPP
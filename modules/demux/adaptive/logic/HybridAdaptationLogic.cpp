@@ -0,0 +1,301 @@
+/*
+ * HybridAdaptationLogic.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "HybridAdaptationLogic.hpp"
+#include "Representationselectors.hpp"
+
+#include "../playlist/BaseAdaptationSet.h"
+#include "../playlist/BaseRepresentation.h"
+#include "../tools/Debug.hpp"
+
+#include <vlc_cxx_helpers.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace adaptive::logic;
+using namespace adaptive;
+
+/*
+ * Throughput estimation is the lowest of a fast and a slow moving average
+ * and of the harmonic mean of the last samples, measured on the transfer
+ * time only. The request round trip is accounted per segment. The buffer
+ * occupancy sets the safety margin, damps the switches up and lets a full
+ * buffer absorb short drops.
+ */
+
+#define FAST_HALFLIFE   VLC_TICK_FROM_SEC(2)
+#define SLOW_HALFLIFE   VLC_TICK_FROM_SEC(6)
+#define MIN_SAMPLE_SIZE 16384
+#define UPSWITCH_VOTES  2
+
+static vlc::threads::mutex history_lock;
+static std::map<std::string, uint64_t> history;
+
+ThroughputEWMA::ThroughputEWMA(vlc_tick_t halflife_)
+    : halflife( halflife_ )
+    , estimate( 0 )
+    , totalweight( 0 )
+{ }
+
+void ThroughputEWMA::push(double value, vlc_tick_t weight)
+{
+    double alpha = std::pow(0.5, (double) weight / halflife);
+    estimate = value * (1 - alpha) + alpha * estimate;
+    totalweight += weight;
+}
+
+double ThroughputEWMA::get() const
+{
+    if(totalweight == 0)
+        return 0;
+    /* average is biased towards its initial zero value */
+    return estimate / (1 - std::pow(0.5, totalweight / halflife));
+}
+
+HybridContext::HybridContext()
+    : buffering_level( 0 )
+    , buffering_target( 1 )
+    , segment_duration( 0 )
+    , upswitch_votes( 0 )
+{ }
+
+HybridAdaptationLogic::HybridAdaptationLogic(vlc_object_t *obj, const std::string &host_)
+    : AbstractAdaptationLogic(obj)
+    , host( host_ )
+    , fast( FAST_HALFLIFE )
+    , slow( SLOW_HALFLIFE )
+    , samples_count( 0 )
+    , ttfb( 0 )
+    , usedBps( 0 )
+{
+    startBps = getHostBandwidth(host);
+    vlc_mutex_init(&lock);
+}
+
+HybridAdaptationLogic::~HybridAdaptationLogic()
+{
+}
+
+uint64_t HybridAdaptationLogic::getHostBandwidth(const std::string &host)
+{
+    vlc::threads::mutex_locker locker {history_lock};
+    auto it = history.find(host);
+    return (it != history.end()) ? it->second : 0;
+}
+
+uint64_t HybridAdaptationLogic::getEstimate() const
+{
+    if(samples_count == 0)
+        return 0;
+
+    const unsigned count = std::min(samples_count, (unsigned) ARRAY_SIZE(samples));
+    double inverses = 0;
+    for(unsigned i = 0; i < count; i++)
+        inverses += 1.0 / samples[i];
+
+    return std::min({ fast.get(), slow.get(), count / inverses });
+}
+
+uint64_t HybridAdaptationLogic::getAvailableBw(uint64_t i_bw, const BaseRepresentation *curRep) const
+{
+    uint64_t i_others = usedBps;
+    if(curRep)
+        i_others -= std::min(i_others, curRep->getBandwidth());
+    return (i_bw > i_others) ? i_bw - i_others : 0;
+}
+
+BaseRepresentation *HybridAdaptationLogic::getNextRepresentation(BaseAdaptationSet *adaptSet, BaseRepresentation *prevRep)
+{
+    RepresentationSelector selector(maxwidth, maxheight);
+
+    vlc_mutex_locker locker(&lock);
+
+    const uint64_t estimate = getEstimate();
+    if(estimate == 0)
+    {
+        if(prevRep)
+            return prevRep;
+        /* fast start from the previous sessions */
+        if(startBps)
+            return selector.select(adaptSet, getAvailableBw(startBps * 3 / 4, nullptr));
+        return selector.lowest(adaptSet);
+    }
+
+    HybridContext &ctx = streams[adaptSet->getID()];
+    const double level = (double) ctx.buffering_level / ctx.buffering_target;
+    const vlc_tick_t duration = ctx.segment_duration;
+
+    double factor;
+    if(level < 0.25)
+        factor = 0.5;
+    else if(level < 0.5)
+        factor = 0.75;
+    else if(level < 0.9)
+        factor = 0.9;
+    else
+        factor = 1.0;
+
+    const uint64_t i_available_bw = getAvailableBw(estimate, prevRep);
+    double budget = i_available_bw * factor;
+    /* the request round trip is lost for the transfer */
+    if(ttfb > 0 && duration > 0)
+        budget = budget * std::max(duration - ttfb, duration / 2) / duration;
+
+    BaseRepresentation *rep = selector.select(adaptSet, budget);
+    if(!prevRep || !rep)
+        return rep;
+
+    if(rep->getBandwidth() < prevRep->getBandwidth())
+    {
+        ctx.upswitch_votes = 0;
+        /* a full buffer absorbs short drops */
+        if(level >= 0.75 && i_available_bw && duration > 0)
+        {
+            vlc_tick_t dltime = ttfb + duration * prevRep->getBandwidth() / i_available_bw;
+            if(dltime < ctx.buffering_level / 2)
+                rep = prevRep;
+        }
+    }
+    else if(rep->getBandwidth() > prevRep->getBandwidth())
+    {
+        /* only step up once confirmed, and never on a low buffer */
+        if(level < 0.5 || ++ctx.upswitch_votes < UPSWITCH_VOTES)
+        {
+            rep = prevRep;
+        }
+        else
+        {
+            ctx.upswitch_votes = 0;
+            rep = selector.higher(adaptSet, prevRep);
+        }
+    }
+    else ctx.upswitch_votes = 0;
+
+    BwDebug( if( rep != prevRep )
+                msg_Info(p_obj, "Stream %s new bandwidth usage %" PRIu64 " KiB/s"
+                         " (estimate %" PRIu64 " KiB/s, buffer %.2f)",
+                         adaptSet->getID().str().c_str(), rep->getBandwidth() / 8000,
+                         estimate / 8000, level); );
+
+    return rep;
+}
+
+void HybridAdaptationLogic::updateDownloadRate(const ID &, size_t dlsize,
+                                               vlc_tick_t time, vlc_tick_t latency)
+{
+    if(unlikely(time <= 0))
+        return;
+
+    vlc_tick_t transfer = time;
+    if(latency > 0 && latency < time)
+        transfer -= latency;
+
+    vlc_mutex_locker locker(&lock);
+
+    if(latency > 0)
+        ttfb = ttfb ? (ttfb * 7 + latency * 3) / 10 : latency;
+
+    /* small transfers only measure the congestion window */
+    if(dlsize < MIN_SAMPLE_SIZE)
+        return;
+
+    const double bps = (double) CLOCK_FREQ * dlsize * 8 / transfer;
+    fast.push(bps, transfer);
+    slow.push(bps, transfer);
+    samples[samples_count++ % ARRAY_SIZE(samples)] = bps;
+
+    if(!host.empty())
+    {
+        vlc::threads::mutex_locker hlocker {history_lock};
+        history[host] = getEstimate();
+    }
+
+    BwDebug(msg_Dbg(p_obj, "sample %" PRIu64 " KiB/s ttfb %" PRId64 "ms -> estimate %" PRIu64 " KiB/s",
+                    (uint64_t) bps / 8000, MS_FROM_VLC_TICK(ttfb), getEstimate() / 8000));
+}
+
+void HybridAdaptationLogic::trackerEvent(const TrackerEvent &ev)
+{
+    switch(ev.getType())
+    {
+    case TrackerEvent::Type::RepresentationSwitch:
+        {
+            const RepresentationSwitchEvent &event =
+                    static_cast<const RepresentationSwitchEvent &>(ev);
+            vlc_mutex_locker locker(&lock);
+            if(event.prev)
+                usedBps -= event.prev->getBandwidth();
+            if(event.next)
+                usedBps += event.next->getBandwidth();
+        }
+        break;
+
+    case TrackerEvent::Type::BufferingStateUpdate:
+        {
+            const BufferingStateUpdatedEvent &event =
+                    static_cast<const BufferingStateUpdatedEvent &>(ev);
+            const ID &id = *event.id;
+            vlc_mutex_locker locker(&lock);
+            if(event.enabled)
+            {
+                if(streams.find(id) == streams.end())
+                    streams.insert(std::pair<ID, HybridContext>(id, HybridContext()));
+            }
+            else
+            {
+                std::map<ID, HybridContext>::iterator it = streams.find(id);
+                if(it != streams.end())
+                    streams.erase(it);
+            }
+        }
+        break;
+
+    case TrackerEvent::Type::BufferingLevelChange:
+        {
+            const BufferingLevelChangedEvent &event =
+                    static_cast<const BufferingLevelChangedEvent &>(ev);
+            const ID &id = *event.id;
+            vlc_mutex_locker locker(&lock);
+            HybridContext &ctx = streams[id];
+            ctx.buffering_level = event.current;
+            ctx.buffering_target = event.target ? event.target : 1;
+        }
+        break;
+
+    case TrackerEvent::Type::SegmentChange:
+        {
+            const SegmentChangedEvent &event =
+                    static_cast<const SegmentChangedEvent &>(ev);
+            const ID &id = *event.id;
+            vlc_mutex_locker locker(&lock);
+            HybridContext &ctx = streams[id];
+            if(event.duration != VLC_TICK_INVALID)
+                ctx.segment_duration = event.duration;
+        }
+        break;
+
+    default:
+            break;
+    }
+}
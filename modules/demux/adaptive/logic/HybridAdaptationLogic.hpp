@@ -0,0 +1,95 @@
+/*
+ * HybridAdaptationLogic.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef HYBRIDADAPTATIONLOGIC_HPP
+#define HYBRIDADAPTATIONLOGIC_HPP
+
+#include "AbstractAdaptationLogic.h"
+
+#include <map>
+#include <string>
+
+#include <vlc_threads.h>
+
+namespace adaptive
+{
+    namespace logic
+    {
+        /* Download time weighted moving average, with bias correction
+         * for the first samples */
+        class ThroughputEWMA
+        {
+            public:
+                ThroughputEWMA(vlc_tick_t halflife);
+                void push(double value, vlc_tick_t weight);
+                double get() const;
+
+            private:
+                vlc_tick_t halflife;
+                double estimate;
+                double totalweight;
+        };
+
+        class HybridContext
+        {
+            friend class HybridAdaptationLogic;
+
+            public:
+                HybridContext();
+
+            private:
+                vlc_tick_t buffering_level;
+                vlc_tick_t buffering_target;
+                vlc_tick_t segment_duration;
+                unsigned   upswitch_votes;
+        };
+
+        class HybridAdaptationLogic : public AbstractAdaptationLogic
+        {
+            public:
+                HybridAdaptationLogic(vlc_object_t *, const std::string &host);
+                virtual ~HybridAdaptationLogic();
+
+                BaseRepresentation* getNextRepresentation(BaseAdaptationSet *,
+                                                          BaseRepresentation *) override;
+                void                updateDownloadRate     (const ID &, size_t,
+                                                            vlc_tick_t, vlc_tick_t) override;
+                void                trackerEvent           (const TrackerEvent &) override;
+
+                /* last estimation for the host, kept for the next sessions */
+                static uint64_t     getHostBandwidth(const std::string &);
+
+            private:
+                uint64_t                    getEstimate() const;
+                uint64_t                    getAvailableBw(uint64_t, const BaseRepresentation *) const;
+                std::map<ID, HybridContext> streams;
+                std::string                 host;
+                ThroughputEWMA              fast;
+                ThroughputEWMA              slow;
+                double                      samples[5];
+                unsigned                    samples_count;
+                vlc_tick_t                  ttfb;
+                uint64_t                    startBps;
+                uint64_t                    usedBps;
+                vlc_mutex_t                 lock;
+        };
+    }
+}
+
+#endif // HYBRIDADAPTATIONLOGIC_HPP
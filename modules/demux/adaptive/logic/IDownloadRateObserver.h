@@ -39,6 +39,7 @@ namespace adaptive
         PREREQ_INTERFACE(IDownloadRateObserver);
 
         public:
+            /* size, time from request to last byte, time to first byte */
             virtual void updateDownloadRate(const ID &, size_t,
                                             vlc_tick_t, vlc_tick_t) = 0;
     };
@@ -82,5 +82,8 @@ void SegmentChunk::setStreamFormat(const StreamFormat &f)
 void SegmentChunk::setEncryptionSession(CommonEncryptionSession *s)
 {
     delete encryptionSession;
-    encryptionSession = s;
+    encryptionSession = nullptr;
+    /* prefer decrypting in the download stage, off the demux thread */
+    if(!source->setEncryptionSession(s))
+        encryptionSession = s;
 }
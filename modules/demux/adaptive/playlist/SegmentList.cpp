@@ -30,6 +30,7 @@
 #include "SegmentInformation.hpp"
 #include "SegmentTimeline.h"
 
+#include <algorithm>
 #include <limits>
 #include <cassert>
 
@@ -41,6 +42,7 @@ SegmentList::SegmentList( SegmentInformation *parent_, bool b_relative ):
 {
     totalLength = 0;
     b_relative_mediatimes = b_relative;
+    deltaStart = std::numeric_limits<uint64_t>::max();
 }
 SegmentList::~SegmentList()
 {
@@ -65,19 +67,13 @@ Segment * SegmentList::getMediaSegment(uint64_t number) const
         return segments.at(listindex);
     }
 
-    std::vector<Segment *>::const_iterator it = segments.begin();
-    for(it = segments.begin(); it != segments.end(); ++it)
-    {
-        Segment *seg = *it;
-        if(seg->getSequenceNumber() == number)
-        {
-            return seg;
-        }
-        else if (seg->getSequenceNumber() > number)
-        {
-            break;
-        }
-    }
+    /* segments are sorted by number */
+    std::vector<Segment *>::const_iterator it =
+        std::lower_bound(segments.begin(), segments.end(), number,
+                         [](const Segment *seg, uint64_t num)
+                         { return seg->getSequenceNumber() < num; });
+    if(it != segments.end() && (*it)->getSequenceNumber() == number)
+        return *it;
     return nullptr;
 }
 
@@ -88,6 +84,11 @@ void SegmentList::addSegment(Segment *seg)
     totalLength += seg->duration;
 }
 
+void SegmentList::setDeltaStart(uint64_t number)
+{
+    deltaStart = number;
+}
+
 void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
                              bool b_restamp)
 {
@@ -96,10 +97,20 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
     AbstractMultipleSegmentBaseType::updateWith(updated_);
 
     SegmentList *updated = dynamic_cast<SegmentList *>(updated_);
-    if(!updated || updated->segments.empty())
+    if(!updated)
+        return;
+
+    /* A delta update only lists the segments past the ones we know,
+     * and always needs merging, even with absolute media times */
+    const bool b_delta = updated->deltaStart != std::numeric_limits<uint64_t>::max();
+    if(updated->segments.empty())
+    {
+        if(b_delta)
+            pruneBySegmentNumber(updated->deltaStart);
         return;
+    }
 
-    b_restamp = b_relative_mediatimes;
+    b_restamp = b_relative_mediatimes || b_delta;
 
     if(!b_restamp || segments.empty())
     {
@@ -113,15 +124,21 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
     else
     {
         const Segment * prevSegment = segments.back();
-        const uint64_t oldest = updated->segments.front()->getSequenceNumber();
+        const uint64_t oldest = b_delta ? updated->deltaStart
+                                        : updated->segments.front()->getSequenceNumber();
+        const Timescale timescale = inheritTimescale();
 
         /* filter out known segments from the update */
         updated->pruneBySegmentNumber(prevSegment->getSequenceNumber() + 1);
 
         if(updated->segments.empty())
+        {
+            pruneBySegmentNumber(oldest);
             return;
+        }
 
         /* merge update with current list */
+        segments.reserve(segments.size() + updated->segments.size());
         for(auto it = updated->segments.begin(); it != updated->segments.end(); ++it)
         {
             Segment *cur = *it;
@@ -134,6 +151,13 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
                 uint64_t gap = cur->getSequenceNumber() - prevSegment->getSequenceNumber() - 1;
                 cur->startTime = cur->startTime + duration * gap;
             }
+            /* the tail of a delta update can lack the date of its segments */
+            else if(cur->getDisplayTime() == VLC_TICK_INVALID &&
+                    prevSegment->getDisplayTime() != VLC_TICK_INVALID)
+            {
+                cur->setDisplayTime(prevSegment->getDisplayTime() +
+                                    timescale.ToTime(prevSegment->duration));
+            }
             prevSegment = cur;
             addSegment(cur);
         }
@@ -155,17 +179,18 @@ void SegmentList::pruneByPlaybackTime(vlc_tick_t time)
 void SegmentList::pruneBySegmentNumber(uint64_t tobelownum)
 {
     std::vector<Segment *>::iterator it = segments.begin();
-    while(it != segments.end())
+    for(; it != segments.end(); ++it)
     {
         Segment *seg = *it;
 
         if(seg->getSequenceNumber() >= tobelownum)
             break;
 
-        totalLength -= (*it)->duration;
-        delete *it;
-        it = segments.erase(it);
+        totalLength -= seg->duration;
+        delete seg;
     }
+    /* a single move of the remaining segments */
+    segments.erase(segments.begin(), it);
 }
 
 bool SegmentList::getPlaybackTimeDurationBySegmentNumber(uint64_t number,
@@ -46,6 +46,7 @@ namespace adaptive
                 void                    updateWith(AbstractMultipleSegmentBaseType *,
                                                    bool = false) override;
                 void                    pruneBySegmentNumber(uint64_t);
+                void                    setDeltaStart(uint64_t);
                 void                    pruneByPlaybackTime(vlc_tick_t);
                 stime_t                 getTotalLength() const;
                 bool                    hasRelativeMediaTimes() const;
@@ -64,6 +65,7 @@ namespace adaptive
                 std::vector<Segment *>  segments;
                 stime_t totalLength;
                 bool b_relative_mediatimes;
+                uint64_t deltaStart;
         };
     }
 }
@@ -26,7 +26,7 @@
 #include "Inheritables.hpp"
 
 #include <vlc_common.h>
-#include <list>
+#include <vector>
 
 namespace adaptive
 {
@@ -56,21 +56,27 @@ namespace adaptive
                 void debug(vlc_object_t *, int = 0) const;
 
             private:
-                std::list<Element *> elements;
-                stime_t totalLength;
-                AbstractMultipleSegmentBaseType *parent;
-
                 class Element
                 {
                     public:
                         Element(uint64_t, stime_t, uint64_t, stime_t);
                         void debug(vlc_object_t *, int = 0) const;
                         bool contains(stime_t) const;
+                        uint64_t last() const { return number + r; }
+                        stime_t  length() const { return d * (r + 1); }
                         stime_t  t;
                         stime_t  d;
                         uint64_t r;
                         uint64_t number;
+                        stime_t  offset; /* summed length of the previous runs */
                 };
+
+                /* Runs are stored by value, sorted by number and time */
+                std::vector<Element> elements;
+                AbstractMultipleSegmentBaseType *parent;
+
+                std::vector<Element>::const_iterator findByNumber(uint64_t) const;
+                void append(Element &);
         };
     }
 }
@@ -0,0 +1,232 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/Chunk.h"
+#include "../../http/HTTPConnectionManager.h"
+#include "../../encryption/CommonEncryption.hpp"
+#include "../../encryption/Keyring.hpp"
+#include "../../SharedResources.hpp"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+
+#ifdef HAVE_GCRYPT
+ #include <gcrypt.h>
+ #include <vlc_gcrypt.h>
+#endif
+
+#include <cstring>
+#include <vector>
+
+using namespace adaptive;
+using namespace adaptive::http;
+using namespace adaptive::encryption;
+
+#ifdef HAVE_GCRYPT
+static const uint8_t aeskey[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+
+/* Serves the key to the keyring */
+class KeySource : public AbstractChunkSource
+{
+    public:
+        KeySource() : AbstractChunkSource(ChunkType::Key)
+        {
+            read_ = 0;
+        }
+        block_t * readBlock() override
+        {
+            return read(sizeof(aeskey));
+        }
+        block_t * read(size_t) override
+        {
+            if(read_)
+                return nullptr;
+            block_t *p_block = block_Alloc(sizeof(aeskey));
+            if(p_block)
+            {
+                memcpy(p_block->p_buffer, aeskey, sizeof(aeskey));
+                read_ = sizeof(aeskey);
+            }
+            return p_block;
+        }
+        bool hasMoreData() const override
+        {
+            return !read_;
+        }
+        size_t getBytesRead() const override
+        {
+            return read_;
+        }
+        void recycle() override
+        {
+            delete this;
+        }
+
+    private:
+        size_t read_;
+};
+
+class KeyConnectionManager : public AbstractConnectionManager
+{
+    public:
+        KeyConnectionManager() : AbstractConnectionManager(nullptr) {}
+        void closeAllConnections() override {}
+        AbstractConnection * getConnection(ConnectionParams &) override
+        {
+            return nullptr;
+        }
+        AbstractChunkSource *makeSource(const std::string &, const ID &,
+                                        ChunkType, const BytesRange &) override
+        {
+            return new KeySource();
+        }
+        void recycleSource(AbstractChunkSource *source) override
+        {
+            source->recycle();
+        }
+        void start(AbstractChunkSource *) override {}
+        void cancel(AbstractChunkSource *) override {}
+};
+
+class DecryptingSource : public HTTPChunkBufferedSource
+{
+    public:
+        DecryptingSource(AbstractConnectionManager *manager)
+            : HTTPChunkBufferedSource("http://localhost/segment.ts", manager,
+                                      ID(), ChunkType::Segment, BytesRange()) {}
+        using HTTPChunkBufferedSource::decrypt;
+};
+
+/* AES-128-CBC with the PKCS#7 padding, as HLS segments are */
+static std::vector<uint8_t> Encrypt(const std::vector<uint8_t> &plain,
+                                    const std::vector<unsigned char> &iv)
+{
+    const uint8_t pad = 16 - plain.size() % 16;
+    std::vector<uint8_t> cipher(plain);
+    cipher.insert(cipher.end(), pad, pad);
+
+    gcry_cipher_hd_t handle;
+    if(gcry_cipher_open(&handle, GCRY_CIPHER_AES, GCRY_CIPHER_MODE_CBC, 0))
+        return std::vector<uint8_t>();
+    if(gcry_cipher_setkey(handle, aeskey, 16) ||
+       gcry_cipher_setiv(handle, &iv[0], 16) ||
+       gcry_cipher_encrypt(handle, &cipher[0], cipher.size(), nullptr, 0))
+        cipher.clear();
+    gcry_cipher_close(handle);
+    return cipher;
+}
+
+/* Feeds the ciphertext in reads of the given sizes, the last one ending
+ * the transfer, and checks what is released after each of them */
+static void DecryptReads(SharedResources *resources, size_t plainsize,
+                         const std::vector<size_t> &reads)
+{
+    CommonEncryption enc;
+    enc.method = CommonEncryption::Method::AES_128;
+    enc.uri = "http://localhost/key";
+    for(unsigned char i = 0; i < 16; i++)
+        enc.iv.push_back(i);
+
+    std::vector<uint8_t> plain;
+    for(size_t i = 0; i < plainsize; i++)
+        plain.push_back(i * 7);
+    const std::vector<uint8_t> cipher = Encrypt(plain, enc.iv);
+    Expect(!cipher.empty());
+
+    CommonEncryptionSession *session = new CommonEncryptionSession();
+    if(!session->start(resources, enc))
+    {
+        delete session;
+        Expect(false);
+    }
+
+    DecryptingSource source(resources->getConnManager());
+    Expect(source.setEncryptionSession(session));
+
+    std::vector<uint8_t> out;
+    size_t fed = 0;
+    for(size_t i = 0; i < reads.size(); i++)
+    {
+        const bool b_last = (i + 1 == reads.size());
+        block_t *p_block = nullptr;
+        if(reads[i])
+        {
+            Expect(fed + reads[i] <= cipher.size());
+            p_block = block_Alloc(reads[i]);
+            Expect(p_block);
+            memcpy(p_block->p_buffer, &cipher[fed], reads[i]);
+            fed += reads[i];
+        }
+
+        p_block = source.decrypt(p_block, b_last);
+        if(p_block)
+        {
+            out.insert(out.end(), p_block->p_buffer,
+                       p_block->p_buffer + p_block->i_buffer);
+            block_Release(p_block);
+        }
+
+        if(!b_last)
+        {
+            /* only whole cipher blocks, and never the last received one */
+            const size_t released = (fed > 16) ? (fed - 1) & ~(size_t)15 : 0;
+            Expect(out.size() == released);
+        }
+    }
+    Expect(fed == cipher.size());
+
+    /* the padding is gone */
+    Expect(out.size() == plainsize);
+    Expect(out == plain);
+}
+
+int ChunkDecrypt_test() try
+{
+    vlc_gcrypt_init();
+
+    SharedResources resources(nullptr, new Keyring(nullptr),
+                              new KeyConnectionManager(), nullptr);
+
+    /* 100 bytes and 12 bytes of padding, read with the data */
+    DecryptReads(&resources, 100, {5, 13, 20, 1, 40, 33});
+    /* ends on a cipher block boundary, the end has no data */
+    DecryptReads(&resources, 100, {16, 15, 17, 64, 0});
+    /* a whole padding block, after a read of exactly one block */
+    DecryptReads(&resources, 64, {7, 9, 16, 48});
+    /* all in one read */
+    DecryptReads(&resources, 37, {48});
+
+    return 0;
+} catch (...) {
+    return 1;
+}
+#else
+int ChunkDecrypt_test()
+{
+    return 0;
+}
+#endif
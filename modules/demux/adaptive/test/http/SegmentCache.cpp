@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/SegmentCache.hpp"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace adaptive::http;
+
+static block_t * MakeChain(size_t size, uint8_t fill)
+{
+    block_t *p_chain = nullptr;
+    block_t **pp_tail = &p_chain;
+    while(size)
+    {
+        const size_t blocksize = std::min(size, (size_t) 1000);
+        block_t *p_block = block_Alloc(blocksize);
+        memset(p_block->p_buffer, fill, blocksize);
+        block_ChainLastAppend(&pp_tail, p_block);
+        size -= blocksize;
+    }
+    return p_chain;
+}
+
+static bool Check(block_t *p_block, size_t size, uint8_t fill)
+{
+    if(!p_block)
+        return false;
+    bool b_ok = (p_block->i_buffer == size);
+    for(size_t i = 0; b_ok && i < size; i++)
+        b_ok = (p_block->p_buffer[i] == fill);
+    block_Release(p_block);
+    return b_ok;
+}
+
+int SegmentCache_test() try
+{
+    SegmentCache cache(nullptr, 10000);
+    std::string type;
+
+    Expect(cache.isCacheable(ChunkType::Init));
+    Expect(cache.isCacheable(ChunkType::Index));
+    Expect(!cache.isCacheable(ChunkType::Segment));
+    Expect(!cache.isCacheable(ChunkType::Key));
+    Expect(!cache.isCacheable(ChunkType::Playlist));
+    cache.setSegmentsCacheable(true);
+    Expect(cache.isCacheable(ChunkType::Segment));
+
+    Expect(cache.get("a", &type) == nullptr);
+
+    block_t *p_chain = MakeChain(4000, 'a');
+    cache.put("a", p_chain, "video/mp4");
+    block_ChainRelease(p_chain);
+    Expect(Check(cache.get("a", &type), 4000, 'a'));
+    Expect(type == "video/mp4");
+
+    p_chain = MakeChain(4000, 'b');
+    cache.put("b", p_chain, "");
+    block_ChainRelease(p_chain);
+    /* refresh a, so b is the least recently used */
+    Expect(Check(cache.get("a", &type), 4000, 'a'));
+
+    p_chain = MakeChain(4000, 'c');
+    cache.put("c", p_chain, "");
+    block_ChainRelease(p_chain);
+    Expect(cache.get("b", &type) == nullptr);
+    Expect(Check(cache.get("a", &type), 4000, 'a'));
+    Expect(Check(cache.get("c", &type), 4000, 'c'));
+
+    /* larger than the cache */
+    p_chain = MakeChain(12000, 'd');
+    cache.put("d", p_chain, "");
+    block_ChainRelease(p_chain);
+    Expect(cache.get("d", &type) == nullptr);
+
+    SegmentCache::Stats stats = cache.getStats();
+    Expect(stats.hits == 4);
+    Expect(stats.misses == 3);
+    Expect(stats.memusage == 8000);
+    Expect(stats.diskusage == 0);
+
+    return 0;
+} catch (...) {
+    return 1;
+}
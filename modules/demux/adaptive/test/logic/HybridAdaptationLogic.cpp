@@ -0,0 +1,236 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../playlist/BasePlaylist.hpp"
+#include "../../playlist/BasePeriod.h"
+#include "../../playlist/BaseAdaptationSet.h"
+#include "../../playlist/BaseRepresentation.h"
+#include "../../logic/HybridAdaptationLogic.hpp"
+#include "../../logic/Representationselectors.hpp"
+#include "../../SegmentTracker.hpp"
+
+#include "../test.hpp"
+
+#include <vector>
+
+using namespace adaptive;
+using namespace adaptive::playlist;
+using namespace adaptive::logic;
+
+/* Trace driven playback simulator: segments are downloaded back to back
+ * over a link following a per second throughput trace, while the
+ * playback drains the buffer. */
+
+#define SEGMENT_DURATION VLC_TICK_FROM_SEC(2)
+#define BUFFER_TARGET    VLC_TICK_FROM_SEC(20)
+#define TTFB             VLC_TICK_FROM_MS(80)
+
+class SimRepresentation : public BaseRepresentation
+{
+    public:
+        SimRepresentation(BaseAdaptationSet *set, uint64_t bw) : BaseRepresentation(set)
+        {
+            setBandwidth(bw);
+        }
+        virtual ~SimRepresentation() = default;
+        StreamFormat getStreamFormat() const override { return StreamFormat::Type::Unknown; }
+};
+
+/* Reference: picks from the last throughput sample only */
+class LastSampleLogic : public AbstractAdaptationLogic
+{
+    public:
+        LastSampleLogic() : AbstractAdaptationLogic(nullptr), bps(0) {}
+        virtual ~LastSampleLogic() = default;
+        BaseRepresentation* getNextRepresentation(BaseAdaptationSet *set,
+                                                  BaseRepresentation *) override
+        {
+            RepresentationSelector selector(maxwidth, maxheight);
+            return selector.select(set, bps);
+        }
+        void updateDownloadRate(const ID &, size_t size, vlc_tick_t time,
+                                vlc_tick_t) override
+        {
+            bps = CLOCK_FREQ * size * 8 / time;
+        }
+        uint64_t bps;
+};
+
+struct SimResult
+{
+    vlc_tick_t rebuffering;
+    unsigned switches;
+    uint64_t averagebps;
+    BaseRepresentation *first;
+    BaseRepresentation *last;
+};
+
+static vlc_tick_t Transfer(const std::vector<unsigned> &trace, vlc_tick_t now, uint64_t size)
+{
+    double remain = size;
+    vlc_tick_t t = now;
+    for(;;)
+    {
+        const double rate = trace[(t / CLOCK_FREQ) % trace.size()] * 1000.0 / 8;
+        const vlc_tick_t left = CLOCK_FREQ - t % CLOCK_FREQ;
+        const double bytes = rate * left / CLOCK_FREQ;
+        if(bytes >= remain)
+            return t + remain * CLOCK_FREQ / rate - now;
+        remain -= bytes;
+        t += left;
+    }
+}
+
+static SimResult Simulate(AbstractAdaptationLogic *logic, BaseAdaptationSet *set,
+                          const std::vector<unsigned> &trace, unsigned count)
+{
+    SimResult res = {0, 0, 0, nullptr, nullptr};
+    const ID &id = set->getID();
+    BaseRepresentation *prev = nullptr;
+    vlc_tick_t now = 0, buffer = 0;
+    uint64_t bitsum = 0;
+
+    logic->trackerEvent(BufferingStateUpdatedEvent(id, true));
+    for(unsigned i = 0; i < count; i++)
+    {
+        BaseRepresentation *rep = logic->getNextRepresentation(set, prev);
+        if(rep != prev)
+        {
+            logic->trackerEvent(RepresentationSwitchEvent(prev, rep));
+            if(prev)
+                res.switches++;
+        }
+        logic->trackerEvent(SegmentChangedEvent(id, i, i * SEGMENT_DURATION,
+                                                i * SEGMENT_DURATION, SEGMENT_DURATION));
+        if(!res.first)
+            res.first = rep;
+        prev = rep;
+
+        const uint64_t size = rep->getBandwidth() * SEGMENT_DURATION / CLOCK_FREQ / 8;
+        const vlc_tick_t elapsed = TTFB + Transfer(trace, now + TTFB, size);
+        if(i > 0) /* playing */
+        {
+            if(elapsed > buffer)
+                res.rebuffering += elapsed - buffer;
+            buffer -= std::min(buffer, elapsed);
+        }
+        now += elapsed;
+        buffer += SEGMENT_DURATION;
+        logic->updateDownloadRate(id, size, elapsed, TTFB);
+
+        /* idle until there's room for the next segment */
+        if(buffer > BUFFER_TARGET)
+        {
+            now += buffer - BUFFER_TARGET;
+            buffer = BUFFER_TARGET;
+        }
+        logic->trackerEvent(BufferingLevelChangedEvent(id, 0, BUFFER_TARGET * 2,
+                                                       buffer, BUFFER_TARGET));
+        bitsum += rep->getBandwidth();
+    }
+    logic->trackerEvent(RepresentationSwitchEvent(prev, nullptr));
+    logic->trackerEvent(BufferingStateUpdatedEvent(id, false));
+
+    res.averagebps = bitsum / count;
+    res.last = prev;
+    return res;
+}
+
+static std::vector<unsigned> MakeTrace(std::initializer_list<std::pair<unsigned, unsigned>> steps)
+{
+    std::vector<unsigned> trace;
+    for(const auto &step : steps)
+        trace.insert(trace.end(), step.first, step.second);
+    return trace;
+}
+
+int HybridAdaptationLogic_test()
+{
+    BasePlaylist *playlist = nullptr;
+    try
+    {
+        playlist = new BasePlaylist(nullptr);
+        BasePeriod *period = new BasePeriod(playlist);
+        playlist->addPeriod(period);
+        BaseAdaptationSet *set = new BaseAdaptationSet(period);
+        period->addAdaptationSet(set);
+        set->setID(ID("video"));
+
+        static const uint64_t ladder[] = { 300000, 800000, 1500000, 3000000, 5000000 };
+        std::vector<BaseRepresentation *> reps;
+        for(uint64_t bw : ladder)
+        {
+            reps.push_back(new SimRepresentation(set, bw));
+            set->addRepresentation(reps.back());
+        }
+
+        /* Stable link, starts low without history then converges */
+        {
+            HybridAdaptationLogic logic(nullptr, "");
+            SimResult res = Simulate(&logic, set, MakeTrace({{1, 8000}}), 60);
+            Expect(res.first == reps[0]);
+            Expect(res.last == reps[4]);
+            Expect(res.rebuffering == 0);
+        }
+
+        /* Fluctuating mobile link */
+        {
+            const std::vector<unsigned> trace = MakeTrace({{5, 4000}, {5, 1200},
+                                                           {3, 6000}, {4, 900},
+                                                           {6, 3000}, {2, 600}});
+            HybridAdaptationLogic logic(nullptr, "");
+            SimResult res = Simulate(&logic, set, trace, 150);
+            LastSampleLogic reference;
+            SimResult refres = Simulate(&reference, set, trace, 150);
+            Expect(res.rebuffering == 0);
+            Expect(res.switches * 3 < refres.switches);
+            Expect(res.averagebps >= ladder[1]);
+        }
+
+        /* Sudden drop */
+        {
+            HybridAdaptationLogic logic(nullptr, "");
+            SimResult res = Simulate(&logic, set, MakeTrace({{60, 6000}, {600, 500}}), 60);
+            Expect(res.last == reps[0]);
+            Expect(res.rebuffering < VLC_TICK_FROM_SEC(2));
+        }
+
+        /* Fast start from the previous session on the same host */
+        {
+            HybridAdaptationLogic logic(nullptr, "sim.example.org");
+            Expect(HybridAdaptationLogic::getHostBandwidth("sim.example.org") == 0);
+            Simulate(&logic, set, MakeTrace({{1, 5000}}), 20);
+            Expect(HybridAdaptationLogic::getHostBandwidth("sim.example.org") > 4500000);
+            HybridAdaptationLogic logic2(nullptr, "sim.example.org");
+            SimResult res = Simulate(&logic2, set, MakeTrace({{1, 5000}}), 1);
+            Expect(res.first == reps[3]);
+        }
+
+        delete playlist;
+    } catch (...) {
+        delete playlist;
+        return 1;
+    }
+
+    return 0;
+}
@@ -56,6 +56,19 @@ static M3U8 * ParseM3U8(vlc_object_t *obj, const char *psz, size_t isz)
     return m3u;
 }
 
+static bool ReloadM3U8(vlc_object_t *obj, BaseRepresentation *rep,
+                       const char *psz, size_t isz)
+{
+    M3U8Parser parser(nullptr);
+    stream_t *substream = vlc_stream_MemoryNew(obj, ((uint8_t *)psz), isz, true);
+    if(!substream)
+        return false;
+    bool b_ret = parser.appendSegmentsFromPlaylist(obj, static_cast<HLSRepresentation *>(rep),
+                                                   substream, false);
+    vlc_stream_Delete(substream);
+    return b_ret;
+}
+
 int M3U8MasterPlaylist_test()
 {
     vlc_object_t *obj = static_cast<vlc_object_t*>(nullptr);
@@ -584,6 +597,184 @@ int M3U8Playlist_test()
         return 1;
     }
 
+    /* Manifest 7, delta update */
+    const char manifest7[] =
+        "#EXTM3U\n"
+        "#EXT-X-SERVER-CONTROL:CAN-SKIP-UNTIL=36.0\n"
+        "#EXT-X-MEDIA-SEQUENCE:10\n"
+        "#EXT-X-SKIP:SKIPPED-SEGMENTS=3\n"
+        "#EXTINF:4\n"
+        "foobar.ts\n"
+        "#EXTINF:4\n"
+        "foobar.ts\n";
+
+    m3u = ParseM3U8(obj, manifest7, sizeof(manifest7));
+    try
+    {
+        Expect(m3u);
+        Expect(m3u->isLive() == true);
+        BaseRepresentation *rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+                                  getRepresentations().front();
+        Expect(rep->getProfile()->getStartSegmentNumber() == 13);
+        Expect(rep->getMediaSegment(12) == nullptr);
+        Segment *seg = rep->getMediaSegment(14);
+        Expect(seg);
+        Expect(seg->getSequenceNumber() == 14);
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+
+    return 0;
+}
+
+int M3U8PlaylistReload_test()
+{
+    vlc_object_t *obj = static_cast<vlc_object_t*>(nullptr);
+
+    /* The known segments of a reload are collapsed into an EXT-X-SKIP, and
+     * merged as a delta update even with absolute media times */
+    const char manifest0[] =
+        "#EXTM3U\n"
+        "#EXT-X-TARGETDURATION:4\n"
+        "#EXT-X-MEDIA-SEQUENCE:10\n"
+        "#EXT-X-PROGRAM-DATE-TIME:2026-01-01T00:00:00Z\n"
+        "#EXTINF:4\n"
+        "seg10.ts\n"
+        "#EXTINF:4\n"
+        "seg11.ts\n"
+        "#EXTINF:4\n"
+        "seg12.ts\n"
+        "#EXTINF:4\n"
+        "seg13.ts\n";
+
+    const char reload0[] =
+        "#EXTM3U\n"
+        "#EXT-X-TARGETDURATION:4\n"
+        "#EXT-X-MEDIA-SEQUENCE:12\n"
+        "#EXT-X-PROGRAM-DATE-TIME:2026-01-01T00:00:08Z\n"
+        "#EXTINF:4\n"
+        "seg12.ts\n"
+        "#EXTINF:4\n"
+        "seg13.ts\n"
+        "#EXTINF:4\n"
+        "seg14.ts\n"
+        "#EXTINF:5\n"
+        "seg15.ts\n";
+
+    M3U8 *m3u = ParseM3U8(obj, manifest0, sizeof(manifest0));
+    try
+    {
+        Expect(m3u);
+        BaseRepresentation *rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+                                  getRepresentations().front();
+        Expect(rep->getMediaSegment(13));
+        const vlc_tick_t displayTime = rep->getMediaSegment(13)->getDisplayTime();
+        Expect(displayTime != VLC_TICK_INVALID);
+
+        Expect(ReloadM3U8(obj, rep, reload0, sizeof(reload0)));
+        Expect(rep->getMediaSegment(11) == nullptr);
+
+        /* A full update would have restarted the media times from 0 */
+        vlc_tick_t mediatime, duration;
+        Expect(rep->getPlaybackTimeDurationBySegmentNumber(12, &mediatime, &duration));
+        Expect(mediatime == vlc_tick_from_sec(8));
+        Expect(duration == vlc_tick_from_sec(4));
+        Expect(rep->getPlaybackTimeDurationBySegmentNumber(15, &mediatime, &duration));
+        Expect(mediatime == vlc_tick_from_sec(20));
+        Expect(duration == vlc_tick_from_sec(5));
+
+        Segment *seg = rep->getMediaSegment(13);
+        Expect(seg);
+        Expect(seg->getDisplayTime() == displayTime);
+        seg = rep->getMediaSegment(14);
+        Expect(seg);
+        Expect(seg->getDisplayTime() == displayTime + vlc_tick_from_sec(4));
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+    /* Byte ranges can depend on the previous segments: the collapsing stops
+     * at the first one, and the known segments keep their tags */
+    const char manifest1[] =
+        "#EXTM3U\n"
+        "#EXT-X-TARGETDURATION:4\n"
+        "#EXT-X-MEDIA-SEQUENCE:10\n"
+        "#EXT-X-PROGRAM-DATE-TIME:2026-01-01T00:00:00Z\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000@0\n"
+        "media.ts\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000\n"
+        "media.ts\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000\n"
+        "media.ts\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000\n"
+        "media.ts\n";
+
+    const char reload1[] =
+        "#EXTM3U\n"
+        "#EXT-X-TARGETDURATION:4\n"
+        "#EXT-X-MEDIA-SEQUENCE:12\n"
+        "#EXT-X-PROGRAM-DATE-TIME:2026-01-01T00:00:06Z\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000@2000\n"
+        "media.ts\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000\n"
+        "media.ts\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000\n"
+        "media.ts\n"
+        "#EXTINF:3\n"
+        "#EXT-X-BYTERANGE:1000\n"
+        "media.ts\n";
+
+    m3u = ParseM3U8(obj, manifest1, sizeof(manifest1));
+    try
+    {
+        Expect(m3u);
+        BaseRepresentation *rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+                                  getRepresentations().front();
+        const vlc_tick_t displayTime = rep->getMediaSegment(12)->getDisplayTime();
+
+        Expect(ReloadM3U8(obj, rep, reload1, sizeof(reload1)));
+        Expect(rep->getMediaSegment(11) == nullptr);
+
+        /* Parsed as a full update, with the duration and date of the
+         * first segment, and every offset */
+        vlc_tick_t mediatime, duration;
+        Expect(rep->getPlaybackTimeDurationBySegmentNumber(12, &mediatime, &duration));
+        Expect(mediatime == vlc_tick_from_sec(0));
+        Expect(duration == vlc_tick_from_sec(3));
+
+        Segment *seg = rep->getMediaSegment(12);
+        Expect(seg);
+        Expect(seg->getDisplayTime() == displayTime);
+        Expect(seg->getOffset() == 2000);
+        seg = rep->getMediaSegment(13);
+        Expect(seg);
+        Expect(seg->getOffset() == 3000);
+        seg = rep->getMediaSegment(15);
+        Expect(seg);
+        Expect(seg->getOffset() == 5000);
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
 
     return 0;
 }
@@ -0,0 +1,126 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../xml/Node.h"
+#include "../../tools/Conversions.hpp"
+#include "../../../dash/mpd/MPDPatch.hpp"
+
+#include "../test.hpp"
+
+#include <memory>
+
+using namespace adaptive;
+using namespace adaptive::xml;
+using namespace dash::mpd;
+
+static Namespaces nss;
+
+static Node * AddNode(Node *parent, const char *name, const char *ns,
+                      const std::vector<std::pair<std::string, std::string>> &attrs = {})
+{
+    Node *node = new Node(std::make_unique<std::string>(name),
+                          nss.registerNamespace(ns));
+    for(const auto &attr : attrs)
+        node->addAttribute(attr.first, nss.registerNamespace(""), attr.second);
+    if(parent)
+        parent->addSubNode(node);
+    return node;
+}
+
+#define MPDNS   "urn:mpeg:dash:schema:mpd:2011"
+#define PATCHNS "urn:mpeg:dash:schema:mpd-patch:2020"
+#define TIMELINE "/MPD/Period[@id='p0']/AdaptationSet[@id='1']/SegmentTemplate/SegmentTimeline"
+
+int MPDPatch_test() try
+{
+    std::unique_ptr<Node> mpd(AddNode(nullptr, "MPD", MPDNS,
+                                      {{"id", "live"},
+                                       {"publishTime", "2026-01-01T00:00:00Z"}}));
+    Node *period = AddNode(mpd.get(), "Period", MPDNS, {{"id", "p0"}});
+    AddNode(mpd.get(), "Period", MPDNS, {{"id", "p1"}});
+    Node *set = AddNode(period, "AdaptationSet", MPDNS, {{"id", "1"}});
+    Node *templ = AddNode(set, "SegmentTemplate", MPDNS);
+    Node *timeline = AddNode(templ, "SegmentTimeline", MPDNS);
+    AddNode(timeline, "S", MPDNS, {{"t", "0"}, {"d", "10"}});
+    AddNode(timeline, "S", MPDNS, {{"d", "10"}, {"r", "2"}});
+
+    /* Check failures */
+    std::unique_ptr<Node> patchroot(AddNode(nullptr, "Patch", PATCHNS,
+                                            {{"mpdId", "live"},
+                                             {"originalPublishTime", "2026-01-01T00:00:00Z"}}));
+    MPDPatch patch(patchroot.get());
+    Expect(patch.isValid());
+    Expect(!patch.appliesTo("foo", UTCTime("2026-01-01T00:00:00Z")));
+    Expect(!patch.appliesTo("live", UTCTime("2026-01-01T00:00:02Z")));
+    Expect(patch.appliesTo("live", UTCTime("2026-01-01T00:00:00Z")));
+
+    Node *op = AddNode(patchroot.get(), "remove", PATCHNS, {{"sel", "/MPD/Period[@id='p2']"}});
+    Expect(!patch.apply(mpd.get()));
+    patchroot->detachSubNode(op);
+    delete op;
+    op = AddNode(patchroot.get(), "remove", PATCHNS, {{"sel", "/MPD/@id/Period"}});
+    Expect(!patch.apply(mpd.get()));
+    patchroot->detachSubNode(op);
+    delete op;
+    op = AddNode(patchroot.get(), "remove", PATCHNS, {{"sel", "/MPD"}});
+    Expect(!patch.apply(mpd.get()));
+    patchroot->detachSubNode(op);
+    delete op;
+    Expect(mpd->getSubNodes().size() == 2);
+
+    /* Live timeline update */
+    op = AddNode(patchroot.get(), "replace", PATCHNS, {{"sel", "/MPD/@publishTime"}});
+    op->setText("2026-01-01T00:00:10Z");
+    AddNode(patchroot.get(), "remove", PATCHNS, {{"sel", TIMELINE "/S[1]"}});
+    op = AddNode(patchroot.get(), "add", PATCHNS, {{"sel", TIMELINE}});
+    AddNode(op, "S", PATCHNS, {{"d", "20"}});
+    op = AddNode(patchroot.get(), "add", PATCHNS, {{"sel", TIMELINE "/S[1]"},
+                                                    {"pos", "before"}});
+    AddNode(op, "S", PATCHNS, {{"t", "10"}, {"d", "10"}});
+    op = AddNode(patchroot.get(), "add", PATCHNS, {{"sel", "/MPD/Period[1]"},
+                                                    {"type", "@start"}});
+    op->setText("PT30S");
+    op = AddNode(patchroot.get(), "replace", PATCHNS, {{"sel", "/MPD/Period[@id='p1']"}});
+    AddNode(op, "Period", PATCHNS, {{"id", "p2"}});
+
+    Expect(patch.apply(mpd.get()));
+    Expect(mpd->getAttributeValue("publishTime") == "2026-01-01T00:00:10Z");
+    Expect(timeline->getSubNodes().size() == 3);
+    Node *s = timeline->getSubNodes().at(0);
+    Expect(s->getAttributeValue("t") == "10");
+    Expect(s->matches("S", MPDNS));
+    s = timeline->getSubNodes().at(1);
+    Expect(s->getAttributeValue("r") == "2");
+    s = timeline->getSubNodes().at(2);
+    Expect(s->getAttributeValue("d") == "20");
+    Expect(s->matches("S", MPDNS));
+    Expect(mpd->getSubNodes().size() == 2);
+    Expect(mpd->getSubNodes().at(0) == period);
+    Expect(period->getAttributeValue("start") == "PT30S");
+    Expect(mpd->getSubNodes().at(1)->getAttributeValue("id") == "p2");
+    Expect(!mpd->getSubNodes().at(1)->hasAttribute("start"));
+
+    return 0;
+} catch (...) {
+    return 1;
+}
@@ -233,6 +233,50 @@ int SegmentList_test() try
     segmentList.reset();
     segmentList2.reset();
 
+    /* delta updates, absolute media timings */
+    segmentList = std::make_unique<SegmentList>(nullptr, false);
+    segmentList->addAttribute(new TimescaleAttr(timescale));
+    for(int i=0; i<4; i++)
+    {
+        seg = std::make_unique<Segment>(nullptr);
+        seg->setSequenceNumber(123 + i);
+        seg->startTime = START + 100 * i;
+        seg->duration = 100;
+        seg->setDisplayTime(VLC_TICK_0 + timescale.ToTime(100 * i));
+        segmentList->addSegment(seg.release());
+    }
+    segmentList2 = std::make_unique<SegmentList>(nullptr, false);
+    segmentList2->setDeltaStart(124);
+    for(int i=0; i<2; i++)
+    {
+        seg = std::make_unique<Segment>(nullptr);
+        seg->setSequenceNumber(127 + i);
+        seg->startTime = 100 * i; /* delta updates restart from 0 */
+        seg->duration = 100;
+        segmentList2->addSegment(seg.release());
+    }
+    segmentList->updateWith(segmentList2.get());
+    Expect(segmentList->getStartSegmentNumber() == 124);
+    Expect(segmentList->getSegments().size() == 5);
+    Expect(segmentList->getTotalLength() == 100 * 5);
+    for(int i=1; i<6; i++)
+    {
+        segptr = segmentList->getMediaSegment(123 + i);
+        Expect(segptr);
+        Expect(segptr->startTime == START + 100 * i);
+        Expect(segptr->getDisplayTime() == VLC_TICK_0 + timescale.ToTime(100 * i));
+    }
+
+    /* delta update with no new segment only moves the window */
+    segmentList2 = std::make_unique<SegmentList>(nullptr, false);
+    segmentList2->setDeltaStart(126);
+    segmentList->updateWith(segmentList2.get());
+    Expect(segmentList->getStartSegmentNumber() == 126);
+    Expect(segmentList->getSegments().size() == 3);
+
+    segmentList.reset();
+    segmentList2.reset();
+
     /* Tricky now, check timelined */
     segmentList = std::make_unique<SegmentList>(nullptr);
     segmentList->addAttribute(new TimescaleAttr(timescale));
@@ -172,6 +172,31 @@ int Timeline_test()
 
         delete timeline;
         delete timeline2;
+        timeline2 = nullptr;
+
+        /* Irregular long DVR window */
+        timeline = new SegmentTimeline(nullptr);
+        for(uint64_t i = 0; i < 1000; i++)
+            timeline->addElement(100 + 2 * i, 10 + i % 7, 1, 0);
+        Expect(timeline->maxElementNumber() == 100 + 1999);
+        stime_t expected = 0;
+        for(uint64_t i = 0; i < 2000; i++)
+        {
+            Expect(timeline->getScaledPlaybackTimeDurationBySegmentNumber(100 + i, &time, &duration));
+            Expect(time == expected);
+            Expect(duration == (stime_t)(10 + (i / 2) % 7));
+            Expect(timeline->getElementNumberByScaledPlaybackTime(time + duration - 1) == 100 + i);
+            Expect(timeline->getElementIndexBySequence(100 + i) == i / 2);
+            expected += duration;
+            Expect(timeline->getMinAheadScaledTime(100 + i) == timeline->getTotalLength() - expected);
+        }
+        Expect(timeline->pruneBySequenceNumber(1101) == 1001);
+        Expect(timeline->minElementNumber() == 1101);
+        Expect(timeline->getElementIndexBySequence(1101) == 0);
+        Expect(timeline->getScaledPlaybackTimeByElementNumber(1101) ==
+               expected - timeline->getTotalLength());
+
+        delete timeline;
 
     } catch (...) {
         delete timeline;
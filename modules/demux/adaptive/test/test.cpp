@@ -46,9 +46,14 @@ int main()
     TEST(Conversions) ||
     TEST(TemplatedUri) ||
     TEST(BufferingLogic) ||
+    TEST(SegmentCache) ||
+    TEST(ChunkDecrypt) ||
+    TEST(HybridAdaptationLogic) ||
     TEST(CommandsQueue) ||
     TEST(M3U8MasterPlaylist) ||
     TEST(M3U8Playlist) ||
+    TEST(M3U8PlaylistReload) ||
+    TEST(MPDPatch) ||
     TEST(SegmentTracker)
     ;
 }
@@ -45,8 +45,13 @@ int Timeline_test();
 int Conversions_test();
 int M3U8MasterPlaylist_test();
 int M3U8Playlist_test();
+int M3U8PlaylistReload_test();
+int MPDPatch_test();
 int CommandsQueue_test();
 int BufferingLogic_test();
+int SegmentCache_test();
+int ChunkDecrypt_test();
+int HybridAdaptationLogic_test();
 int FakeEsOut_test();
 int SegmentTracker_test();
 
@@ -59,6 +59,21 @@ Node*   DOMParser::getRootNode              ()
 {
     return this->root;
 }
+
+Node*   DOMParser::releaseRootNode          ()
+{
+    Node *node = this->root;
+    this->root = nullptr;
+    return node;
+}
+
+void DOMParser::setElementHandler(const std::string &name, ElementHandler handler)
+{
+    if(handler)
+        handlers[name] = std::move(handler);
+    else
+        handlers.erase(name);
+}
 bool    DOMParser::parse                    (bool b)
 {
     if(!stream)
@@ -107,6 +122,12 @@ Node* DOMParser::processNode(bool b_strict)
                 bool empty = xml_ReaderIsEmptyElement(vlc_reader);
                 const char *unprefixed = std::strchr(data, ':');
                 data = unprefixed ? unprefixed + 1 : data;
+                if(empty && !lifo.empty() && !handlers.empty())
+                {
+                    auto it = handlers.find(data);
+                    if(it != handlers.end() && it->second(lifo.top(), vlc_reader))
+                        break;
+                }
                 auto name = std::make_unique<std::string>(data);
                 Node *node = new (std::nothrow) Node(std::move(name), ptr);
                 if(node)
@@ -30,6 +30,9 @@
 
 #include "Node.h"
 
+#include <functional>
+#include <map>
+
 namespace adaptive
 {
     namespace xml
@@ -37,6 +40,11 @@ namespace adaptive
         class DOMParser
         {
             public:
+                /* Takes empty elements out of the tree: returns false to let
+                 * the node be built instead, without reading any attribute */
+                using ElementHandler = std::function<bool(const Node *parent,
+                                                          xml_reader_t *)>;
+
                 DOMParser           ();
                 DOMParser           (stream_t *stream);
                 virtual ~DOMParser  ();
@@ -44,6 +52,9 @@ namespace adaptive
                 bool                parse       (bool);
                 bool                reset       (stream_t *);
                 Node*               getRootNode ();
+                Node*               releaseRootNode();
+                void                setElementHandler(const std::string &,
+                                                      ElementHandler);
                 void                print       ();
 
             private:
@@ -52,6 +63,7 @@ namespace adaptive
                 stream_t            *stream;
 
                 xml_reader_t        *vlc_reader;
+                std::map<std::string, ElementHandler> handlers;
 
                 Node*   processNode             (bool);
                 void    addAttributesToNode     (Node *node);
@@ -59,6 +59,20 @@ void                                Node::addSubNode            (Node *node)
 {
     this->subNodes.push_back(node);
 }
+void                                Node::insertSubNode         (size_t pos, Node *node)
+{
+    pos = std::min(pos, this->subNodes.size());
+    this->subNodes.insert(this->subNodes.begin() + pos, node);
+}
+Node *                              Node::detachSubNode         (const Node *node)
+{
+    auto it = std::find(this->subNodes.begin(), this->subNodes.end(), node);
+    if(it == this->subNodes.end())
+        return nullptr;
+    Node *detached = *it;
+    this->subNodes.erase(it);
+    return detached;
+}
 const std::string&                  Node::getName               () const
 {
     return *name;
@@ -71,6 +85,11 @@ const std::string & Node::getNamespace() const
     return EmptyString;
 }
 
+void Node::setNamespace(Namespaces::Ptr ns)
+{
+    this->ns = ns;
+}
+
 bool Node::hasAttribute(const std::string& name) const
 {
     return hasAttribute(name, EmptyString);
@@ -108,6 +127,28 @@ void Node::addAttribute(const std::string& key, Namespaces::Ptr ns, const std::s
     attributes.push_back(std::move(attr));
 }
 
+void Node::setAttribute(const std::string& key, Namespaces::Ptr ns, const std::string& value)
+{
+    auto it = std::find_if(attributes.begin(),attributes.end(),
+                           [key](const class Attribute &a)
+                                {return a.name == key;});
+    if(it != attributes.end())
+        (*it).value = value;
+    else
+        addAttribute(key, ns, value);
+}
+
+bool Node::removeAttribute(const std::string& key)
+{
+    auto it = std::find_if(attributes.begin(),attributes.end(),
+                           [key](const class Attribute &a)
+                                {return a.name == key;});
+    if(it == attributes.end())
+        return false;
+    attributes.erase(it);
+    return true;
+}
+
 const std::string&                         Node::getText               () const
 {
     return text;
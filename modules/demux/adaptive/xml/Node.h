@@ -54,11 +54,16 @@ namespace adaptive
 
                 const std::vector<Node *>&          getSubNodes         () const;
                 void                                addSubNode          (Node *node);
+                void                                insertSubNode       (size_t pos, Node *node);
+                Node *                              detachSubNode       (const Node *node);
                 const std::string&                  getName             () const;
                 const std::string&                  getNamespace        () const;
+                void                                setNamespace        (Namespaces::Ptr);
                 bool                                hasAttribute        (const std::string& key) const;
                 bool                                hasAttribute        (const std::string& key, const std::string &ns) const;
                 void                                addAttribute        (const std::string& key, Namespaces::Ptr, const std::string& value);
+                void                                setAttribute        (const std::string& key, Namespaces::Ptr, const std::string& value);
+                bool                                removeAttribute     (const std::string& key);
                 const std::string&                  getAttributeValue   (const std::string& key) const;
                 const std::string&                  getAttributeValue   (const std::string& key, const std::string &ns) const;
                 const std::string&                  getText             () const;
@@ -196,6 +196,7 @@ typedef struct
     bool  b_seekable;
     bool  b_fastseekable;
     bool  b_indexloaded; /* if we read indexes from end of file before starting */
+    bool  b_trick_play; /* only read the video keyframes */
     vlc_tick_t i_read_increment;
     uint32_t i_avih_flags;
     avi_chunk_t ck_root;
@@ -1348,6 +1349,20 @@ static int Demux_Seekable( demux_t *p_demux )
         /* Set the track to use */
         avi_track_t *tk = p_sys->track[i_track];
 
+        /* In trick-play, skip the video chunks that are not keyframes
+         * without reading them */
+        if( p_sys->b_trick_play && tk->fmt.i_cat == VIDEO_ES &&
+            !tk->i_samplesize &&
+            !( tk->idx.p_entry[tk->i_idxposc].i_flags & AVIIF_KEYFRAME ) )
+        {
+            tk->i_idxposc++;
+            tk->demuxctx.i_toread--;
+            tk->demuxctx.i_posf = tk->i_idxposc < tk->idx.i_size
+                                ? (int64_t)tk->idx.p_entry[tk->i_idxposc].i_pos
+                                : -1;
+            continue;
+        }
+
         size_t i_size;
         unsigned i_ck_remaining_bytes = tk->idx.p_entry[tk->i_idxposc].i_length -
                                         tk->i_idxposb;
@@ -1882,6 +1897,10 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             return VLC_SUCCESS;
         }
 
+        case DEMUX_SET_TRICK_PLAY:
+            p_sys->b_trick_play = (bool)va_arg( args, int );
+            return VLC_SUCCESS;
+
         case DEMUX_CAN_PAUSE:
         case DEMUX_SET_PAUSE_STATE:
         case DEMUX_CAN_CONTROL_PACE:
@@ -31,6 +31,7 @@
 #include "DASHManager.h"
 #include "mpd/ProgramInformation.h"
 #include "mpd/IsoffMainParser.h"
+#include "mpd/MPDPatch.hpp"
 #include "../adaptive/xml/DOMParser.h"
 #include "../adaptive/xml/Node.h"
 #include "../adaptive/SharedResources.hpp"
@@ -40,6 +41,7 @@
 #include <vlc_demux.h>
 #include <vlc_meta.h>
 #include <vlc_block.h>
+#include <vlc_url.h>
 #include "../adaptive/tools/Retrieve.hpp"
 
 #include <algorithm>
@@ -53,13 +55,16 @@ DASHManager::DASHManager(demux_t *demux_,
                          SharedResources *res,
                          MPD *mpd,
                          AbstractStreamFactory *factory,
-                         AbstractAdaptationLogic::LogicType type) :
+                         AbstractAdaptationLogic::LogicType type,
+                         xml::Node *root) :
              PlaylistManager(demux_, res, mpd, factory, type)
 {
+    mpdRoot = root;
 }
 
 DASHManager::~DASHManager   ()
 {
+    delete mpdRoot;
 }
 
 void DASHManager::scheduleNextUpdate()
@@ -91,42 +96,133 @@ bool DASHManager::updatePlaylist()
     /* do update */
     if(nextPlaylistupdate)
     {
-        std::string url(p_demux->psz_url);
+        MPD *mpd = dynamic_cast<MPD *>(playlist);
+        if(mpd && mpdRoot && patchPlaylist(mpd))
+            return true;
 
-        block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, url);
-        if(!p_block)
-            return false;
+        delete mpdRoot;
+        mpdRoot = nullptr;
+        return fetchPlaylist();
+    }
 
-        stream_t *mpdstream = vlc_stream_MemoryNew(p_demux, p_block->p_buffer, p_block->i_buffer, true);
-        if(!mpdstream)
-        {
-            block_Release(p_block);
-            return false;
-        }
+    return true;
+}
 
-        xml::DOMParser parser(mpdstream);
-        if(!parser.parse(true))
-        {
-            vlc_stream_Delete(mpdstream);
-            block_Release(p_block);
-            return false;
-        }
+bool DASHManager::fetchPlaylist()
+{
+    std::string url(p_demux->psz_url);
 
-        IsoffMainParser mpdparser(parser.getRootNode(), VLC_OBJECT(p_demux),
-                                  mpdstream, Helper::getDirectoryPath(url).append("/"));
-        MPD *newmpd = mpdparser.parse();
-        if(newmpd)
-        {
-            playlist->updateWith(newmpd);
-            delete newmpd;
-        }
+    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, url);
+    if(!p_block)
+        return false;
+
+    stream_t *mpdstream = vlc_stream_MemoryNew(p_demux, p_block->p_buffer, p_block->i_buffer, true);
+    if(!mpdstream)
+    {
+        block_Release(p_block);
+        return false;
+    }
+
+    /* Patches need the whole document, timelines included */
+    bool b_patchable = isPatchable(p_block->p_buffer, p_block->i_buffer);
+
+    TimelineCollector timelines;
+    xml::DOMParser parser(mpdstream);
+    if(!b_patchable)
+        timelines.attach(parser);
+    if(!parser.parse(true))
+    {
         vlc_stream_Delete(mpdstream);
         block_Release(p_block);
+        return false;
     }
 
+    IsoffMainParser mpdparser(parser.getRootNode(), VLC_OBJECT(p_demux),
+                              mpdstream, Helper::getDirectoryPath(url).append("/"),
+                              b_patchable ? nullptr : &timelines);
+    MPD *newmpd = mpdparser.parse();
+    if(newmpd)
+    {
+        if(b_patchable)
+            mpdRoot = parser.releaseRootNode();
+        mergePlaylist(newmpd);
+    }
+    vlc_stream_Delete(mpdstream);
+    block_Release(p_block);
+
     return true;
 }
 
+bool DASHManager::patchPlaylist(MPD *mpd)
+{
+    if(mpd->patchLocation.empty())
+        return false;
+
+    /* The location is only valid for ttl after the publication */
+    if(mpd->patchLocationTTL &&
+       mpd->publishTime + mpd->patchLocationTTL < vlc_tick_from_sec(time(nullptr)))
+        return false;
+
+    char *psz_url = vlc_uri_resolve(p_demux->psz_url, mpd->patchLocation.c_str());
+    if(!psz_url)
+        return false;
+    std::string url(psz_url);
+    free(psz_url);
+
+    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, url);
+    if(!p_block)
+        return false;
+
+    stream_t *patchstream = vlc_stream_MemoryNew(p_demux, p_block->p_buffer, p_block->i_buffer, true);
+    if(!patchstream)
+    {
+        block_Release(p_block);
+        return false;
+    }
+
+    MPD *newmpd = nullptr;
+    xml::DOMParser parser(patchstream);
+    if(parser.parse(true))
+    {
+        MPDPatch patch(parser.getRootNode());
+        if(patch.appliesTo(mpd->mpdId, mpd->publishTime) && patch.apply(mpdRoot))
+        {
+            IsoffMainParser mpdparser(mpdRoot, VLC_OBJECT(p_demux), patchstream,
+                                      Helper::getDirectoryPath(p_demux->psz_url).append("/"));
+            newmpd = mpdparser.parse();
+        }
+        else msg_Dbg(p_demux, "Cannot apply MPD patch, refetching MPD");
+    }
+    vlc_stream_Delete(patchstream);
+    block_Release(p_block);
+
+    if(!newmpd)
+        return false;
+
+    mergePlaylist(newmpd);
+    return true;
+}
+
+void DASHManager::mergePlaylist(MPD *newmpd)
+{
+    playlist->updateWith(newmpd);
+
+    MPD *mpd = dynamic_cast<MPD *>(playlist);
+    if(mpd)
+    {
+        mpd->mpdId = newmpd->mpdId;
+        mpd->publishTime = newmpd->publishTime;
+        mpd->patchLocation = newmpd->patchLocation;
+        mpd->patchLocationTTL = newmpd->patchLocationTTL;
+    }
+    if(newmpd->patchLocation.empty())
+    {
+        delete mpdRoot;
+        mpdRoot = nullptr;
+    }
+    delete newmpd;
+}
+
 int DASHManager::doControl(int i_query, va_list args)
 {
     switch (i_query)
@@ -185,3 +281,10 @@ bool DASHManager::mimeMatched(const std::string &mime)
 {
     return (mime == "application/dash+xml");
 }
+
+bool DASHManager::isPatchable(const uint8_t *data, size_t size)
+{
+    static const char patchTag[] = "PatchLocation";
+    const uint8_t *end = data + size;
+    return std::search(data, end, patchTag, patchTag + sizeof(patchTag) - 1) != end;
+}
@@ -48,7 +48,8 @@ namespace dash
                          SharedResources *,
                          mpd::MPD *mpd,
                          AbstractStreamFactory *,
-                         logic::AbstractAdaptationLogic::LogicType type);
+                         logic::AbstractAdaptationLogic::LogicType type,
+                         xml::Node * = nullptr);
             virtual ~DASHManager    ();
 
             bool needsUpdate() const override;
@@ -56,9 +57,16 @@ namespace dash
             void scheduleNextUpdate() override;
             static bool isDASH(xml::Node *);
             static bool mimeMatched(const std::string &);
+            static bool isPatchable(const uint8_t *, size_t);
 
         protected:
             int doControl(int, va_list) override;
+
+        private:
+            bool fetchPlaylist();
+            bool patchPlaylist(mpd::MPD *);
+            void mergePlaylist(mpd::MPD *);
+            xml::Node *mpdRoot; /* patchable document */
     };
 
 }
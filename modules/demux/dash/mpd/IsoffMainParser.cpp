@@ -43,21 +43,65 @@
 #include "../../adaptive/tools/Helper.h"
 #include "../../adaptive/tools/Debug.hpp"
 #include "../../adaptive/tools/Conversions.hpp"
+#include "../../adaptive/xml/DOMParser.h"
 #include <vlc_stream.h>
+#include <vlc_xml.h>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 using namespace dash::mpd;
 using namespace adaptive::xml;
 using namespace adaptive::playlist;
 
+void TimelineCollector::attach(DOMParser &parser)
+{
+    parser.setElementHandler("S", [this](const Node *parent, xml_reader_t *reader)
+    {
+        if(parent->getName() != "SegmentTimeline")
+            return false;
+
+        Element e = {0, 0, 0, false};
+        bool hasDuration = false;
+        const char *name, *value;
+        while((name = xml_ReaderNextAttr(reader, &value)) != nullptr)
+        {
+            if(!std::strcmp(name, "t"))
+            {
+                e.t = Integer<stime_t>(value);
+                e.hasTime = true;
+            }
+            else if(!std::strcmp(name, "d"))
+            {
+                e.d = Integer<stime_t>(value);
+                hasDuration = true;
+            }
+            else if(!std::strcmp(name, "r"))
+            {
+                e.r = Integer<int64_t>(value);
+            }
+        }
+        if(hasDuration) /* Mandatory */
+            timelines[parent].push_back(e);
+        return true;
+    });
+}
+
+const TimelineCollector::Elements * TimelineCollector::get(const Node *node) const
+{
+    auto it = timelines.find(node);
+    return (it != timelines.end()) ? &it->second : nullptr;
+}
+
 IsoffMainParser::IsoffMainParser    (Node *root_, vlc_object_t *p_object_,
-                                     stream_t *stream, const std::string & streambaseurl_)
+                                     stream_t *stream, const std::string & streambaseurl_,
+                                     const TimelineCollector *timelines_)
 {
     root = root_;
     p_stream = stream;
     p_object = p_object_;
     playlisturl = streambaseurl_;
+    timelines = timelines_;
 }
 
 IsoffMainParser::~IsoffMainParser   ()
@@ -98,6 +142,7 @@ MPD * IsoffMainParser::parse()
     {
         parseMPDAttributes(mpd, root);
         parseProgramInformation(DOMHelper::getFirstChildElementByName(root, "ProgramInformation", getDASHNamespace()), mpd);
+        parsePatchLocation(DOMHelper::getFirstChildElementByName(root, "PatchLocation", getDASHNamespace()), mpd);
         parseMPDBaseUrl(mpd, root);
         parsePeriods(mpd, root);
         mpd->addAttribute(new StartnumberAttr(1));
@@ -153,6 +198,14 @@ void    IsoffMainParser::parseMPDAttributes   (MPD *mpd, xml::Node *node)
         {
             mpd->suggestedPresentationDelay = IsoTime(attr.value);
         }
+        else if(attr.name == "id")
+        {
+            mpd->mpdId = attr.value;
+        }
+        else if(attr.name == "publishTime")
+        {
+            mpd->publishTime = UTCTime(attr.value);
+        }
     }
 }
 
@@ -524,30 +577,42 @@ void IsoffMainParser::parseTimeline(Node *node, AbstractMultipleSegmentBaseType
     SegmentTimeline *timeline = new (std::nothrow) SegmentTimeline(base);
     if(timeline)
     {
-        std::vector<Node *> elements = DOMHelper::getElementByTagName(node, "S", getDASHNamespace(), false);
-        std::vector<Node *>::const_iterator it;
-        for(it = elements.begin(); it != elements.end(); ++it)
+        auto addElement = [&](const TimelineCollector::Element &e)
         {
-            const Node *s = *it;
-            if(!s->hasAttribute("d")) /* Mandatory */
-                continue;
-            stime_t d = Integer<stime_t>(s->getAttributeValue("d"));
-            int64_t r = 0; // never repeats by default
-            if(s->hasAttribute("r"))
-            {
-                r = Integer<int64_t>(s->getAttributeValue("r"));
-                if(r < 0)
-                    r = std::numeric_limits<unsigned>::max();
-            }
+            int64_t r = e.r; // never repeats by default
+            if(r < 0)
+                r = std::numeric_limits<unsigned>::max();
+            if(e.hasTime)
+                timeline->addElement(number, e.d, r, e.t);
+            else
+                timeline->addElement(number, e.d, r);
+            number += (1 + r);
+        };
 
-            if(s->hasAttribute("t"))
+        const TimelineCollector::Elements *streamed = timelines ? timelines->get(node) : nullptr;
+        if(streamed)
+        {
+            for(const TimelineCollector::Element &e : *streamed)
+                addElement(e);
+        }
+        else
+        {
+            std::vector<Node *> elements = DOMHelper::getElementByTagName(node, "S", getDASHNamespace(), false);
+            for(const Node *s : elements)
             {
-                stime_t t = Integer<stime_t>(s->getAttributeValue("t"));
-                timeline->addElement(number, d, r, t);
+                if(!s->hasAttribute("d")) /* Mandatory */
+                    continue;
+                TimelineCollector::Element e = {0, 0, 0, false};
+                e.d = Integer<stime_t>(s->getAttributeValue("d"));
+                if(s->hasAttribute("r"))
+                    e.r = Integer<int64_t>(s->getAttributeValue("r"));
+                if(s->hasAttribute("t"))
+                {
+                    e.t = Integer<stime_t>(s->getAttributeValue("t"));
+                    e.hasTime = true;
+                }
+                addElement(e);
             }
-            else timeline->addElement(number, d, r);
-
-            number += (1 + r);
         }
         //base->setSegmentTimeline(timeline);
         base->addAttribute(timeline);
@@ -581,6 +646,16 @@ void IsoffMainParser::parseProgramInformation(Node * node, MPD *mpd)
     }
 }
 
+void IsoffMainParser::parsePatchLocation(Node *node, MPD *mpd)
+{
+    if(!node || node->getText().empty())
+        return;
+
+    mpd->patchLocation = node->getText();
+    if(node->hasAttribute("ttl"))
+        mpd->patchLocationTTL = vlc_tick_from_sec(Integer<double>(node->getAttributeValue("ttl")));
+}
+
 Profile IsoffMainParser::getProfile() const
 {
     Profile res(Profile::Name::Unknown);
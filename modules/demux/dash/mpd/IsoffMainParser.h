@@ -30,9 +30,12 @@
 #endif
 
 #include "../../adaptive/playlist/SegmentBaseType.hpp"
+#include "../../adaptive/Time.hpp"
 #include "Profile.hpp"
 
 #include <cstdlib>
+#include <unordered_map>
+#include <vector>
 
 #include <vlc_common.h>
 
@@ -48,6 +51,7 @@ namespace adaptive
     namespace xml
     {
         class Node;
+        class DOMParser;
     }
 }
 
@@ -63,11 +67,33 @@ namespace dash
 
         static const std::string NS_DASH("urn:mpeg:dash:schema:mpd:2011");
 
+        /* Collects the SegmentTimeline S entries straight from the reader
+         * events, instead of building one DOM node per segment */
+        class TimelineCollector
+        {
+            public:
+                struct Element
+                {
+                    stime_t t;
+                    stime_t d;
+                    int64_t r;
+                    bool    hasTime;
+                };
+                using Elements = std::vector<Element>;
+
+                void            attach(xml::DOMParser &);
+                const Elements *get(const xml::Node *) const;
+
+            private:
+                std::unordered_map<const xml::Node *, Elements> timelines;
+        };
+
         class IsoffMainParser
         {
             public:
                 IsoffMainParser             (xml::Node *root, vlc_object_t *p_object,
-                                             stream_t *p_stream, const std::string &);
+                                             stream_t *p_stream, const std::string &,
+                                             const TimelineCollector * = nullptr);
                 virtual ~IsoffMainParser    ();
                 MPD *   parse();
 
@@ -86,6 +112,7 @@ namespace dash
                 size_t  parseSegmentList    (MPD *, xml::Node *, SegmentInformation *);
                 size_t  parseSegmentTemplate(MPD *, xml::Node *, SegmentInformation *);
                 void    parseProgramInformation(xml::Node *, MPD *);
+                void    parsePatchLocation  (xml::Node *, MPD *);
                 void    parseSegmentBaseType(MPD *mpd, xml::Node *node,
                                              AbstractSegmentBaseType *base,
                                              SegmentInformation *parent);
@@ -98,6 +125,7 @@ namespace dash
                 vlc_object_t    *p_object;
                 stream_t        *p_stream;
                 std::string      playlisturl;
+                const TimelineCollector *timelines;
         };
     }
 }
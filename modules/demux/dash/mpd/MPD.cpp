@@ -41,6 +41,8 @@ MPD::MPD (vlc_object_t *p_object, Profile profile_) :
 {
     programInfo = nullptr;
     lowLatency = false;
+    publishTime = 0;
+    patchLocationTTL = 0;
 }
 
 MPD::~MPD()
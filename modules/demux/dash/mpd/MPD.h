@@ -53,6 +53,10 @@ namespace dash
                 void                            debug() const override;
 
                 ProgramInformation *            programInfo;
+                std::string                     mpdId;
+                vlc_tick_t                      publishTime;
+                std::string                     patchLocation;
+                vlc_tick_t                      patchLocationTTL;
 
             private:
                 Profile                             profile;
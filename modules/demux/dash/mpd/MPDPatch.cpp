@@ -0,0 +1,334 @@
+/*
+ * MPDPatch.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "MPDPatch.hpp"
+#include "../../adaptive/xml/Node.h"
+#include "../../adaptive/tools/Conversions.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace dash::mpd;
+using namespace adaptive::xml;
+
+namespace
+{
+    struct Step
+    {
+        std::string name;
+        std::vector<std::pair<std::string, std::string>> attributes;
+        size_t position;
+    };
+}
+
+static std::string unprefixed(const std::string &name)
+{
+    size_t pos = name.find(':');
+    return (pos == std::string::npos) ? name : name.substr(pos + 1);
+}
+
+/* Splits the path on the separators outside of predicates */
+static bool tokenize(const std::string &sel, std::vector<std::string> *steps)
+{
+    std::string step;
+    char quote = 0;
+    unsigned depth = 0;
+
+    for(char c : sel.substr(1))
+    {
+        if(quote)
+        {
+            if(c == quote)
+                quote = 0;
+        }
+        else if(c == '\'' || c == '"')
+            quote = c;
+        else if(c == '[')
+            depth++;
+        else if(c == ']')
+        {
+            if(depth-- == 0)
+                return false;
+        }
+        else if(c == '/' && depth == 0)
+        {
+            if(step.empty())
+                return false;
+            steps->push_back(step);
+            step.clear();
+            continue;
+        }
+        step += c;
+    }
+    if(quote || depth || step.empty())
+        return false;
+    steps->push_back(step);
+    return true;
+}
+
+static bool parseStep(const std::string &str, Step *step)
+{
+    size_t pos = str.find('[');
+    step->name = unprefixed(str.substr(0, pos));
+    step->position = 0;
+    if(step->name.empty())
+        return false;
+
+    while(pos != std::string::npos)
+    {
+        size_t end = str.find(']', pos);
+        if(end == std::string::npos)
+            return false;
+        std::string pred = str.substr(pos + 1, end - pos - 1);
+        if(!pred.empty() && pred[0] == '@')
+        {
+            size_t eq = pred.find('=');
+            if(eq == std::string::npos || eq + 2 >= pred.size() ||
+               (pred[eq + 1] != '\'' && pred[eq + 1] != '"') ||
+               pred.back() != pred[eq + 1])
+                return false;
+            step->attributes.emplace_back(unprefixed(pred.substr(1, eq - 1)),
+                                          pred.substr(eq + 2, pred.size() - eq - 3));
+        }
+        else
+        {
+            char *endptr;
+            unsigned long n = std::strtoul(pred.c_str(), &endptr, 10);
+            if(n == 0 || *endptr)
+                return false;
+            step->position = n;
+        }
+        /* predicates are only valid back to back */
+        pos = end + 1;
+        if(pos == str.size())
+            break;
+        if(str[pos] != '[')
+            return false;
+    }
+    return true;
+}
+
+static bool stepMatches(const Step &step, const Node *node)
+{
+    if(node->getName() != step.name)
+        return false;
+    for(const auto &attr : step.attributes)
+    {
+        if(!node->hasAttribute(attr.first) ||
+           node->getAttributeValue(attr.first) != attr.second)
+            return false;
+    }
+    return true;
+}
+
+static size_t indexOf(const Node *parent, const Node *node)
+{
+    const std::vector<Node *> &nodes = parent->getSubNodes();
+    return std::find(nodes.begin(), nodes.end(), node) - nodes.begin();
+}
+
+MPDPatch::MPDPatch(Node *root_)
+{
+    root = root_;
+}
+
+bool MPDPatch::isValid() const
+{
+    return root && root->getName() == "Patch" &&
+           root->hasAttribute("mpdId") &&
+           root->hasAttribute("originalPublishTime");
+}
+
+bool MPDPatch::appliesTo(const std::string &mpdId, vlc_tick_t publishTime) const
+{
+    return isValid() && !mpdId.empty() &&
+           root->getAttributeValue("mpdId") == mpdId &&
+           UTCTime(root->getAttributeValue("originalPublishTime")) == publishTime;
+}
+
+bool MPDPatch::select(Node *mpdRoot, const std::string &sel, Selection *selection) const
+{
+    std::vector<std::string> steps;
+    if(sel.empty() || sel[0] != '/' || !tokenize(sel, &steps))
+        return false;
+
+    selection->parent = nullptr;
+    selection->node = nullptr;
+    selection->attribute.clear();
+
+    for(size_t i = 0; i < steps.size(); i++)
+    {
+        if(steps[i][0] == '@')
+        {
+            /* Only the last step can target an attribute */
+            if(i == 0 || i + 1 != steps.size())
+                return false;
+            selection->attribute = unprefixed(steps[i].substr(1));
+            return !selection->attribute.empty();
+        }
+
+        Step step;
+        if(!parseStep(steps[i], &step))
+            return false;
+
+        Node *found = nullptr;
+        if(i == 0)
+        {
+            if(stepMatches(step, mpdRoot) && step.position < 2)
+                found = mpdRoot;
+        }
+        else
+        {
+            size_t count = 0;
+            for(Node *child : selection->node->getSubNodes())
+            {
+                if(!stepMatches(step, child))
+                    continue;
+                if(step.position == 0 || ++count == step.position)
+                {
+                    found = child;
+                    break;
+                }
+            }
+        }
+        if(!found)
+            return false;
+        selection->parent = selection->node;
+        selection->node = found;
+    }
+    return true;
+}
+
+void MPDPatch::adopt(Node *node) const
+{
+    /* Elements are carried in the patch namespace */
+    if(node->getNamespace() == root->getNamespace())
+        node->setNamespace(mpdNamespace);
+    for(Node *child : node->getSubNodes())
+        adopt(child);
+}
+
+bool MPDPatch::add(const Selection &sel, Node *op)
+{
+    if(!sel.attribute.empty())
+        return false;
+
+    if(op->hasAttribute("type"))
+    {
+        const std::string &type = op->getAttributeValue("type");
+        if(type.size() < 2 || type[0] != '@')
+            return false; /* no namespace declarations */
+        sel.node->setAttribute(unprefixed(type.substr(1)), attrNamespace, op->getText());
+        return true;
+    }
+
+    const std::string &pos = op->getAttributeValue("pos");
+    size_t index;
+    Node *target = sel.node;
+    if(pos.empty() || pos == "append")
+        index = target->getSubNodes().size();
+    else if(pos == "prepend")
+        index = 0;
+    else if(pos == "before" || pos == "after")
+    {
+        if(!sel.parent)
+            return false;
+        target = sel.parent;
+        index = indexOf(target, sel.node) + (pos == "after" ? 1 : 0);
+    }
+    else
+        return false;
+
+    const std::vector<Node *> nodes = op->getSubNodes();
+    if(nodes.empty())
+        return false;
+    for(Node *node : nodes)
+    {
+        op->detachSubNode(node);
+        adopt(node);
+        target->insertSubNode(index++, node);
+    }
+    return true;
+}
+
+bool MPDPatch::replace(const Selection &sel, Node *op)
+{
+    if(!sel.attribute.empty())
+    {
+        if(!sel.node->hasAttribute(sel.attribute))
+            return false;
+        sel.node->setAttribute(sel.attribute, attrNamespace, op->getText());
+        return true;
+    }
+
+    if(!sel.parent || op->getSubNodes().size() != 1)
+        return false;
+
+    Node *node = op->detachSubNode(op->getSubNodes().front());
+    adopt(node);
+    size_t index = indexOf(sel.parent, sel.node);
+    delete sel.parent->detachSubNode(sel.node);
+    sel.parent->insertSubNode(index, node);
+    return true;
+}
+
+bool MPDPatch::remove(const Selection &sel)
+{
+    if(!sel.attribute.empty())
+        return sel.node->removeAttribute(sel.attribute);
+
+    if(!sel.parent)
+        return false;
+    delete sel.parent->detachSubNode(sel.node);
+    return true;
+}
+
+bool MPDPatch::apply(Node *mpdRoot)
+{
+    if(!isValid() || !mpdRoot)
+        return false;
+
+    mpdNamespace = std::make_shared<Namespaces::Entry>(mpdRoot->getNamespace());
+    attrNamespace = std::make_shared<Namespaces::Entry>();
+
+    for(Node *op : root->getSubNodes())
+    {
+        Selection sel;
+        if(!select(mpdRoot, op->getAttributeValue("sel"), &sel))
+            return false;
+
+        bool b_ok;
+        if(op->getName() == "add")
+            b_ok = add(sel, op);
+        else if(op->getName() == "replace")
+            b_ok = replace(sel, op);
+        else if(op->getName() == "remove")
+            b_ok = remove(sel);
+        else
+            b_ok = false;
+        if(!b_ok)
+            return false;
+    }
+    return true;
+}
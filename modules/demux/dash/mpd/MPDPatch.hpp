@@ -0,0 +1,78 @@
+/*
+ * MPDPatch.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef MPDPATCH_HPP
+#define MPDPATCH_HPP
+
+#include "../../adaptive/xml/Namespaces.hpp"
+
+#include <vlc_common.h>
+#include <vlc_tick.h>
+
+#include <string>
+
+namespace adaptive
+{
+    namespace xml
+    {
+        class Node;
+    }
+}
+
+namespace dash
+{
+    namespace mpd
+    {
+        using namespace adaptive;
+
+        /* MPD Patch document (ISO/IEC 23009-1 5.15), applying the add,
+         * replace and remove operations of RFC 5261 to the MPD document.
+         * Selectors are limited to absolute paths of element names, with
+         * attribute value or position predicates, and a final attribute. */
+        class MPDPatch
+        {
+            public:
+                MPDPatch(xml::Node *);
+                bool isValid() const;
+                bool appliesTo(const std::string &mpdId, vlc_tick_t publishTime) const;
+                /* Moves the patch content into the document. The document is
+                 * left partially patched on failure and has to be dropped. */
+                bool apply(xml::Node *mpdRoot);
+
+            private:
+                struct Selection
+                {
+                    xml::Node *parent;
+                    xml::Node *node;
+                    std::string attribute;
+                };
+                bool select(xml::Node *, const std::string &, Selection *) const;
+                bool add(const Selection &, xml::Node *);
+                bool replace(const Selection &, xml::Node *);
+                bool remove(const Selection &);
+                void adopt(xml::Node *) const;
+
+                xml::Node *root;
+                xml::Namespaces::Ptr mpdNamespace;
+                xml::Namespaces::Ptr attrNamespace;
+        };
+    }
+}
+
+#endif // MPDPATCH_HPP
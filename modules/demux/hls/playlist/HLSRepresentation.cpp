@@ -43,6 +43,7 @@ HLSRepresentation::HLSRepresentation  ( BaseAdaptationSet *set ) :
     b_loaded = false;
     updateFailureCount = 0;
     lastUpdateTime = 0;
+    canSkipUntil = 0;
     targetDuration = 0;
     streamFormat = StreamFormat::Type::Unknown;
     channels = 0;
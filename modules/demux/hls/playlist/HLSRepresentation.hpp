@@ -69,6 +69,7 @@ namespace hls
                 bool b_loaded;
                 unsigned updateFailureCount;
                 vlc_tick_t lastUpdateTime;
+                vlc_tick_t canSkipUntil; /* delta updates, if non zero */
                 unsigned channels;
         };
     }
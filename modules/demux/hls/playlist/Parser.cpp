@@ -45,6 +45,7 @@
 #include <cctype>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 using namespace adaptive;
 using namespace adaptive::playlist;
@@ -223,25 +224,105 @@ void M3U8Parser::fillAdaptsetFromMediainfo(const AttributesTag *mediatag,
     }
 }
 
+/* Tells if every segment a delta playlist skipped is already known */
+static bool isDeltaMergeable(const std::list<Tag *> &tagslist,
+                             uint64_t knownFirst, uint64_t knownLast)
+{
+    uint64_t sequence = 0;
+    for(const Tag *tag : tagslist)
+    {
+        switch(tag->getType())
+        {
+            case SingleValueTag::EXTXMEDIASEQUENCE:
+                sequence = static_cast<const SingleValueTag *>(tag)->getValue().decimal();
+                break;
+            case SingleValueTag::URI:
+                sequence++;
+                break;
+            case AttributesTag::EXTXSKIP:
+            {
+                const Attribute *skipped = static_cast<const AttributesTag *>(tag)->
+                                               getAttributeByName("SKIPPED-SEGMENTS");
+                uint64_t count = skipped ? skipped->decimal() : 0;
+                if(count && (sequence < knownFirst || sequence + count - 1 > knownLast))
+                    return false;
+                sequence += count;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/* Sequence numbers of the segments a loaded representation already has */
+static bool getKnownSegments(const SegmentList *segmentList, uint64_t *first, uint64_t *last)
+{
+    if(!segmentList || segmentList->getSegments().empty())
+        return false;
+    *first = segmentList->getSegments().front()->getSequenceNumber();
+    *last = segmentList->getSegments().back()->getSequenceNumber();
+    return true;
+}
+
+bool M3U8Parser::appendSegmentsFromPlaylist(vlc_object_t *p_obj, HLSRepresentation *rep,
+                                            stream_t *stream, bool b_delta)
+{
+    /* Only the segments past the known ones need parsing */
+    uint64_t knownFirst = std::numeric_limits<uint64_t>::max();
+    uint64_t knownLast = std::numeric_limits<uint64_t>::max();
+    getKnownSegments(rep->b_loaded ? rep->inheritSegmentList() : nullptr,
+                     &knownFirst, &knownLast);
+
+    std::list<Tag *> tagslist = parseEntries(stream, knownFirst, knownLast);
+    if(b_delta && !isDeltaMergeable(tagslist, knownFirst, knownLast))
+    {
+        releaseTagsList(tagslist);
+        return false;
+    }
+
+    parseSegments(p_obj, rep, tagslist);
+    releaseTagsList(tagslist);
+    return true;
+}
+
 bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresentation *rep)
 {
-    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getPlaylistUrl().toString());
-    if(p_block)
+    /* The server can skip the older segments of a recent enough playlist */
+    uint64_t knownFirst, knownLast;
+    bool b_delta = getKnownSegments(rep->b_loaded ? rep->inheritSegmentList() : nullptr,
+                                    &knownFirst, &knownLast) &&
+                   rep->canSkipUntil > 0 &&
+                   vlc_tick_now() - rep->lastUpdateTime < rep->canSkipUntil / 2;
+
+    for(;;)
     {
+        std::string url = rep->getPlaylistUrl().toString();
+        if(b_delta)
+            url.append(url.find('?') == std::string::npos ? "?" : "&").append("_HLS_skip=YES");
+
+        block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, url);
+        if(!p_block)
+            return false;
+
         stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
         if(substream)
         {
-            std::list<Tag *> tagslist = parseEntries(substream);
+            bool b_merged = appendSegmentsFromPlaylist(p_obj, rep, substream, b_delta);
             vlc_stream_Delete(substream);
 
-            parseSegments(p_obj, rep, tagslist);
-
-            releaseTagsList(tagslist);
+            if(!b_merged)
+            {
+                msg_Dbg(p_obj, "delta playlist skips unknown segments, reloading");
+                block_Release(p_block);
+                b_delta = false;
+                continue;
+            }
         }
         block_Release(p_block);
         return true;
     }
-    return false;
 }
 
 static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
@@ -290,6 +371,7 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
 
     rep->b_loaded = true;
     rep->b_live = !b_vod;
+    rep->canSkipUntil = 0;
 
     vlc_tick_t totalduration = 0;
     vlc_tick_t nzStartTime = 0;
@@ -301,6 +383,7 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     const SingleValueTag *ctx_byterange = nullptr;
     CommonEncryption encryption;
     const ValuesListTag *ctx_extinf = nullptr;
+    bool b_delta = false;
 
     std::list<HLSSegment *> segmentstoappend;
 
@@ -446,6 +529,35 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                 discontinuitySequence++;
                 break;
 
+            case AttributesTag::EXTXSERVERCONTROL:
+            {
+                const Attribute *skipAttr = static_cast<const AttributesTag *>(tag)->
+                                                getAttributeByName("CAN-SKIP-UNTIL");
+                rep->canSkipUntil = skipAttr ? vlc_tick_from_sec(skipAttr->floatingPoint()) : 0;
+            }
+            break;
+
+            case AttributesTag::EXTXSKIP:
+            {
+                /* Segments left out by the server or by parseEntries(), all
+                 * already known: only the window start and numbering matter */
+                const Attribute *skipAttr = static_cast<const AttributesTag *>(tag)->
+                                                getAttributeByName("SKIPPED-SEGMENTS");
+                if(!skipAttr)
+                    break;
+                if(!b_delta)
+                {
+                    segmentList->setDeltaStart(sequenceNumber);
+                    b_delta = true;
+                }
+                sequenceNumber += skipAttr->decimal();
+                ctx_extinf = nullptr;
+                ctx_byterange = nullptr;
+                discontinuity = false;
+                absReferenceTime = VLC_TICK_INVALID;
+            }
+            break;
+
             case Tag::EXTXENDLIST:
                 break;
         }
@@ -465,6 +577,15 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     }
 
     rep->updateSegmentList(segmentList, true);
+
+    /* A delta only accounted the duration of its new segments */
+    if(b_delta && !rep->isLive())
+    {
+        const SegmentList *merged = rep->inheritSegmentList();
+        vlc_tick_t mergedduration = timescale.ToTime(merged->getTotalLength());
+        if(mergedduration > rep->getPlaylist()->duration)
+            rep->getPlaylist()->duration = mergedduration;
+    }
 }
 M3U8 * M3U8Parser::parse(vlc_object_t *p_object, stream_t *p_stream, const std::string &playlisturl)
 {
@@ -805,38 +926,102 @@ M3U8 * M3U8Parser::parse(vlc_object_t *p_object, stream_t *p_stream, const std::
     return playlist;
 }
 
-std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
+std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream, uint64_t knownFirst,
+                                          uint64_t knownLast)
 {
     std::list<Tag *> entrieslist;
     Tag *lastTag = nullptr;
     char *psz_line;
 
+    /* Segments up to knownLast are collapsed into EXT-X-SKIP tags, the
+     * way a delta playlist does, sparing their tags allocations */
+    bool b_skipping = knownLast != std::numeric_limits<uint64_t>::max();
+    bool b_sequence = false;
+    uint64_t sequence = 0; /* of the next segment */
+    uint64_t skipped = 0;
+    /* tags of the known segment being collapsed, until its URI */
+    std::vector<std::string> held;
+
+    auto flushSkipped = [&]()
+    {
+        if(!skipped)
+            return;
+        Tag *tag = TagFactory::createTagByName("EXT-X-SKIP",
+                                               "SKIPPED-SEGMENTS=" + std::to_string(skipped));
+        if(tag)
+            entrieslist.push_back(tag);
+        skipped = 0;
+    };
+
+    auto addTag = [&](const char *line)
+    {
+        std::string key;
+        std::string attributes;
+        const char *split = strchr(line, ':');
+        if(split)
+        {
+            key = std::string(line + 1, split - line - 1);
+            attributes = std::string(split + 1);
+        }
+        else
+        {
+            key = std::string(line + 1);
+        }
+
+        if(key.empty())
+            return;
+
+        Tag *tag = TagFactory::createTagByName(key, attributes);
+        if(tag)
+        {
+            flushSkipped();
+            entrieslist.push_back(tag);
+
+            if(tag->getType() == SingleValueTag::EXTXMEDIASEQUENCE)
+            {
+                sequence = static_cast<SingleValueTag *>(tag)->getValue().decimal();
+                b_sequence = true;
+                /* restarted or jumped past what we know */
+                if(sequence < knownFirst || sequence > knownLast)
+                    b_skipping = false;
+            }
+            else if(tag->getType() == AttributesTag::EXTXSKIP)
+            {
+                const Attribute *skipAttr = static_cast<AttributesTag *>(tag)->
+                                                getAttributeByName("SKIPPED-SEGMENTS");
+                if(skipAttr)
+                    sequence += skipAttr->decimal();
+            }
+        }
+        lastTag = tag;
+    };
+
     while((psz_line = vlc_stream_ReadLine(stream)))
     {
+        const bool b_known = b_skipping && b_sequence && sequence <= knownLast;
+
         if(*psz_line == '#')
         {
             if(!strncmp(psz_line, "#EXT", 4)) //tag
             {
-                std::string key;
-                std::string attributes;
-                const char *split = strchr(psz_line, ':');
-                if(split)
+                if(b_known && (!strncmp(psz_line, "#EXTINF:", 8) ||
+                               !strncmp(psz_line, "#EXT-X-PROGRAM-DATE-TIME:", 25)))
                 {
-                    key = std::string(psz_line + 1, split - psz_line - 1);
-                    attributes = std::string(split + 1);
+                    held.emplace_back(psz_line);
+                    free(psz_line);
+                    continue;
                 }
-                else
+                if(b_skipping && !strncmp(psz_line, "#EXT-X-BYTERANGE:", 17))
                 {
-                    key = std::string(psz_line + 1);
+                    /* offsets can depend on previous segments: parse
+                     * everything from there, including the held tags */
+                    b_skipping = false;
+                    for(const std::string &line : held)
+                        addTag(line.c_str());
+                    held.clear();
                 }
 
-                if(!key.empty())
-                {
-                    Tag *tag = TagFactory::createTagByName(key, attributes);
-                    if(tag)
-                        entrieslist.push_back(tag);
-                    lastTag = tag;
-                }
+                addTag(psz_line);
             }
         }
         else if(*psz_line)
@@ -850,12 +1035,19 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
                 if(uriAttr)
                     streaminftag->addAttribute(uriAttr);
             }
+            else if(b_known)
+            {
+                held.clear();
+                skipped++;
+            }
             else /* playlist tag, will take modifiers */
             {
+                flushSkipped();
                 Tag *tag = TagFactory::createTagByName("", std::string(psz_line));
                 if(tag)
                     entrieslist.push_back(tag);
             }
+            sequence++;
             lastTag = nullptr;
         }
         else // drop
@@ -866,5 +1058,7 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
         free(psz_line);
     }
 
+    flushSkipped();
+
     return entrieslist;
 }
@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <sstream>
 #include <list>
+#include <limits>
 
 #include <vlc_common.h>
 
@@ -59,6 +60,8 @@ namespace hls
 
                 M3U8 *             parse  (vlc_object_t *p_obj, stream_t *p_stream, const std::string &);
                 bool appendSegmentsFromPlaylistURI(vlc_object_t *, HLSRepresentation *);
+                bool appendSegmentsFromPlaylist(vlc_object_t *, HLSRepresentation *,
+                                                stream_t *, bool);
 
             private:
                 HLSRepresentation * createRepresentation(BaseAdaptationSet *, const AttributesTag *);
@@ -69,7 +72,9 @@ namespace hls
                 void fillAdaptsetFromMediainfo(const AttributesTag *, const std::string &,
                                                const std::string &, BaseAdaptationSet *);
                 void parseSegments(vlc_object_t *, HLSRepresentation *, const std::list<Tag *>&);
-                std::list<Tag *> parseEntries(stream_t *);
+                std::list<Tag *> parseEntries(stream_t *,
+                                              uint64_t = std::numeric_limits<uint64_t>::max(),
+                                              uint64_t = std::numeric_limits<uint64_t>::max());
                 adaptive::SharedResources *resources;
         };
     }
@@ -47,6 +47,7 @@ public:
         :demuxer(demux)
         ,b_seekable(false)
         ,b_fastseekable(false)
+        ,b_trick_play(false)
         ,i_pts(VLC_TICK_INVALID)
         ,i_pcr(VLC_TICK_INVALID)
         ,i_start_pts(VLC_TICK_0)
@@ -68,6 +69,7 @@ public:
     demux_t                 & demuxer;
     bool                    b_seekable;
     bool                    b_fastseekable;
+    bool                    b_trick_play; /* only output the video keyframes */
 
     vlc_tick_t              i_pts;
     vlc_tick_t              i_pcr;
@@ -485,6 +485,10 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
         case DEMUX_NAV_MENU:
             return p_sys->ev.SendEventNav( static_cast<demux_query_e>(i_query) );
 
+        case DEMUX_SET_TRICK_PLAY:
+            p_sys->b_trick_play = va_arg( args, int );
+            return VLC_SUCCESS;
+
         case DEMUX_CAN_PAUSE:
         case DEMUX_SET_PAUSE_STATE:
         case DEMUX_CAN_CONTROL_PACE:
@@ -883,6 +887,13 @@ static int Demux( demux_t *p_demux)
                 return VLC_DEMUXER_SUCCESS; // this block shall be ignored
             }
         }
+
+        if( p_sys->b_trick_play && track.fmt.i_cat == VIDEO_ES && !b_key_picture )
+        {
+            delete block;
+            delete additions;
+            return VLC_DEMUXER_SUCCESS; // only keyframes in trick-play
+        }
     }
 
     if (UpdatePCR( p_demux ) != VLC_SUCCESS)
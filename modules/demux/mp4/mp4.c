@@ -123,6 +123,7 @@ typedef struct
     bool         b_seekable;
     bool         b_fastseekable;
     bool         b_error;        /* unrecoverable */
+    bool         b_trick_play;   /* only read the video sync samples */
 
     bool            b_index_probed;     /* mFra sync points index */
     bool            b_fragments_probed; /* moof segments index created */
@@ -1621,6 +1622,26 @@ static uint64_t OverflowCheck( demux_t *p_demux, mp4_track_t *tk,
  *****************************************************************************
  * TODO check for newly selected track (ie audio upt to now )
  *****************************************************************************/
+static bool MP4_IsSyncSample( const MP4_Box_data_stss_t *p_stss,
+                              uint32_t i_sample )
+{
+    /* stss sample numbers are sorted, and start from 1 */
+    const uint32_t i_number = i_sample + 1;
+    uint32_t i_lo = 0, i_hi = p_stss->i_entry_count;
+
+    while( i_lo < i_hi )
+    {
+        const uint32_t i_mid = i_lo + (i_hi - i_lo) / 2;
+        if( p_stss->i_sample_number[i_mid] == i_number )
+            return true;
+        if( p_stss->i_sample_number[i_mid] < i_number )
+            i_lo = i_mid + 1;
+        else
+            i_hi = i_mid;
+    }
+    return false;
+}
+
 static int DemuxTrack( demux_t *p_demux, mp4_track_t *tk, uint64_t i_readpos,
                        vlc_tick_t i_max_preload )
 {
@@ -1634,6 +1655,13 @@ static int DemuxTrack( demux_t *p_demux, mp4_track_t *tk, uint64_t i_readpos,
     if( tk->i_use_flags & USEAS_CHAPTERS )
         return VLC_DEMUXER_SUCCESS;
 
+    /* In trick-play, the video samples that are not sync samples are
+     * skipped without being read. No stss means only sync samples. */
+    const MP4_Box_t *p_stss = NULL;
+    if( p_sys->b_trick_play && !p_sys->b_fragmented &&
+        tk->fmt.i_cat == VIDEO_ES && tk->p_stbl != NULL )
+        p_stss = MP4_BoxGet( tk->p_stbl, "stss" );
+
     uint32_t i_run_seq = MP4_TrackGetRunSeq( tk );
     vlc_tick_t i_current_nzpts;
     vlc_tick_t i_current_nzdts = MP4_TrackGetDTSPTS( p_demux, tk, &i_current_nzpts );
@@ -1653,6 +1681,10 @@ static int DemuxTrack( demux_t *p_demux, mp4_track_t *tk, uint64_t i_readpos,
 #endif
 
         i_samplessize = MP4_TrackGetReadSize( tk, &i_nb_samples );
+        if( p_stss != NULL && BOXDATA(p_stss) != NULL && i_nb_samples == 1 &&
+            !MP4_IsSyncSample( BOXDATA(p_stss), tk->i_sample ) )
+            i_samplessize = 0;
+
         if( i_samplessize > 0 )
         {
             block_t *p_block;
@@ -2445,6 +2477,10 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             }
             return demux_vaControlHelper( p_demux->s, 0, -1, 0, 1, i_query, args );
         }
+        case DEMUX_SET_TRICK_PLAY:
+            p_sys->b_trick_play = (bool)va_arg( args, int );
+            return VLC_SUCCESS;
+
         case DEMUX_SET_NEXT_DEMUX_TIME:
         case DEMUX_SET_GROUP_DEFAULT:
         case DEMUX_SET_GROUP_ALL:
@@ -0,0 +1,724 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*****************************************************************************
+ * frombinary.c: read vlc struct from binary messages
+ *****************************************************************************
+ * Copyright © 2026 VideoLAN and VLC authors
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <limits.h>
+#ifdef __linux__
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_es.h>
+#include <vlc_fs.h>
+#include <vlc_input_item.h>
+#include <vlc_picture.h>
+#include <vlc_preparser_ipc.h>
+#include <vlc_vector.h>
+
+#include "serializer.h"
+
+/* Sanity limit on the number of elements of arrays read from the peer */
+#define BIN_ARRAY_MAX (1 << 20)
+
+static size_t
+bin_ReadCount(struct serdes_sys *sys)
+{
+    uint64_t count = bin_ReadVarint(sys);
+    if (count > BIN_ARRAY_MAX) {
+        serdes_set_error(VLC_EGENERIC);
+        return 0;
+    }
+    return count;
+}
+
+static void
+fromBIN_audio_format(struct serdes_sys *sys, audio_format_t *a)
+{
+    a->i_format = bin_ReadU32(sys);
+    bin_read_uint(sys, a->i_rate);
+    bin_read_uint(sys, a->i_physical_channels);
+    bin_read_uint(sys, a->i_chan_mode);
+    bin_read_ranged(sys, a->channel_type, AUDIO_CHANNEL_TYPE_BITMAP,
+                    AUDIO_CHANNEL_TYPE_AMBISONICS);
+    bin_read_uint(sys, a->i_bytes_per_frame);
+    bin_read_uint(sys, a->i_frame_length);
+    bin_read_uint(sys, a->i_bitspersample);
+    bin_read_uint(sys, a->i_blockalign);
+    bin_read_uint(sys, a->i_channels);
+}
+
+static void
+fromBIN_audio_replay_gain(struct serdes_sys *sys, audio_replay_gain_t *ag)
+{
+    for (size_t i = 0; i < AUDIO_REPLAY_GAIN_MAX; i++) {
+        ag->pb_peak[i] = bin_ReadBool(sys);
+        ag->pf_peak[i] = bin_ReadDouble(sys);
+        ag->pb_gain[i] = bin_ReadBool(sys);
+        ag->pf_gain[i] = bin_ReadDouble(sys);
+    }
+}
+
+static void
+fromBIN_video_format(struct serdes_sys *sys, video_format_t *video)
+{
+    video_format_Init(video, bin_ReadU32(sys));
+    bin_read_uint(sys, video->i_width);
+    bin_read_uint(sys, video->i_height);
+    bin_read_uint(sys, video->i_x_offset);
+    bin_read_uint(sys, video->i_y_offset);
+    bin_read_uint(sys, video->i_visible_width);
+    bin_read_uint(sys, video->i_visible_height);
+    bin_read_uint(sys, video->i_sar_num);
+    bin_read_uint(sys, video->i_sar_den);
+    bin_read_uint(sys, video->i_frame_rate);
+    bin_read_uint(sys, video->i_frame_rate_base);
+
+    if (bin_ReadBool(sys) && sys->error == VLC_SUCCESS) {
+        video_palette_t *palette = malloc(sizeof(*palette));
+        if (palette == NULL) {
+            serdes_set_error(VLC_ENOMEM);
+            return;
+        }
+        bin_read_ranged(sys, palette->i_entries, 0, VIDEO_PALETTE_COLORS_MAX);
+        bin_Read(sys, palette->palette, sizeof(palette->palette));
+        video->p_palette = palette;
+    }
+
+    bin_read_ranged(sys, video->orientation, ORIENT_TOP_LEFT, ORIENT_MAX);
+    bin_read_ranged(sys, video->primaries, COLOR_PRIMARIES_UNDEF,
+                    COLOR_PRIMARIES_MAX);
+    bin_read_ranged(sys, video->transfer, TRANSFER_FUNC_UNDEF,
+                    TRANSFER_FUNC_MAX);
+    bin_read_ranged(sys, video->space, COLOR_SPACE_UNDEF, COLOR_SPACE_MAX);
+    bin_read_ranged(sys, video->color_range, COLOR_RANGE_UNDEF,
+                    COLOR_RANGE_MAX);
+    bin_read_ranged(sys, video->chroma_location, CHROMA_LOCATION_UNDEF,
+                    CHROMA_LOCATION_MAX);
+    bin_read_ranged(sys, video->multiview_mode, MULTIVIEW_2D,
+                    MULTIVIEW_STEREO_MAX);
+    video->b_multiview_right_eye_first = bin_ReadBool(sys);
+    bin_read_ranged(sys, video->projection_mode, PROJECTION_MODE_RECTANGULAR,
+                    PROJECTION_MODE_CUBEMAP_LAYOUT_STANDARD);
+
+    video->pose.yaw = bin_ReadDouble(sys);
+    video->pose.pitch = bin_ReadDouble(sys);
+    video->pose.roll = bin_ReadDouble(sys);
+    video->pose.fov = bin_ReadDouble(sys);
+
+    for (size_t i = 0; i < ARRAY_SIZE(video->mastering.primaries); i++) {
+        bin_read_uint(sys, video->mastering.primaries[i]);
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(video->mastering.white_point); i++) {
+        bin_read_uint(sys, video->mastering.white_point[i]);
+    }
+    bin_read_uint(sys, video->mastering.max_luminance);
+    bin_read_uint(sys, video->mastering.min_luminance);
+
+    bin_read_uint(sys, video->lighting.MaxCLL);
+    bin_read_uint(sys, video->lighting.MaxFALL);
+
+    bin_read_uint(sys, video->dovi.version_major);
+    bin_read_uint(sys, video->dovi.version_minor);
+    bin_read_ranged(sys, video->dovi.profile, 0, (1 << 7) - 1);
+    bin_read_ranged(sys, video->dovi.level, 0, (1 << 6) - 1);
+    bin_read_ranged(sys, video->dovi.rpu_present, 0, 1);
+    bin_read_ranged(sys, video->dovi.el_present, 0, 1);
+    bin_read_ranged(sys, video->dovi.bl_present, 0, 1);
+
+    bin_read_uint(sys, video->i_cubemap_padding);
+}
+
+static void
+fromBIN_subs_format(struct serdes_sys *sys, subs_format_t *subs)
+{
+    subs->psz_encoding = bin_ReadString(sys);
+    bin_read_int(sys, subs->i_x_origin);
+    bin_read_int(sys, subs->i_y_origin);
+
+    bin_read_uint(sys, subs->spu.i_original_frame_width);
+    bin_read_uint(sys, subs->spu.i_original_frame_height);
+    for (size_t i = 0; i < VIDEO_PALETTE_CLUT_COUNT; i++) {
+        bin_read_uint(sys, subs->spu.palette[i]);
+    }
+    subs->spu.b_palette = bin_ReadBool(sys);
+
+    bin_read_int(sys, subs->dvb.i_id);
+
+    bin_read_uint(sys, subs->teletext.i_magazine);
+    bin_read_uint(sys, subs->teletext.i_page);
+
+    bin_read_uint(sys, subs->cc.i_channel);
+    bin_read_int(sys, subs->cc.i_reorder_depth);
+}
+
+static void
+fromBIN_es_format(struct serdes_sys *sys, es_format_t *es)
+{
+    int cat = UNKNOWN_ES;
+    bin_read_ranged(sys, cat, UNKNOWN_ES, DATA_ES);
+    es_format_Init(es, cat, 0);
+    es->i_codec = bin_ReadU32(sys);
+    es->i_original_fourcc = bin_ReadU32(sys);
+    bin_read_ranged(sys, es->i_id, -1, INT_MAX);
+    bin_read_ranged(sys, es->i_group, -1, INT_MAX);
+    bin_read_ranged(sys, es->i_priority, -2, INT_MAX);
+    es->psz_language = bin_ReadString(sys);
+    es->psz_description = bin_ReadString(sys);
+
+    size_t count = bin_ReadCount(sys);
+    if (count != 0 && sys->error == VLC_SUCCESS) {
+        es->p_extra_languages = vlc_alloc(count,
+                                          sizeof(*es->p_extra_languages));
+        if (es->p_extra_languages == NULL) {
+            serdes_set_error(VLC_ENOMEM);
+            return;
+        }
+        es->i_extra_languages = count;
+        for (size_t i = 0; i < count; i++) {
+            es->p_extra_languages[i].psz_language = bin_ReadString(sys);
+            es->p_extra_languages[i].psz_description = bin_ReadString(sys);
+        }
+    }
+
+    switch (es->i_cat) {
+        case AUDIO_ES:
+            fromBIN_audio_format(sys, &es->audio);
+            fromBIN_audio_replay_gain(sys, &es->audio_replay_gain);
+            break;
+        case VIDEO_ES:
+            fromBIN_video_format(sys, &es->video);
+            break;
+        case SPU_ES:
+            fromBIN_subs_format(sys, &es->subs);
+            break;
+        default:
+            break;
+    }
+
+    bin_read_uint(sys, es->i_bitrate);
+    bin_read_int(sys, es->i_profile);
+    bin_read_int(sys, es->i_level);
+    es->b_packetized = bin_ReadBool(sys);
+}
+
+static void
+fromBIN_meta(struct serdes_sys *sys, vlc_meta_t *meta)
+{
+    size_t count = bin_ReadCount(sys);
+    for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        vlc_meta_type_t type = vlc_meta_Title;
+        vlc_meta_priority_t priority = VLC_META_PRIORITY_BASIC;
+        bin_read_ranged(sys, type, 0, VLC_META_TYPE_COUNT - 1);
+        bin_read_ranged(sys, priority, VLC_META_PRIORITY_BASIC,
+                        VLC_META_PRIORITY_INBAND);
+        char *value = bin_ReadString(sys);
+        if (sys->error == VLC_SUCCESS) {
+            vlc_meta_SetWithPriority(meta, type, value, priority);
+        }
+        free(value);
+    }
+
+    count = bin_ReadCount(sys);
+    for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        char *key = bin_ReadString(sys);
+        char *value = bin_ReadString(sys);
+        vlc_meta_priority_t priority = VLC_META_PRIORITY_BASIC;
+        bin_read_ranged(sys, priority, VLC_META_PRIORITY_BASIC,
+                        VLC_META_PRIORITY_INBAND);
+        if (key == NULL) {
+            serdes_set_error(VLC_EGENERIC);
+        }
+        if (sys->error == VLC_SUCCESS) {
+            vlc_meta_SetExtraWithPriority(meta, key, value, priority);
+        }
+        free(key);
+        free(value);
+    }
+}
+
+static input_item_t *
+fromBIN_input_item(struct serdes_sys *sys)
+{
+    if (!bin_ReadBool(sys) || sys->error != VLC_SUCCESS) {
+        return NULL;
+    }
+
+    input_item_t *item = input_item_New(NULL, NULL);
+    if (item == NULL) {
+        serdes_set_error(VLC_ENOMEM);
+        return NULL;
+    }
+
+    item->psz_name = bin_ReadString(sys);
+    item->psz_uri = bin_ReadString(sys);
+    bin_read_int(sys, item->i_duration);
+
+    vlc_vector_clear(&item->es_vec);
+    size_t count = bin_ReadCount(sys);
+    if (sys->error == VLC_SUCCESS
+     && !vlc_vector_reserve(&item->es_vec, count)) {
+        serdes_set_error(VLC_ENOMEM);
+    }
+    for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        struct input_item_es item_es;
+        fromBIN_es_format(sys, &item_es.es);
+        item_es.id = bin_ReadString(sys);
+        item_es.id_stable = bin_ReadBool(sys);
+        /* pushed even on error, to be released with the item */
+        vlc_vector_push(&item->es_vec, item_es);
+    }
+
+    if (bin_ReadBool(sys) && sys->error == VLC_SUCCESS) {
+        if (item->p_meta == NULL) {
+            item->p_meta = vlc_meta_New();
+        }
+        if (item->p_meta != NULL) {
+            fromBIN_meta(sys, item->p_meta);
+        } else {
+            serdes_set_error(VLC_ENOMEM);
+        }
+    }
+
+    count = bin_ReadCount(sys);
+    for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        enum slave_type type = SLAVE_TYPE_SPU;
+        enum slave_priority priority = SLAVE_PRIORITY_MATCH_NONE;
+        bin_read_ranged(sys, type, SLAVE_TYPE_SPU, SLAVE_TYPE_GENERIC);
+        bin_read_ranged(sys, priority, SLAVE_PRIORITY_MATCH_NONE,
+                        SLAVE_PRIORITY_USER);
+        bool forced = bin_ReadBool(sys);
+        char *uri = bin_ReadString(sys);
+        if (sys->error == VLC_SUCCESS) {
+            struct input_item_slave *slave =
+                input_item_slave_New(uri, type, priority);
+            if (slave == NULL
+             || input_item_AddSlave(item, slave) != VLC_SUCCESS) {
+                free(slave);
+                serdes_set_error(VLC_ENOMEM);
+            } else {
+                slave->b_forced = forced;
+            }
+        }
+        free(uri);
+    }
+
+    bin_read_ranged(sys, item->i_type, ITEM_TYPE_UNKNOWN,
+                    ITEM_TYPE_NUMBER - 1);
+    item->b_net = bin_ReadBool(sys);
+
+    if (sys->error != VLC_SUCCESS) {
+        input_item_Release(item);
+        return NULL;
+    }
+    return item;
+}
+
+static input_item_node_t *
+fromBIN_input_item_node(struct serdes_sys *sys)
+{
+    if (!bin_ReadBool(sys) || sys->error != VLC_SUCCESS) {
+        return NULL;
+    }
+
+    input_item_t *item = fromBIN_input_item(sys);
+    if (item == NULL) {
+        serdes_set_error(VLC_EGENERIC);
+        return NULL;
+    }
+    input_item_node_t *node = input_item_node_Create(item);
+    input_item_Release(item);
+    if (node == NULL) {
+        serdes_set_error(VLC_ENOMEM);
+        return NULL;
+    }
+
+    size_t count = bin_ReadCount(sys);
+    for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        input_item_node_t *child = fromBIN_input_item_node(sys);
+        if (child == NULL) {
+            serdes_set_error(VLC_EGENERIC);
+            break;
+        }
+        input_item_node_AppendNode(node, child);
+    }
+
+    if (sys->error != VLC_SUCCESS) {
+        input_item_node_Delete(node);
+        return NULL;
+    }
+    return node;
+}
+
+static input_attachment_t *
+fromBIN_input_attachment(struct serdes_sys *sys)
+{
+    char *name = bin_ReadString(sys);
+    char *mime = bin_ReadString(sys);
+    char *description = bin_ReadString(sys);
+    size_t size = 0;
+    bin_read_uint(sys, size);
+
+    input_attachment_t *a = NULL;
+    if (sys->error == VLC_SUCCESS) {
+        a = vlc_input_attachment_New(name, mime, description, NULL, 0);
+        if (a == NULL) {
+            serdes_set_error(VLC_ENOMEM);
+        }
+    }
+    free(name);
+    free(mime);
+    free(description);
+    if (a == NULL) {
+        return NULL;
+    }
+
+    void *data = size != 0 ? malloc(size) : NULL;
+    if (size != 0 && data == NULL) {
+        serdes_set_error(VLC_ENOMEM);
+        vlc_input_attachment_Release(a);
+        return NULL;
+    }
+    bin_Read(sys, data, size);
+    free(a->p_data);
+    a->p_data = data;
+    a->i_data = size;
+    if (sys->error != VLC_SUCCESS) {
+        vlc_input_attachment_Release(a);
+        return NULL;
+    }
+    return a;
+}
+
+#ifdef __linux__
+struct bin_shm_mapping {
+    void *base;
+    size_t size;
+};
+
+static void
+bin_shm_Destroy(picture_t *pic)
+{
+    struct bin_shm_mapping *map = pic->p_sys;
+    munmap(map->base, map->size);
+    free(map);
+}
+
+/**
+ * Map the pixels shared by the peer and wrap them in a picture.
+ *
+ * The memfd is always closed.
+ */
+static picture_t *
+fromBIN_MapPixels(const video_format_t *fmt, const plane_t *planes, int count,
+                  int memfd, size_t size)
+{
+    /* Without these seals, the peer could truncate the file under our
+     * mapping and crash us with SIGBUS. */
+    const int seals = F_SEAL_SHRINK | F_SEAL_WRITE;
+    int memfd_seals = fcntl(memfd, F_GET_SEALS);
+    struct stat st;
+    if (memfd_seals == -1 || (memfd_seals & seals) != seals
+     || fstat(memfd, &st) != 0 || (uint64_t)st.st_size != size) {
+        vlc_close(memfd);
+        return NULL;
+    }
+
+    /* Private, so that consumers writing in place don't fault */
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      memfd, 0);
+    vlc_close(memfd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    struct bin_shm_mapping *map = malloc(sizeof(*map));
+    if (map == NULL) {
+        munmap(base, size);
+        return NULL;
+    }
+    map->base = base;
+    map->size = size;
+
+    picture_resource_t res = {
+        .p_sys = map,
+        .pf_destroy = bin_shm_Destroy,
+    };
+    size_t offset = 0;
+    for (int i = 0; i < count; i++) {
+        res.p[i].p_pixels = (uint8_t *)base + offset;
+        res.p[i].i_lines = planes[i].i_lines;
+        res.p[i].i_pitch = planes[i].i_pitch;
+        offset += vlc_align((size_t)planes[i].i_pitch * planes[i].i_lines, 64);
+    }
+
+    picture_t *pic = picture_NewFromResource(fmt, &res);
+    if (pic == NULL) {
+        munmap(base, size);
+        free(map);
+    }
+    return pic;
+}
+#endif
+
+static picture_t *
+fromBIN_InlinePixels(struct serdes_sys *sys, const video_format_t *fmt,
+                     const plane_t *planes, int count)
+{
+    picture_t *pic = picture_NewFromFormat(fmt);
+    if (pic == NULL) {
+        serdes_set_error(VLC_ENOMEM);
+        return NULL;
+    }
+    if (pic->i_planes != count) {
+        serdes_set_error(VLC_EGENERIC);
+        picture_Release(pic);
+        return NULL;
+    }
+
+    for (int i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        const plane_t *src = &planes[i];
+        plane_t *dst = &pic->p[i];
+        size_t size = (size_t)src->i_pitch * src->i_lines;
+        if (dst->i_pitch == src->i_pitch && dst->i_lines == src->i_lines) {
+            /* Same layout, read directly in place */
+            bin_Read(sys, dst->p_pixels, size);
+            continue;
+        }
+        plane_t tmp = *src;
+        tmp.p_pixels = malloc(size);
+        if (tmp.p_pixels == NULL) {
+            serdes_set_error(VLC_ENOMEM);
+            break;
+        }
+        bin_Read(sys, tmp.p_pixels, size);
+        plane_CopyPixels(dst, &tmp);
+        free(tmp.p_pixels);
+    }
+
+    if (sys->error != VLC_SUCCESS) {
+        picture_Release(pic);
+        return NULL;
+    }
+    return pic;
+}
+
+static picture_t *
+fromBIN_picture(struct serdes_sys *sys)
+{
+    if (!bin_ReadBool(sys) || sys->error != VLC_SUCCESS) {
+        return NULL;
+    }
+
+    video_format_t fmt;
+    fromBIN_video_format(sys, &fmt);
+
+    plane_t planes[PICTURE_PLANE_MAX];
+    int count = 0;
+    bin_read_ranged(sys, count, 0, PICTURE_PLANE_MAX);
+    size_t total = 0;
+    for (int i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+        plane_t *p = &planes[i];
+        bin_read_ranged(sys, p->i_lines, 0, UINT16_MAX);
+        bin_read_ranged(sys, p->i_pitch, 0, UINT16_MAX * 16);
+        bin_read_int(sys, p->i_pixel_pitch);
+        bin_read_int(sys, p->i_visible_lines);
+        bin_read_int(sys, p->i_visible_pitch);
+        /* Checked before any copy, the pixels are read according to the
+         * visible area */
+        if (p->i_pixel_pitch <= 0
+         || p->i_visible_lines < 0 || p->i_visible_lines > p->i_lines
+         || p->i_visible_pitch < 0 || p->i_visible_pitch > p->i_pitch) {
+            serdes_set_error(VLC_EGENERIC);
+        }
+        total += vlc_align((size_t)p->i_pitch * p->i_lines, 64);
+    }
+
+    vlc_tick_t date = VLC_TICK_INVALID;
+    bin_read_int(sys, date);
+    bool force = bin_ReadBool(sys);
+    bool still = bin_ReadBool(sys);
+    bool progressive = bin_ReadBool(sys);
+    bool top_field_first = bin_ReadBool(sys);
+    bool multiview_left_eye = bin_ReadBool(sys);
+    unsigned nb_fields = 0;
+    bin_read_uint(sys, nb_fields);
+
+    int storage = BIN_PIXELS_INLINE;
+    bin_read_ranged(sys, storage, BIN_PIXELS_INLINE, BIN_PIXELS_SHM);
+
+    picture_t *pic = NULL;
+    if (sys->error != VLC_SUCCESS) {
+        /* nothing */
+    } else if (storage == BIN_PIXELS_SHM) {
+        uint64_t size = bin_ReadVarint(sys);
+        if (sys->error == VLC_SUCCESS && size != total) {
+            serdes_set_error(VLC_EGENERIC);
+        }
+        int fd = bin_ReadFd(sys);
+#ifdef __linux__
+        if (sys->error == VLC_SUCCESS) {
+            pic = fromBIN_MapPixels(&fmt, planes, count, fd, size);
+            fd = -1;
+        }
+#endif
+        if (fd != -1) {
+            vlc_close(fd);
+        }
+        if (pic == NULL) {
+            /* This response is lost, ask for inline pixels from now on */
+            sys->shm_enabled = false;
+            serdes_set_error(VLC_EGENERIC);
+        }
+    } else {
+        pic = fromBIN_InlinePixels(sys, &fmt, planes, count);
+    }
+    video_format_Clean(&fmt);
+
+    if (pic == NULL) {
+        return NULL;
+    }
+    if (pic->i_planes != count || nb_fields != pic->i_nb_fields) {
+        serdes_set_error(VLC_EGENERIC);
+    }
+    for (int i = 0; i < pic->i_planes && i < count; i++) {
+        const plane_t *p = &pic->p[i];
+        if (p->i_pixel_pitch != planes[i].i_pixel_pitch
+         || p->i_visible_lines != planes[i].i_visible_lines
+         || p->i_visible_pitch != planes[i].i_visible_pitch
+         || p->i_visible_lines > p->i_lines
+         || p->i_visible_pitch > p->i_pitch) {
+            serdes_set_error(VLC_EGENERIC);
+        }
+    }
+    if (sys->error != VLC_SUCCESS) {
+        picture_Release(pic);
+        return NULL;
+    }
+    pic->date = date;
+    pic->b_force = force;
+    pic->b_still = still;
+    pic->b_progressive = progressive;
+    pic->b_top_field_first = top_field_first;
+    pic->b_multiview_left_eye = multiview_left_eye;
+    return pic;
+}
+
+static void
+fromBIN_vlc_preparser_msg_req(struct serdes_sys *sys,
+                              struct vlc_preparser_msg_req *req)
+{
+    bin_read_uint(sys, sys->peer_flags);
+
+    if (req->type == VLC_PREPARSER_MSG_REQ_TYPE_PARSE) {
+        bin_read_int(sys, req->options);
+    } else {
+        if (req->type == VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL_TO_FILES) {
+            size_t count = bin_ReadCount(sys);
+            for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+                struct vlc_thumbnailer_output out;
+                bin_read_ranged(sys, out.format, VLC_THUMBNAILER_FORMAT_PNG,
+                                VLC_THUMBNAILER_FORMAT_JPEG);
+                bin_read_int(sys, out.width);
+                bin_read_int(sys, out.height);
+                out.crop = bin_ReadBool(sys);
+                char *path = bin_ReadString(sys);
+                bin_read_uint(sys, out.creat_mode);
+                if (sys->error != VLC_SUCCESS
+                 || !vlc_vector_push(&req->outputs_path, path)) {
+                    serdes_set_error(VLC_ENOMEM);
+                    free(path);
+                    break;
+                }
+                out.file_path = path;
+                if (!vlc_vector_push(&req->outputs, out)) {
+                    serdes_set_error(VLC_ENOMEM);
+                }
+            }
+        }
+        bin_read_ranged(sys, req->arg.seek.type, VLC_THUMBNAILER_SEEK_NONE,
+                        VLC_THUMBNAILER_SEEK_POS);
+        if (req->arg.seek.type == VLC_THUMBNAILER_SEEK_TIME) {
+            bin_read_int(sys, req->arg.seek.time);
+        } else if (req->arg.seek.type == VLC_THUMBNAILER_SEEK_POS) {
+            req->arg.seek.pos = bin_ReadDouble(sys);
+        }
+        bin_read_ranged(sys, req->arg.seek.speed, VLC_THUMBNAILER_SEEK_PRECISE,
+                        VLC_THUMBNAILER_SEEK_FAST);
+        req->arg.hw_dec = bin_ReadBool(sys);
+    }
+    req->uri = bin_ReadString(sys);
+}
+
+static void
+fromBIN_vlc_preparser_msg_res(struct serdes_sys *sys,
+                              struct vlc_preparser_msg_res *res)
+{
+    size_t count;
+    switch (res->type) {
+        case VLC_PREPARSER_MSG_REQ_TYPE_PARSE:
+            count = bin_ReadCount(sys);
+            for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+                input_attachment_t *a = fromBIN_input_attachment(sys);
+                if (a != NULL && !vlc_vector_push(&res->attachments, a)) {
+                    vlc_input_attachment_Release(a);
+                    serdes_set_error(VLC_ENOMEM);
+                }
+            }
+            res->subtree = fromBIN_input_item_node(sys);
+            break;
+        case VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL:
+            res->pic = fromBIN_picture(sys);
+            break;
+        case VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL_TO_FILES:
+            count = bin_ReadCount(sys);
+            for (size_t i = 0; i < count && sys->error == VLC_SUCCESS; i++) {
+                bool result = bin_ReadBool(sys);
+                if (!vlc_vector_push(&res->result, result)) {
+                    serdes_set_error(VLC_ENOMEM);
+                }
+            }
+            break;
+        default:
+            vlc_assert_unreachable();
+    }
+    bin_read_int(sys, res->status);
+    res->item = fromBIN_input_item(sys);
+}
+
+void
+bin_ReadMsg(struct serdes_sys *sys, struct vlc_preparser_msg *msg)
+{
+    assert(sys != NULL);
+    assert(msg != NULL);
+
+    int msg_type = VLC_PREPARSER_MSG_TYPE_REQ;
+    enum vlc_preparser_msg_req_type req_type = VLC_PREPARSER_MSG_REQ_TYPE_PARSE;
+    bin_read_ranged(sys, msg_type, VLC_PREPARSER_MSG_TYPE_REQ,
+                    VLC_PREPARSER_MSG_TYPE_RES);
+    bin_read_ranged(sys, req_type, VLC_PREPARSER_MSG_REQ_TYPE_PARSE,
+                    VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL_TO_FILES);
+    if (sys->error != VLC_SUCCESS) {
+        return;
+    }
+
+    vlc_preparser_msg_Init(msg, msg_type, req_type);
+    if (msg_type == VLC_PREPARSER_MSG_TYPE_REQ) {
+        fromBIN_vlc_preparser_msg_req(sys, &msg->req);
+    } else {
+        fromBIN_vlc_preparser_msg_res(sys, &msg->res);
+    }
+
+    if (sys->error != VLC_SUCCESS) {
+        vlc_preparser_msg_Clean(msg);
+    }
+}
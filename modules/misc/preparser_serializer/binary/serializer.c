@@ -0,0 +1,453 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*****************************************************************************
+ * serializer.c: binary preparser serializer module
+ *****************************************************************************
+ * Copyright © 2026 VideoLAN and VLC authors
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <errno.h>
+
+#include <vlc_common.h>
+#include <vlc_fs.h>
+#include <vlc_plugin.h>
+#include <vlc_preparser_ipc.h>
+
+#include "serializer.h"
+
+/* Sanity limit on the length of strings read from the peer */
+#define BIN_STRING_MAX (1 << 24)
+
+/****************************************************************************
+ * Output
+ *****************************************************************************/
+
+static int
+bin_WriteRaw(struct serdes_sys *sys, const uint8_t *data, size_t size)
+{
+    const struct vlc_preparser_msg_serdes_cbs *cbs = sys->parent->owner.cbs;
+    assert(cbs != NULL && cbs->write != NULL);
+
+    while (size != 0) {
+        ssize_t ret = cbs->write(data, size, sys->userdata);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            serdes_set_error(-errno);
+            return sys->error;
+        }
+        data += ret;
+        size -= ret;
+    }
+    return VLC_SUCCESS;
+}
+
+int
+bin_Flush(struct serdes_sys *sys)
+{
+    assert(sys != NULL);
+
+    if (sys->error != VLC_SUCCESS) {
+        return sys->error;
+    }
+    int ret = bin_WriteRaw(sys, sys->buffer, sys->size);
+    sys->size = 0;
+    return ret;
+}
+
+void
+bin_Write(struct serdes_sys *sys, const void *data, size_t size)
+{
+    assert(sys != NULL);
+
+    if (size == 0 || sys->error != VLC_SUCCESS) {
+        return;
+    }
+    assert(data != NULL);
+
+    if (size > sys->cap - sys->size) {
+        if (bin_Flush(sys) != VLC_SUCCESS) {
+            return;
+        }
+        /* Large blobs (attachments, pixels) bypass the buffer */
+        if (size >= sys->cap) {
+            bin_WriteRaw(sys, data, size);
+            return;
+        }
+    }
+    memcpy(sys->buffer + sys->size, data, size);
+    sys->size += size;
+}
+
+void
+bin_WriteVarint(struct serdes_sys *sys, uint64_t value)
+{
+    uint8_t buf[10];
+    size_t len = 0;
+    do {
+        buf[len] = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            buf[len] |= 0x80;
+        }
+        len++;
+    } while (value != 0);
+    bin_Write(sys, buf, len);
+}
+
+void
+bin_WriteU32(struct serdes_sys *sys, uint32_t value)
+{
+    uint8_t buf[4];
+    SetDWLE(buf, value);
+    bin_Write(sys, buf, sizeof(buf));
+}
+
+void
+bin_WriteDouble(struct serdes_sys *sys, double value)
+{
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "unexpected double size");
+    memcpy(&bits, &value, sizeof(bits));
+    uint8_t buf[8];
+    SetQWLE(buf, bits);
+    bin_Write(sys, buf, sizeof(buf));
+}
+
+void
+bin_WriteString(struct serdes_sys *sys, const char *str)
+{
+    /* 0 is NULL, otherwise the length plus one */
+    if (str == NULL) {
+        bin_WriteVarint(sys, 0);
+        return;
+    }
+    size_t len = strlen(str);
+    bin_WriteVarint(sys, (uint64_t)len + 1);
+    bin_Write(sys, str, len);
+}
+
+void
+bin_WriteFd(struct serdes_sys *sys, int fd)
+{
+    const struct vlc_preparser_msg_serdes_cbs *cbs = sys->parent->owner.cbs;
+    assert(cbs->write_fd != NULL);
+
+    if (bin_Flush(sys) != VLC_SUCCESS) {
+        return;
+    }
+    static const uint8_t zero = 0;
+    for (;;) {
+        ssize_t ret = cbs->write_fd(&zero, 1, fd, sys->userdata);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            serdes_set_error(-errno);
+        } else if (ret != 1) {
+            serdes_set_error(VLC_EGENERIC);
+        }
+        return;
+    }
+}
+
+/****************************************************************************
+ * Input
+ *****************************************************************************/
+
+static ssize_t
+bin_ReadRaw(struct serdes_sys *sys, uint8_t *data, size_t size)
+{
+    const struct vlc_preparser_msg_serdes_cbs *cbs = sys->parent->owner.cbs;
+    assert(cbs != NULL && cbs->read != NULL);
+
+    for (;;) {
+        ssize_t ret;
+        if (cbs->read_fd != NULL) {
+            int fd = -1;
+            ret = cbs->read_fd(data, size, &fd, sys->userdata);
+            if (fd != -1) {
+                if (sys->recv_fd != -1) {
+                    /* Only one descriptor per message is expected */
+                    vlc_close(fd);
+                    serdes_set_error(VLC_EGENERIC);
+                    return -1;
+                }
+                sys->recv_fd = fd;
+            }
+        } else {
+            ret = cbs->read(data, size, sys->userdata);
+        }
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            serdes_set_error(-errno);
+            return -1;
+        }
+        if (ret == 0) {
+            /* The peer closed in the middle of a message */
+            serdes_set_error(VLC_EGENERIC);
+            return -1;
+        }
+        return ret;
+    }
+}
+
+void
+bin_Read(struct serdes_sys *sys, void *_data, size_t size)
+{
+    assert(sys != NULL);
+    uint8_t *data = _data;
+
+    while (size != 0 && sys->error == VLC_SUCCESS) {
+        size_t avail = sys->size - sys->offset;
+        if (avail != 0) {
+            size_t copy = avail < size ? avail : size;
+            memcpy(data, sys->buffer + sys->offset, copy);
+            sys->offset += copy;
+            data += copy;
+            size -= copy;
+            continue;
+        }
+
+        sys->offset = sys->size = 0;
+        if (size >= sys->cap) {
+            /* Read large blobs straight into their destination */
+            ssize_t ret = bin_ReadRaw(sys, data, size);
+            if (ret > 0) {
+                data += ret;
+                size -= ret;
+            }
+        } else {
+            ssize_t ret = bin_ReadRaw(sys, sys->buffer, sys->cap);
+            if (ret > 0) {
+                sys->size = ret;
+            }
+        }
+    }
+    if (size != 0) {
+        memset(data, 0, size);
+    }
+}
+
+uint64_t
+bin_ReadVarint(struct serdes_sys *sys)
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        uint8_t b;
+        bin_Read(sys, &b, 1);
+        if (sys->error != VLC_SUCCESS) {
+            return 0;
+        }
+        value |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return value;
+        }
+    }
+    serdes_set_error(VLC_EGENERIC);
+    return 0;
+}
+
+bool
+bin_ReadBool(struct serdes_sys *sys)
+{
+    uint8_t b;
+    bin_Read(sys, &b, 1);
+    if (b > 1) {
+        serdes_set_error(VLC_EGENERIC);
+    }
+    return b == 1;
+}
+
+uint32_t
+bin_ReadU32(struct serdes_sys *sys)
+{
+    uint8_t buf[4];
+    bin_Read(sys, buf, sizeof(buf));
+    return GetDWLE(buf);
+}
+
+double
+bin_ReadDouble(struct serdes_sys *sys)
+{
+    uint8_t buf[8];
+    bin_Read(sys, buf, sizeof(buf));
+    uint64_t bits = GetQWLE(buf);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+char *
+bin_ReadString(struct serdes_sys *sys)
+{
+    uint64_t len = bin_ReadVarint(sys);
+    if (len == 0 || sys->error != VLC_SUCCESS) {
+        return NULL;
+    }
+    len--;
+    if (len > BIN_STRING_MAX) {
+        serdes_set_error(VLC_EGENERIC);
+        return NULL;
+    }
+    char *str = malloc(len + 1);
+    if (str == NULL) {
+        serdes_set_error(VLC_ENOMEM);
+        return NULL;
+    }
+    bin_Read(sys, str, len);
+    str[len] = '\0';
+    if (sys->error != VLC_SUCCESS || memchr(str, '\0', len) != NULL) {
+        serdes_set_error(VLC_EGENERIC);
+        free(str);
+        return NULL;
+    }
+    return str;
+}
+
+int
+bin_ReadFd(struct serdes_sys *sys)
+{
+    uint8_t b;
+    bin_Read(sys, &b, 1);
+    if (sys->error != VLC_SUCCESS || b != 0 || sys->recv_fd == -1) {
+        serdes_set_error(VLC_EGENERIC);
+        return -1;
+    }
+    int fd = sys->recv_fd;
+    sys->recv_fd = -1;
+    return fd;
+}
+
+/****************************************************************************
+ * serdes Operations
+ *****************************************************************************/
+
+static void
+serdes_ReleaseFd(struct serdes_sys *sys)
+{
+    if (sys->recv_fd != -1) {
+        vlc_close(sys->recv_fd);
+        sys->recv_fd = -1;
+    }
+}
+
+static int
+serdes_Serialize(struct vlc_preparser_msg_serdes *serdes,
+                 const struct vlc_preparser_msg *msg, void *userdata)
+{
+    assert(serdes != NULL);
+    struct serdes_sys *sys = serdes->owner.sys;
+    assert(serdes == sys->parent);
+
+    if (msg == NULL) {
+        return VLC_SUCCESS;
+    }
+    sys->userdata = userdata;
+    sys->error = VLC_SUCCESS;
+    sys->size = 0;
+
+    bin_WriteU32(sys, BIN_MAGIC);
+    bin_WriteMsg(sys, msg);
+    return bin_Flush(sys);
+}
+
+static int
+serdes_Deserialize(struct vlc_preparser_msg_serdes *serdes,
+                   struct vlc_preparser_msg *msg, void *userdata)
+{
+    assert(serdes != NULL);
+    assert(msg != NULL);
+    struct serdes_sys *sys = serdes->owner.sys;
+    assert(serdes == sys->parent);
+
+    sys->userdata = userdata;
+    sys->error = VLC_SUCCESS;
+
+    if (bin_ReadU32(sys) != BIN_MAGIC) {
+        serdes_set_error(VLC_EGENERIC);
+    }
+    if (sys->error == VLC_SUCCESS) {
+        bin_ReadMsg(sys, msg);
+    }
+    if (sys->error != VLC_SUCCESS) {
+        /* Whatever is left belongs to a broken message */
+        sys->offset = sys->size = 0;
+    }
+    serdes_ReleaseFd(sys);
+    return sys->error;
+}
+
+static void
+serdes_Close(struct vlc_preparser_msg_serdes *serdes)
+{
+    assert(serdes != NULL);
+    assert(serdes->owner.sys != NULL);
+
+    struct serdes_sys *sys = serdes->owner.sys;
+    serdes->owner.sys = NULL;
+
+    serdes_ReleaseFd(sys);
+    free(sys);
+}
+
+#define SERDES_BUFFER_SIZE (1 << 16)
+
+/**
+ * Create a new de/serializer.
+ */
+static int
+serdes_Open(struct vlc_preparser_msg_serdes *serdes, bool bin_data)
+{
+    assert(serdes != NULL);
+
+    /* The textual output of vlc-preparser is left to the JSON module */
+    if (!bin_data) {
+        return VLC_EGENERIC;
+    }
+
+    struct serdes_sys *sys = malloc(sizeof(*sys) + SERDES_BUFFER_SIZE);
+    if (sys == NULL) {
+        return VLC_ENOMEM;
+    }
+    sys->parent = serdes;
+    sys->userdata = NULL;
+    sys->error = VLC_SUCCESS;
+    const struct vlc_preparser_msg_serdes_cbs *cbs = serdes->owner.cbs;
+#ifdef __linux__
+    sys->shm_enabled = cbs->read_fd != NULL;
+#else
+    VLC_UNUSED(cbs);
+    sys->shm_enabled = false;
+#endif
+    sys->peer_flags = 0;
+    sys->recv_fd = -1;
+    sys->offset = 0;
+    sys->size = 0;
+    sys->cap = SERDES_BUFFER_SIZE;
+
+    static const struct vlc_preparser_msg_serdes_operations ops = {
+        .serialize = serdes_Serialize,
+        .deserialize = serdes_Deserialize,
+        .close = serdes_Close,
+    };
+    serdes->ops = &ops;
+    serdes->owner.sys = sys;
+
+    return VLC_SUCCESS;
+}
+
+#undef SERDES_BUFFER_SIZE
+
+vlc_module_begin()
+    set_description(N_("Binary Preparser Message Serializer/Deserializer"))
+    set_callback_preparser_msg_serdes(serdes_Open, 60)
+    add_shortcut("binary")
+vlc_module_end()
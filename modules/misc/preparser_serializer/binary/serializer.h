@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*****************************************************************************
+ * serializer.h: binary serializer header
+ *****************************************************************************
+ * Copyright © 2026 VideoLAN and VLC authors
+ *****************************************************************************/
+
+#ifndef BINARY_SERIALIZER_H
+#define BINARY_SERIALIZER_H
+
+#include <vlc_common.h>
+#include <vlc_preparser_ipc.h>
+
+#include <stdckdint.h>
+
+/* Every message starts with this magic, so that a peer using another
+ * serializer, or a desynchronized stream, is detected on the first bytes. */
+#define BIN_MAGIC           0x56504231 /* "VPB1" */
+
+/* Flags sent with every request */
+#define BIN_REQ_FLAG_SHM    0x1 /* The sender can map shared pictures */
+
+/* Storage of picture pixels in a response */
+#define BIN_PIXELS_INLINE   0
+#define BIN_PIXELS_SHM      1
+
+struct serdes_sys {
+    struct vlc_preparser_msg_serdes *parent;
+
+    void *userdata;
+    int error;
+
+    /* Requester side: shared pictures are accepted. Cleared after a
+     * failure to map one, the next requests ask for inline pixels. */
+    bool shm_enabled;
+    /* Responder side: flags of the last request received. */
+    int peer_flags;
+    /* Requester side: file descriptor received with the data, not yet
+     * claimed by bin_ReadFd(). */
+    int recv_fd;
+
+    /* Buffered bytes are buffer[offset, size) */
+    size_t offset;
+    size_t size;
+    size_t cap;
+    uint8_t buffer[];
+};
+
+#define serdes_set_error(err) \
+    sys->error = sys->error == VLC_SUCCESS ? err : sys->error
+
+/****************************************************************************
+ * Primitives
+ *****************************************************************************/
+
+void
+bin_Write(struct serdes_sys *sys, const void *data, size_t size);
+
+int
+bin_Flush(struct serdes_sys *sys);
+
+void
+bin_WriteVarint(struct serdes_sys *sys, uint64_t value);
+
+static inline void
+bin_WriteSVarint(struct serdes_sys *sys, int64_t value)
+{
+    /* zigzag: small negative values stay small */
+    bin_WriteVarint(sys, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static inline void
+bin_WriteBool(struct serdes_sys *sys, bool value)
+{
+    uint8_t b = value;
+    bin_Write(sys, &b, 1);
+}
+
+void
+bin_WriteU32(struct serdes_sys *sys, uint32_t value);
+
+void
+bin_WriteDouble(struct serdes_sys *sys, double value);
+
+void
+bin_WriteString(struct serdes_sys *sys, const char *str);
+
+/* Flush, then send a file descriptor along with a single zero byte. */
+void
+bin_WriteFd(struct serdes_sys *sys, int fd);
+
+void
+bin_Read(struct serdes_sys *sys, void *data, size_t size);
+
+uint64_t
+bin_ReadVarint(struct serdes_sys *sys);
+
+static inline int64_t
+bin_ReadSVarint(struct serdes_sys *sys)
+{
+    uint64_t v = bin_ReadVarint(sys);
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+bool
+bin_ReadBool(struct serdes_sys *sys);
+
+uint32_t
+bin_ReadU32(struct serdes_sys *sys);
+
+double
+bin_ReadDouble(struct serdes_sys *sys);
+
+char *
+bin_ReadString(struct serdes_sys *sys);
+
+/* Read the byte written by bin_WriteFd() and return the file descriptor
+ * that came with it, or -1 on error. */
+int
+bin_ReadFd(struct serdes_sys *sys);
+
+/* Read into an integer field, failing if the value does not fit. */
+#define bin_read_uint(sys, field) \
+    do { \
+        uint64_t v_ = bin_ReadVarint(sys); \
+        if (ckd_add(&(field), v_, 0)) { \
+            serdes_set_error(VLC_EGENERIC); \
+        } \
+    } while (0)
+
+#define bin_read_int(sys, field) \
+    do { \
+        int64_t v_ = bin_ReadSVarint(sys); \
+        if (ckd_add(&(field), v_, 0)) { \
+            serdes_set_error(VLC_EGENERIC); \
+        } \
+    } while (0)
+
+/* Enums and bit-fields can't be used with ckd_add(). The value is
+ * written with bin_WriteSVarint(). */
+#define bin_read_ranged(sys, field, min, max) \
+    do { \
+        int64_t v_ = bin_ReadSVarint(sys); \
+        if (v_ < (int64_t)(min) || v_ > (int64_t)(max)) { \
+            serdes_set_error(VLC_EGENERIC); \
+        } else { \
+            (field) = v_; \
+        } \
+    } while (0)
+
+/****************************************************************************
+ * Messages
+ *****************************************************************************/
+
+void
+bin_WriteMsg(struct serdes_sys *sys, const struct vlc_preparser_msg *msg);
+
+void
+bin_ReadMsg(struct serdes_sys *sys, struct vlc_preparser_msg *msg);
+
+#endif /* BINARY_SERIALIZER_H */
@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*****************************************************************************
+ * tobinary.c: write binary messages from vlc struct
+ *****************************************************************************
+ * Copyright © 2026 VideoLAN and VLC authors
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <unistd.h>
+#ifdef __linux__
+# include <fcntl.h>
+# include <sys/mman.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_es.h>
+#include <vlc_fs.h>
+#include <vlc_input_item.h>
+#include <vlc_picture.h>
+#include <vlc_preparser_ipc.h>
+#include <vlc_vector.h>
+
+#include "serializer.h"
+
+/* Fields are written in a fixed order without names: both ends are
+ * built from the same tree. Optional structures are preceded by a
+ * presence boolean, arrays by their length. */
+
+static void
+toBIN_extra_languages(struct serdes_sys *sys, const extra_languages_t *el)
+{
+    bin_WriteString(sys, el->psz_language);
+    bin_WriteString(sys, el->psz_description);
+}
+
+static void
+toBIN_audio_format(struct serdes_sys *sys, const audio_format_t *a)
+{
+    bin_WriteU32(sys, a->i_format);
+    bin_WriteVarint(sys, a->i_rate);
+    bin_WriteVarint(sys, a->i_physical_channels);
+    bin_WriteVarint(sys, a->i_chan_mode);
+    bin_WriteSVarint(sys, a->channel_type);
+    bin_WriteVarint(sys, a->i_bytes_per_frame);
+    bin_WriteVarint(sys, a->i_frame_length);
+    bin_WriteVarint(sys, a->i_bitspersample);
+    bin_WriteVarint(sys, a->i_blockalign);
+    bin_WriteVarint(sys, a->i_channels);
+}
+
+static void
+toBIN_audio_replay_gain(struct serdes_sys *sys, const audio_replay_gain_t *ag)
+{
+    for (size_t i = 0; i < AUDIO_REPLAY_GAIN_MAX; i++) {
+        bin_WriteBool(sys, ag->pb_peak[i]);
+        bin_WriteDouble(sys, ag->pf_peak[i]);
+        bin_WriteBool(sys, ag->pb_gain[i]);
+        bin_WriteDouble(sys, ag->pf_gain[i]);
+    }
+}
+
+static void
+toBIN_video_format(struct serdes_sys *sys, const video_format_t *video)
+{
+    bin_WriteU32(sys, video->i_chroma);
+    bin_WriteVarint(sys, video->i_width);
+    bin_WriteVarint(sys, video->i_height);
+    bin_WriteVarint(sys, video->i_x_offset);
+    bin_WriteVarint(sys, video->i_y_offset);
+    bin_WriteVarint(sys, video->i_visible_width);
+    bin_WriteVarint(sys, video->i_visible_height);
+    bin_WriteVarint(sys, video->i_sar_num);
+    bin_WriteVarint(sys, video->i_sar_den);
+    bin_WriteVarint(sys, video->i_frame_rate);
+    bin_WriteVarint(sys, video->i_frame_rate_base);
+
+    const video_palette_t *palette = video->p_palette;
+    bin_WriteBool(sys, palette != NULL);
+    if (palette != NULL) {
+        bin_WriteSVarint(sys, palette->i_entries);
+        bin_Write(sys, palette->palette, sizeof(palette->palette));
+    }
+
+    bin_WriteSVarint(sys, video->orientation);
+    bin_WriteSVarint(sys, video->primaries);
+    bin_WriteSVarint(sys, video->transfer);
+    bin_WriteSVarint(sys, video->space);
+    bin_WriteSVarint(sys, video->color_range);
+    bin_WriteSVarint(sys, video->chroma_location);
+    bin_WriteSVarint(sys, video->multiview_mode);
+    bin_WriteBool(sys, video->b_multiview_right_eye_first);
+    bin_WriteSVarint(sys, video->projection_mode);
+
+    bin_WriteDouble(sys, video->pose.yaw);
+    bin_WriteDouble(sys, video->pose.pitch);
+    bin_WriteDouble(sys, video->pose.roll);
+    bin_WriteDouble(sys, video->pose.fov);
+
+    for (size_t i = 0; i < ARRAY_SIZE(video->mastering.primaries); i++) {
+        bin_WriteVarint(sys, video->mastering.primaries[i]);
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(video->mastering.white_point); i++) {
+        bin_WriteVarint(sys, video->mastering.white_point[i]);
+    }
+    bin_WriteVarint(sys, video->mastering.max_luminance);
+    bin_WriteVarint(sys, video->mastering.min_luminance);
+
+    bin_WriteVarint(sys, video->lighting.MaxCLL);
+    bin_WriteVarint(sys, video->lighting.MaxFALL);
+
+    bin_WriteVarint(sys, video->dovi.version_major);
+    bin_WriteVarint(sys, video->dovi.version_minor);
+    bin_WriteSVarint(sys, video->dovi.profile);
+    bin_WriteSVarint(sys, video->dovi.level);
+    bin_WriteSVarint(sys, video->dovi.rpu_present);
+    bin_WriteSVarint(sys, video->dovi.el_present);
+    bin_WriteSVarint(sys, video->dovi.bl_present);
+
+    bin_WriteVarint(sys, video->i_cubemap_padding);
+}
+
+static void
+toBIN_subs_format(struct serdes_sys *sys, const subs_format_t *subs)
+{
+    bin_WriteString(sys, subs->psz_encoding);
+    bin_WriteSVarint(sys, subs->i_x_origin);
+    bin_WriteSVarint(sys, subs->i_y_origin);
+
+    bin_WriteVarint(sys, subs->spu.i_original_frame_width);
+    bin_WriteVarint(sys, subs->spu.i_original_frame_height);
+    for (size_t i = 0; i < VIDEO_PALETTE_CLUT_COUNT; i++) {
+        bin_WriteVarint(sys, subs->spu.palette[i]);
+    }
+    bin_WriteBool(sys, subs->spu.b_palette);
+
+    bin_WriteSVarint(sys, subs->dvb.i_id);
+
+    bin_WriteVarint(sys, subs->teletext.i_magazine);
+    bin_WriteVarint(sys, subs->teletext.i_page);
+
+    bin_WriteVarint(sys, subs->cc.i_channel);
+    bin_WriteSVarint(sys, subs->cc.i_reorder_depth);
+}
+
+static void
+toBIN_es_format(struct serdes_sys *sys, const es_format_t *es)
+{
+    bin_WriteSVarint(sys, es->i_cat);
+    bin_WriteU32(sys, es->i_codec);
+    bin_WriteU32(sys, es->i_original_fourcc);
+    bin_WriteSVarint(sys, es->i_id);
+    bin_WriteSVarint(sys, es->i_group);
+    bin_WriteSVarint(sys, es->i_priority);
+    bin_WriteString(sys, es->psz_language);
+    bin_WriteString(sys, es->psz_description);
+    bin_WriteVarint(sys, es->i_extra_languages);
+    for (unsigned i = 0; i < es->i_extra_languages; i++) {
+        toBIN_extra_languages(sys, &es->p_extra_languages[i]);
+    }
+
+    switch (es->i_cat) {
+        case AUDIO_ES:
+            toBIN_audio_format(sys, &es->audio);
+            toBIN_audio_replay_gain(sys, &es->audio_replay_gain);
+            break;
+        case VIDEO_ES:
+            toBIN_video_format(sys, &es->video);
+            break;
+        case SPU_ES:
+            toBIN_subs_format(sys, &es->subs);
+            break;
+        default:
+            break;
+    }
+
+    bin_WriteVarint(sys, es->i_bitrate);
+    bin_WriteSVarint(sys, es->i_profile);
+    bin_WriteSVarint(sys, es->i_level);
+    bin_WriteBool(sys, es->b_packetized);
+    /* p_extra not sent */
+}
+
+static void
+toBIN_meta(struct serdes_sys *sys, const vlc_meta_t *meta)
+{
+    /* Only the set fields are sent, as (type, priority, value) */
+    unsigned count = 0;
+    for (int i = 0; i < VLC_META_TYPE_COUNT; i++) {
+        if (vlc_meta_Get(meta, i) != NULL) {
+            count++;
+        }
+    }
+    bin_WriteVarint(sys, count);
+    for (int i = 0; i < VLC_META_TYPE_COUNT; i++) {
+        vlc_meta_priority_t priority = VLC_META_PRIORITY_BASIC;
+        const char *value = vlc_meta_GetWithPriority(meta, i, &priority);
+        if (value != NULL) {
+            bin_WriteSVarint(sys, i);
+            bin_WriteSVarint(sys, priority);
+            bin_WriteString(sys, value);
+        }
+    }
+
+    char **keys = vlc_meta_CopyExtraNames(meta);
+    unsigned extra_count = keys != NULL ? vlc_meta_GetExtraCount(meta) : 0;
+    bin_WriteVarint(sys, extra_count);
+    for (unsigned i = 0; i < extra_count; i++) {
+        vlc_meta_priority_t priority = VLC_META_PRIORITY_BASIC;
+        const char *value = vlc_meta_GetExtraWithPriority(meta, keys[i],
+                                                          &priority);
+        bin_WriteString(sys, keys[i]);
+        bin_WriteString(sys, value);
+        bin_WriteSVarint(sys, priority);
+        free(keys[i]);
+    }
+    free(keys);
+}
+
+static void
+toBIN_input_item(struct serdes_sys *sys, const input_item_t *item)
+{
+    bin_WriteBool(sys, item != NULL);
+    if (item == NULL) {
+        return;
+    }
+    bin_WriteString(sys, item->psz_name);
+    bin_WriteString(sys, item->psz_uri);
+    bin_WriteSVarint(sys, item->i_duration);
+
+    bin_WriteVarint(sys, item->es_vec.size);
+    const struct input_item_es *item_es;
+    vlc_vector_foreach_ref(item_es, &item->es_vec) {
+        toBIN_es_format(sys, &item_es->es);
+        bin_WriteString(sys, item_es->id);
+        bin_WriteBool(sys, item_es->id_stable);
+    }
+
+    bin_WriteBool(sys, item->p_meta != NULL);
+    if (item->p_meta != NULL) {
+        toBIN_meta(sys, item->p_meta);
+    }
+
+    bin_WriteVarint(sys, item->i_slaves);
+    for (int i = 0; i < item->i_slaves; i++) {
+        const struct input_item_slave *slave = item->pp_slaves[i];
+        bin_WriteSVarint(sys, slave->i_type);
+        bin_WriteSVarint(sys, slave->i_priority);
+        bin_WriteBool(sys, slave->b_forced);
+        bin_WriteString(sys, slave->psz_uri);
+    }
+
+    bin_WriteSVarint(sys, item->i_type);
+    bin_WriteBool(sys, item->b_net);
+}
+
+static void
+toBIN_input_item_node(struct serdes_sys *sys, const input_item_node_t *node)
+{
+    bin_WriteBool(sys, node != NULL);
+    if (node == NULL) {
+        return;
+    }
+    toBIN_input_item(sys, node->p_item);
+    bin_WriteVarint(sys, node->i_children);
+    for (int i = 0; i < node->i_children; i++) {
+        toBIN_input_item_node(sys, node->pp_children[i]);
+    }
+}
+
+static void
+toBIN_input_attachment(struct serdes_sys *sys, const input_attachment_t *a)
+{
+    bin_WriteString(sys, a->psz_name);
+    bin_WriteString(sys, a->psz_mime);
+    bin_WriteString(sys, a->psz_description);
+    bin_WriteVarint(sys, a->i_data);
+    bin_Write(sys, a->p_data, a->i_data);
+}
+
+#ifdef __linux__
+/**
+ * Copy the planes to a sealed memfd, that is passed to the peer to map
+ * instead of receiving the pixels through the pipe.
+ *
+ * Planes are laid out one after the other, aligned on 64 bytes.
+ *
+ * @return the memfd, or -1 on error
+ */
+static int
+toBIN_SharePixels(const picture_t *pic, size_t size)
+{
+    int fd = vlc_memfd();
+    if (fd == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, size) != 0) {
+        goto error;
+    }
+    uint8_t *base = mmap(NULL, size, PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        goto error;
+    }
+    size_t offset = 0;
+    for (int i = 0; i < pic->i_planes; i++) {
+        const plane_t *p = &pic->p[i];
+        size_t plane_size = (size_t)p->i_pitch * p->i_lines;
+        memcpy(base + offset, p->p_pixels, plane_size);
+        offset += vlc_align(plane_size, 64);
+    }
+    munmap(base, size);
+
+    /* The peer must not see the content or the size change under its
+     * mapping. */
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE
+                                | F_SEAL_SEAL) != 0) {
+        goto error;
+    }
+    return fd;
+
+error:
+    vlc_close(fd);
+    return -1;
+}
+#endif
+
+/* Below this size, pixels are cheaper to send inline */
+#define BIN_SHM_MIN_SIZE (64 * 1024)
+
+static void
+toBIN_picture(struct serdes_sys *sys, const picture_t *pic)
+{
+    bin_WriteBool(sys, pic != NULL);
+    if (pic == NULL) {
+        return;
+    }
+    toBIN_video_format(sys, &pic->format);
+    bin_WriteSVarint(sys, pic->i_planes);
+    size_t size = 0;
+    for (int i = 0; i < pic->i_planes; i++) {
+        const plane_t *p = &pic->p[i];
+        bin_WriteSVarint(sys, p->i_lines);
+        bin_WriteSVarint(sys, p->i_pitch);
+        bin_WriteSVarint(sys, p->i_pixel_pitch);
+        bin_WriteSVarint(sys, p->i_visible_lines);
+        bin_WriteSVarint(sys, p->i_visible_pitch);
+        size += vlc_align((size_t)p->i_pitch * p->i_lines, 64);
+    }
+    bin_WriteSVarint(sys, pic->date);
+    bin_WriteBool(sys, pic->b_force);
+    bin_WriteBool(sys, pic->b_still);
+    bin_WriteBool(sys, pic->b_progressive);
+    bin_WriteBool(sys, pic->b_top_field_first);
+    bin_WriteBool(sys, pic->b_multiview_left_eye);
+    bin_WriteVarint(sys, pic->i_nb_fields);
+
+#ifdef __linux__
+    const struct vlc_preparser_msg_serdes_cbs *cbs = sys->parent->owner.cbs;
+    int fd = -1;
+    if ((sys->peer_flags & BIN_REQ_FLAG_SHM) && cbs->write_fd != NULL
+     && size >= BIN_SHM_MIN_SIZE
+     && (fd = toBIN_SharePixels(pic, size)) != -1) {
+        bin_WriteSVarint(sys, BIN_PIXELS_SHM);
+        bin_WriteVarint(sys, size);
+        /* The peer holds its own reference once the descriptor is sent */
+        bin_WriteFd(sys, fd);
+        vlc_close(fd);
+        return;
+    }
+#else
+    VLC_UNUSED(size);
+#endif
+
+    bin_WriteSVarint(sys, BIN_PIXELS_INLINE);
+    for (int i = 0; i < pic->i_planes; i++) {
+        const plane_t *p = &pic->p[i];
+        bin_Write(sys, p->p_pixels, (size_t)p->i_pitch * p->i_lines);
+    }
+}
+
+static void
+toBIN_vlc_preparser_msg_req(struct serdes_sys *sys,
+                            const struct vlc_preparser_msg_req *req)
+{
+    bin_WriteVarint(sys, sys->shm_enabled ? BIN_REQ_FLAG_SHM : 0);
+
+    if (req->type == VLC_PREPARSER_MSG_REQ_TYPE_PARSE) {
+        bin_WriteSVarint(sys, req->options);
+    } else {
+        if (req->type == VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL_TO_FILES) {
+            bin_WriteVarint(sys, req->outputs.size);
+            const struct vlc_thumbnailer_output *out;
+            vlc_vector_foreach_ref(out, &req->outputs) {
+                bin_WriteSVarint(sys, out->format);
+                bin_WriteSVarint(sys, out->width);
+                bin_WriteSVarint(sys, out->height);
+                bin_WriteBool(sys, out->crop);
+                bin_WriteString(sys, out->file_path);
+                bin_WriteVarint(sys, out->creat_mode);
+            }
+        }
+        bin_WriteSVarint(sys, req->arg.seek.type);
+        if (req->arg.seek.type == VLC_THUMBNAILER_SEEK_TIME) {
+            bin_WriteSVarint(sys, req->arg.seek.time);
+        } else if (req->arg.seek.type == VLC_THUMBNAILER_SEEK_POS) {
+            bin_WriteDouble(sys, req->arg.seek.pos);
+        } else if (req->arg.seek.type != VLC_THUMBNAILER_SEEK_NONE) {
+            vlc_assert_unreachable();
+        }
+        bin_WriteSVarint(sys, req->arg.seek.speed);
+        bin_WriteBool(sys, req->arg.hw_dec);
+    }
+    bin_WriteString(sys, req->uri);
+}
+
+static void
+toBIN_vlc_preparser_msg_res(struct serdes_sys *sys,
+                            const struct vlc_preparser_msg_res *res)
+{
+    switch (res->type) {
+        case VLC_PREPARSER_MSG_REQ_TYPE_PARSE:
+            bin_WriteVarint(sys, res->attachments.size);
+            for (size_t i = 0; i < res->attachments.size; i++) {
+                toBIN_input_attachment(sys, res->attachments.data[i]);
+            }
+            toBIN_input_item_node(sys, res->subtree);
+            break;
+        case VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL:
+            toBIN_picture(sys, res->pic);
+            break;
+        case VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL_TO_FILES:
+            bin_WriteVarint(sys, res->result.size);
+            for (size_t i = 0; i < res->result.size; i++) {
+                bin_WriteBool(sys, res->result.data[i]);
+            }
+            break;
+        default:
+            vlc_assert_unreachable();
+    }
+    bin_WriteSVarint(sys, res->status);
+    toBIN_input_item(sys, res->item);
+}
+
+void
+bin_WriteMsg(struct serdes_sys *sys, const struct vlc_preparser_msg *msg)
+{
+    assert(sys != NULL);
+    assert(msg != NULL);
+    assert(msg->req_type == VLC_PREPARSER_MSG_REQ_TYPE_PARSE ||
+           msg->req_type == VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL ||
+           msg->req_type == VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL_TO_FILES);
+
+    bin_WriteSVarint(sys, msg->type);
+    bin_WriteSVarint(sys, msg->req_type);
+
+    if (msg->type == VLC_PREPARSER_MSG_TYPE_REQ) {
+        assert(msg->req.type == msg->req_type);
+        toBIN_vlc_preparser_msg_req(sys, &msg->req);
+    } else if (msg->type == VLC_PREPARSER_MSG_TYPE_RES) {
+        assert(msg->res.type == msg->req_type);
+        toBIN_vlc_preparser_msg_res(sys, &msg->res);
+    } else {
+        vlc_assert_unreachable();
+    }
+}
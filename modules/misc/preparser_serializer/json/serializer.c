@@ -429,4 +429,5 @@ serdes_Open(struct vlc_preparser_msg_serdes *serdes, bool bin_data)
 vlc_module_begin()
     set_description(N_("Preparser Message Serializer/Deserializer"))
     set_callback_preparser_msg_serdes(serdes_Open, 50)
+    add_shortcut("json")
 vlc_module_end()
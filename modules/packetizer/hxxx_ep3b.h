@@ -19,64 +19,105 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
  *****************************************************************************/
 #include <vlc_bits.h>
+#include <vlc_cpu.h>
 
-static inline uint8_t *hxxx_ep3b_to_rbsp( uint8_t *p, uint8_t *end, unsigned *pi_prev, size_t i_count )
+#ifdef CAN_COMPILE_SSE2
+# include <emmintrin.h>
+#endif
+
+/* Looks up the next emulation prevention three byte, that is the 0x03 of
+ * a 0x00 0x00 0x03 sequence starting at p or after, and followed by at
+ * least one byte. Returns end if there is none. */
+static inline const uint8_t *hxxx_ep3b_find_c( const uint8_t *p, const uint8_t *end )
 {
-    for( size_t i=0; i<i_count; i++ )
+    /* The zeros of a sequence can only start in words holding a zero */
+    for( ; end - p >= 8 + 2; p += 8 )
     {
-        if( ++p >= end )
-            return p;
+        uint64_t x;
+        memcpy( &x, p, sizeof(x) );
+        if( !((x - UINT64_C(0x0101010101010101)) & ~x & UINT64_C(0x8080808080808080)) )
+            continue;
+
+        for( unsigned i = 0; i < 8; i++ )
+            if( p[i] == 0 && p[i + 1] == 0 && p[i + 2] == 3 )
+                return &p[i + 2] + 1 < end ? &p[i + 2] : end;
+    }
+
+    for( ; end - p >= 3; p++ )
+        if( p[0] == 0 && p[1] == 0 && p[2] == 3 )
+            return &p[2] + 1 < end ? &p[2] : end;
+
+    return end;
+}
+
+#ifdef CAN_COMPILE_SSE2
+__attribute__ ((__target__ ("sse2")))
+static inline const uint8_t *hxxx_ep3b_find_sse2( const uint8_t *p, const uint8_t *end )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i three = _mm_set1_epi8( 3 );
 
-        *pi_prev = (*pi_prev << 1) | (!*p);
+    /* Matches the 0x03 of 16 sequences at once */
+    for( ; end - p >= 16 + 2; p += 16 )
+    {
+        __m128i z0 = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *) p ), zero );
+        __m128i z1 = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)(p + 1) ), zero );
+        __m128i e = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *)(p + 2) ), three );
+        unsigned match = _mm_movemask_epi8( _mm_and_si128( _mm_and_si128( z0, z1 ), e ) );
 
-        if( *p == 0x03 &&
-           ( p + 1 ) != end ) /* Never escape sequence if no next byte */
+        if( match )
         {
-            if( (*pi_prev & 0x06) == 0x06 )
-            {
-                ++p;
-                *pi_prev = !*p;
-            }
+            const uint8_t *ep = p + 2 + ctz( match );
+            return ep + 1 < end ? ep : end;
         }
     }
-    return p;
+
+    return hxxx_ep3b_find_c( p, end );
 }
 
-#if 0
-/* Discards emulation prevention three bytes */
-static inline uint8_t * hxxx_ep3b_to_rbsp(const uint8_t *p_src, size_t i_src, size_t *pi_ret)
+static inline const uint8_t *hxxx_ep3b_find( const uint8_t *p, const uint8_t *end )
 {
-    uint8_t *p_dst;
-    if(!p_src || !(p_dst = malloc(i_src)))
-        return NULL;
-
-    size_t j = 0;
-    for (size_t i = 0; i < i_src; i++) {
-        if (i < i_src - 3 &&
-            p_src[i] == 0 && p_src[i+1] == 0 && p_src[i+2] == 3) {
-            p_dst[j++] = 0;
-            p_dst[j++] = 0;
-            i += 2;
-            continue;
-        }
-        p_dst[j++] = p_src[i];
-    }
-    *pi_ret = j;
-    return p_dst;
+    if( vlc_CPU_SSE2() )
+        return hxxx_ep3b_find_sse2( p, end );
+    else
+        return hxxx_ep3b_find_c( p, end );
 }
+#else
+# define hxxx_ep3b_find hxxx_ep3b_find_c
 #endif
 
-/* vlc_bits's bs_t forward callback for stripping emulation prevention three bytes */
+/* vlc_bits's bs_t forward callback for stripping emulation prevention three bytes.
+ * The bytes are skipped in place: the next one is looked up ahead, and the
+ * bytes before it are read directly by the bitstream reader. */
+#define HXXX_EP3B_LOOKAHEAD 64
+
 struct hxxx_bsfw_ep3b_ctx_s
 {
-    unsigned i_prev;
-    size_t i_bytepos;
+    const uint8_t *p_ep3b; /* next emulation prevention byte, or lookup limit */
+    bool b_ep3b;
+    size_t i_removed;
 };
 
 static void hxxx_bsfw_ep3b_ctx_init( struct hxxx_bsfw_ep3b_ctx_s *ctx )
 {
-    ctx->i_prev = 0;
-    ctx->i_bytepos = 0;
+    ctx->p_ep3b = NULL;
+    ctx->b_ep3b = false;
+    ctx->i_removed = 0;
+}
+
+/* Only looks a few bytes ahead, as headers are parsed out of whole slices */
+static void hxxx_bsfw_ep3b_lookup( bs_t *s, struct hxxx_bsfw_ep3b_ctx_s *ctx,
+                                   const uint8_t *p )
+{
+    const uint8_t *lim = s->p_end;
+    if( s->p_end - p > HXXX_EP3B_LOOKAHEAD )
+        lim = p + HXXX_EP3B_LOOKAHEAD;
+
+    /* a 0x03 at the limit is followed by a byte, let it be matched */
+    const uint8_t *ep = hxxx_ep3b_find( p, lim < s->p_end ? lim + 1 : lim );
+    ctx->b_ep3b = ep < lim;
+    ctx->p_ep3b = ctx->b_ep3b ? ep : lim;
+    s->p_fast_end = ctx->p_ep3b;
 }
 
 static size_t hxxx_bsfw_byte_forward_ep3b( bs_t *s, size_t i_count )
@@ -85,22 +126,50 @@ static size_t hxxx_bsfw_byte_forward_ep3b( bs_t *s, size_t i_count )
     if( s->p == NULL )
     {
         s->p = s->p_start;
-        ctx->i_bytepos = 1;
+        /* The first byte never counts as an escaped zero */
+        if( s->p_start < s->p_end )
+            hxxx_bsfw_ep3b_lookup( s, ctx, s->p_start + 1 );
+        else
+            ctx->p_ep3b = s->p_fast_end = s->p_end;
         return 1;
     }
 
     if( s->p >= s->p_end )
         return 0;
 
-    s->p = hxxx_ep3b_to_rbsp( s->p, s->p_end, &ctx->i_prev, i_count );
-    ctx->i_bytepos += i_count;
+    for( size_t i = i_count;; )
+    {
+        size_t n = __MIN( i, (size_t)(ctx->p_ep3b - s->p) );
+        s->p += n;
+        i -= n;
+        if( ctx->p_ep3b >= s->p_end )
+            break;
+
+        if( ctx->b_ep3b )
+        {
+            if( s->p != ctx->p_ep3b )
+                break;
+            /* Landed on an emulation prevention byte, step over it */
+            s->p++;
+            ctx->i_removed++;
+            hxxx_bsfw_ep3b_lookup( s, ctx, s->p );
+        }
+        else if( ctx->p_ep3b - s->p < 16 )
+            /* Look further, sequences may straddle the limit */
+            hxxx_bsfw_ep3b_lookup( s, ctx, ctx->p_ep3b - 2 );
+        else
+            break;
+    }
     return i_count;
 }
 
 static size_t hxxx_bsfw_byte_pos_ep3b( const bs_t *s )
 {
     struct hxxx_bsfw_ep3b_ctx_s *ctx = (struct hxxx_bsfw_ep3b_ctx_s *) s->p_priv;
-    return ctx->i_bytepos;
+    if( s->p == NULL )
+        return 0;
+    size_t pos = s->p - s->p_start - ctx->i_removed;
+    return s->p < s->p_end ? pos + 1 : pos;
 }
 
 static const bs_byte_callbacks_t hxxx_bsfw_ep3b_callbacks =
@@ -180,6 +180,15 @@ block_t * transcode_encoder_get_output_async( transcode_encoder_t *p_enc )
     return p_data;
 }
 
+void transcode_encoder_get_stats( transcode_encoder_t *p_enc,
+                                  transcode_encoder_stats_t *p_stats )
+{
+    if( p_enc->p_encoder->fmt_in.i_cat == VIDEO_ES && p_enc->b_threaded )
+        transcode_encoder_video_get_stats( p_enc, p_stats );
+    else
+        memset( p_stats, 0, sizeof (*p_stats) );
+}
+
 void transcode_encoder_close( transcode_encoder_t *p_enc )
 {
     if( !p_enc->p_encoder->p_module )
@@ -59,6 +59,14 @@ typedef struct
     };
 } transcode_encoder_config_t;
 
+typedef struct
+{
+    uint64_t        i_pictures;
+    uint64_t        i_batches;   /* thread wake-ups that encoded pictures */
+    size_t          i_max_queued;
+    vlc_tick_t      i_encoding;
+} transcode_encoder_stats_t;
+
 void transcode_encoder_config_init( transcode_encoder_config_t * );
 void transcode_encoder_config_clean( transcode_encoder_config_t * );
 
@@ -70,6 +78,8 @@ void transcode_encoder_update_format_out( transcode_encoder_t *, const es_format
 
 block_t * transcode_encoder_encode( transcode_encoder_t *, void * );
 block_t * transcode_encoder_get_output_async( transcode_encoder_t * );
+/* Only filled for threaded video encoders */
+void transcode_encoder_get_stats( transcode_encoder_t *, transcode_encoder_stats_t * );
 void transcode_encoder_delete( transcode_encoder_t * );
 transcode_encoder_t * transcode_encoder_new( encoder_t *, const es_format_t * );
 void transcode_encoder_close( transcode_encoder_t * );
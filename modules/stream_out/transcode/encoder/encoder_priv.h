@@ -27,10 +27,14 @@ struct transcode_encoder_t
     picture_fifo_t *pp_pics;
     vlc_sem_t       picture_pool_has_room;
     vlc_cond_t      cond;
+    size_t          i_queued; /* pictures not taken by the thread yet */
+    bool            b_idle;
 
     /* output buffers */
     block_t         *p_buffers;
     bool b_threaded;
+
+    transcode_encoder_stats_t stats;
 };
 
 int transcode_encoder_audio_open( transcode_encoder_t *p_enc,
@@ -41,6 +45,8 @@ int transcode_encoder_spu_open( transcode_encoder_t *p_enc,
                                 const transcode_encoder_config_t *p_cfg );
 
 void transcode_encoder_video_stop( transcode_encoder_t *p_enc );
+void transcode_encoder_video_get_stats( transcode_encoder_t *p_enc,
+                                        transcode_encoder_stats_t *p_stats );
 
 block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t *p_pic );
 block_t * transcode_encoder_audio_encode( transcode_encoder_t *p_enc, block_t *p_block );
@@ -292,12 +292,34 @@ void transcode_encoder_video_configure( vlc_object_t *p_obj,
              (const char *)&p_enc_in->i_chroma);
 }
 
-static picture_t *picture_fifo_LockPop( picture_fifo_t *fifo )
+/* Takes every queued picture at once, with a single lock round-trip */
+static void picture_fifo_LockPopAll( picture_fifo_t *fifo,
+                                     vlc_picture_chain_t *batch )
 {
+    picture_t *pic;
+
     picture_fifo_Lock( fifo );
-    picture_t *pic = picture_fifo_Pop( fifo );
+    while( (pic = picture_fifo_Pop( fifo )) != NULL )
+        vlc_picture_chain_Append( batch, pic );
     picture_fifo_Unlock( fifo );
-    return pic;
+}
+
+static block_t *EncodeBatch( transcode_encoder_t *p_enc,
+                             vlc_picture_chain_t *batch, unsigned *count )
+{
+    block_t *p_blocks = NULL;
+    picture_t *p_pic;
+
+    *count = 0;
+    while( (p_pic = vlc_picture_chain_PopFront( batch )) != NULL )
+    {
+        vlc_sem_post( &p_enc->picture_pool_has_room );
+        block_ChainAppend( &p_blocks,
+                           vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic ) );
+        picture_Release( p_pic );
+        (*count)++;
+    }
+    return p_blocks;
 }
 
 static void* EncoderThread( void *obj )
@@ -305,28 +327,43 @@ static void* EncoderThread( void *obj )
     vlc_thread_set_name("vlc-encoder");
 
     transcode_encoder_t *p_enc = obj;
-    picture_t *p_pic = NULL;
+    vlc_picture_chain_t batch;
     int canc = vlc_savecancel ();
     block_t *p_block = NULL;
 
+    vlc_picture_chain_Init( &batch );
     vlc_mutex_lock( &p_enc->lock_out );
 
     for( ;; )
     {
-        while( !p_enc->b_abort &&
-               (p_pic = picture_fifo_LockPop( p_enc->pp_pics )) == NULL )
+        while( !p_enc->b_abort && p_enc->i_queued == 0 )
+        {
+            p_enc->b_idle = true;
             vlc_cond_wait( &p_enc->cond, &p_enc->lock_out );
-        vlc_sem_post( &p_enc->picture_pool_has_room );
+        }
+        p_enc->b_idle = false;
 
-        if( p_pic )
+        if( p_enc->i_queued > 0 )
         {
-            /* release lock while encoding */
+            p_enc->i_queued = 0;
+
+            /* release lock while encoding, and feed the encoder every
+             * picture queued meanwhile, so that its lookahead stays full */
             vlc_mutex_unlock( &p_enc->lock_out );
-            p_block = vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
-            picture_Release( p_pic );
+            vlc_tick_t start = vlc_tick_now();
+            unsigned count;
+            picture_fifo_LockPopAll( p_enc->pp_pics, &batch );
+            p_block = EncodeBatch( p_enc, &batch, &count );
+            vlc_tick_t duration = vlc_tick_now() - start;
             vlc_mutex_lock( &p_enc->lock_out );
 
             block_ChainAppend( &p_enc->p_buffers, p_block );
+            if( count > 0 )
+            {
+                p_enc->stats.i_pictures += count;
+                p_enc->stats.i_batches++;
+                p_enc->stats.i_encoding += duration;
+            }
         }
 
         if( p_enc->b_abort )
@@ -334,13 +371,10 @@ static void* EncoderThread( void *obj )
     }
 
     /*Encode what we have in the buffer on closing*/
-    while( (p_pic = picture_fifo_LockPop( p_enc->pp_pics )) != NULL )
-    {
-        vlc_sem_post( &p_enc->picture_pool_has_room );
-        p_block = vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
-        picture_Release( p_pic );
-        block_ChainAppend( &p_enc->p_buffers, p_block );
-    }
+    unsigned count;
+    picture_fifo_LockPopAll( p_enc->pp_pics, &batch );
+    block_ChainAppend( &p_enc->p_buffers, EncodeBatch( p_enc, &batch, &count ) );
+    p_enc->stats.i_pictures += count;
 
     /*Now flush encoder*/
     do {
@@ -392,6 +426,14 @@ void transcode_encoder_video_stop( transcode_encoder_t *p_enc )
     }
 }
 
+void transcode_encoder_video_get_stats( transcode_encoder_t *p_enc,
+                                        transcode_encoder_stats_t *p_stats )
+{
+    vlc_mutex_lock( &p_enc->lock_out );
+    *p_stats = p_enc->stats;
+    vlc_mutex_unlock( &p_enc->lock_out );
+}
+
 int transcode_encoder_video_open( transcode_encoder_t *p_enc,
                                    const transcode_encoder_config_t *p_cfg )
 {
@@ -416,6 +458,9 @@ int transcode_encoder_video_open( transcode_encoder_t *p_enc,
     vlc_cond_init( &p_enc->cond );
     p_enc->p_buffers = NULL;
     p_enc->b_abort = false;
+    p_enc->b_idle = false;
+    p_enc->i_queued = 0;
+    memset( &p_enc->stats, 0, sizeof (p_enc->stats) );
 
     if( p_cfg->video.threads.i_count > 0 )
     {
@@ -441,12 +486,21 @@ block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t
     }
 
     vlc_sem_wait( &p_enc->picture_pool_has_room );
-    vlc_mutex_lock( &p_enc->lock_out );
     picture_Hold( p_pic );
     picture_fifo_Lock( p_enc->pp_pics );
     picture_fifo_Push( p_enc->pp_pics, p_pic );
     picture_fifo_Unlock( p_enc->pp_pics );
-    vlc_cond_signal( &p_enc->cond );
+
+    vlc_mutex_lock( &p_enc->lock_out );
+    p_enc->i_queued++;
+    if( p_enc->i_queued > p_enc->stats.i_max_queued )
+        p_enc->stats.i_max_queued = p_enc->i_queued;
+    /* A busy thread picks the picture up with its next batch */
+    if( p_enc->b_idle )
+        vlc_cond_signal( &p_enc->cond );
+    /* Hand over what was encoded meanwhile */
+    block_t *p_blocks = p_enc->p_buffers;
+    p_enc->p_buffers = NULL;
     vlc_mutex_unlock( &p_enc->lock_out );
-    return NULL;
+    return p_blocks;
 }
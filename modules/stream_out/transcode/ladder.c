@@ -0,0 +1,616 @@
+/*****************************************************************************
+ * ladder.c: transcoding stream output module (video renditions ladder)
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_sout.h>
+
+#include "transcode.h"
+
+/*
+ * The ladder encodes extra renditions of a transcoded video stream, from the
+ * pictures fed to its main encoder. Each rendition is scaled from the
+ * previous one, and scales and encodes on its own thread: the renditions
+ * run in parallel, as a pipeline.
+ */
+
+struct transcode_rendition
+{
+    transcode_ladder_t *ladder;
+    struct transcode_rendition *next;
+    unsigned index;
+
+    /* Shares the strings of the main configuration */
+    transcode_encoder_config_t cfg;
+    filter_chain_t *scaler; /**< from the previous rendition, if needed */
+    transcode_encoder_t *encoder;
+    void *downstream_id;
+    es_format_t fmt_out; /**< of the downstream ES */
+    char *es_id;
+    transcode_track_pcr_helper_t *pcr_helper;
+
+    vlc_thread_t thread;
+
+    /* Guarded by lock */
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    vlc_cond_t room;
+    picture_t **ring; /**< pictures to scale and encode */
+    size_t ring_size;
+    size_t ring_head;
+    size_t ring_count;
+    bool closing;
+    bool discard; /**< close without encoding the queued pictures */
+    block_t *out;
+    block_t **out_last;
+
+    struct
+    {
+        uint64_t pictures;
+        uint64_t bytes;
+        vlc_tick_t encoding;
+    } stats;
+};
+
+struct transcode_ladder_t
+{
+    sout_stream_t *stream;
+    sout_stream_id_sys_t *id;
+    size_t count;
+    struct transcode_rendition *renditions;
+    video_format_t src; /**< of the pictures fed to the ladder */
+    bool opened; /**< the rendition threads are running */
+    bool drained;
+};
+
+static picture_t *ladder_filter_buffer_new( filter_t *p_filter )
+{
+    return picture_NewFromFormat( &p_filter->fmt_out.video );
+}
+
+static vlc_decoder_device *ladder_filter_hold_device( vlc_object_t *o,
+                                                      void *sys )
+{
+    VLC_UNUSED(o); VLC_UNUSED(sys);
+    return NULL;
+}
+
+static const struct filter_video_callbacks ladder_filter_video_cbs =
+{
+    ladder_filter_buffer_new, ladder_filter_hold_device,
+};
+
+static vlc_decoder_device *ladder_get_encoder_device( encoder_t *enc )
+{
+    VLC_UNUSED(enc);
+    return NULL;
+}
+
+static const struct encoder_owner_callbacks ladder_encoder_cbs =
+{
+    .video.get_device = ladder_get_encoder_device,
+};
+
+static void RenditionPush( struct transcode_rendition *r, picture_t *pic )
+{
+    vlc_mutex_lock( &r->lock );
+    while( r->ring_count == r->ring_size )
+        vlc_cond_wait( &r->room, &r->lock );
+    r->ring[(r->ring_head + r->ring_count++) % r->ring_size] = pic;
+    vlc_cond_signal( &r->wait );
+    vlc_mutex_unlock( &r->lock );
+}
+
+static void RenditionOutput( struct transcode_rendition *r, block_t *out,
+                             vlc_tick_t encoding )
+{
+    uint64_t bytes = 0;
+    for( const block_t *b = out; b != NULL; b = b->p_next )
+        bytes += b->i_buffer;
+
+    vlc_mutex_lock( &r->lock );
+    r->stats.bytes += bytes;
+    r->stats.encoding += encoding;
+    block_ChainLastAppend( &r->out_last, out );
+    vlc_mutex_unlock( &r->lock );
+}
+
+static void *RenditionThread( void *data )
+{
+    struct transcode_rendition *r = data;
+
+    vlc_thread_set_name( "vlc-rendition" );
+
+    vlc_mutex_lock( &r->lock );
+    for( ;; )
+    {
+        while( r->ring_count == 0 && !r->closing )
+            vlc_cond_wait( &r->wait, &r->lock );
+        if( r->ring_count == 0 || r->discard )
+            break; /* closing, and nothing left to encode */
+
+        picture_t *pic = r->ring[r->ring_head];
+        r->ring_head = (r->ring_head + 1) % r->ring_size;
+        r->ring_count--;
+        r->stats.pictures++;
+        vlc_cond_signal( &r->room );
+        vlc_mutex_unlock( &r->lock );
+
+        if( r->scaler != NULL )
+            pic = filter_chain_VideoFilter( r->scaler, pic );
+
+        if( pic != NULL )
+        {
+            /* The next rendition is scaled from this one */
+            if( r->next != NULL )
+                RenditionPush( r->next, picture_Hold( pic ) );
+
+            vlc_tick_t start = vlc_tick_now();
+            block_t *out = transcode_encoder_encode( r->encoder, pic );
+            picture_Release( pic );
+            RenditionOutput( r, out, vlc_tick_now() - start );
+        }
+
+        vlc_mutex_lock( &r->lock );
+    }
+    const bool discard = r->discard;
+    vlc_mutex_unlock( &r->lock );
+
+    if( !discard )
+    {
+        block_t *out = NULL;
+        vlc_tick_t start = vlc_tick_now();
+        transcode_encoder_drain( r->encoder, &out );
+        RenditionOutput( r, out, vlc_tick_now() - start );
+    }
+    return NULL;
+}
+
+/* Parses "WIDTHxHEIGHT@KBPS" or "HEIGHT@KBPS" */
+static int ParseRendition( const char *psz, unsigned *w, unsigned *h,
+                           unsigned *kbps )
+{
+    char *end;
+
+    *w = *h = *kbps = 0;
+    unsigned long v = strtoul( psz, &end, 10 );
+    if( end == psz )
+        return VLC_EGENERIC;
+    if( *end == 'x' )
+    {
+        *w = v;
+        psz = end + 1;
+        v = strtoul( psz, &end, 10 );
+        if( end == psz )
+            return VLC_EGENERIC;
+    }
+    *h = v;
+    if( *end == '@' )
+    {
+        psz = end + 1;
+        *kbps = strtoul( psz, &end, 10 );
+        if( end == psz )
+            return VLC_EGENERIC;
+    }
+    return *end == '\0' && *h > 0 ? VLC_SUCCESS : VLC_EGENERIC;
+}
+
+transcode_ladder_t *transcode_ladder_New( sout_stream_t *p_stream,
+                                          sout_stream_id_sys_t *id,
+                                          const char *psz_ladder )
+{
+    char *list = strdup( psz_ladder );
+    transcode_ladder_t *ladder = calloc( 1, sizeof (*ladder) );
+    if( unlikely(list == NULL || ladder == NULL) )
+        goto error;
+
+    ladder->stream = p_stream;
+    ladder->id = id;
+
+    const transcode_encoder_config_t *base = id->p_enccfg;
+    char *saveptr;
+    for( const char *psz = strtok_r( list, ",", &saveptr ); psz != NULL;
+         psz = strtok_r( NULL, ",", &saveptr ) )
+    {
+        unsigned w, h, kbps;
+
+        while( *psz == ' ' )
+            psz++;
+        if( ParseRendition( psz, &w, &h, &kbps ) != VLC_SUCCESS )
+        {
+            msg_Err( p_stream, "invalid rendition \"%s\"", psz );
+            goto error;
+        }
+
+        struct transcode_rendition *renditions =
+            realloc( ladder->renditions,
+                     (ladder->count + 1) * sizeof (*renditions) );
+        if( unlikely(renditions == NULL) )
+            goto error;
+        ladder->renditions = renditions;
+
+        struct transcode_rendition *r = &renditions[ladder->count];
+        memset( r, 0, sizeof (*r) );
+        r->index = ladder->count++;
+        r->cfg = *base;
+        r->cfg.video.f_scale = 0.f;
+        r->cfg.video.i_width = w;
+        r->cfg.video.i_height = h;
+        r->cfg.video.i_maxwidth = r->cfg.video.i_maxheight = 0;
+        r->cfg.video.i_bitrate = kbps * 1000;
+        /* The rendition thread is the encoder thread */
+        r->cfg.video.threads.i_count = 0;
+    }
+    free( list );
+
+    if( ladder->count == 0 )
+    {
+        free( ladder );
+        return NULL;
+    }
+
+    const sout_stream_sys_t *p_sys = p_stream->p_sys;
+    for( size_t i = 0; i < ladder->count; i++ )
+    {
+        struct transcode_rendition *r = &ladder->renditions[i];
+        r->ladder = ladder;
+        r->next = i + 1 < ladder->count ? &ladder->renditions[i + 1] : NULL;
+        vlc_mutex_init( &r->lock );
+        vlc_cond_init( &r->wait );
+        vlc_cond_init( &r->room );
+        r->out_last = &r->out;
+        r->ring_size = __MAX( base->video.threads.pool_size, 1 );
+        es_format_Init( &r->fmt_out, VIDEO_ES, 0 );
+    }
+
+    /* Each rendition is a track of its own for the PCR forwarding */
+    for( size_t i = 0; i < ladder->count && p_sys->pcr_forwarding_enabled; i++ )
+    {
+        struct transcode_rendition *r = &ladder->renditions[i];
+        // TODO properly estimate the delay
+        r->pcr_helper = transcode_track_pcr_helper_New( p_sys->pcr_sync,
+                                                        VLC_TICK_FROM_SEC( 4 ) );
+        if( unlikely(r->pcr_helper == NULL) )
+        {
+            while( i > 0 )
+                transcode_track_pcr_helper_Delete( ladder->renditions[--i].pcr_helper );
+            goto error;
+        }
+    }
+
+    msg_Dbg( p_stream, "encoding %zu extra video rendition(s)", ladder->count );
+    return ladder;
+
+error:
+    if( ladder != NULL )
+        free( ladder->renditions );
+    free( ladder );
+    free( list );
+    return NULL;
+}
+
+static void RenditionStats( sout_stream_t *p_stream,
+                            const struct transcode_rendition *r )
+{
+    if( r->stats.pictures == 0 )
+        return;
+
+    const video_format_t *fmt = &r->fmt_out.video;
+    double seconds = fmt->i_frame_rate > 0
+        ? (double)r->stats.pictures * fmt->i_frame_rate_base
+                                    / fmt->i_frame_rate : 0.;
+    msg_Info( p_stream, "rendition %u %ux%u: %"PRIu64" pictures, "
+              "%"PRIu64" kB, %.0f kb/s, encoded at %.1f fps", r->index + 1,
+              fmt->i_visible_width, fmt->i_visible_height,
+              r->stats.pictures, r->stats.bytes / 1024,
+              seconds > 0. ? r->stats.bytes * 8 / seconds / 1000 : 0.,
+              r->stats.encoding > 0
+              ? r->stats.pictures * (double)CLOCK_FREQ / r->stats.encoding
+              : 0. );
+}
+
+/* Releases the scaler and the encoder, the downstream ES is kept */
+static void RenditionReset( struct transcode_rendition *r )
+{
+    if( r->ring != NULL )
+        for( size_t i = 0; i < r->ring_count; i++ )
+            picture_Release( r->ring[(r->ring_head + i) % r->ring_size] );
+    free( r->ring );
+    r->ring = NULL;
+    r->ring_head = r->ring_count = 0;
+    r->closing = r->discard = false;
+    if( r->scaler != NULL )
+    {
+        filter_chain_Delete( r->scaler );
+        r->scaler = NULL;
+    }
+    if( r->encoder != NULL )
+    {
+        transcode_encoder_delete( r->encoder );
+        r->encoder = NULL;
+    }
+}
+
+static void RenditionClean( sout_stream_t *p_stream,
+                            struct transcode_rendition *r )
+{
+    RenditionReset( r );
+    block_ChainRelease( r->out );
+    if( r->downstream_id != NULL )
+        sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+    es_format_Clean( &r->fmt_out );
+    free( r->es_id );
+    if( r->pcr_helper != NULL )
+        transcode_track_pcr_helper_Delete( r->pcr_helper );
+}
+
+static void RenditionStop( struct transcode_rendition *r, bool discard )
+{
+    vlc_mutex_lock( &r->lock );
+    r->closing = true;
+    r->discard = discard;
+    vlc_cond_signal( &r->wait );
+    vlc_mutex_unlock( &r->lock );
+    vlc_join( r->thread, NULL );
+}
+
+static int RenditionOpen( struct transcode_rendition *r, const es_format_t *src )
+{
+    transcode_ladder_t *ladder = r->ladder;
+    sout_stream_t *p_stream = ladder->stream;
+
+    encoder_t *p_encoder = sout_EncoderCreate( p_stream, sizeof (*p_encoder) );
+    r->encoder = transcode_encoder_new( p_encoder, src );
+    if( r->encoder == NULL )
+        return VLC_EGENERIC;
+    p_encoder->cbs = &ladder_encoder_cbs;
+
+    transcode_encoder_video_configure( VLC_OBJECT(p_stream), &src->video,
+                                       &r->cfg, &src->video, NULL,
+                                       r->encoder );
+    if( transcode_encoder_open( r->encoder, &r->cfg ) != VLC_SUCCESS )
+    {
+        msg_Err( p_stream, "cannot open the encoder of rendition %u",
+                 r->index + 1 );
+        return VLC_EGENERIC;
+    }
+
+    const es_format_t *enc_in = transcode_encoder_format_in( r->encoder );
+    if( !video_format_IsSimilar( &src->video, &enc_in->video ) )
+    {
+        filter_owner_t owner = {
+            .video = &ladder_filter_video_cbs,
+        };
+
+        r->scaler = filter_chain_NewVideo( p_stream, false, &owner );
+        if( r->scaler == NULL )
+            return VLC_EGENERIC;
+        filter_chain_Reset( r->scaler, src, NULL, enc_in );
+        if( filter_chain_AppendConverter( r->scaler, NULL ) != VLC_SUCCESS )
+        {
+            msg_Err( p_stream, "cannot scale rendition %u", r->index + 1 );
+            return VLC_EGENERIC;
+        }
+    }
+
+    r->ring = vlc_alloc( r->ring_size, sizeof (*r->ring) );
+    if( unlikely(r->ring == NULL) )
+        return VLC_ENOMEM;
+
+    /* The renditions of "video/0" are "video/0/1", "video/0/2"... */
+    const char *es_id = ladder->id->es_id != NULL ? ladder->id->es_id : "video";
+    if( r->es_id == NULL
+     && asprintf( &r->es_id, "%s/%u", es_id, r->index + 1 ) < 0 )
+    {
+        r->es_id = NULL;
+        return VLC_ENOMEM;
+    }
+
+    /* A restarted rendition keeps its ES, unless its output changed */
+    const es_format_t *enc_out = transcode_encoder_format_out( r->encoder );
+    if( r->downstream_id != NULL && !es_format_IsSimilar( &r->fmt_out, enc_out ) )
+    {
+        sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+        r->downstream_id = NULL;
+    }
+    if( r->downstream_id == NULL )
+    {
+        es_format_t fmt;
+        es_format_Copy( &fmt, enc_out );
+        fmt.i_group = ladder->id->p_decoder->fmt_in->i_group;
+        fmt.i_id = -1; /* let the muxer number the renditions */
+        r->downstream_id = sout_StreamIdAdd( p_stream->p_next, &fmt, r->es_id );
+        es_format_Clean( &r->fmt_out );
+        r->fmt_out = fmt;
+        if( r->downstream_id == NULL )
+            return VLC_EGENERIC;
+    }
+
+    if( vlc_clone( &r->thread, RenditionThread, r ) )
+        return VLC_EGENERIC;
+
+    msg_Dbg( p_stream, "rendition %u: %ux%u %4.4s %u kb/s", r->index + 1,
+             enc_in->video.i_visible_width, enc_in->video.i_visible_height,
+             (const char *)&r->cfg.i_codec, r->cfg.video.i_bitrate / 1000 );
+    return VLC_SUCCESS;
+}
+
+/* Drops the renditions from the given index */
+static void LadderTruncate( transcode_ladder_t *ladder, size_t count )
+{
+    for( size_t i = count; i < ladder->count; i++ )
+        RenditionClean( ladder->stream, &ladder->renditions[i] );
+    ladder->count = count;
+    if( count > 0 )
+        ladder->renditions[count - 1].next = NULL;
+}
+
+static int LadderOpen( transcode_ladder_t *ladder, const es_format_t *fmt )
+{
+    const es_format_t *src = fmt;
+    for( size_t i = 0; i < ladder->count; i++ )
+    {
+        struct transcode_rendition *r = &ladder->renditions[i];
+
+        if( RenditionOpen( r, src ) != VLC_SUCCESS )
+        {
+            /* Keep the renditions that could open */
+            LadderTruncate( ladder, i );
+            break;
+        }
+        src = transcode_encoder_format_in( r->encoder );
+    }
+    if( ladder->count == 0 )
+        return VLC_EGENERIC;
+
+    ladder->opened = true;
+    video_format_Copy( &ladder->src, &fmt->video );
+    return VLC_SUCCESS;
+}
+
+/* Stops the rendition threads, and releases their encoders */
+static void LadderClose( transcode_ladder_t *ladder, bool discard )
+{
+    assert( ladder->opened );
+
+    /* In order, so that each rendition got all its pictures before closing */
+    for( size_t i = 0; i < ladder->count; i++ )
+        RenditionStop( &ladder->renditions[i], discard );
+
+    for( size_t i = 0; i < ladder->count; i++ )
+        RenditionReset( &ladder->renditions[i] );
+
+    video_format_Clean( &ladder->src );
+    ladder->opened = false;
+}
+
+void transcode_ladder_Push( transcode_ladder_t *ladder, const es_format_t *src,
+                            picture_t *pic )
+{
+    if( ladder->drained || ladder->count == 0 )
+        return;
+
+    if( ladder->opened && !video_format_IsSimilar( &ladder->src, &src->video ) )
+    {
+        /* The scalers and the encoders are set up for a single format:
+         * encode the queued pictures, then start over */
+        msg_Dbg( ladder->stream, "video format changed, restarting the "
+                 "renditions" );
+        LadderClose( ladder, false );
+    }
+
+    if( !ladder->opened )
+    {
+        if( pic->context != NULL )
+        {
+            msg_Warn( ladder->stream, "video renditions need pictures in "
+                      "system memory, disabled" );
+            LadderTruncate( ladder, 0 );
+            return;
+        }
+        if( LadderOpen( ladder, src ) != VLC_SUCCESS )
+            return;
+    }
+
+    RenditionPush( &ladder->renditions[0], picture_Hold( pic ) );
+}
+
+void transcode_ladder_SignalInput( transcode_ladder_t *ladder,
+                                   const block_t *in )
+{
+    const sout_stream_sys_t *p_sys = ladder->stream->p_sys;
+    if( !p_sys->pcr_forwarding_enabled )
+        return;
+
+    for( size_t i = 0; i < ladder->count; i++ )
+    {
+        vlc_tick_t dropped_frame_ts;
+        transcode_track_pcr_helper_SignalEnteringFrame(
+            ladder->renditions[i].pcr_helper, in, &dropped_frame_ts );
+        if( dropped_frame_ts != VLC_TICK_INVALID )
+            sout_StreamSetPCR( ladder->stream->p_next, dropped_frame_ts );
+    }
+}
+
+void transcode_ladder_Drain( transcode_ladder_t *ladder )
+{
+    if( ladder->drained )
+        return;
+    ladder->drained = true;
+    if( ladder->opened )
+        LadderClose( ladder, false );
+}
+
+void transcode_ladder_Flush( transcode_ladder_t *ladder )
+{
+    if( ladder->opened )
+        LadderClose( ladder, true );
+
+    /* The encoders are created again for the next picture, including after
+     * a drain: the flush starts a new segment of the stream */
+    ladder->drained = false;
+    for( size_t i = 0; i < ladder->count; i++ )
+    {
+        struct transcode_rendition *r = &ladder->renditions[i];
+        block_ChainRelease( r->out );
+        r->out = NULL;
+        r->out_last = &r->out;
+    }
+}
+
+void transcode_ladder_Send( transcode_ladder_t *ladder )
+{
+    for( size_t i = 0; i < ladder->count; i++ )
+    {
+        struct transcode_rendition *r = &ladder->renditions[i];
+
+        vlc_mutex_lock( &r->lock );
+        block_t *out = r->out;
+        r->out = NULL;
+        r->out_last = &r->out;
+        vlc_mutex_unlock( &r->lock );
+
+        if( out != NULL )
+            transcode_track_SendOutput( ladder->stream, r->pcr_helper,
+                                        r->downstream_id, out );
+    }
+}
+
+void transcode_ladder_Delete( transcode_ladder_t *ladder )
+{
+    transcode_ladder_Drain( ladder );
+
+    for( size_t i = 0; i < ladder->count; i++ )
+    {
+        RenditionStats( ladder->stream, &ladder->renditions[i] );
+        RenditionClean( ladder->stream, &ladder->renditions[i] );
+    }
+    free( ladder->renditions );
+    free( ladder );
+}
@@ -76,6 +76,12 @@
 #define MAXHEIGHT_TEXT N_("Maximum video height")
 #define MAXHEIGHT_LONGTEXT N_( \
     "Maximum output video height." )
+#define LADDER_TEXT N_("Video renditions")
+#define LADDER_LONGTEXT N_( \
+    "Extra video renditions to encode along the main one, as a comma " \
+    "separated list of WIDTHxHEIGHT@KBPS, or HEIGHT@KBPS to keep the aspect " \
+    "ratio. Each rendition is scaled from the previous one, and encoded on " \
+    "its own thread." )
 #define VFILTER_TEXT N_("Video filter")
 #define VFILTER_LONGTEXT N_( \
     "Video filters will be applied to the video streams (after overlays " \
@@ -184,6 +190,8 @@ vlc_module_begin ()
                  MAXWIDTH_LONGTEXT )
     add_integer( SOUT_CFG_PREFIX "maxheight", 0, MAXHEIGHT_TEXT,
                  MAXHEIGHT_LONGTEXT )
+    add_string( SOUT_CFG_PREFIX "ladder", NULL, LADDER_TEXT,
+                LADDER_LONGTEXT )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
 
@@ -232,7 +240,7 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    "forward-pcr", NULL
+    "forward-pcr", "ladder", NULL
 };
 
 /*****************************************************************************
@@ -460,6 +468,12 @@ static int Open( vlc_object_t *p_this )
                  p_sys->venc_cfg.video.i_bitrate / 1000 );
     }
 
+    psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "ladder" );
+    if( psz_string && *psz_string )
+        p_sys->psz_ladder = psz_string;
+    else
+        free( psz_string );
+
     /* Video Filter Parameters */
     sout_filters_config_init( &p_sys->vfilters_cfg );
 
@@ -517,6 +531,7 @@ static void Close( sout_stream_t *p_stream )
 
     transcode_encoder_config_clean( &p_sys->venc_cfg );
     sout_filters_config_clean( &p_sys->vfilters_cfg );
+    free( p_sys->psz_ladder );
 
     transcode_encoder_config_clean( &p_sys->aenc_cfg );
     sout_filters_config_clean( &p_sys->afilters_cfg );
@@ -779,6 +794,51 @@ static void Del( sout_stream_t *p_stream, void *_id )
     DeleteSoutStreamID( id );
 }
 
+/**
+ * Sends the output of a transcoded track downstream, each frame followed by
+ * the PCR it releases, if any.
+ */
+int transcode_track_SendOutput( sout_stream_t *p_stream,
+                                transcode_track_pcr_helper_t *pcr_helper,
+                                void *downstream_id, block_t *p_out )
+{
+    sout_stream_sys_t *sys = p_stream->p_sys;
+
+    for( block_t *it = p_out; it != NULL; )
+    {
+        block_t *next = it->p_next;
+        it->p_next = NULL;
+
+        vlc_tick_t pcr = VLC_TICK_INVALID;
+        if( sys->pcr_forwarding_enabled )
+        {
+            const int status = transcode_track_pcr_helper_SignalLeavingFrame(
+                pcr_helper, it, &pcr );
+            if( status != VLC_SUCCESS )
+            {
+                msg_Err( p_stream,
+                         "Failed to match transcode input with encoder output. "
+                         "Disabling PCR forwarding..." );
+                sys->pcr_forwarding_enabled = false;
+            }
+        }
+
+        if( sout_StreamIdSend( p_stream->p_next, downstream_id, it ) != VLC_SUCCESS )
+        {
+            block_ChainRelease( next );
+            return VLC_EGENERIC;
+        }
+
+        if( pcr != VLC_TICK_INVALID )
+        {
+            sout_StreamSetPCR( p_stream->p_next, pcr );
+        }
+
+        it = next;
+    }
+    return VLC_SUCCESS;
+}
+
 static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 {
     sout_stream_id_sys_t *id = (sout_stream_id_sys_t *)_id;
@@ -829,38 +889,9 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
         goto error;
     }
 
-    for( block_t *it = p_out; it != NULL; )
-    {
-        block_t *next = it->p_next;
-        it->p_next = NULL;
-
-        vlc_tick_t pcr = VLC_TICK_INVALID;
-        if( sys->pcr_forwarding_enabled )
-        {
-            const int status = transcode_track_pcr_helper_SignalLeavingFrame(
-                id->pcr_helper, it, &pcr );
-            if( status != VLC_SUCCESS )
-            {
-                msg_Err( p_stream,
-                         "Failed to match transcode input with encoder output. "
-                         "Disabling PCR forwarding..." );
-                sys->pcr_forwarding_enabled = false;
-            }
-        }
-
-        if( sout_StreamIdSend( p_stream->p_next, id->downstream_id, it ) != VLC_SUCCESS )
-        {
-            p_buffer = next;
-            goto error;
-        }
-
-        if( pcr != VLC_TICK_INVALID )
-        {
-            sout_StreamSetPCR( p_stream->p_next, pcr );
-        }
-
-        it = next;
-    }
+    if( transcode_track_SendOutput( p_stream, id->pcr_helper,
+                                    id->downstream_id, p_out ) != VLC_SUCCESS )
+        return VLC_EGENERIC;
 
     if (i_ret != VLC_SUCCESS)
         id->b_error = true;
@@ -42,6 +42,7 @@ void sout_filters_config_clean( sout_filters_config_t *p_cfg )
 }
 
 typedef struct sout_stream_id_sys_t sout_stream_id_sys_t;
+typedef struct transcode_ladder_t transcode_ladder_t;
 
 typedef struct
 {
@@ -54,6 +55,7 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    char *psz_ladder; /**< extra renditions */
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -134,6 +136,7 @@ struct sout_stream_id_sys_t
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             transcode_ladder_t *ladder; /**< extra renditions */
          };
          struct
          {
@@ -199,6 +202,10 @@ static inline void es_format_SetMeta( es_format_t *p_dst, const es_format_t *p_s
     }
 }
 
+int transcode_track_SendOutput( sout_stream_t *,
+                                transcode_track_pcr_helper_t *,
+                                void *downstream_id, block_t *p_out );
+
 static inline void transcode_remove_filters( filter_chain_t **pp )
 {
     if( *pp )
@@ -234,3 +241,16 @@ int transcode_video_get_output_dimensions( sout_stream_id_sys_t *,
 void transcode_video_push_spu( sout_stream_t *, sout_stream_id_sys_t *, subpicture_t * );
 int  transcode_video_init    ( sout_stream_t *, const es_format_t *,
                                sout_stream_id_sys_t *);
+
+/* LADDER */
+
+transcode_ladder_t *transcode_ladder_New( sout_stream_t *,
+                                          sout_stream_id_sys_t *,
+                                          const char *psz_ladder );
+void transcode_ladder_Delete( transcode_ladder_t * );
+void transcode_ladder_Push( transcode_ladder_t *, const es_format_t *,
+                            picture_t * );
+void transcode_ladder_SignalInput( transcode_ladder_t *, const block_t * );
+void transcode_ladder_Drain( transcode_ladder_t * );
+void transcode_ladder_Flush( transcode_ladder_t * );
+void transcode_ladder_Send( transcode_ladder_t * );
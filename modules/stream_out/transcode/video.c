@@ -321,6 +321,10 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
         es_format_Copy( &id->decoder_out, &id->p_decoder->fmt_out );
     }
 
+    const sout_stream_sys_t *p_sys = p_stream->p_sys;
+    if( p_sys->psz_ladder != NULL )
+        id->ladder = transcode_ladder_New( p_stream, id, p_sys->psz_ladder );
+
     return VLC_SUCCESS;
 }
 
@@ -401,13 +405,29 @@ void transcode_video_flush( sout_stream_id_sys_t *id )
         filter_chain_VideoFlush( id->p_uf_chain );
     if ( id->p_final_conv_static != NULL )
         filter_chain_VideoFlush( id->p_final_conv_static );
+    if( id->ladder != NULL )
+        transcode_ladder_Flush( id->ladder );
 }
 
 void transcode_video_clean( sout_stream_id_sys_t *id )
 {
+    if( id->ladder )
+        transcode_ladder_Delete( id->ladder );
+
     /* Close encoder, but only if one was opened. */
     if ( id->encoder )
+    {
+        transcode_encoder_stats_t stats;
+        transcode_encoder_get_stats( id->encoder, &stats );
+        if( stats.i_batches > 0 )
+            msg_Dbg( id->p_decoder, "encoded %"PRIu64" pictures at %.1f fps, "
+                     "%.1f pictures per batch, up to %zu queued",
+                     stats.i_pictures, stats.i_encoding > 0
+                     ? stats.i_pictures * (double)CLOCK_FREQ / stats.i_encoding
+                     : 0., (double)stats.i_pictures / stats.i_batches,
+                     stats.i_max_queued );
         transcode_encoder_delete( id->encoder );
+    }
 
     es_format_Clean( &id->decoder_out );
 
@@ -544,6 +564,11 @@ static int transcode_process_picture( sout_stream_id_sys_t *id,
 
             if( p_in )
             {
+                if( id->ladder )
+                    transcode_ladder_Push( id->ladder,
+                                           transcode_encoder_format_in( id->encoder ),
+                                           p_in );
+
                 /* If a packetizer is used, multiple blocks might be returned, in w */
                 block_t *p_encoded = transcode_encoder_encode( id->encoder, p_in );
                 picture_Release( p_in );
@@ -562,6 +587,10 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
 
     bool b_eos = in && (in->i_flags & BLOCK_FLAG_END_OF_SEQUENCE);
 
+    /* The renditions output the same frames as the main encoder */
+    if( id->ladder != NULL && in != NULL )
+        transcode_ladder_SignalInput( id->ladder, in );
+
     int ret = id->p_decoder->pf_decode( id->p_decoder, in );
     if( ret != VLCDEC_SUCCESS )
         return VLC_EGENERIC;
@@ -573,6 +602,13 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( id->encoder == NULL )
         return VLC_SUCCESS;
 
+    if( id->ladder )
+    {
+        if( unlikely( in == NULL ) )
+            transcode_ladder_Drain( id->ladder );
+        transcode_ladder_Send( id->ladder );
+    }
+
     vlc_fifo_Lock( id->output_fifo );
     if( unlikely( !id->b_error && in == NULL ) && transcode_encoder_opened( id->encoder ) )
     {
@@ -41,12 +41,14 @@
 #include <vlc_subpicture.h>
 #include <vlc_text_style.h>                                   /* text_style_t*/
 #include <vlc_charset.h>
+#include <vlc_memstream.h>
 
 #include <assert.h>
 
 #include "platform_fonts.h"
 #include "freetype.h"
 #include "text_layout.h"
+#include "lru.h"
 #include "blend/rgb.h"
 #include "blend/yuv.h"
 
@@ -87,6 +89,9 @@ static void Destroy( filter_t * );
 #define SHADOW_DISTANCE_TEXT N_("Shadow distance")
 #define CACHE_SIZE_TEXT N_("Cache size")
 #define CACHE_SIZE_LONGTEXT N_("Cache size in kBytes")
+#define REGION_CACHE_TEXT N_("Rendered regions cache")
+#define REGION_CACHE_LONGTEXT N_("Number of rendered text regions kept " \
+    "for reuse while the same text stays on screen. 0 disables the cache.")
 
 #define TEXT_DIRECTION_TEXT N_("Text direction")
 #define TEXT_DIRECTION_LONGTEXT N_("Paragraph base direction for the Unicode bi-directional algorithm.")
@@ -184,6 +189,9 @@ vlc_module_begin ()
     add_integer_with_range( "freetype-cache-size", 200, 25, (UINT32_MAX >> 10),
                             CACHE_SIZE_TEXT, CACHE_SIZE_LONGTEXT )
         change_safe()
+    add_integer_with_range( "freetype-region-cache", 32, 0, 1024,
+                            REGION_CACHE_TEXT, REGION_CACHE_LONGTEXT )
+        change_safe()
 
     add_obsolete_integer( "freetype-fontsize" ) /* since 4.0.0 */
     add_obsolete_integer( "freetype-rel-fontsize" ) /* since 4.0.0 */
@@ -918,6 +926,182 @@ static size_t SegmentsToTextAndStyles( filter_t *p_filter, const text_segment_t
     return i_nb_char;
 }
 
+/*****************************************************************************
+ * Rendered regions cache
+ *****************************************************************************
+ * A subtitle usually stays on screen for many frames, and each of them
+ * requests the same rendering. Keep the resulting pictures, keyed on
+ * everything the layout and the blending depend on, and hand out new
+ * references to them instead of shaping and blending again.
+ *
+ * The position of the source region is not part of the key, so that moving
+ * text hits the cache too: it is applied again to the cached region.
+ *****************************************************************************/
+typedef struct
+{
+    video_format_t fmt;
+    picture_t *p_picture;
+    int i_x; /* position relative to the source region */
+    int i_y;
+} cached_region_t;
+
+static void CachedRegionRelease( void *priv, void *value )
+{
+    VLC_UNUSED(priv);
+    cached_region_t *p_cached = value;
+    picture_Release( p_cached->p_picture );
+    video_format_Clean( &p_cached->fmt );
+    free( p_cached );
+}
+
+static void AppendStyleKey( struct vlc_memstream *ms, const text_style_t *p_style )
+{
+    if( !p_style )
+    {
+        vlc_memstream_putc( ms, '-' );
+        return;
+    }
+    vlc_memstream_printf( ms, "%s\x1f%s\x1f%x:%x:%a:%d:%x:%x:%d:%x:%x:%d:%x:%x:%d:%x:%x:%d|",
+                          p_style->psz_fontname ? p_style->psz_fontname : "",
+                          p_style->psz_monofontname ? p_style->psz_monofontname : "",
+                          p_style->i_features, p_style->i_style_flags,
+                          p_style->f_font_relsize, p_style->i_font_size,
+                          p_style->i_font_color, p_style->i_font_alpha,
+                          p_style->i_spacing,
+                          p_style->i_outline_color, p_style->i_outline_alpha,
+                          p_style->i_outline_width,
+                          p_style->i_shadow_color, p_style->i_shadow_alpha,
+                          p_style->i_shadow_width,
+                          p_style->i_background_color, p_style->i_background_alpha,
+                          (int) p_style->e_wrapinfo );
+}
+
+/* Size available to lay the text out, which depends on the region position
+ * when the region has no maximum size */
+static void GetRegionMaxSize( filter_t *p_filter,
+                              const subpicture_region_t *p_region_in,
+                              unsigned *pi_max_width, unsigned *pi_max_height )
+{
+    unsigned i_max_width = p_filter->fmt_out.video.i_visible_width;
+    if( p_region_in->i_max_width > 0 && (unsigned) p_region_in->i_max_width < i_max_width )
+        i_max_width = p_region_in->i_max_width;
+    else if( p_region_in->i_x > 0 && (unsigned)p_region_in->i_x < i_max_width )
+        i_max_width -= p_region_in->i_x;
+
+    unsigned i_max_height = p_filter->fmt_out.video.i_visible_height;
+    if( p_region_in->i_max_height > 0 && (unsigned) p_region_in->i_max_height < i_max_height )
+        i_max_height = p_region_in->i_max_height;
+    else if( p_region_in->i_y > 0 && (unsigned)p_region_in->i_y < i_max_height )
+        i_max_height -= p_region_in->i_y;
+
+    *pi_max_width = i_max_width;
+    *pi_max_height = i_max_height;
+}
+
+static char *CreateRegionCacheKey( filter_t *p_filter,
+                                   const subpicture_region_t *p_region_in,
+                                   const vlc_fourcc_t *p_chroma_list )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const video_format_t *p_fmt = &p_region_in->fmt;
+    struct vlc_memstream ms;
+
+    /* The layout only depends on the position through the available size,
+     * while the requested size also pads the region for the alignment */
+    unsigned i_max_width, i_max_height;
+    GetRegionMaxSize( p_filter, p_region_in, &i_max_width, &i_max_height );
+
+    if( vlc_memstream_open( &ms ) )
+        return NULL;
+
+    vlc_memstream_printf( &ms, "%ux%u:%d:%d:%d:%4.4s|",
+                          p_filter->fmt_out.video.i_visible_width,
+                          p_filter->fmt_out.video.i_visible_height,
+                          p_sys->i_scale, p_sys->i_font_default_size,
+                          p_sys->i_outline_thickness,
+                          (const char *) &p_sys->i_forced_chroma );
+    if( p_chroma_list )
+        for( ; *p_chroma_list != 0; p_chroma_list++ )
+            vlc_memstream_printf( &ms, "%4.4s", (const char *) p_chroma_list );
+    vlc_memstream_printf( &ms, "|%d:%d:%u:%u:%d:%d|%u:%u:%d:%d:%d|",
+                          p_region_in->text_flags, p_region_in->i_align,
+                          i_max_width, i_max_height,
+                          p_region_in->i_max_width, p_region_in->i_max_height,
+                          p_fmt->i_sar_num, p_fmt->i_sar_den,
+                          (int) p_fmt->transfer, (int) p_fmt->primaries,
+                          (int) p_fmt->space );
+    vlc_memstream_printf( &ms, "%"PRIu32":%"PRIu32"|",
+                          p_fmt->mastering.max_luminance,
+                          p_fmt->mastering.min_luminance );
+    for( size_t i = 0; i < ARRAY_SIZE(p_fmt->mastering.primaries); i++ )
+        vlc_memstream_printf( &ms, "%"PRIu16",", p_fmt->mastering.primaries[i] );
+    vlc_memstream_printf( &ms, "%"PRIu16",%"PRIu16"|",
+                          p_fmt->mastering.white_point[0],
+                          p_fmt->mastering.white_point[1] );
+
+    AppendStyleKey( &ms, p_sys->p_default_style );
+    AppendStyleKey( &ms, p_sys->p_forced_style );
+
+    for( const text_segment_t *s = p_region_in->p_text; s; s = s->p_next )
+    {
+        vlc_memstream_putc( &ms, '\x1e' );
+        AppendStyleKey( &ms, s->style );
+        if( s->psz_text )
+            vlc_memstream_puts( &ms, s->psz_text );
+        for( const text_segment_ruby_t *r = s->p_ruby; r; r = r->p_next )
+            vlc_memstream_printf( &ms, "\x1d%s\x1d%s",
+                                  r->psz_base ? r->psz_base : "",
+                                  r->psz_rt ? r->psz_rt : "" );
+    }
+
+    if( vlc_memstream_close( &ms ) )
+        return NULL;
+    return ms.ptr;
+}
+
+static subpicture_region_t *RegionFromCache( const cached_region_t *p_cached,
+                                             const subpicture_region_t *p_region_in )
+{
+    subpicture_region_t *region = subpicture_region_ForPicture( p_cached->p_picture );
+    if( unlikely(region == NULL) )
+        return NULL;
+
+    /* The region format may carry more than the picture one (palette) */
+    video_format_Clean( &region->fmt );
+    if( video_format_Copy( &region->fmt, &p_cached->fmt ) != VLC_SUCCESS )
+    {
+        video_format_Init( &region->fmt, 0 );
+        subpicture_region_Delete( region );
+        return NULL;
+    }
+
+    region->i_x = p_cached->i_x + p_region_in->i_x;
+    region->i_y = p_cached->i_y + p_region_in->i_y;
+    region->i_alpha = p_region_in->i_alpha;
+    region->i_align = p_region_in->i_align;
+    region->b_absolute = p_region_in->b_absolute;
+    region->b_in_window = p_region_in->b_in_window;
+    return region;
+}
+
+static void RegionToCache( filter_sys_t *p_sys, const char *psz_key,
+                           const subpicture_region_t *region,
+                           const subpicture_region_t *p_region_in )
+{
+    cached_region_t *p_cached = malloc( sizeof(*p_cached) );
+    if( unlikely(p_cached == NULL) )
+        return;
+    if( video_format_Copy( &p_cached->fmt, &region->fmt ) != VLC_SUCCESS )
+    {
+        free( p_cached );
+        return;
+    }
+    p_cached->p_picture = picture_Hold( region->p_picture );
+    p_cached->i_x = region->i_x - p_region_in->i_x;
+    p_cached->i_y = region->i_y - p_region_in->i_y;
+    vlc_lru_Insert( p_sys->region_cache, psz_key, p_cached );
+}
+
 /**
  * This function renders a text subpicture region into another one.
  * It also calculates the size needed for this string, and renders the
@@ -948,6 +1132,24 @@ static subpicture_region_t *Render( filter_t *p_filter,
         p_sys->i_font_default_size = i_font_default_size;
     }
 
+    char *psz_cache_key = NULL;
+    if( p_sys->region_cache )
+    {
+        psz_cache_key = CreateRegionCacheKey( p_filter, p_region_in, p_chroma_list );
+        const cached_region_t *p_cached = psz_cache_key
+                                        ? vlc_lru_Get( p_sys->region_cache, psz_cache_key )
+                                        : NULL;
+        if( p_cached )
+        {
+            region = RegionFromCache( p_cached, p_region_in );
+            if( region )
+            {
+                free( psz_cache_key );
+                return region;
+            }
+        }
+    }
+
     layout_text_block_t text_block = { 0 };
     text_block.b_balanced = (p_region_in->text_flags & VLC_SUBPIC_TEXT_FLAG_TEXT_NOT_BALANCED) == 0;
     text_block.b_grid = b_grid;
@@ -957,6 +1159,7 @@ static subpicture_region_t *Render( filter_t *p_filter,
     {
         free( text_block.pp_styles );
         free( text_block.p_uchars );
+        free( psz_cache_key );
         return NULL;
     }
 
@@ -965,17 +1168,8 @@ static subpicture_region_t *Render( filter_t *p_filter,
     FT_BBox bbox;
     int i_max_face_height;
 
-    unsigned i_max_width = p_filter->fmt_out.video.i_visible_width;
-    if( p_region_in->i_max_width > 0 && (unsigned) p_region_in->i_max_width < i_max_width )
-        i_max_width = p_region_in->i_max_width;
-    else if( p_region_in->i_x > 0 && (unsigned)p_region_in->i_x < i_max_width )
-        i_max_width -= p_region_in->i_x;
-
-    unsigned i_max_height = p_filter->fmt_out.video.i_visible_height;
-    if( p_region_in->i_max_height > 0 && (unsigned) p_region_in->i_max_height < i_max_height )
-        i_max_height = p_region_in->i_max_height;
-    else if( p_region_in->i_y > 0 && (unsigned)p_region_in->i_y < i_max_height )
-        i_max_height -= p_region_in->i_y;
+    unsigned i_max_width, i_max_height;
+    GetRegionMaxSize( p_filter, p_region_in, &i_max_width, &i_max_height );
 
     text_block.i_max_width = i_max_width;
     text_block.i_max_height = i_max_height;
@@ -1154,6 +1348,8 @@ static subpicture_region_t *Render( filter_t *p_filter,
 
     if (region == NULL)
         msg_Warn( p_filter, "no output chroma supported for rendering" );
+    else if( psz_cache_key )
+        RegionToCache( p_sys, psz_cache_key, region, p_region_in );
 
 done:
     FreeLines( text_block.p_laid );
@@ -1162,6 +1358,7 @@ done:
     FreeStylesArray( text_block.pp_styles, text_block.i_count );
     if( text_block.pp_ruby )
         FreeRubyBlockArray( text_block.pp_ruby, text_block.i_count );
+    free( psz_cache_key );
 
     return region;
 }
@@ -1204,6 +1401,17 @@ static int Create( filter_t *p_filter )
     if( !p_sys->ftcache )
         goto error;
 
+    int i_region_cache = var_InheritInteger( p_filter, "freetype-region-cache" );
+    if( i_region_cache > 0 )
+    {
+        /* The LRU evicts as soon as an insertion reaches its maximum, so
+         * it only keeps max - 1 entries */
+        p_sys->region_cache = vlc_lru_New( i_region_cache + 1,
+                                           CachedRegionRelease, NULL );
+        if( !p_sys->region_cache )
+            goto error;
+    }
+
     p_sys->i_scale = 100;
 
     /* default style to apply to incomplete segments styles */
@@ -1270,6 +1478,9 @@ static void Destroy( filter_t *p_filter )
         DumpFamilies( p_sys->fs );
 #endif
 
+    if( p_sys->region_cache )
+        vlc_lru_Release( p_sys->region_cache );
+
     if( p_sys->ftcache )
         vlc_ftcache_Delete( p_sys->ftcache );
 
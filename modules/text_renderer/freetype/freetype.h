@@ -113,6 +113,9 @@ typedef struct
     vlc_font_select_t *fs;
     vlc_ftcache_t     *ftcache;
 
+    /* Already rendered regions, keyed on text, styles and output size */
+    struct vlc_lru    *region_cache;
+
 } filter_sys_t;
 
 /**
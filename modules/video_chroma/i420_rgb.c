@@ -58,6 +58,9 @@ static void Set8bppPalette( filter_t *, uint8_t * );
  *****************************************************************************/
 static int  Activate   ( filter_t * );
 static void Deactivate ( filter_t * );
+#if defined (PLUGIN_SSE2)
+static int  ActivateExact( filter_t * );
+#endif
 
 static void ProbeChroma(vlc_chroma_conv_vec *vec)
 {
@@ -92,6 +95,11 @@ vlc_module_begin ()
                        "RGB8,RV15,RV16,RV24,RV32 conversions") )
     set_callback_video_converter( Activate, 80 )
 # define vlc_CPU_capable() (true)
+#endif
+#if defined (PLUGIN_SSE2)
+    /* Take precedence over swscale when no scaling is involved */
+    add_submodule()
+        set_callback_video_converter( ActivateExact, 160 )
 #endif
     add_submodule()
         set_callback_chroma_conv_probe(ProbeChroma)
@@ -245,6 +253,36 @@ static int Activate( filter_t *p_filter )
     return 0;
 }
 
+#if defined (PLUGIN_SSE2)
+/*****************************************************************************
+ * ActivateExact: allocate a chroma function for unscaled conversions
+ *****************************************************************************
+ * The SIMD conversion uses fixed BT.601 limited range coefficients, leave
+ * the other cases to the more accurate converters.
+ *****************************************************************************/
+static int ActivateExact( filter_t *p_filter )
+{
+    const video_format_t *p_fmti = &p_filter->fmt_in.video;
+    const video_format_t *p_fmto = &p_filter->fmt_out.video;
+
+    if( p_fmti->i_visible_width != p_fmto->i_visible_width
+     || p_fmti->i_visible_height != p_fmto->i_visible_height
+     || p_fmti->i_visible_width < 16 )
+        return VLC_EGENERIC;
+
+    /* Resolve the undefined range and space like the core does: HD content
+     * defaults to BT.709 */
+    video_format_t fmt = *p_fmti;
+    fmt.p_palette = NULL;
+    video_format_AdjustColorSpace( &fmt );
+    if( fmt.color_range != COLOR_RANGE_LIMITED
+     || fmt.space != COLOR_SPACE_BT601 )
+        return VLC_EGENERIC;
+
+    return Activate( p_filter );
+}
+#endif
+
 /*****************************************************************************
  * Deactivate: free the chroma function
  *****************************************************************************
@@ -39,6 +39,13 @@
 #include <libswscale/swscale.h>
 #include <libswscale/version.h>
 
+/* Slice threading is only available through the frame API */
+#if LIBSWSCALE_VERSION_INT >= ((6<<16)+(4<<8)+100)
+# define SWSCALE_THREADED 1
+# include <libavutil/frame.h>
+# include <libavutil/opt.h>
+#endif
+
 #ifdef __APPLE__
 # include <TargetConditionals.h>
 #endif
@@ -54,6 +61,11 @@ static void CloseScaler( filter_t * );
 #define SCALEMODE_TEXT N_("Scaling mode")
 #define SCALEMODE_LONGTEXT NULL
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_( \
+    "Number of threads used to scale and convert each picture in slices " \
+    "(0=automatic, 1=single-threaded).")
+
 static const int pi_mode_values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
 static const char *const ppsz_mode_descriptions[] =
 { N_("Fast bilinear"), N_("Bilinear"), N_("Bicubic (good quality)"),
@@ -119,6 +131,8 @@ vlc_module_begin ()
     set_callback_video_converter( OpenScaler, 150 )
     add_integer( "swscale-mode", 2, SCALEMODE_TEXT, SCALEMODE_LONGTEXT )
         change_integer_list( pi_mode_values, ppsz_mode_descriptions )
+    add_integer_with_range( "swscale-threads", 0, 0, 64,
+                            THREADS_TEXT, THREADS_LONGTEXT )
     add_submodule()
         set_callback_chroma_conv_probe(ProbeChroma)
 vlc_module_end ()
@@ -135,6 +149,7 @@ typedef struct
 {
     SwsFilter *p_filter;
     int i_sws_flags;
+    int i_threads;
 
     video_format_t fmt_in;
     video_format_t fmt_out;
@@ -152,6 +167,11 @@ typedef struct
     bool b_copy;
     bool b_swap_uvi;
     bool b_swap_uvo;
+
+    /* Contexts were created with slice threads and need the frame API */
+    bool b_threaded;
+    enum AVPixelFormat i_fmti;
+    enum AVPixelFormat i_fmto;
 } filter_sys_t;
 
 static picture_t *Filter( filter_t *, picture_t * );
@@ -180,6 +200,8 @@ static int GetParameters( ScalerConfiguration *,
 #define ALLOW_YUVP (false)
 /* SwScaler does not like too small picture */
 #define MINIMUM_WIDTH (32)
+/* Below this size, the threads synchronization costs more than it saves */
+#define MINIMUM_THREADED_PIXELS (640 * 480)
 
 /* XXX is it always 3 even for BIG_ENDIAN (blend.c seems to think so) ? */
 #define OFFSET_A (3)
@@ -275,6 +297,7 @@ static int OpenScaler( filter_t *p_filter )
     case 10: p_sys->i_sws_flags = SWS_SPLINE; break;
     default: p_sys->i_sws_flags = SWS_BICUBIC; i_sws_mode = 2; break;
     }
+    p_sys->i_threads = var_InheritInteger( p_filter, "swscale-threads" );
 
     /* Misc init */
     memset( &p_sys->fmt_in,  0, sizeof(p_sys->fmt_in) );
@@ -420,6 +443,44 @@ static int GetParameters( ScalerConfiguration *p_cfg,
     return VLC_SUCCESS;
 }
 
+static struct SwsContext *CreateContext( filter_sys_t *p_sys, int i_threads,
+                                         int i_src_width, int i_src_height,
+                                         enum AVPixelFormat i_src_fmt,
+                                         int i_dst_width, int i_dst_height,
+                                         enum AVPixelFormat i_dst_fmt,
+                                         int i_flags )
+{
+#ifdef SWSCALE_THREADED
+    if( i_threads != 1 )
+    {
+        struct SwsContext *ctx = sws_alloc_context();
+        if( !ctx )
+            return NULL;
+
+        av_opt_set_int( ctx, "srcw", i_src_width, 0 );
+        av_opt_set_int( ctx, "srch", i_src_height, 0 );
+        av_opt_set_int( ctx, "src_format", i_src_fmt, 0 );
+        av_opt_set_int( ctx, "dstw", i_dst_width, 0 );
+        av_opt_set_int( ctx, "dsth", i_dst_height, 0 );
+        av_opt_set_int( ctx, "dst_format", i_dst_fmt, 0 );
+        av_opt_set_int( ctx, "sws_flags", i_flags, 0 );
+        av_opt_set_int( ctx, "threads", i_threads, 0 );
+
+        if( sws_init_context( ctx, p_sys->p_filter, NULL ) < 0 )
+        {
+            sws_freeContext( ctx );
+            return NULL;
+        }
+        return ctx;
+    }
+#else
+    VLC_UNUSED( i_threads );
+#endif
+    return sws_getContext( i_src_width, i_src_height, i_src_fmt,
+                           i_dst_width, i_dst_height, i_dst_fmt,
+                           i_flags, p_sys->p_filter, NULL, 0 );
+}
+
 static int Init( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -471,16 +532,25 @@ static int Init( filter_t *p_filter )
 
     const unsigned i_fmti_visible_width = p_fmti->i_visible_width * p_sys->i_extend_factor;
     const unsigned i_fmto_visible_width = p_fmto->i_visible_width * p_sys->i_extend_factor;
+
+    int i_threads = 1;
+#ifdef SWSCALE_THREADED
+    if( p_sys->i_threads != 1 &&
+        ( (uint64_t)i_fmti_visible_width * p_fmti->i_visible_height >= MINIMUM_THREADED_PIXELS ||
+          (uint64_t)i_fmto_visible_width * p_fmto->i_visible_height >= MINIMUM_THREADED_PIXELS ) )
+        i_threads = p_sys->i_threads; /* 0 lets swscale pick the CPU count */
+#endif
+
     for( int n = 0; n < (cfg.b_has_a ? 2 : 1); n++ )
     {
         const int i_fmti = n == 0 ? cfg.i_fmti : AV_PIX_FMT_GRAY8;
         const int i_fmto = n == 0 ? cfg.i_fmto : AV_PIX_FMT_GRAY8;
         struct SwsContext *ctx;
 
-        ctx = sws_getContext( i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
-                              i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
-                              cfg.i_sws_flags,
-                              p_sys->p_filter, NULL, 0 );
+        ctx = CreateContext( p_sys, i_threads,
+                             i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
+                             i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
+                             cfg.i_sws_flags );
         if( n == 0 )
             p_sys->ctx = ctx;
         else
@@ -533,6 +603,9 @@ static int Init( filter_t *p_filter )
 
     p_sys->b_add_a = cfg.b_add_a;
     p_sys->b_copy = cfg.b_copy;
+    p_sys->b_threaded = i_threads != 1;
+    p_sys->i_fmti = cfg.i_fmti;
+    p_sys->i_fmto = cfg.i_fmto;
     p_sys->fmt_in  = *p_fmti;
     p_sys->fmt_out = *p_fmto;
     p_sys->b_swap_uvi = cfg.b_swap_uvi;
@@ -659,6 +732,59 @@ static void SwapUV( picture_t *p_dst, const picture_t *p_src )
     picture_CopyPixels( p_dst, &tmp );
 }
 
+#ifdef SWSCALE_THREADED
+static void ReleaseNothing( void *opaque, uint8_t *data )
+{
+    VLC_UNUSED( opaque );
+    VLC_UNUSED( data );
+}
+
+static int WrapFrame( AVFrame *frame, uint8_t *const data[4],
+                      const int linesize[4], int i_width, int i_height,
+                      enum AVPixelFormat i_fmt )
+{
+    for( int i = 0; i < 4; i++ )
+    {
+        frame->data[i] = data[i];
+        frame->linesize[i] = linesize[i];
+    }
+    frame->width = i_width;
+    frame->height = i_height;
+    frame->format = i_fmt;
+
+    /* The pixels are owned by the pictures, but swscale copies frames
+     * without buffer references */
+    frame->buf[0] = av_buffer_create( data[0], 0, ReleaseNothing, NULL, 0 );
+    return frame->buf[0] ? 0 : AVERROR(ENOMEM);
+}
+
+static int ScaleFrame( filter_t *p_filter, struct SwsContext *ctx,
+                       uint8_t *const src[4], const int src_stride[4],
+                       uint8_t *const dst[4], const int dst_stride[4],
+                       int i_src_height )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const bool b_alpha = ctx == p_sys->ctxA;
+    int i_ret = AVERROR(ENOMEM);
+
+    AVFrame *p_src = av_frame_alloc();
+    AVFrame *p_dst = av_frame_alloc();
+    if( p_src && p_dst
+     && !WrapFrame( p_src, src, src_stride,
+                    p_sys->fmt_in.i_visible_width * p_sys->i_extend_factor,
+                    i_src_height, b_alpha ? AV_PIX_FMT_GRAY8 : p_sys->i_fmti )
+     && !WrapFrame( p_dst, dst, dst_stride,
+                    p_sys->fmt_out.i_visible_width * p_sys->i_extend_factor,
+                    p_sys->fmt_out.i_visible_height,
+                    b_alpha ? AV_PIX_FMT_GRAY8 : p_sys->i_fmto ) )
+        i_ret = sws_scale_frame( ctx, p_dst, p_src );
+
+    av_frame_free( &p_src );
+    av_frame_free( &p_dst );
+    return i_ret;
+}
+#endif
+
 static void Convert( filter_t *p_filter, struct SwsContext *ctx,
                      picture_t *p_dst, picture_t *p_src, int i_height,
                      int i_plane_count, bool b_swap_uvi, bool b_swap_uvo )
@@ -707,6 +833,16 @@ static void Convert( filter_t *p_filter, struct SwsContext *ctx,
     GetPixels( dst, dst_stride, p_sys->desc_out, &p_filter->fmt_out.video,
                p_dst, i_plane_count, b_swap_uvo );
 
+#ifdef SWSCALE_THREADED
+    if( p_sys->b_threaded )
+    {
+        if( ScaleFrame( p_filter, ctx, src, src_stride, dst, dst_stride,
+                        i_height ) < 0 )
+            msg_Err( p_filter, "could not scale the picture" );
+        return;
+    }
+#endif
+
     for (size_t i = 0; i < ARRAY_SIZE(src); i++)
         csrc[i] = src[i];
 
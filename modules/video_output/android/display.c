@@ -34,7 +34,6 @@
 #include <vlc_vout_display.h>
 #include <vlc_subpicture.h>
 
-#include <vlc_vector.h>
 #include <vlc_opengl.h>
 #include "utils.h"
 #include "../opengl/gl_api.h"
@@ -51,9 +50,6 @@ struct subpicture
     bool is_dirty;
     bool clear;
 
-    int64_t last_order;
-    struct VLC_VECTOR(vout_display_place_t) regions;
-
     struct {
         PFNGLFLUSHPROC Flush;
     } vt;
@@ -117,59 +113,12 @@ static bool subpicture_NeedDraw(vout_display_t *vd,
     if (sub->place_changed)
         return true;
 
+    /* The surface was cleared: the subpicture must be drawn again even if
+     * the core did not see any change since its previous rendering */
+    bool cleared = !sub->clear;
     sub->clear = true;
 
-    size_t count = subpicture->regions.size;
-    const struct subpicture_region_rendered *r;
-
-    if (subpicture->i_order != sub->last_order)
-    {
-        sub->last_order = subpicture->i_order;
-        /* Subpicture content is different */
-        goto end;
-    }
-
-    bool draw = false;
-
-    if (count == sub->regions.size)
-    {
-        size_t i = 0;
-        vlc_vector_foreach(r, &subpicture->regions)
-        {
-            vout_display_place_t *cmp = &sub->regions.data[i++];
-            if (!vout_display_PlaceEquals(cmp, &r->place))
-            {
-                /* Subpicture regions are different */
-                draw = true;
-                break;
-            }
-        }
-    }
-    else
-    {
-        /* Subpicture region count is different */
-        draw = true;
-    }
-
-    if (!draw)
-        return false;
-
-end:
-    /* Store the current subpicture regions in order to compare then later.
-     */
-    if (!vlc_vector_reserve(&sub->regions, count))
-        return false;
-
-    sub->regions.size = 0;
-
-    vlc_vector_foreach(r, &subpicture->regions)
-    {
-        bool res = vlc_vector_push(&sub->regions, r->place);
-        /* Already checked with vlc_vector_reserve */
-        assert(res); (void) res;
-    }
-
-    return true;
+    return cleared || subpicture->b_changed;
 }
 
 static void subpicture_Prepare(vout_display_t *vd, const vlc_render_subpicture *subpicture)
@@ -244,8 +193,6 @@ static void subpicture_CloseDisplay(vout_display_t *vd)
 
     vlc_window_Disable(sub->window);
     vlc_window_Delete(sub->window);
-
-    vlc_vector_destroy(&sub->regions);
 }
 
 static void subpicture_window_Resized(struct vlc_window *wnd, unsigned width,
@@ -275,8 +222,6 @@ static int subpicture_OpenDisplay(vout_display_t *vd)
 
     sub->is_dirty = false;
     sub->clear = false;
-    sub->last_order = -1;
-    vlc_vector_init(&sub->regions);
 
     /* Create a VLC sub window that will hold the subpicture surface */
     static const struct vlc_window_callbacks win_cbs = {
@@ -486,6 +486,7 @@ static void DeletePipController( pip_controller_t * pipcontroller );
 @property (nonatomic, weak) VLCSampleBufferDisplay *sys;
 @property (nonatomic) NSArray<VLCSampleBufferSubpictureRegion *> *regions;
 @property (nonatomic) int64_t order;
+@property (nonatomic) unsigned displayHeight;
 @end
 
 @implementation VLCSampleBufferSubpicture
@@ -495,7 +496,8 @@ static void DeletePipController( pip_controller_t * pipcontroller );
 #pragma mark -
 
 @interface VLCSampleBufferSubpictureView: VLCView
-- (void)drawSubpicture:(VLCSampleBufferSubpicture *)subpicture;
+- (void)drawSubpicture:(VLCSampleBufferSubpicture *)subpicture
+                inRect:(CGRect)backingRect;
 @end
 
 @implementation VLCSampleBufferSubpictureView
@@ -517,12 +519,26 @@ static void DeletePipController( pip_controller_t * pipcontroller );
     return self;
 }
 
-- (void)drawSubpicture:(VLCSampleBufferSubpicture *)subpicture {
+- (void)drawSubpicture:(VLCSampleBufferSubpicture *)subpicture
+                inRect:(CGRect)backingRect {
     _pendingSubpicture = subpicture;
 #if TARGET_OS_OSX
-    [self setNeedsDisplay:YES];
+    if (CGRectIsNull(backingRect))
+        [self setNeedsDisplay:YES];
+    else
+        [self setNeedsDisplayInRect:[self convertRectFromBacking:backingRect]];
 #else
-    [self setNeedsDisplay];
+    if (CGRectIsNull(backingRect)) {
+        [self setNeedsDisplay];
+    } else {
+        // Same mapping as the transform applied in drawRect:
+        const CGFloat scale = 1.0f / self.contentScaleFactor;
+        [self setNeedsDisplayInRect:CGRectMake(
+            backingRect.origin.x * scale,
+            self.frame.size.height - CGRectGetMaxY(backingRect) * scale,
+            backingRect.size.width * scale,
+            backingRect.size.height * scale)];
+    }
 #endif
 }
 
@@ -534,7 +550,8 @@ static void DeletePipController( pip_controller_t * pipcontroller );
     CGContextRef cgCtx = UIGraphicsGetCurrentContext();
     #endif
 
-    CGContextClearRect(cgCtx, self.bounds);
+    // Only the damaged area is redrawn, the drawing is clipped to it
+    CGContextClearRect(cgCtx, dirtyRect);
 
 #if TARGET_OS_IPHONE
     CGContextSaveGState(cgCtx);
@@ -901,6 +918,18 @@ static CGRect RegionBackingFrame(unsigned display_height,
     );
 }
 
+static CGRect DamageBackingFrame(unsigned display_height,
+                                 const vout_display_place_t *damage)
+{
+    // Invert y coords for CoreGraphics
+    return CGRectMake(
+        damage->x,
+        (int)display_height - (int)damage->height - damage->y,
+        damage->width,
+        damage->height
+    );
+}
+
 static void UpdateSubpictureRegions(vout_display_t *vd,
                                     const vlc_render_subpicture *subpicture)
 {
@@ -946,11 +975,16 @@ static void UpdateSubpictureRegions(vout_display_t *vd,
     sys.subpicture.regions = regions;
 }
 
-static bool IsSubpictureDrawNeeded(vout_display_t *vd, const vlc_render_subpicture *subpicture)
+static bool IsSubpictureDrawNeeded(vout_display_t *vd,
+                                   const vlc_render_subpicture *subpicture,
+                                   CGRect *dirty)
 {
     VLCSampleBufferDisplay *sys;
     sys = (__bridge VLCSampleBufferDisplay*)vd->sys;
 
+    /* Redraw the whole view by default */
+    *dirty = CGRectNull;
+
     if (subpicture == NULL)
     {
         if (sys.subpicture == nil)
@@ -960,8 +994,20 @@ static bool IsSubpictureDrawNeeded(vout_display_t *vd, const vlc_render_subpictu
         return true;
     }
 
-    size_t count = subpicture->regions.size;
-    const struct subpicture_region_rendered *r;
+    const unsigned display_height = vd->cfg->display.height;
+    if (sys.subpicture != nil && sys.subpicture.displayHeight == display_height)
+    {
+        /* The core compares the regions with the previous rendering, which
+         * is the one drawn: keep the drawing if nothing changed, even for a
+         * new subpicture, else only redraw the damaged area if known. */
+        if (!subpicture->b_changed)
+        {
+            sys.subpicture.order = subpicture->i_order;
+            return false;
+        }
+        if (subpicture->damage.width > 0 && subpicture->damage.height > 0)
+            *dirty = DamageBackingFrame(display_height, &subpicture->damage);
+    }
 
     if (!sys.subpicture || subpicture->i_order != sys.subpicture.order)
     {
@@ -969,56 +1015,25 @@ static bool IsSubpictureDrawNeeded(vout_display_t *vd, const vlc_render_subpictu
         sys.subpicture = [VLCSampleBufferSubpicture new];
         sys.subpicture.sys = sys;
         sys.subpicture.order = subpicture->i_order;
-        UpdateSubpictureRegions(vd, subpicture);
-        return true;
     }
+    sys.subpicture.displayHeight = display_height;
 
-    bool draw = false;
-
-    if (count == sys.subpicture.regions.count)
-    {
-        size_t i = 0;
-        vlc_vector_foreach(r, &subpicture->regions)
-        {
-            VLCSampleBufferSubpictureRegion *region =
-                sys.subpicture.regions[i++];
-
-            CGRect newRegion = RegionBackingFrame(vd->cfg->display.height, r);
-
-            if ( !CGRectEqualToRect(region.backingFrame, newRegion) )
-            {
-                /* Subpicture regions are different */
-                draw = true;
-                break;
-            }
-        }
-    }
-    else
-    {
-        /* Subpicture region count is different */
-        draw = true;
-    }
-
-    if (!draw)
-        return false;
-
-    /* Store the current subpicture regions in order to compare then later.
-     */
-
+    /* Store the current subpicture regions in order to draw them later */
     UpdateSubpictureRegions(vd, subpicture);
     return true;
 }
 
 static void RenderSubpicture(vout_display_t *vd, const vlc_render_subpicture *spu)
 {
-    if (!IsSubpictureDrawNeeded(vd, spu))
+    CGRect dirty;
+    if (!IsSubpictureDrawNeeded(vd, spu, &dirty))
         return;
 
     VLCSampleBufferDisplay *sys;
     sys = (__bridge VLCSampleBufferDisplay*)vd->sys;
 
     dispatch_async(dispatch_get_main_queue(), ^{
-        [sys.spuView drawSubpicture:sys.subpicture];
+        [sys.spuView drawSubpicture:sys.subpicture inRect:dirty];
     });
 }
 
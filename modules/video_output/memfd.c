@@ -0,0 +1,391 @@
+/*****************************************************************************
+ * memfd.c: shared memory video output
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_vout_display.h>
+#include <vlc_fs.h>
+
+#include "memfd.h"
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+#define PATH_TEXT N_("Shared memory file")
+#ifdef __linux__
+#define PATH_LONGTEXT N_("File to publish the pictures to, " \
+    "eg. \"/dev/shm/vlc-video\". An anonymous memory file is used if empty, " \
+    "readers can then map it from /proc.")
+#else
+#define PATH_LONGTEXT N_("File to publish the pictures to, " \
+    "eg. \"/tmp/vlc-video\".")
+#endif
+
+#define CHROMA_TEXT N_("Chroma used")
+#define CHROMA_LONGTEXT N_(\
+    "Force use of a specific chroma for output.")
+
+#define SLOTS_TEXT N_("Number of slots")
+#define SLOTS_LONGTEXT N_("Number of pictures in the shared ring. More " \
+    "slots give slow readers more time before a picture is overwritten.")
+
+#define CFG_PREFIX "memfd-"
+
+static int Open(vout_display_t *vd,
+                video_format_t *fmtp, vlc_video_context *context);
+static void Close(vout_display_t *vd);
+
+vlc_module_begin()
+    set_shortname(N_("Shared memory"))
+    set_description(N_("Shared memory video output"))
+    set_subcategory(SUBCAT_VIDEO_VOUT)
+
+    add_string(CFG_PREFIX "path", NULL, PATH_TEXT, PATH_LONGTEXT)
+    add_string(CFG_PREFIX "chroma", NULL, CHROMA_TEXT, CHROMA_LONGTEXT)
+    add_integer_with_range(CFG_PREFIX "slots", 4, 2, 64,
+                           SLOTS_TEXT, SLOTS_LONGTEXT)
+
+    set_callback_display(Open, 0)
+vlc_module_end()
+
+/*****************************************************************************
+ * Local prototypes
+ *****************************************************************************/
+static void Prepare(vout_display_t *, picture_t *,
+                    const struct vlc_render_subpicture *, vlc_tick_t);
+static void Display(vout_display_t *, picture_t *);
+static int  Control(vout_display_t *, int);
+
+typedef struct vout_display_sys_t {
+    int    fd;
+    char  *path;           /* unlinked on close, NULL for anonymous files */
+    void  *base;
+    size_t size;
+
+    struct vlc_memfd_video_header *header;
+    struct vlc_memfd_video_slot   *slots;
+
+    /* pictures mapping the ring slots */
+    picture_t **pictures;
+    unsigned    count;
+
+    uint64_t    sequence;  /* sequence of the frame being prepared */
+    bool        prepared;
+} vout_display_sys_t;
+
+static const struct vlc_display_operations ops = {
+    .close = Close,
+    .prepare = Prepare,
+    .display = Display,
+    .control = Control,
+};
+
+static size_t AlignUp(size_t size, size_t align)
+{
+    return (size + align - 1) & ~(align - 1);
+}
+
+static int CreateFile(vout_display_t *vd, vout_display_sys_t *sys)
+{
+    char *path = var_InheritString(vd, CFG_PREFIX "path");
+    if (path != NULL && *path == '\0')
+    {
+        free(path);
+        path = NULL;
+    }
+
+    if (path != NULL)
+    {
+        sys->fd = vlc_open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (sys->fd == -1)
+        {
+            msg_Err(vd, "cannot create %s: %s", path, vlc_strerror_c(errno));
+            free(path);
+            return VLC_EGENERIC;
+        }
+        sys->path = path;
+        return VLC_SUCCESS;
+    }
+
+#ifdef __linux__
+    /* Other processes can only open an anonymous file through /proc */
+    sys->fd = vlc_memfd();
+    if (sys->fd == -1)
+    {
+        msg_Err(vd, "cannot create memory file: %s", vlc_strerror_c(errno));
+        return VLC_EGENERIC;
+    }
+    sys->path = NULL;
+    msg_Info(vd, "publishing pictures to /proc/%d/fd/%d",
+             (int)getpid(), sys->fd);
+    return VLC_SUCCESS;
+#else
+    msg_Err(vd, "no shared memory file, set --" CFG_PREFIX "path");
+    return VLC_EGENERIC;
+#endif
+}
+
+static void DestroyFile(vout_display_sys_t *sys)
+{
+    if (sys->base != NULL)
+        munmap(sys->base, sys->size);
+    if (sys->path != NULL)
+    {
+        vlc_unlink(sys->path);
+        free(sys->path);
+    }
+    vlc_close(sys->fd);
+}
+
+/*****************************************************************************
+ * Open: maps the shared ring and wraps its slots into pictures
+ *****************************************************************************/
+static int Open(vout_display_t *vd,
+                video_format_t *fmtp, vlc_video_context *context)
+{
+    VLC_UNUSED(context);
+
+    /* */
+    char *psz_fcc = var_InheritString(vd, CFG_PREFIX "chroma");
+    vlc_fourcc_t chroma = vlc_fourcc_GetCodecFromString(VIDEO_ES, psz_fcc);
+    free(psz_fcc);
+
+    if (chroma == 0)
+    {
+        const vlc_chroma_description_t *desc =
+            vlc_fourcc_GetChromaDescription(vd->source->i_chroma);
+        chroma = (desc != NULL && desc->plane_count > 0)
+               ? vd->source->i_chroma : VLC_CODEC_I420;
+    }
+
+    video_format_t fmt;
+    video_format_ApplyRotation(&fmt, vd->source);
+    fmt.i_chroma = chroma;
+    fmt.i_x_offset = fmt.i_y_offset = 0;
+    fmt.i_width  = fmt.i_visible_width;
+    fmt.i_height = fmt.i_visible_height;
+
+    /* Get the planes layout the core would use for this format */
+    picture_t *probe = picture_NewFromFormat(&fmt);
+    if (probe == NULL || probe->i_planes == 0
+     || probe->i_planes > VLC_MEMFD_VIDEO_PLANES_MAX)
+    {
+        msg_Err(vd, "unsupported chroma %4.4s", (const char *)&chroma);
+        if (probe != NULL)
+            picture_Release(probe);
+        return VLC_EGENERIC;
+    }
+
+    vout_display_sys_t *sys = calloc(1, sizeof(*sys));
+    if (unlikely(sys == NULL))
+    {
+        picture_Release(probe);
+        return VLC_ENOMEM;
+    }
+
+    sys->count = var_InheritInteger(vd, CFG_PREFIX "slots");
+
+    const size_t page = sysconf(_SC_PAGESIZE);
+    size_t plane_offset[VLC_MEMFD_VIDEO_PLANES_MAX];
+    size_t slot_size = 0;
+    for (int i = 0; i < probe->i_planes; i++)
+    {
+        plane_offset[i] = slot_size;
+        slot_size += AlignUp((size_t)probe->p[i].i_pitch * probe->p[i].i_lines, 64);
+    }
+    slot_size = AlignUp(slot_size, page);
+
+    const size_t slot_offset =
+        AlignUp(sizeof(struct vlc_memfd_video_header)
+                + sys->count * sizeof(struct vlc_memfd_video_slot), page);
+    sys->size = slot_offset + sys->count * slot_size;
+
+    if (CreateFile(vd, sys) != VLC_SUCCESS)
+    {
+        picture_Release(probe);
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+    if (ftruncate(sys->fd, sys->size))
+    {
+        msg_Err(vd, "cannot resize memory file: %s", vlc_strerror_c(errno));
+        goto error;
+    }
+
+    sys->base = mmap(NULL, sys->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     sys->fd, 0);
+    if (sys->base == MAP_FAILED)
+    {
+        sys->base = NULL;
+        msg_Err(vd, "cannot map memory file: %s", vlc_strerror_c(errno));
+        goto error;
+    }
+
+    sys->header = sys->base;
+    sys->slots  = (struct vlc_memfd_video_slot *)(sys->header + 1);
+
+    struct vlc_memfd_video_header *hdr = sys->header;
+    memcpy(hdr->magic, VLC_MEMFD_VIDEO_MAGIC, sizeof(VLC_MEMFD_VIDEO_MAGIC));
+    hdr->version        = VLC_MEMFD_VIDEO_VERSION;
+    hdr->slot_count     = sys->count;
+    hdr->chroma         = fmt.i_chroma;
+    hdr->width          = fmt.i_width;
+    hdr->height         = fmt.i_height;
+    hdr->visible_width  = fmt.i_visible_width;
+    hdr->visible_height = fmt.i_visible_height;
+    hdr->sar_num        = fmt.i_sar_num;
+    hdr->sar_den        = fmt.i_sar_den;
+    hdr->plane_count    = probe->i_planes;
+    for (int i = 0; i < probe->i_planes; i++)
+    {
+        hdr->pitch[i] = probe->p[i].i_pitch;
+        hdr->lines[i] = probe->p[i].i_lines;
+        hdr->plane_offset[i] = plane_offset[i];
+    }
+    hdr->slot_offset = slot_offset;
+    hdr->slot_size   = slot_size;
+    atomic_init(&hdr->sequence, 0);
+    for (unsigned i = 0; i < sys->count; i++)
+    {
+        atomic_init(&sys->slots[i].fence, 0);
+        sys->slots[i].date = 0;
+    }
+
+    sys->pictures = vlc_alloc(sys->count, sizeof(*sys->pictures));
+    if (unlikely(sys->pictures == NULL))
+        goto error;
+
+    for (unsigned i = 0; i < sys->count; i++)
+    {
+        uint8_t *slot = (uint8_t *)sys->base + slot_offset + i * slot_size;
+        picture_resource_t rsc = { .p_sys = NULL };
+
+        for (int j = 0; j < probe->i_planes; j++)
+        {
+            rsc.p[j].p_pixels = slot + plane_offset[j];
+            rsc.p[j].i_lines  = probe->p[j].i_lines;
+            rsc.p[j].i_pitch  = probe->p[j].i_pitch;
+        }
+
+        sys->pictures[i] = picture_NewFromResource(&fmt, &rsc);
+        if (unlikely(sys->pictures[i] == NULL))
+        {
+            sys->count = i;
+            goto error;
+        }
+    }
+    picture_Release(probe);
+    probe = NULL;
+
+    *fmtp = fmt;
+    vd->sys = sys;
+    vd->ops = &ops;
+    return VLC_SUCCESS;
+
+error:
+    if (probe != NULL)
+        picture_Release(probe);
+    if (sys->pictures != NULL)
+    {
+        for (unsigned i = 0; i < sys->count; i++)
+            picture_Release(sys->pictures[i]);
+        free(sys->pictures);
+    }
+    DestroyFile(sys);
+    free(sys);
+    return VLC_EGENERIC;
+}
+
+static void Close(vout_display_t *vd)
+{
+    vout_display_sys_t *sys = vd->sys;
+
+    for (unsigned i = 0; i < sys->count; i++)
+        picture_Release(sys->pictures[i]);
+    free(sys->pictures);
+    DestroyFile(sys);
+    free(sys);
+}
+
+static void Prepare(vout_display_t *vd, picture_t *pic,
+                    const struct vlc_render_subpicture *subpic,
+                    vlc_tick_t date)
+{
+    vout_display_sys_t *sys = vd->sys;
+    struct vlc_memfd_video_slot *slot = &sys->slots[sys->sequence % sys->count];
+
+    /* Tell readers the slot content is going away before touching it */
+    if (!sys->prepared)
+    {
+        atomic_store_explicit(&slot->fence, 2 * sys->sequence + 1,
+                              memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        sys->prepared = true;
+    }
+
+    picture_CopyPixels(sys->pictures[sys->sequence % sys->count], pic);
+    slot->date = US_FROM_VLC_TICK(date);
+
+    (void) subpic;
+}
+
+static void Display(vout_display_t *vd, picture_t *pic)
+{
+    vout_display_sys_t *sys = vd->sys;
+    struct vlc_memfd_video_slot *slot = &sys->slots[sys->sequence % sys->count];
+    VLC_UNUSED(pic);
+
+    if (!sys->prepared)
+        return;
+
+    sys->sequence++;
+    atomic_store_explicit(&slot->fence, 2 * sys->sequence,
+                          memory_order_release);
+    atomic_store_explicit(&sys->header->sequence, sys->sequence,
+                          memory_order_release);
+    sys->prepared = false;
+}
+
+static int Control(vout_display_t *vd, int query)
+{
+    (void) vd;
+
+    switch (query) {
+        case VOUT_DISPLAY_CHANGE_SOURCE_ASPECT:
+        case VOUT_DISPLAY_CHANGE_SOURCE_CROP:
+        case VOUT_DISPLAY_CHANGE_SOURCE_PLACE:
+            return VLC_SUCCESS;
+    }
+    return VLC_EGENERIC;
+}
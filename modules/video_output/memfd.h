@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * memfd.h: shared memory video output protocol
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_VOUT_MEMFD_H
+#define VLC_VOUT_MEMFD_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * Layout of the shared memory file published by the memfd video output.
+ *
+ * The file starts with a vlc_memfd_video_header, followed by slot_count
+ * vlc_memfd_video_slot descriptors. The pixels of slot i start at
+ * slot_offset + i * slot_size, and plane p of a slot at plane_offset[p]
+ * from the start of the slot. Everything but the atomics is written once,
+ * before the first frame is published, and never changes afterwards: a new
+ * file is created whenever the output format changes.
+ *
+ * Each slot is protected by a sequence lock. The fence is odd while the
+ * writer fills the slot, and equal to 2 * (sequence + 1) once the frame
+ * with the given sequence number is complete. A reader:
+ *  - loads the header sequence (acquire), n frames have been published,
+ *    the latest one being in slot (n - 1) % slot_count,
+ *  - loads the slot fence (acquire) and checks it is 2 * n,
+ *  - uses or copies the pixels,
+ *  - loads the fence again: if it changed, the writer recycled the slot
+ *    meanwhile and the pixels must be discarded.
+ *
+ * Readers only need to map the file read-only.
+ */
+
+#define VLC_MEMFD_VIDEO_MAGIC      "VLCVSHM"
+#define VLC_MEMFD_VIDEO_VERSION    1
+#define VLC_MEMFD_VIDEO_PLANES_MAX 5
+
+struct vlc_memfd_video_header
+{
+    char     magic[8];              /**< VLC_MEMFD_VIDEO_MAGIC */
+    uint32_t version;               /**< VLC_MEMFD_VIDEO_VERSION */
+    uint32_t slot_count;
+
+    uint32_t chroma;                /**< VLC fourcc of the pictures */
+    uint32_t width;
+    uint32_t height;
+    uint32_t visible_width;
+    uint32_t visible_height;
+    uint32_t sar_num;
+    uint32_t sar_den;
+
+    uint32_t plane_count;
+    uint32_t pitch[VLC_MEMFD_VIDEO_PLANES_MAX];
+    uint32_t lines[VLC_MEMFD_VIDEO_PLANES_MAX];
+    uint64_t plane_offset[VLC_MEMFD_VIDEO_PLANES_MAX];
+
+    uint64_t slot_offset;           /**< offset of the first slot pixels */
+    uint64_t slot_size;
+
+    _Atomic uint64_t sequence;      /**< number of published frames */
+};
+
+struct vlc_memfd_video_slot
+{
+    _Atomic uint64_t fence;         /**< sequence lock, see above */
+    int64_t  date;                  /**< presentation date in microseconds */
+};
+
+#endif
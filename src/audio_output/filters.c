@@ -32,6 +32,7 @@
 #include <assert.h>
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 #include <vlc_configuration.h>
 #include <vlc_dialog.h>
 #include <vlc_modules.h>
@@ -41,6 +42,152 @@
 #include "aout_internal.h"
 #include "../video_output/vout_internal.h" /* for vout_Request */
 
+/**
+ * Pool of recycled audio buffers.
+ *
+ * The blocks handed out to the filters may outlive the filters pipeline, as
+ * they end up in the audio output. Each of them holds a reference to the
+ * pool, and goes back to the free list when released.
+ */
+#define AOUT_POOL_MAX_FREE 8
+#define AOUT_POOL_ALIGN    32
+
+struct aout_pool_block
+{
+    block_t self;
+    struct aout_block_pool *pool;
+    struct aout_pool_block *next;
+    size_t capacity;
+};
+
+struct aout_block_pool
+{
+    vlc_mutex_t lock;
+    vlc_atomic_rc_t rc;
+    bool closed;
+    unsigned free_count;
+    struct aout_pool_block *free;
+};
+
+static void aout_pool_block_Delete(struct aout_pool_block *pb)
+{
+    aligned_free(pb->self.p_start);
+    free(pb);
+}
+
+static void aout_block_pool_Release(struct aout_block_pool *pool)
+{
+    if (!vlc_atomic_rc_dec(&pool->rc))
+        return;
+
+    assert(pool->free == NULL);
+    free(pool);
+}
+
+static void aout_pool_block_Free(block_t *block)
+{
+    struct aout_pool_block *pb = container_of(block, struct aout_pool_block,
+                                              self);
+    struct aout_block_pool *pool = pb->pool;
+
+    vlc_mutex_lock(&pool->lock);
+    if (!pool->closed && pool->free_count < AOUT_POOL_MAX_FREE)
+    {
+        pb->next = pool->free;
+        pool->free = pb;
+        pool->free_count++;
+        pb = NULL;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (pb != NULL)
+        aout_pool_block_Delete(pb);
+    aout_block_pool_Release(pool);
+}
+
+static const struct vlc_block_callbacks aout_pool_block_cbs =
+{
+    aout_pool_block_Free,
+};
+
+static struct aout_block_pool *aout_block_pool_New(void)
+{
+    struct aout_block_pool *pool = malloc(sizeof (*pool));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    vlc_mutex_init(&pool->lock);
+    vlc_atomic_rc_init(&pool->rc);
+    pool->closed = false;
+    pool->free_count = 0;
+    pool->free = NULL;
+    return pool;
+}
+
+static void aout_block_pool_Close(struct aout_block_pool *pool)
+{
+    vlc_mutex_lock(&pool->lock);
+    struct aout_pool_block *pb = pool->free;
+    pool->free = NULL;
+    pool->free_count = 0;
+    pool->closed = true;
+    vlc_mutex_unlock(&pool->lock);
+
+    while (pb != NULL)
+    {
+        struct aout_pool_block *next = pb->next;
+        aout_pool_block_Delete(pb);
+        pb = next;
+    }
+    aout_block_pool_Release(pool);
+}
+
+static block_t *aout_block_pool_Get(struct aout_block_pool *pool, size_t size)
+{
+    struct aout_pool_block *pb = NULL;
+
+    /* Reuse the first free block large enough. The stages of a pipeline
+     * request a few stable sizes, so the first fit is usually exact. */
+    vlc_mutex_lock(&pool->lock);
+    for (struct aout_pool_block **pp = &pool->free; *pp != NULL;
+         pp = &(*pp)->next)
+    {
+        if ((*pp)->capacity >= size)
+        {
+            pb = *pp;
+            *pp = pb->next;
+            pool->free_count--;
+            break;
+        }
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (pb == NULL)
+    {
+        pb = malloc(sizeof (*pb));
+        if (unlikely(pb == NULL))
+            return NULL;
+
+        size_t capacity = size + ((-size) % AOUT_POOL_ALIGN);
+        if (capacity == 0)
+            capacity = AOUT_POOL_ALIGN;
+        void *buf = aligned_alloc(AOUT_POOL_ALIGN, capacity);
+        if (unlikely(buf == NULL))
+        {
+            free(pb);
+            return NULL;
+        }
+        pb->capacity = capacity;
+        pb->pool = pool;
+        pb->self.p_start = buf;
+    }
+
+    vlc_atomic_rc_inc(&pool->rc);
+    block_Init(&pb->self, &aout_pool_block_cbs, pb->self.p_start, pb->capacity);
+    pb->self.i_buffer = size;
+    return &pb->self;
+}
+
 struct aout_filter
 {
     filter_t *f;
@@ -106,19 +253,21 @@ filter_t *aout_filter_Create(vlc_object_t *obj, const filter_owner_t *restrict o
 }
 
 static filter_t *FindConverter (vlc_object_t *obj,
+                                const filter_owner_t *restrict owner,
                                 const audio_sample_format_t *infmt,
                                 const audio_sample_format_t *outfmt)
 {
-    return aout_filter_Create(obj, NULL, "audio converter", NULL, infmt, outfmt,
+    return aout_filter_Create(obj, owner, "audio converter", NULL, infmt, outfmt,
                               NULL, true);
 }
 
 static filter_t *FindResampler (vlc_object_t *obj,
+                                const filter_owner_t *restrict owner,
                                 const audio_sample_format_t *infmt,
                                 const audio_sample_format_t *outfmt)
 {
     char *modlist = var_InheritString(obj, "audio-resampler");
-    filter_t *filter = aout_filter_Create(obj, NULL, "audio resampler", modlist,
+    filter_t *filter = aout_filter_Create(obj, owner, "audio resampler", modlist,
                                           infmt, outfmt, NULL, true);
     free(modlist);
     return filter;
@@ -146,7 +295,9 @@ static void aout_FiltersPipelineDestroy(struct aout_filter *tab, unsigned n)
     }
 }
 
-static filter_t *TryFormat (vlc_object_t *obj, vlc_fourcc_t codec,
+static filter_t *TryFormat (vlc_object_t *obj,
+                            const filter_owner_t *restrict owner,
+                            vlc_fourcc_t codec,
                             audio_sample_format_t *restrict fmt)
 {
     audio_sample_format_t output = *fmt;
@@ -155,7 +306,7 @@ static filter_t *TryFormat (vlc_object_t *obj, vlc_fourcc_t codec,
     output.i_format = codec;
     aout_FormatPrepare (&output);
 
-    filter_t *filter = FindConverter (obj, fmt, &output);
+    filter_t *filter = FindConverter (obj, owner, fmt, &output);
     if (filter != NULL)
         *fmt = output;
     return filter;
@@ -164,6 +315,7 @@ static filter_t *TryFormat (vlc_object_t *obj, vlc_fourcc_t codec,
 /**
  * Allocates audio format conversion filters
  * @param obj parent VLC object for new filters
+ * @param owner owner of the new filters
  * @param filters table of filters [IN/OUT]
  * @param count pointer to the number of filters in the table [IN/OUT]
  * @param max size of filters table [IN]
@@ -171,7 +323,9 @@ static filter_t *TryFormat (vlc_object_t *obj, vlc_fourcc_t codec,
  * @param outfmt output audio format
  * @return 0 on success, -1 on failure
  */
-static int aout_FiltersPipelineCreate(vlc_object_t *obj, struct aout_filter *filters,
+static int aout_FiltersPipelineCreate(vlc_object_t *obj,
+                                      const filter_owner_t *restrict owner,
+                                      struct aout_filter *filters,
                                       unsigned *count, unsigned max,
                                  const audio_sample_format_t *restrict infmt,
                                  const audio_sample_format_t *restrict outfmt)
@@ -202,7 +356,7 @@ static int aout_FiltersPipelineCreate(vlc_object_t *obj, struct aout_filter *fil
             if (n == max)
                 goto overflow;
 
-            filter_t *f = TryFormat (obj, VLC_CODEC_FL32, &input);
+            filter_t *f = TryFormat (obj, owner, VLC_CODEC_FL32, &input);
             if (f == NULL)
             {
                 msg_Err (obj, "cannot find %s for conversion pipeline",
@@ -228,7 +382,7 @@ static int aout_FiltersPipelineCreate(vlc_object_t *obj, struct aout_filter *fil
             infmt->channel_type != outfmt->channel_type ?
             "audio renderer" : "audio converter";
 
-        filter_t *f = aout_filter_Create(obj, NULL, filter_type, NULL,
+        filter_t *f = aout_filter_Create(obj, owner, filter_type, NULL,
                                          &input, &output, NULL, true);
 
         if (f == NULL)
@@ -251,7 +405,7 @@ static int aout_FiltersPipelineCreate(vlc_object_t *obj, struct aout_filter *fil
         audio_sample_format_t output = input;
         output.i_rate = outfmt->i_rate;
 
-        filter_t *f = FindConverter (obj, &input, &output);
+        filter_t *f = FindConverter (obj, owner, &input, &output);
         if (f == NULL)
         {
             msg_Err (obj, "cannot find %s for conversion pipeline",
@@ -269,7 +423,7 @@ static int aout_FiltersPipelineCreate(vlc_object_t *obj, struct aout_filter *fil
         if (max == 0)
             goto overflow;
 
-        filter_t *f = TryFormat (obj, outfmt->i_format, &input);
+        filter_t *f = TryFormat (obj, owner, outfmt->i_format, &input);
         if (f == NULL)
         {
             msg_Err (obj, "cannot find %s for conversion pipeline",
@@ -373,8 +527,20 @@ struct aout_filters
     unsigned count; /**< Number of filters */
     struct aout_filter tab[AOUT_MAX_FILTERS]; /**< Configured user filters
         (e.g. equalization) and their conversions */
+
+    struct aout_block_pool *pool; /**< Recycled output buffers */
+    struct filter_audio_callbacks audio_cbs;
+    filter_owner_t owner; /**< Owner of the conversion filters */
 };
 
+static block_t *aout_FiltersNewBuffer(filter_t *filter, size_t size)
+{
+    const struct aout_filters *filters =
+        container_of(filter->owner.audio, struct aout_filters, audio_cbs);
+
+    return aout_block_pool_Get(filters->pool, size);
+}
+
 /** Callback for visualization selection */
 static int VisualizationCallback (vlc_object_t *obj, const char *var,
                                   vlc_value_t oldval, vlc_value_t newval,
@@ -465,7 +631,10 @@ static int AppendFilter(vlc_object_t *obj, const char *type, const char *name,
         .clock = NULL,
         .vout = NULL,
     };
-    const filter_owner_t owner = { .sys = &owner_sys };
+    const filter_owner_t owner = {
+        .audio = &filters->audio_cbs,
+        .sys = &owner_sys,
+    };
     filter_t *filter = aout_filter_Create(obj, &owner, type, name,
                                           infmt, outfmt, cfg, false);
     if (filter == NULL)
@@ -475,8 +644,9 @@ static int AppendFilter(vlc_object_t *obj, const char *type, const char *name,
     }
 
     /* convert to the filter input format if necessary */
-    if (aout_FiltersPipelineCreate (obj, filters->tab, &filters->count,
-                                    max - 1, infmt, &filter->fmt_in.audio))
+    if (aout_FiltersPipelineCreate (obj, &filters->owner, filters->tab,
+                                    &filters->count, max - 1, infmt,
+                                    &filter->fmt_in.audio))
     {
         msg_Err (filter, "cannot add user %s \"%s\" (skipped)", type, name);
         vlc_filter_Delete(filter);
@@ -556,6 +726,18 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
     filters->resampling = 0;
     filters->count = 0;
     filters->clock_source = clock;
+    filters->pool = aout_block_pool_New();
+    if (unlikely(filters->pool == NULL))
+    {
+        free(filters);
+        return NULL;
+    }
+    filters->audio_cbs = (struct filter_audio_callbacks) {
+        .buffer_new = aout_FiltersNewBuffer,
+    };
+    filters->owner = (filter_owner_t) {
+        .audio = &filters->audio_cbs,
+    };
 
     /* Prepare format structure */
     aout_FormatPrint (obj, "input", infmt);
@@ -570,7 +752,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
         if (!AOUT_FMTS_IDENTICAL(infmt, outfmt))
         {
             aout_FormatsPrint (obj, "pass-through:", infmt, outfmt);
-            filter_t *f = FindConverter(obj, infmt, outfmt);
+            filter_t *f = FindConverter(obj, &filters->owner, infmt, outfmt);
             if (f == NULL)
             {
                 msg_Err (obj, "cannot setup pass-through");
@@ -594,8 +776,9 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
 
         /* convert to the output format (minus resampling) if necessary */
         output_format.i_rate = input_format.i_rate;
-        if (aout_FiltersPipelineCreate (obj, filters->tab, &filters->count,
-                                  AOUT_MAX_FILTERS, &input_format, &output_format))
+        if (aout_FiltersPipelineCreate (obj, &filters->owner, filters->tab,
+                                        &filters->count, AOUT_MAX_FILTERS,
+                                        &input_format, &output_format))
         {
             msg_Warn (obj, "cannot setup audio renderer pipeline");
             /* Fallback to bitmap without any conversions */
@@ -617,7 +800,8 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
         audio_sample_format_t input_phys_format = input_format;
         aout_SetWavePhysicalChannels(&input_phys_format);
 
-        filter_t *f = FindConverter (obj, &input_format, &input_phys_format);
+        filter_t *f = FindConverter (obj, &filters->owner, &input_format,
+                                     &input_phys_format);
         if (f == NULL)
         {
             msg_Err (obj, "cannot find channel converter");
@@ -663,8 +847,9 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
 
     /* convert to the output format (minus resampling) if necessary */
     output_format.i_rate = input_format.i_rate;
-    if (aout_FiltersPipelineCreate (obj, filters->tab, &filters->count,
-                              AOUT_MAX_FILTERS, &input_format, &output_format))
+    if (aout_FiltersPipelineCreate (obj, &filters->owner, filters->tab,
+                                    &filters->count, AOUT_MAX_FILTERS,
+                                    &input_format, &output_format))
     {
         msg_Err (obj, "cannot setup filtering pipeline");
         goto error;
@@ -674,7 +859,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
     /* insert the resampler */
     output_format.i_rate = outfmt->i_rate;
     assert (AOUT_FMTS_IDENTICAL(&output_format, outfmt));
-    filters->resampler.f = FindResampler(obj, &input_format,
+    filters->resampler.f = FindResampler(obj, &filters->owner, &input_format,
                                          &output_format);
     if (filters->resampler.f == NULL && input_format.i_rate != outfmt->i_rate)
     {
@@ -689,6 +874,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
 error:
     aout_FiltersPipelineDestroy (filters->tab, filters->count);
     var_DelCallback(obj, "visual", VisualizationCallback, NULL);
+    aout_block_pool_Close(filters->pool);
     free (filters);
     return NULL;
 }
@@ -764,6 +950,7 @@ void aout_FiltersDelete (vlc_object_t *obj, aout_filters_t *filters)
         aout_FiltersPipelineDestroy(&filters->resampler, 1);
     aout_FiltersPipelineDestroy (filters->tab, filters->count);
     var_DelCallback(obj, "visual", VisualizationCallback, NULL);
+    aout_block_pool_Close(filters->pool);
     free (filters);
 }
 
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <stdatomic.h>
 #include <limits.h>
+#include <math.h>
 
 #include <vlc_common.h>
 #include <vlc_block.h>
@@ -53,6 +54,7 @@
 #include "decoder.h"
 #include "resource.h"
 #include "decoder_prevframe.h"
+#include "decoder_threads.h"
 
 #include "../libvlc.h"
 
@@ -160,6 +162,10 @@ struct vlc_input_decoder_t
 
     bool hw_dec;
 
+    /* Thread budget entry of the decoder module, NULL if it did not request
+     * threads. Only used by the DecoderThread, reset on reload. */
+    struct vlc_decoder_threads *threads;
+
     const struct vlc_input_decoder_callbacks *cbs;
     void *cbs_userdata;
 
@@ -170,6 +176,23 @@ struct vlc_input_decoder_t
     es_format_t pktz_fmt_in;
     bool b_packetizer;
 
+    /* Packetizer running ahead of the decoder on its own thread, feeding
+     * the fifo with packetized frames. Guarded by the fifo lock. */
+    struct
+    {
+        vlc_thread_t thread;
+        vlc_cond_t wait;
+        vlc_frame_t *first; /* frames to packetize */
+        vlc_frame_t **last;
+        size_t count;
+        size_t bytes;
+        unsigned depth; /* packetized frames queued at most, 0 if disabled */
+        unsigned flushes;
+        bool busy;
+        bool draining;
+        struct vlc_list formats; /* format changes, in the fifo order */
+    } lookahead;
+
     /* initial and immutable category */
     enum es_format_category_e cat;
     /* Current format in use by the output */
@@ -228,6 +251,7 @@ struct vlc_input_decoder_t
     vlc_tick_t pause_date;
     vlc_tick_t delay, output_delay;
     float rate, output_rate;
+    bool wait_keyframe; /* after trick-play, until the next keyframe */
     int frames_countdown;
     bool paused, output_paused;
 
@@ -278,6 +302,16 @@ struct vlc_input_decoder_t
 /* */
 #define DECODER_SPU_VOUT_WAIT_DURATION   VLC_TICK_FROM_MS(200)
 #define BLOCK_FLAG_CORE_PRIVATE_RELOADED (1 << BLOCK_FLAG_CORE_PRIVATE_SHIFT)
+/* Packetized by the lookahead thread */
+#define BLOCK_FLAG_CORE_PRIVATE_PACKETIZED (2 << BLOCK_FLAG_CORE_PRIVATE_SHIFT)
+/* First frame of a new packetizer output format */
+#define BLOCK_FLAG_CORE_PRIVATE_FORMAT (4 << BLOCK_FLAG_CORE_PRIVATE_SHIFT)
+
+struct decoder_lookahead_format
+{
+    es_format_t fmt;
+    struct vlc_list node;
+};
 
 #define decoder_Notify(decoder_priv, event, ...) \
     if (decoder_priv->cbs && decoder_priv->cbs->event) \
@@ -453,9 +487,25 @@ static void Decoder_ChangeOutputRate( vlc_input_decoder_t *p_owner, float rate )
     switch( p_dec->fmt_in->i_cat )
     {
         case VIDEO_ES:
+        {
+            const float trick_rate = var_InheritFloat( p_dec, "trickplay-rate" );
+            const bool trick_play = trick_rate > 0.f && fabsf( rate ) >= trick_rate;
+            if( trick_play != p_dec->b_trick_play )
+            {
+                msg_Dbg( p_dec, "%s trick-play", trick_play ? "entering"
+                                                           : "leaving" );
+                p_dec->b_trick_play = trick_play;
+                /* The frames dropped meanwhile are missing references */
+                if( !trick_play )
+                    p_owner->wait_keyframe = true;
+            }
             if( p_owner->video.vout != NULL && p_owner->video.started )
+            {
                 vout_ChangeRate( p_owner->video.vout, rate );
+                vout_ChangeTrickPlay( p_owner->video.vout, trick_play );
+            }
             break;
+        }
         case AUDIO_ES:
             if( p_owner->audio.stream != NULL )
                 vlc_aout_stream_ChangeRate( p_owner->audio.stream, rate );
@@ -549,6 +599,7 @@ static int DecoderThread_Reload( vlc_input_decoder_t *p_owner,
 
     /* Restart the decoder module */
     vlc_fifo_Unlock(p_owner->p_fifo);
+    p_owner->threads = NULL;
     decoder_Clean( p_dec );
     vlc_fifo_Lock(p_owner->p_fifo);
     es_format_Clean( &p_owner->dec_fmt_in );
@@ -579,6 +630,7 @@ static int DecoderThread_Reload( vlc_input_decoder_t *p_owner,
         es_format_Clean( &fmt_in );
         return VLC_EGENERIC;
     }
+    p_owner->threads = vlc_decoder_threads_Get( p_dec );
     vlc_fifo_Lock(p_owner->p_fifo);
     es_format_Clean( &fmt_in );
     return VLC_SUCCESS;
@@ -1767,6 +1819,35 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
     decoder_t *p_dec = &p_owner->dec;
     struct vlc_tracer *tracer = vlc_object_get_tracer( &p_dec->obj );
 
+    /* In trick-play, and then until the next keyframe, only decode the
+     * keyframes of the streams telling the frame types */
+    if( frame != NULL && ( frame->i_flags & BLOCK_FLAG_TYPE_MASK ) )
+    {
+        if( frame->i_flags & BLOCK_FLAG_TYPE_I )
+            p_owner->wait_keyframe = false;
+        else if( p_dec->b_trick_play || p_owner->wait_keyframe )
+        {
+            block_Release( frame );
+            return;
+        }
+    }
+
+    /* Apply a new thread share from the next keyframe on, once the frames
+     * being decoded with the former share are out */
+    if( frame != NULL && p_owner->cat == VIDEO_ES
+     && ( frame->i_flags & BLOCK_FLAG_TYPE_I ) && p_owner->threads != NULL
+     && vlc_decoder_threads_ShouldReload( p_owner->threads, vlc_tick_now() ) )
+    {
+        msg_Dbg( p_dec, "reloading the decoder module for its thread share" );
+        DecoderThread_DecodeBlock( p_owner, NULL );
+        if( DecoderThread_Reload( p_owner, p_dec->fmt_in,
+                                  RELOAD_DECODER ) != VLC_SUCCESS )
+        {
+            block_Release( frame );
+            return;
+        }
+    }
+
     vlc_fifo_Unlock(p_owner->p_fifo);
 
     if ( tracer != NULL && frame != NULL )
@@ -1775,8 +1856,24 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
                             frame->i_pts, frame->i_dts );
     }
 
+    struct vlc_decoder_threads *threads = p_owner->threads;
+    vlc_tick_t start = 0, cpu = 0;
+    if( threads != NULL )
+    {
+        start = vlc_tick_now();
+        cpu = vlc_decoder_threads_CPUTime();
+    }
+
     int ret = p_dec->pf_decode( p_dec, frame );
 
+    if( threads != NULL )
+    {
+        vlc_tick_t busy = vlc_tick_now() - start;
+        cpu = vlc_decoder_threads_CPUTime() - cpu;
+        vlc_decoder_threads_Account( threads, busy, cpu );
+        decoder_Notify( p_owner, on_new_decoding_time, busy, cpu );
+    }
+
     vlc_fifo_Lock(p_owner->p_fifo);
     switch( ret )
     {
@@ -1811,6 +1908,18 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
 static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, vlc_frame_t *frame )
 {
     decoder_t *p_dec = &p_owner->dec;
+    struct decoder_lookahead_format *fmt = NULL;
+
+    if( frame != NULL && ( frame->i_flags & BLOCK_FLAG_CORE_PRIVATE_FORMAT ) )
+    {
+        /* Take the format out even if the frame is dropped */
+        frame->i_flags &= ~BLOCK_FLAG_CORE_PRIVATE_FORMAT;
+        fmt = vlc_list_first_entry_or_null( &p_owner->lookahead.formats,
+                                            struct decoder_lookahead_format,
+                                            node );
+        assert( fmt != NULL );
+        vlc_list_remove( &fmt->node );
+    }
 
     if( p_owner->error )
         goto error;
@@ -1829,14 +1938,43 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, vlc_frame_
             goto error;
     }
 
-    bool packetize = p_owner->p_packetizer != NULL;
+    if( fmt != NULL )
+    {
+        if( !es_format_IsSimilar( p_dec->fmt_in, &fmt->fmt ) )
+        {
+            msg_Dbg( p_dec, "restarting module due to input format change");
+            es_format_LogDifferences( vlc_object_logger(p_dec),
+                                      "decoder in", p_dec->fmt_in,
+                                      "packetizer out", &fmt->fmt );
+
+            /* Drain the decoder module */
+            DecoderThread_DecodeBlock( p_owner, NULL );
+
+            if( DecoderThread_Reload( p_owner, &fmt->fmt,
+                                      RELOAD_DECODER ) != VLC_SUCCESS )
+                goto error;
+        }
+        es_format_Clean( &fmt->fmt );
+        free( fmt );
+        fmt = NULL;
+    }
+
+    /* With a lookahead, only its thread packetizes, and drains the
+     * packetizer before queuing the drain request */
+    bool packetize = p_owner->p_packetizer != NULL
+                  && p_owner->lookahead.depth == 0;
     if( frame )
     {
         if( frame->i_buffer <= 0 )
             goto error;
 
+        /* The lookahead thread carries the preroll of the input frames on
+         * the packetized ones: the preroll is only updated here, in order
+         * with the flushes */
         DecoderUpdatePreroll( &p_owner->i_preroll_end, frame );
-        if( unlikely( frame->i_flags & BLOCK_FLAG_CORE_PRIVATE_RELOADED ) )
+        if( frame->i_flags & BLOCK_FLAG_CORE_PRIVATE_PACKETIZED )
+            assert( !packetize );
+        else if( unlikely( frame->i_flags & BLOCK_FLAG_CORE_PRIVATE_RELOADED ) )
         {
             /* This frame has already been packetized */
             packetize = false;
@@ -1905,6 +2043,11 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, vlc_frame_
     return;
 
 error:
+    if( fmt != NULL )
+    {
+        es_format_Clean( &fmt->fmt );
+        free( fmt );
+    }
     if( frame )
         block_Release( frame );
 }
@@ -1914,7 +2057,9 @@ static void DecoderThread_Flush( vlc_input_decoder_t *p_owner )
     decoder_t *p_dec = &p_owner->dec;
     decoder_t *p_packetizer = p_owner->p_packetizer;
 
-    if( p_packetizer != NULL && p_packetizer->pf_flush != NULL )
+    /* The lookahead thread flushes its packetizer itself */
+    if( p_packetizer != NULL && p_packetizer->pf_flush != NULL
+     && p_owner->lookahead.depth == 0 )
         p_packetizer->pf_flush( p_packetizer );
 
     if ( p_dec->pf_flush != NULL )
@@ -2027,7 +2172,8 @@ static void *DecoderThread( void *p_data )
             continue;
         }
 
-        vlc_cond_signal( &p_owner->wait_fifo );
+        /* Wake the input, or the lookahead thread */
+        vlc_cond_broadcast( &p_owner->wait_fifo );
 
         vlc_frame_t *frame = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
         if( frame == NULL )
@@ -2086,6 +2232,173 @@ static void *DecoderThread( void *p_data )
     return NULL;
 }
 
+static bool Lookahead_IsIdleLocked( const vlc_input_decoder_t *p_owner )
+{
+    return p_owner->lookahead.first == NULL && !p_owner->lookahead.busy
+        && !p_owner->lookahead.draining;
+}
+
+static void Lookahead_EmptyLocked( vlc_input_decoder_t *p_owner )
+{
+    block_ChainRelease( p_owner->lookahead.first );
+    p_owner->lookahead.first = NULL;
+    p_owner->lookahead.last = &p_owner->lookahead.first;
+    p_owner->lookahead.count = 0;
+    p_owner->lookahead.bytes = 0;
+
+    /* The format changes of the frames dropped from the fifo */
+    struct decoder_lookahead_format *fmt;
+    vlc_list_foreach( fmt, &p_owner->lookahead.formats, node )
+    {
+        vlc_list_remove( &fmt->node );
+        es_format_Clean( &fmt->fmt );
+        free( fmt );
+    }
+}
+
+/**
+ * The packetizer lookahead loop
+ *
+ * Packetizes the input frames and extracts their closed captions ahead of
+ * the decoder thread, then queues the packetized frames to its fifo.
+ *
+ * \param p_data the input decoder object
+ */
+static void *PacketizerThread( void *p_data )
+{
+    vlc_input_decoder_t *p_owner = (vlc_input_decoder_t *)p_data;
+    decoder_t *p_packetizer = p_owner->p_packetizer;
+    es_format_t fmt_sent;
+    bool has_fmt = false;
+    unsigned flushes = 0;
+
+    vlc_thread_set_name( "vlc-packetizer" );
+    es_format_Init( &fmt_sent, p_owner->cat, 0 );
+
+    vlc_fifo_Lock( p_owner->p_fifo );
+    for( ;; )
+    {
+        while( p_owner->lookahead.first == NULL
+            && !p_owner->lookahead.draining && !p_owner->aborting )
+            vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->lookahead.wait );
+        if( p_owner->aborting )
+            break;
+
+        /* No frame means draining */
+        vlc_frame_t *frame = p_owner->lookahead.first;
+        if( frame != NULL )
+        {
+            p_owner->lookahead.first = frame->p_next;
+            if( p_owner->lookahead.first == NULL )
+                p_owner->lookahead.last = &p_owner->lookahead.first;
+            frame->p_next = NULL;
+            p_owner->lookahead.count--;
+            p_owner->lookahead.bytes -= frame->i_buffer;
+            vlc_cond_broadcast( &p_owner->wait_fifo );
+
+            if( frame->i_buffer == 0 )
+            {
+                block_Release( frame );
+                continue;
+            }
+        }
+
+        /* The decoder thread updates the preroll from the packetized frames,
+         * since a flush resets it there */
+        const bool preroll = frame != NULL
+            && ( ( frame->i_flags & BLOCK_FLAG_PREROLL )
+              || ( frame->i_flags & (BLOCK_FLAG_DISCONTINUITY|BLOCK_FLAG_CORRUPTED) )
+                    == (BLOCK_FLAG_DISCONTINUITY|BLOCK_FLAG_CORRUPTED) );
+        const bool drain = frame == NULL;
+        const unsigned gen = p_owner->lookahead.flushes;
+        const bool flush = gen != flushes;
+        flushes = gen;
+        p_owner->lookahead.busy = true;
+        vlc_fifo_Unlock( p_owner->p_fifo );
+
+        if( flush )
+        {
+            if( p_packetizer->pf_flush != NULL )
+                p_packetizer->pf_flush( p_packetizer );
+            /* The last format sent may have been flushed */
+            has_fmt = false;
+        }
+
+        vlc_frame_t **pp_frame = drain ? NULL : &frame;
+        vlc_frame_t *out;
+        while( (out = p_packetizer->pf_packetize( p_packetizer, pp_frame )) )
+        {
+            struct decoder_lookahead_format *fmt = NULL;
+
+            if( !has_fmt || !es_format_IsSimilar( &fmt_sent,
+                                                  &p_packetizer->fmt_out ) )
+            {
+                fmt = malloc( sizeof (*fmt) );
+                if( likely(fmt != NULL)
+                 && es_format_Copy( &fmt->fmt, &p_packetizer->fmt_out ) == VLC_SUCCESS )
+                {
+                    es_format_Clean( &fmt_sent );
+                    es_format_Copy( &fmt_sent, &p_packetizer->fmt_out );
+                    has_fmt = true;
+                    out->i_flags |= BLOCK_FLAG_CORE_PRIVATE_FORMAT;
+                }
+                else
+                {
+                    free( fmt );
+                    fmt = NULL;
+                }
+            }
+
+            for( vlc_frame_t *f = out; f != NULL; f = f->p_next )
+            {
+                f->i_flags |= BLOCK_FLAG_CORE_PRIVATE_PACKETIZED;
+                if( preroll )
+                    f->i_flags |= BLOCK_FLAG_PREROLL;
+            }
+
+            vlc_fifo_Lock( p_owner->p_fifo );
+            while( vlc_fifo_GetCount( p_owner->p_fifo ) >= p_owner->lookahead.depth
+                && p_owner->lookahead.flushes == gen && !p_owner->aborting )
+                vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+
+            if( p_owner->lookahead.flushes == gen && !p_owner->aborting )
+            {
+                if( p_packetizer->pf_get_cc )
+                    PacketizerGetCc( p_owner, p_packetizer );
+                if( fmt != NULL )
+                    vlc_list_append( &fmt->node, &p_owner->lookahead.formats );
+                vlc_fifo_QueueUnlocked( p_owner->p_fifo, out );
+            }
+            else
+            {   /* Flushed meanwhile */
+                block_ChainRelease( out );
+                if( fmt != NULL )
+                {
+                    es_format_Clean( &fmt->fmt );
+                    free( fmt );
+                }
+            }
+            vlc_fifo_Unlock( p_owner->p_fifo );
+        }
+
+        vlc_fifo_Lock( p_owner->p_fifo );
+        p_owner->lookahead.busy = false;
+        if( drain && p_owner->lookahead.flushes == gen )
+        {
+            /* The packetizer is drained, now drain the decoder */
+            p_owner->lookahead.draining = false;
+            p_owner->b_draining = true;
+            vlc_fifo_Signal( p_owner->p_fifo );
+        }
+        if( Lookahead_IsIdleLocked( p_owner ) )
+            vlc_cond_signal( &p_owner->wait_acknowledge );
+    }
+    vlc_fifo_Unlock( p_owner->p_fifo );
+
+    es_format_Clean( &fmt_sent );
+    return NULL;
+}
+
 static const struct decoder_owner_callbacks dec_video_cbs =
 {
     .video = {
@@ -2160,11 +2473,23 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->p_sout_input = NULL;
     p_owner->p_packetizer = NULL;
 
+    vlc_cond_init( &p_owner->lookahead.wait );
+    p_owner->lookahead.first = NULL;
+    p_owner->lookahead.last = &p_owner->lookahead.first;
+    p_owner->lookahead.count = 0;
+    p_owner->lookahead.bytes = 0;
+    p_owner->lookahead.depth = 0;
+    p_owner->lookahead.flushes = 0;
+    p_owner->lookahead.busy = false;
+    p_owner->lookahead.draining = false;
+    vlc_list_init( &p_owner->lookahead.formats );
+
     p_owner->b_fmt_description = false;
     p_owner->p_description = NULL;
 
     p_owner->output_delay = p_owner->delay = 0;
     p_owner->output_rate = p_owner->rate = 1.f;
+    p_owner->wait_keyframe = false;
     p_owner->output_paused = p_owner->paused = false;
     p_owner->pause_date = VLC_TICK_INVALID;
     p_owner->frames_countdown = 0;
@@ -2175,6 +2500,7 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->out_started = false;
 
     p_owner->error = false;
+    p_owner->threads = NULL;
 
     p_owner->flushing = false;
     p_owner->b_draining = false;
@@ -2213,6 +2539,10 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
             {
                 p_owner->p_packetizer->fmt_out.b_packetized = true;
                 fmt = &p_owner->p_packetizer->fmt_out;
+
+                if( p_owner->cat == VIDEO_ES )
+                    p_owner->lookahead.depth =
+                        var_InheritInteger( p_dec, "dec-lookahead" );
             }
         }
     }
@@ -2255,6 +2585,7 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     decoder_Init(p_dec, &p_owner->dec_fmt_in, fmt);
     if (LoadDecoder(p_dec, cfg->sout != NULL, &p_owner->dec_fmt_in))
         return p_owner;
+    p_owner->threads = vlc_decoder_threads_Get( p_dec );
 
     assert( p_dec->fmt_in->i_cat == p_dec->fmt_out.i_cat && fmt->i_cat == p_dec->fmt_in->i_cat);
 
@@ -2293,10 +2624,14 @@ static void DeleteDecoder( vlc_input_decoder_t *p_owner, enum es_format_category
     msg_Dbg( p_dec, "killing decoder fourcc `%4.4s'",
              (char*)&p_dec->fmt_in->i_codec );
 
+    p_owner->threads = NULL;
     decoder_Clean( p_dec );
 
     /* Free all packets still in the decoder fifo. */
     block_FifoEmpty( p_owner->p_fifo );
+    vlc_fifo_Lock( p_owner->p_fifo );
+    Lookahead_EmptyLocked( p_owner );
+    vlc_fifo_Unlock( p_owner->p_fifo );
 
     /* Cleanup */
     if( p_owner->p_sout_input )
@@ -2435,10 +2770,33 @@ decoder_New( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
 
     if( !vlc_input_decoder_IsSynchronous( p_owner ) )
     {
+        /* Spawn the packetizer thread first, the decoder thread needs to
+         * know whether it runs */
+        if( p_owner->lookahead.depth > 0 )
+        {
+            if( vlc_clone( &p_owner->lookahead.thread, PacketizerThread,
+                           p_owner ) )
+            {
+                msg_Warn( p_dec, "cannot spawn packetizer thread" );
+                p_owner->lookahead.depth = 0;
+            }
+            else
+                msg_Dbg( p_dec, "packetizing up to %u frames ahead",
+                         p_owner->lookahead.depth );
+        }
+
         /* Spawn the decoder thread in asynchronous scenario. */
         if( vlc_clone( &p_owner->thread, DecoderThread, p_owner ) )
         {
             msg_Err( p_dec, "cannot spawn decoder thread" );
+            if( p_owner->lookahead.depth > 0 )
+            {
+                vlc_fifo_Lock( p_owner->p_fifo );
+                p_owner->aborting = true;
+                vlc_cond_signal( &p_owner->lookahead.wait );
+                vlc_fifo_Unlock( p_owner->p_fifo );
+                vlc_join( p_owner->lookahead.thread, NULL );
+            }
             DeleteDecoder( p_owner, p_dec->fmt_in->i_cat );
             return NULL;
         }
@@ -2508,8 +2866,12 @@ void vlc_input_decoder_Delete( vlc_input_decoder_t *p_owner )
 
     /* Make sure we aren't waiting/decoding anymore */
     vlc_cond_signal( &p_owner->wait_request );
+    vlc_cond_signal( &p_owner->lookahead.wait );
+    vlc_cond_broadcast( &p_owner->wait_fifo );
     vlc_fifo_Unlock( p_owner->p_fifo );
 
+    if( p_owner->lookahead.depth > 0 )
+        vlc_join( p_owner->lookahead.thread, NULL );
     if( !vlc_input_decoder_IsSynchronous( p_owner ) )
         vlc_join( p_owner->thread, NULL );
 
@@ -2630,16 +2992,28 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_owner, vlc_frame_
     }
 
     vlc_fifo_Lock( p_owner->p_fifo );
+    /* With a lookahead, the input frames wait in its queue instead */
+    const bool lookahead = p_owner->lookahead.depth > 0;
     if( !b_do_pace )
     {
         /* FIXME: ideally we would check the time amount of data
          * in the FIFO instead of its size. */
         /* 400 MiB, i.e. ~ 50mb/s for 60s */
-        if( vlc_fifo_GetBytes( p_owner->p_fifo ) > 400*1024*1024 )
+        if( ( lookahead ? p_owner->lookahead.bytes
+                        : vlc_fifo_GetBytes( p_owner->p_fifo ) ) > 400*1024*1024 )
         {
             msg_Warn( &p_owner->dec, "decoder/packetizer fifo full (data not "
                       "consumed quickly enough), resetting fifo!" );
-            block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+            if( lookahead )
+            {
+                block_ChainRelease( p_owner->lookahead.first );
+                p_owner->lookahead.first = NULL;
+                p_owner->lookahead.last = &p_owner->lookahead.first;
+                p_owner->lookahead.count = 0;
+                p_owner->lookahead.bytes = 0;
+            }
+            else
+                block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
             frame->i_flags |= BLOCK_FLAG_DISCONTINUITY;
         }
     }
@@ -2648,14 +3022,27 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_owner, vlc_frame_
     {   /* The FIFO is not consumed when waiting, so pacing would deadlock VLC.
          * Locking is not necessary as b_waiting is only read, not written by
          * the decoder thread. */
-        while( vlc_fifo_GetCount( p_owner->p_fifo ) >= 10 )
+        while( ( lookahead ? p_owner->lookahead.count
+                           : vlc_fifo_GetCount( p_owner->p_fifo ) ) >= 10 )
             vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
     }
 
-    if (vlc_fifo_IsEmpty(p_owner->p_fifo) && p_owner->frames_countdown > 0)
+    if (vlc_fifo_IsEmpty(p_owner->p_fifo) && p_owner->lookahead.first == NULL
+     && p_owner->frames_countdown > 0)
         decoder_Notify(p_owner, frame_next_need_data, false);
 
-    vlc_fifo_QueueUnlocked( p_owner->p_fifo, frame );
+    if( lookahead )
+    {
+        for( vlc_frame_t *f = frame; f != NULL; f = f->p_next )
+        {
+            p_owner->lookahead.count++;
+            p_owner->lookahead.bytes += f->i_buffer;
+        }
+        vlc_frame_ChainLastAppend( &p_owner->lookahead.last, frame );
+        vlc_cond_signal( &p_owner->lookahead.wait );
+    }
+    else
+        vlc_fifo_QueueUnlocked( p_owner->p_fifo, frame );
     if (status != NULL)
         GetStatusLocked(p_owner, status);
 
@@ -2685,7 +3072,7 @@ static bool vlc_input_decoder_IsDrainedLocked(vlc_input_decoder_t *owner)
 {
     vlc_fifo_Assert(owner->p_fifo);
 
-    if (owner->b_draining)
+    if (owner->b_draining || owner->lookahead.draining)
         return false;
     else if (owner->p_sout_input != NULL)
         return true;
@@ -2710,7 +3097,8 @@ bool vlc_input_decoder_IsEmpty( vlc_input_decoder_t * p_owner )
     assert( !p_owner->b_waiting );
 
     vlc_fifo_Lock( p_owner->p_fifo );
-    if( !vlc_fifo_IsEmpty( p_owner->p_fifo ) )
+    if( !vlc_fifo_IsEmpty( p_owner->p_fifo )
+     || !Lookahead_IsIdleLocked( p_owner ) )
     {
         vlc_fifo_Unlock( p_owner->p_fifo );
         return false;
@@ -2735,8 +3123,17 @@ void vlc_input_decoder_Drain( vlc_input_decoder_t *p_owner )
     }
 
     vlc_fifo_Lock( p_owner->p_fifo );
-    p_owner->b_draining = true;
-    vlc_fifo_Signal( p_owner->p_fifo );
+    if( p_owner->lookahead.depth > 0 )
+    {
+        /* Drain the packetizer first, it will drain the decoder */
+        p_owner->lookahead.draining = true;
+        vlc_cond_signal( &p_owner->lookahead.wait );
+    }
+    else
+    {
+        p_owner->b_draining = true;
+        vlc_fifo_Signal( p_owner->p_fifo );
+    }
     vlc_fifo_Unlock( p_owner->p_fifo );
 }
 
@@ -2747,6 +3144,16 @@ void vlc_input_decoder_Flush( vlc_input_decoder_t *p_owner )
 
     /* Empty the fifo */
     block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    if( p_owner->lookahead.depth > 0 )
+    {
+        /* The frames being packetized are dropped, and the packetizer
+         * flushed, once the lookahead thread sees the flush count change */
+        Lookahead_EmptyLocked( p_owner );
+        p_owner->lookahead.flushes++;
+        p_owner->lookahead.draining = false;
+        vlc_cond_signal( &p_owner->lookahead.wait );
+        vlc_cond_broadcast( &p_owner->wait_fifo );
+    }
 
     /* Don't need to wait for the DecoderThread to flush. Indeed, if called a
      * second time, this function will clear the FIFO again before anything was
@@ -2923,7 +3330,8 @@ void vlc_input_decoder_Wait( vlc_input_decoder_t *p_owner )
          * owner */
         if( p_owner->paused )
             break;
-        if( p_owner->b_idle && vlc_fifo_IsEmpty( p_owner->p_fifo ) )
+        if( p_owner->b_idle && vlc_fifo_IsEmpty( p_owner->p_fifo )
+         && Lookahead_IsIdleLocked( p_owner ) )
         {
             msg_Err( &p_owner->dec, "buffer deadlock prevented" );
             break;
@@ -52,6 +52,8 @@ struct vlc_input_decoder_callbacks {
                                void *userdata);
     void (*on_new_audio_stats)(vlc_input_decoder_t *decoder, unsigned decoded,
                                unsigned lost, unsigned played, void *userdata);
+    void (*on_new_decoding_time)(vlc_input_decoder_t *decoder, vlc_tick_t busy,
+                                 vlc_tick_t cpu, void *userdata);
     void (*frame_next_status)(vlc_input_decoder_t *decoder, int status,
                               void *userdata);
     void (*frame_next_need_data)(vlc_input_decoder_t *decoder, bool need_data,
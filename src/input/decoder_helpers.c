@@ -33,6 +33,7 @@
 #include <vlc_modules.h>
 #include <vlc_picture.h>
 #include "../libvlc.h"
+#include "decoder_threads.h"
 
 #include <stdckdint.h>
 
@@ -40,6 +41,7 @@ void decoder_Init( decoder_t *p_dec, es_format_t *restrict fmt_in, const es_form
 {
     p_dec->i_extra_picture_buffers = 0;
     p_dec->b_frame_drop_allowed = false;
+    p_dec->b_trick_play = false;
 
     p_dec->pf_decode = NULL;
     p_dec->pf_get_cc = NULL;
@@ -97,6 +99,7 @@ void decoder_Clean( decoder_t *p_dec )
         module_unneed(p_dec, p_dec->p_module);
         p_dec->p_module = NULL;
     }
+    vlc_decoder_threads_Release( p_dec );
 
     es_format_Clean( &p_dec->fmt_out );
 
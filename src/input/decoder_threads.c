@@ -0,0 +1,240 @@
+/*****************************************************************************
+ * decoder_threads.c: decoder thread budget
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vlc_common.h>
+#include <vlc_codec.h>
+#include <vlc_cpu.h>
+#include <vlc_list.h>
+
+#include "decoder_threads.h"
+
+/* Shares are recomputed at most this often while decoding, so that decoders
+ * coming and going in a burst (track changes) settle before any reload */
+#define REBALANCE_PERIOD VLC_TICK_FROM_SEC(1)
+/* A decoder is not reloaded more often than this for its share */
+#define RELOAD_INTERVAL VLC_TICK_FROM_SEC(5)
+
+struct vlc_decoder_threads
+{
+    struct vlc_list node;
+    decoder_t *dec;
+    unsigned wanted;
+    unsigned granted;  /* threads the decoder opened with */
+    vlc_tick_t opened; /* date of the last request */
+    bool assigned;
+
+    atomic_uint share; /* current fair share */
+
+    /* Statistics, updated by the decoder thread only */
+    atomic_uint_fast64_t calls;
+    _Atomic vlc_tick_t busy;
+    _Atomic vlc_tick_t cpu;
+};
+
+static vlc_mutex_t lock = VLC_STATIC_MUTEX;
+static struct vlc_list decoders = VLC_LIST_INITIALIZER(&decoders);
+static unsigned budget;
+static bool dirty; /* shares outdated since a decoder left */
+static _Atomic vlc_tick_t next_rebalance = VLC_TICK_INVALID;
+
+static struct vlc_decoder_threads *Find(decoder_t *dec)
+{
+    struct vlc_decoder_threads *entry;
+
+    vlc_list_foreach(entry, &decoders, node)
+        if (entry->dec == dec)
+            return entry;
+    return NULL;
+}
+
+/* Splits the budget equally, the decoders wanting fewer threads than their
+ * share leaving the rest to the others. Every decoder gets at least one
+ * thread, even past the budget. */
+static unsigned Rebalance(void)
+{
+    struct vlc_decoder_threads *entry;
+    unsigned count = 0;
+
+    vlc_list_foreach(entry, &decoders, node)
+    {
+        entry->assigned = false;
+        count++;
+    }
+
+    const unsigned total = count;
+    unsigned left = budget;
+    for (; count > 0; count--)
+    {
+        struct vlc_decoder_threads *min = NULL;
+
+        vlc_list_foreach(entry, &decoders, node)
+            if (!entry->assigned
+             && (min == NULL || entry->wanted < min->wanted))
+                min = entry;
+
+        unsigned share = __MIN(min->wanted, __MAX(left / count, 1));
+        unsigned old = atomic_load_explicit(&min->share, memory_order_relaxed);
+        if (share != old && min->granted != 0)
+            msg_Dbg(min->dec, "thread share changed from %u to %u",
+                    old, share);
+        atomic_store_explicit(&min->share, share, memory_order_relaxed);
+        min->assigned = true;
+        left -= __MIN(share, left);
+    }
+    dirty = false;
+    return total;
+}
+
+unsigned decoder_RequestThreads(decoder_t *dec, unsigned wanted)
+{
+    int64_t total = var_InheritInteger(dec, "dec-threads");
+    if (total <= 0)
+        total = vlc_GetCPUCount();
+    if (wanted == 0)
+        wanted = 1;
+
+    vlc_mutex_lock(&lock);
+    budget = total;
+
+    struct vlc_decoder_threads *entry = Find(dec);
+    if (entry == NULL)
+    {
+        entry = malloc(sizeof (*entry));
+        if (unlikely(entry == NULL))
+        {
+            vlc_mutex_unlock(&lock);
+            return wanted;
+        }
+        entry->dec = dec;
+        atomic_init(&entry->share, 0);
+        atomic_init(&entry->calls, 0);
+        atomic_init(&entry->busy, 0);
+        atomic_init(&entry->cpu, 0);
+        vlc_list_append(&entry->node, &decoders);
+    }
+    entry->wanted = wanted;
+    entry->granted = 0;
+    entry->opened = vlc_tick_now();
+    unsigned count = Rebalance();
+    unsigned granted = entry->granted =
+        atomic_load_explicit(&entry->share, memory_order_relaxed);
+    vlc_mutex_unlock(&lock);
+
+    msg_Dbg(dec, "using %u of %u wanted thread(s), %u decoder(s) sharing "
+            "%u thread(s)", granted, wanted, count, (unsigned)total);
+    return granted;
+}
+
+struct vlc_decoder_threads *vlc_decoder_threads_Get(decoder_t *dec)
+{
+    vlc_mutex_lock(&lock);
+    struct vlc_decoder_threads *entry = Find(dec);
+    vlc_mutex_unlock(&lock);
+    return entry;
+}
+
+void vlc_decoder_threads_Release(decoder_t *dec)
+{
+    vlc_mutex_lock(&lock);
+    struct vlc_decoder_threads *entry = Find(dec);
+    if (entry != NULL)
+    {
+        /* The others get the threads back at the next periodic rebalance */
+        vlc_list_remove(&entry->node);
+        dirty = true;
+    }
+    vlc_mutex_unlock(&lock);
+
+    if (entry == NULL)
+        return;
+
+    struct vlc_decoder_threads_stats stats;
+    vlc_decoder_threads_GetStats(entry, &stats);
+    msg_Dbg(dec, "decoded with %u thread(s): %"PRIu64" calls, "
+            "%"PRId64" ms decoding, %"PRId64" ms CPU", stats.granted,
+            stats.calls, MS_FROM_VLC_TICK(stats.busy),
+            MS_FROM_VLC_TICK(stats.cpu));
+    free(entry);
+}
+
+bool vlc_decoder_threads_ShouldReload(const struct vlc_decoder_threads *entry,
+                                      vlc_tick_t now)
+{
+    unsigned share = atomic_load_explicit(&entry->share, memory_order_relaxed);
+    if (share == entry->granted || now - entry->opened < RELOAD_INTERVAL)
+        return false;
+
+    /* Ignore the changes by less than a quarter of the threads */
+    unsigned diff = share > entry->granted ? share - entry->granted
+                                           : entry->granted - share;
+    return diff * 4 >= entry->granted;
+}
+
+void vlc_decoder_threads_Account(struct vlc_decoder_threads *entry,
+                                 vlc_tick_t busy, vlc_tick_t cpu)
+{
+    atomic_fetch_add_explicit(&entry->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&entry->busy, busy, memory_order_relaxed);
+    atomic_fetch_add_explicit(&entry->cpu, cpu, memory_order_relaxed);
+
+    vlc_tick_t now = vlc_tick_now();
+    vlc_tick_t deadline = atomic_load_explicit(&next_rebalance,
+                                               memory_order_relaxed);
+    if (now < deadline
+     || !atomic_compare_exchange_strong_explicit(&next_rebalance, &deadline,
+                                                 now + REBALANCE_PERIOD,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed))
+        return; /* not yet, or another decoder is rebalancing */
+
+    vlc_mutex_lock(&lock);
+    if (dirty)
+        Rebalance();
+    vlc_mutex_unlock(&lock);
+}
+
+void vlc_decoder_threads_GetStats(const struct vlc_decoder_threads *entry,
+                                  struct vlc_decoder_threads_stats *stats)
+{
+    stats->granted = entry->granted;
+    stats->share = atomic_load_explicit(&entry->share, memory_order_relaxed);
+    stats->calls = atomic_load_explicit(&entry->calls, memory_order_relaxed);
+    stats->busy = atomic_load_explicit(&entry->busy, memory_order_relaxed);
+    stats->cpu = atomic_load_explicit(&entry->cpu, memory_order_relaxed);
+}
+
+vlc_tick_t vlc_decoder_threads_CPUTime(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return vlc_tick_from_timespec(&ts);
+#endif
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * decoder_threads.h: decoder thread budget
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_INPUT_DECODER_THREADS_H
+#define LIBVLC_INPUT_DECODER_THREADS_H 1
+
+#include <vlc_common.h>
+#include <vlc_codec.h>
+
+struct vlc_decoder_threads;
+
+struct vlc_decoder_threads_stats
+{
+    unsigned granted; /**< threads the decoder opened with */
+    unsigned share; /**< current fair share */
+    uint64_t calls; /**< calls to the decoder */
+    vlc_tick_t busy; /**< wall clock time spent decoding */
+    vlc_tick_t cpu; /**< CPU time of the decoding thread */
+};
+
+/**
+ * Returns the thread budget entry of a decoder, or NULL if it did not
+ * request threads.
+ *
+ * The entry is valid until the decoder is cleaned.
+ */
+struct vlc_decoder_threads *vlc_decoder_threads_Get(decoder_t *);
+
+/**
+ * Gives the threads of a decoder back to the budget, and logs its
+ * statistics. Does nothing if the decoder did not request threads.
+ *
+ * The other decoders get the threads at the next periodic rebalance.
+ */
+void vlc_decoder_threads_Release(decoder_t *);
+
+/**
+ * Tells whether a decoder should be reloaded to apply its current share.
+ *
+ * Small changes, and changes too soon after the decoder opened, are
+ * ignored so that decoders are not reloaded back and forth.
+ */
+bool vlc_decoder_threads_ShouldReload(const struct vlc_decoder_threads *,
+                                      vlc_tick_t now);
+
+/**
+ * Accounts the time spent in one call to the decoder.
+ *
+ * This does not lock, but for the periodic rebalance of the shares, done
+ * by one of the decoding threads.
+ *
+ * \param busy wall clock time
+ * \param cpu CPU time of the calling thread
+ */
+void vlc_decoder_threads_Account(struct vlc_decoder_threads *,
+                                 vlc_tick_t busy, vlc_tick_t cpu);
+
+/**
+ * Reads the statistics of a decoder.
+ */
+void vlc_decoder_threads_GetStats(const struct vlc_decoder_threads *,
+                                  struct vlc_decoder_threads_stats *);
+
+/**
+ * Returns the CPU time consumed by the calling thread, or 0 if unknown.
+ */
+vlc_tick_t vlc_decoder_threads_CPUTime(void);
+
+#endif
@@ -450,6 +450,12 @@ int demux_vaControl( demux_t *demux, int query, va_list args )
                 return demux->ops->demux.set_rate(demux, rate);
             }
             return VLC_EGENERIC;
+        case DEMUX_SET_TRICK_PLAY:
+            if (demux->ops->demux.set_trick_play != NULL) {
+                bool trick_play = (bool)va_arg(args, int);
+                return demux->ops->demux.set_trick_play(demux, trick_play);
+            }
+            return VLC_EGENERIC;
         case DEMUX_SET_GROUP_DEFAULT:
             if (demux->ops->demux.set_group_default != NULL) {
                 return demux->ops->demux.set_group_default(demux);
@@ -647,6 +653,7 @@ int demux_vaControlHelper( stream_t *s,
         case DEMUX_SET_ES_LIST:
         case DEMUX_GET_ATTACHMENTS:
         case DEMUX_CAN_RECORD:
+        case DEMUX_SET_TRICK_PLAY:
         case DEMUX_TEST_AND_CLEAR_FLAGS:
         case DEMUX_GET_TITLE:
         case DEMUX_GET_SEEKPOINT:
@@ -608,6 +608,29 @@ decoder_get_attachments(vlc_input_decoder_t *decoder,
     return input_GetAttachments(p_sys->p_input, ppp_attachment);
 }
 
+static void
+decoder_on_new_decoding_time(vlc_input_decoder_t *decoder, vlc_tick_t busy,
+                             vlc_tick_t cpu, void *userdata)
+{
+    (void) decoder;
+
+    es_out_id_t *id = userdata;
+    struct vlc_input_es_out *out = id->out;
+    es_out_sys_t *p_sys = PRIV(&out->out);
+
+    if (!p_sys->p_input)
+        return;
+
+    struct input_stats *stats = input_priv(p_sys->p_input)->stats;
+    if (!stats)
+        return;
+
+    atomic_fetch_add_explicit(&stats->decoding_time, busy,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->decoding_cpu, cpu,
+                              memory_order_relaxed);
+}
+
 static const struct vlc_input_decoder_callbacks decoder_cbs = {
     .on_vout_started = decoder_on_vout_started,
     .on_vout_stopped = decoder_on_vout_stopped,
@@ -615,6 +638,7 @@ static const struct vlc_input_decoder_callbacks decoder_cbs = {
     .on_thumbnail_ready = decoder_on_thumbnail_ready,
     .on_new_video_stats = decoder_on_new_video_stats,
     .on_new_audio_stats = decoder_on_new_audio_stats,
+    .on_new_decoding_time = decoder_on_new_decoding_time,
     .frame_next_status = decoder_frame_next_status,
     .frame_next_need_data = decoder_frame_next_need_data,
     .frame_previous_status = decoder_frame_previous_status,
@@ -276,6 +276,7 @@ input_thread_t * input_Create( vlc_object_t *p_parent, input_item_t *p_item,
     priv->is_stopped = false;
     priv->b_recording = false;
     priv->rate = 1.f;
+    priv->b_trick_play = false;
     TAB_INIT( priv->i_attachment, priv->attachment );
     priv->p_sout   = NULL;
     priv->b_out_pace_control = priv->type == INPUT_TYPE_THUMBNAILING;
@@ -2191,6 +2192,20 @@ static bool Control( input_thread_t *p_input,
                 priv->rate = rate;
                 input_SendEventRate( p_input, rate );
 
+                /* Let the demuxer skip the non sync samples when fast */
+                const float trick_rate =
+                    var_InheritFloat( p_input, "trickplay-rate" );
+                const bool trick_play = trick_rate > 0.f
+                                     && fabsf( rate ) >= trick_rate;
+                if( trick_play != priv->b_trick_play )
+                {
+                    priv->b_trick_play = trick_play;
+                    if( demux_Control( priv->master->p_demux,
+                                       DEMUX_SET_TRICK_PLAY, trick_play ) )
+                        msg_Dbg( p_input, "demuxer outputs every sample "
+                                 "in trick-play" );
+                }
+
                 if( priv->master->b_rescale_ts )
                 {
                     const float rate_source = (priv->master->b_can_pace_control ||
@@ -507,6 +507,7 @@ typedef struct input_thread_private_t
     bool        is_stopped;
     bool        b_recording;
     float       rate;
+    bool        b_trick_play;
 
     /* Playtime configuration and state */
     vlc_tick_t  i_start;    /* :start-time,0 by default */
@@ -774,6 +775,8 @@ struct input_stats {
     atomic_uintmax_t demux_discontinuity;
     atomic_uintmax_t decoded_audio;
     atomic_uintmax_t decoded_video;
+    atomic_uintmax_t decoding_time;
+    atomic_uintmax_t decoding_cpu;
     atomic_uintmax_t played_abuffers;
     atomic_uintmax_t lost_abuffers;
     atomic_uintmax_t displayed_pictures;
@@ -63,6 +63,8 @@ struct input_stats *input_stats_Create(void)
     atomic_init(&stats->demux_discontinuity, 0);
     atomic_init(&stats->decoded_audio, 0);
     atomic_init(&stats->decoded_video, 0);
+    atomic_init(&stats->decoding_time, 0);
+    atomic_init(&stats->decoding_cpu, 0);
     atomic_init(&stats->played_abuffers, 0);
     atomic_init(&stats->lost_abuffers, 0);
     atomic_init(&stats->displayed_pictures, 0);
@@ -111,6 +113,12 @@ void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
                                                     memory_order_relaxed);
     st->i_lost_pictures = atomic_load_explicit(&stats->lost_pictures,
                                                memory_order_relaxed);
+
+    /* Decoders */
+    st->i_decoding_time = atomic_load_explicit(&stats->decoding_time,
+                                               memory_order_relaxed);
+    st->i_decoding_cpu = atomic_load_explicit(&stats->decoding_cpu,
+                                              memory_order_relaxed);
 }
 
 /** Update a counter element with new values
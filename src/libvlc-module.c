@@ -732,6 +732,11 @@ static const char *const ppsz_prefres[] = {
 #define INPUT_RATE_LONGTEXT N_( \
     "This defines the playback speed (nominal speed is 1.0)." )
 
+#define INPUT_TRICKPLAY_TEXT N_("Trick-play speed")
+#define INPUT_TRICKPLAY_LONGTEXT N_( \
+    "From this playback speed on, only the keyframes of the video are " \
+    "demuxed and decoded, at a lower quality (0 = never)." )
+
 #define INPUT_LIST_TEXT N_("Input list")
 #define INPUT_LIST_LONGTEXT N_( \
     "You can give a comma-separated list " \
@@ -1022,6 +1027,17 @@ static const char* const ppsz_restore_playback_desc[] = {
 #define DEC_DEV_TEXT N_("Preferred decoder hardware device")
 #define DEC_DEV_LONGTEXT N_("This allows hardware decoding when available.")
 
+#define DEC_THREADS_TEXT N_("Decoder threads budget")
+#define DEC_THREADS_LONGTEXT N_( \
+    "Number of threads shared equally by all the decoders running at " \
+    "the same time, such as the tiles of a mosaic (0 = number of CPUs). " \
+    "Decoders with an explicit threads count are not limited." )
+
+#define DEC_LOOKAHEAD_TEXT N_("Packetizer lookahead")
+#define DEC_LOOKAHEAD_LONGTEXT N_( \
+    "Number of access units parsed ahead of the video decoder by a " \
+    "separate packetizer thread (0 = packetize on the decoder thread)." )
+
 /*****************************************************************************
  * Sout
  ****************************************************************************/
@@ -1207,6 +1223,27 @@ static const char *const clock_sources_text[] = {
 #define PREPARSE_THREADS_LONGTEXT N_( \
     "Maximum number of threads used to preparse items" )
 
+#define PREPARSE_SERDES_TEXT N_( "Preparser message serializer" )
+#define PREPARSE_SERDES_LONGTEXT N_( \
+    "Serializer used to exchange requests and results with the external " \
+    "preparser process." )
+
+#define PREPARSE_PRESPAWN_TEXT N_( "Start preparser processes early" )
+#define PREPARSE_PRESPAWN_LONGTEXT N_( \
+    "Start all the external preparser processes when the preparser is " \
+    "created, instead of on demand, so that no request waits for a " \
+    "process to start up." )
+
+#define PREPARSE_PROCESS_TASKS_TEXT N_( "Requests per preparser process" )
+#define PREPARSE_PROCESS_TASKS_LONGTEXT N_( \
+    "Restart an external preparser process after it handled this many " \
+    "requests (0 = never)." )
+
+#define PREPARSE_PROCESS_MEMORY_TEXT N_( "Preparser process memory limit" )
+#define PREPARSE_PROCESS_MEMORY_LONGTEXT N_( \
+    "Restart an external preparser process once its resident memory " \
+    "exceeds this size, in MiB (0 = never)." )
+
 #define FETCH_ART_THREADS_TEXT N_( "Fetch-art threads" )
 #define FETCH_ART_THREADS_LONGTEXT N_( \
     "Maximum number of threads used to fetch art" )
@@ -1899,6 +1936,8 @@ vlc_module_begin ()
         change_safe ()
     add_float( "rate", 1.,
                INPUT_RATE_TEXT, INPUT_RATE_LONGTEXT )
+    add_float( "trickplay-rate", 4.,
+               INPUT_TRICKPLAY_TEXT, INPUT_TRICKPLAY_LONGTEXT )
 
     add_string( "input-list", NULL,
                  INPUT_LIST_TEXT, INPUT_LIST_LONGTEXT )
@@ -2040,6 +2079,10 @@ vlc_module_begin ()
     add_bool( "hw-dec", true, HW_DEC_TEXT, HW_DEC_LONGTEXT )
     add_obsolete_string( "encoder" ) /* since 4.0.0 */
     add_module("dec-dev", "decoder device", "any", DEC_DEV_TEXT, DEC_DEV_LONGTEXT)
+    add_integer_with_range( "dec-threads", 0, 0, 1024, DEC_THREADS_TEXT,
+                            DEC_THREADS_LONGTEXT )
+    add_integer_with_range( "dec-lookahead", 0, 0, 64, DEC_LOOKAHEAD_TEXT,
+                            DEC_LOOKAHEAD_LONGTEXT )
 
     //set_subcategory( SUBCAT_INPUT_SCODEC )
     set_subcategory( SUBCAT_INPUT_STREAM_FILTER )
@@ -2176,6 +2219,18 @@ vlc_module_begin ()
     add_integer( "preparse-threads", 1, PREPARSE_THREADS_TEXT,
                  PREPARSE_THREADS_LONGTEXT )
 
+    add_module("preparser-serdes", "preparser msg serdes", "any",
+               PREPARSE_SERDES_TEXT, PREPARSE_SERDES_LONGTEXT)
+
+    add_bool( "preparser-prespawn", false, PREPARSE_PRESPAWN_TEXT,
+              PREPARSE_PRESPAWN_LONGTEXT )
+    add_integer_with_range( "preparser-process-tasks", 0, 0, INT_MAX,
+                            PREPARSE_PROCESS_TASKS_TEXT,
+                            PREPARSE_PROCESS_TASKS_LONGTEXT )
+    add_integer_with_range( "preparser-process-memory", 0, 0, INT_MAX,
+                            PREPARSE_PROCESS_MEMORY_TEXT,
+                            PREPARSE_PROCESS_MEMORY_LONGTEXT )
+
     add_integer( "fetch-art-threads", 1, FETCH_ART_THREADS_TEXT,
                  FETCH_ART_THREADS_LONGTEXT )
 
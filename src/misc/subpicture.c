@@ -35,6 +35,7 @@
 #include "subpicture.h"
 
 #include <limits.h>
+#include <stdatomic.h>
 
 struct subpicture_private_t
 {
@@ -103,6 +104,8 @@ vlc_render_subpicture *vlc_render_subpicture_New( void )
     if( unlikely(p_subpic == NULL ) )
         return NULL;
     vlc_vector_init(&p_subpic->regions);
+    p_subpic->b_changed = true;
+    p_subpic->damage = (vout_display_place_t) { 0 };
     return p_subpic;
 }
 
@@ -207,8 +210,23 @@ typedef struct subpicture_region_private_t
     subpicture_region_t region;
     video_format_t fmt;
     picture_t *p_picture;
+    uint64_t version;
 } subpicture_region_private_t;
 
+static atomic_uint_fast64_t region_version = 0;
+
+static uint64_t subpicture_region_NextVersion( void )
+{
+    return atomic_fetch_add_explicit( &region_version, 1,
+                                      memory_order_relaxed ) + 1;
+}
+
+uint64_t subpicture_region_GetVersion( const subpicture_region_t *p_region )
+{
+    subpicture_region_private_t *p_priv = container_of(p_region, subpicture_region_private_t, region);
+    return p_priv->version;
+}
+
 const video_format_t * subpicture_region_cache_GetFormat( const subpicture_region_t *p_region )
 {
     subpicture_region_private_t *p_priv = container_of(p_region, subpicture_region_private_t, region);
@@ -236,6 +254,7 @@ void subpicture_region_cache_Invalidate( subpicture_region_t *p_region )
     }
     video_format_Clean( &p_priv->fmt );
     video_format_Init( &p_priv->fmt, 0 );
+    p_priv->version = subpicture_region_NextVersion();
 }
 
 int subpicture_region_cache_Assign( subpicture_region_t *p_region, picture_t *p_picture )
@@ -244,6 +263,7 @@ int subpicture_region_cache_Assign( subpicture_region_t *p_region, picture_t *p_
     if ( video_format_Copy( &p_priv->fmt, &p_picture->format ) != VLC_SUCCESS )
         return VLC_EGENERIC;
     p_priv->p_picture = p_picture;
+    p_priv->version = subpicture_region_NextVersion();
     return VLC_SUCCESS;
 }
 
@@ -253,6 +273,7 @@ static subpicture_region_t * subpicture_region_NewInternal( void )
     if( unlikely(p_region == NULL) )
         return NULL;
 
+    p_region->version = subpicture_region_NextVersion();
     p_region->region.i_alpha = 0xff;
     p_region->region.i_x = INT_MAX;
     p_region->region.i_y = INT_MAX;
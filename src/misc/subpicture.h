@@ -25,3 +25,13 @@ void subpicture_region_cache_Invalidate( subpicture_region_t * );
 const video_format_t * subpicture_region_cache_GetFormat( const subpicture_region_t * );
 int subpicture_region_cache_Assign( subpicture_region_t *p_region, picture_t * );
 bool subpicture_region_cache_IsValid(const subpicture_region_t *);
+
+/**
+ * Returns the content version of a region.
+ *
+ * The version is unique for the region and changes whenever its rendering
+ * cache is assigned or invalidated. Regions pictures are not modified once
+ * submitted, so two renderings of the same region with the same version
+ * share the same pixels.
+ */
+uint64_t subpicture_region_GetVersion( const subpicture_region_t * );
@@ -206,6 +206,23 @@ vlc_process_Terminate(struct vlc_process *process, bool kill_process)
     return -1;
 }
 
+VLC_WEAK int
+vlc_process_Stop(struct vlc_process *process, vlc_tick_t timeout)
+{
+    VLC_UNUSED(process);
+    VLC_UNUSED(timeout);
+    vlc_assert_unreachable();
+    return -1;
+}
+
+VLC_WEAK pid_t
+vlc_process_GetPid(const struct vlc_process *process)
+{
+    VLC_UNUSED(process);
+    vlc_assert_unreachable();
+    return -1;
+}
+
 VLC_WEAK ssize_t
 vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
                     vlc_tick_t timeout_ms)
@@ -218,6 +235,19 @@ vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
     return -1;
 }
 
+VLC_WEAK ssize_t
+vlc_process_fd_ReadFd(struct vlc_process *process, uint8_t *buf, size_t size,
+                      vlc_tick_t timeout_ms, int *fd)
+{
+    VLC_UNUSED(process);
+    VLC_UNUSED(buf);
+    VLC_UNUSED(size);
+    VLC_UNUSED(timeout_ms);
+    VLC_UNUSED(fd);
+    vlc_assert_unreachable();
+    return -1;
+}
+
 VLC_WEAK ssize_t
 vlc_process_fd_Write(struct vlc_process *process, const uint8_t *buf, size_t size,
                      vlc_tick_t timeout_ms)
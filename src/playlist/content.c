@@ -58,34 +58,102 @@ vlc_playlist_ItemsReset(vlc_playlist_t *playlist)
 }
 
 static void
-vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count,
-                           bool subitems)
+vlc_playlist_ItemsAdded(vlc_playlist_t *playlist, size_t index, size_t count,
+                        bool subitems, struct vlc_playlist_state *state)
 {
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
         randomizer_Add(&playlist->randomizer,
                        &playlist->items.data[index], count);
 
+    playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
+    playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
+
+    vlc_playlist_item_t **items = &playlist->items.data[index];
+    vlc_playlist_Notify(playlist, on_items_added, index, items, count);
+    vlc_playlist_state_NotifyChanges(playlist, state);
+
+    vlc_playlist_PreparseItems(playlist, index, count, subitems);
+}
+
+static bool
+vlc_playlist_CanMergeInsertion(vlc_playlist_t *playlist, size_t index,
+                               bool subitems)
+{
+    struct vlc_playlist_batch *batch = &playlist->batch;
+    return batch->count == 0 || (batch->subitems == subitems
+                              && index >= batch->index
+                              && index <= batch->index + batch->count);
+}
+
+static void
+vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count,
+                           bool subitems)
+{
+    struct vlc_playlist_batch *batch = &playlist->batch;
+    assert(vlc_playlist_CanMergeInsertion(playlist, index, subitems));
+
     struct vlc_playlist_state state;
-    vlc_playlist_state_Save(playlist, &state);
+    if (batch->count == 0)
+        vlc_playlist_state_Save(playlist, &state);
 
     if (playlist->current >= (ssize_t) index)
         playlist->current += count;
+
+    if (batch->depth == 0)
+    {
+        vlc_playlist_ItemsAdded(playlist, index, count, subitems, &state);
+        return;
+    }
+
+    /* The randomizer only receives the pending items on commit, so in random
+     * order, has_prev and has_next do not account for them yet */
     playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
     playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
 
-    vlc_playlist_item_t **items = &playlist->items.data[index];
-    vlc_playlist_Notify(playlist, on_items_added, index, items, count);
-    vlc_playlist_state_NotifyChanges(playlist, &state);
-
-    for (size_t i = index; i < index + count; ++i)
+    /* notify once on commit */
+    if (batch->count == 0)
     {
-        vlc_playlist_item_t *item = playlist->items.data[i];
-        item->preparser_req = vlc_playlist_AutoPreparse(playlist, item->media,
-                                                        subitems);
+        batch->index = index;
+        batch->subitems = subitems;
+        batch->state = state;
     }
+    batch->count += count;
 }
 
-static void
+void
+vlc_playlist_FlushBatch(vlc_playlist_t *playlist)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    struct vlc_playlist_batch *batch = &playlist->batch;
+    if (batch->count == 0)
+        return;
+
+    size_t count = batch->count;
+    batch->count = 0;
+    vlc_playlist_ItemsAdded(playlist, batch->index, count, batch->subitems,
+                            &batch->state);
+    vlc_playlist_UpdateNextMedia(playlist);
+}
+
+void
+vlc_playlist_BeginBatch(vlc_playlist_t *playlist)
+{
+    vlc_playlist_AssertLocked(playlist);
+    playlist->batch.depth++;
+}
+
+void
+vlc_playlist_CommitBatch(vlc_playlist_t *playlist)
+{
+    vlc_playlist_AssertLocked(playlist);
+    assert(playlist->batch.depth > 0);
+
+    if (--playlist->batch.depth == 0)
+        vlc_playlist_FlushBatch(playlist);
+}
+
+void
 vlc_playlist_ItemsMoved(vlc_playlist_t *playlist, size_t index, size_t count,
                         size_t target)
 {
@@ -177,8 +245,7 @@ vlc_playlist_ItemReplaced(vlc_playlist_t *playlist, size_t index)
                         &playlist->items.data[index], 1);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 
-    vlc_playlist_AutoPreparse(playlist, playlist->items.data[index]->media,
-                              false);
+    vlc_playlist_PreparseItems(playlist, index, 1, false);
 }
 
 size_t
@@ -234,9 +301,13 @@ vlc_playlist_Clear(vlc_playlist_t *playlist)
 {
     vlc_playlist_AssertLocked(playlist);
 
+    /* the pending insertions are notified by the reset */
+    playlist->batch.count = 0;
+
     int ret = vlc_player_SetCurrentMedia(playlist->player, NULL);
     VLC_UNUSED(ret); /* what could we do? */
 
+    vlc_playlist_ClearPreparseQueue(playlist);
     if (playlist->parser != NULL)
         vlc_preparser_Cancel(playlist->parser, NULL);
 
@@ -274,6 +345,9 @@ vlc_playlist_Insert(vlc_playlist_t *playlist, size_t index,
     vlc_playlist_AssertLocked(playlist);
     assert(index <= playlist->items.size);
 
+    if (!vlc_playlist_CanMergeInsertion(playlist, index, true))
+        vlc_playlist_FlushBatch(playlist);
+
     /* make space in the vector */
     if (!vlc_vector_insert_hole(&playlist->items, index, count))
         return VLC_ENOMEM;
@@ -289,7 +363,8 @@ vlc_playlist_Insert(vlc_playlist_t *playlist, size_t index,
     }
 
     vlc_playlist_ItemsInserted(playlist, index, count, true);
-    vlc_playlist_UpdateNextMedia(playlist);
+    if (playlist->batch.depth == 0)
+        vlc_playlist_UpdateNextMedia(playlist);
 
     return VLC_SUCCESS;
 }
@@ -302,6 +377,7 @@ vlc_playlist_Move(vlc_playlist_t *playlist, size_t index, size_t count,
     assert(index + count <= playlist->items.size);
     assert(target + count <= playlist->items.size);
 
+    vlc_playlist_FlushBatch(playlist);
     vlc_vector_move_slice(&playlist->items, index, count, target);
 
     vlc_playlist_ItemsMoved(playlist, index, count, target);
@@ -314,16 +390,20 @@ vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
     vlc_playlist_AssertLocked(playlist);
     assert(index < playlist->items.size);
 
+    vlc_playlist_FlushBatch(playlist);
     vlc_playlist_ItemsRemoving(playlist, index, count);
 
     for (size_t i = 0; i < count; ++i) {
         vlc_playlist_item_t *item = playlist->items.data[index + i];
+        item->preparse_queued = false;
         if (playlist->parser != NULL
                 && item->preparser_req != NULL)
             vlc_preparser_Cancel(playlist->parser, item->preparser_req);
 
         vlc_playlist_item_Release(item);
     }
+    /* the canceled requests left room for the queued ones */
+    vlc_playlist_PreparseNext(playlist);
 
     vlc_vector_remove_slice(&playlist->items, index, count);
 
@@ -342,6 +422,8 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
     vlc_playlist_AssertLocked(playlist);
     assert(index < playlist->items.size);
 
+    vlc_playlist_FlushBatch(playlist);
+
     uint64_t id = playlist->idgen++;
     vlc_playlist_item_t *item = vlc_playlist_item_New(media, id);
     if (!item)
@@ -355,6 +437,7 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
     }
 
     vlc_playlist_item_t *old = playlist->items.data[index];
+    old->preparse_queued = false;
     if (playlist->parser != NULL
             && old->preparser_req != NULL)
         vlc_preparser_Cancel(playlist->parser, old->preparser_req);
@@ -372,6 +455,8 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
     vlc_playlist_AssertLocked(playlist);
     assert(index < playlist->items.size);
 
+    vlc_playlist_FlushBatch(playlist);
+
     if (count == 0)
         vlc_playlist_RemoveOne(playlist, index);
     else
@@ -396,6 +481,8 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
                 return ret;
             }
             vlc_playlist_ItemsInserted(playlist, index + 1, count - 1, false);
+            /* expansions are not batched */
+            vlc_playlist_FlushBatch(playlist);
         }
 
         if ((ssize_t) index == playlist->current)
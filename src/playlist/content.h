@@ -33,4 +33,13 @@ int
 vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
                     input_item_t *const media[], size_t count);
 
+/* notify the pending insertions of the current batch */
+void
+vlc_playlist_FlushBatch(vlc_playlist_t *playlist);
+
+/* update the state and notify the listeners after a slice has been moved */
+void
+vlc_playlist_ItemsMoved(vlc_playlist_t *playlist, size_t index, size_t count,
+                        size_t target);
+
 #endif
@@ -24,6 +24,7 @@
 
 #include "control.h"
 
+#include "content.h"
 #include "item.h"
 #include "notify.h"
 #include "playlist.h"
@@ -128,6 +129,7 @@ vlc_playlist_SetPlaybackRepeat(vlc_playlist_t *playlist,
                                enum vlc_playlist_playback_repeat repeat)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
 
     if (playlist->repeat == repeat)
         return;
@@ -141,6 +143,7 @@ vlc_playlist_SetPlaybackOrder(vlc_playlist_t *playlist,
                               enum vlc_playlist_playback_order order)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
 
     if (playlist->order == order)
         return;
@@ -348,6 +351,7 @@ int
 vlc_playlist_Prev(vlc_playlist_t *playlist)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
 
     if (!vlc_playlist_ComputeHasPrev(playlist))
         return VLC_EGENERIC;
@@ -376,6 +380,7 @@ int
 vlc_playlist_Next(vlc_playlist_t *playlist)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
 
     if (!vlc_playlist_ComputeHasNext(playlist))
         return VLC_EGENERIC;
@@ -403,6 +408,7 @@ vlc_playlist_GoTo(vlc_playlist_t *playlist, ssize_t index)
 {
     vlc_playlist_AssertLocked(playlist);
     assert(index == -1 || (size_t) index < playlist->items.size);
+    vlc_playlist_FlushBatch(playlist);
 
     int ret = vlc_playlist_SetCurrentMedia(playlist, index);
     if (ret != VLC_SUCCESS)
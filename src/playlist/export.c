@@ -34,23 +34,6 @@
 #include "playlist.h"
 #include "../libvlc.h"
 
-struct vlc_playlist_view
-{
-    vlc_playlist_t *playlist;
-};
-
-size_t
-vlc_playlist_view_Count(struct vlc_playlist_view *view)
-{
-    return vlc_playlist_Count(view->playlist);
-}
-
-vlc_playlist_item_t *
-vlc_playlist_view_Get(struct vlc_playlist_view *view, size_t index)
-{
-    return vlc_playlist_Get(view->playlist, index);
-}
-
 int
 vlc_playlist_Export(struct vlc_playlist *playlist, const char *filename,
                     const char *type)
@@ -66,9 +49,15 @@ vlc_playlist_Export(struct vlc_playlist *playlist, const char *filename,
 
     int ret = VLC_EGENERIC;
 
-    struct vlc_playlist_view playlist_view = { .playlist = playlist };
+    struct vlc_playlist_view *playlist_view =
+        vlc_playlist_view_New(playlist, NULL, NULL);
+    if (!playlist_view)
+    {
+        vlc_object_delete(export);
+        return VLC_ENOMEM;
+    }
 
-    export->playlist_view = &playlist_view;
+    export->playlist_view = playlist_view;
     export->base_url = vlc_path2uri(filename, NULL);
     export->file = vlc_fopen(filename, "wt");
     if (!export->file)
@@ -99,6 +88,7 @@ close_file:
     fclose(export->file);
 out:
    free(export->base_url);
+   vlc_playlist_view_Delete(playlist_view);
    vlc_object_delete(export);
    return ret;
 }
@@ -23,6 +23,7 @@
 #endif
 
 #include "item.h"
+#include "sort.h"
 
 #include <vlc_playlist.h>
 #include <vlc_input_item.h>
@@ -37,6 +38,8 @@ vlc_playlist_item_New(input_item_t *media, uint64_t id)
     vlc_atomic_rc_init(&item->rc);
     item->id = id;
     item->preparser_req = NULL;
+    item->preparse_queued = false;
+    item->sort_meta = NULL;
     item->media = media;
     input_item_Hold(media);
     return item;
@@ -53,6 +56,7 @@ vlc_playlist_item_Release(vlc_playlist_item_t *item)
 {
     if (vlc_atomic_rc_dec(&item->rc))
     {
+        vlc_playlist_item_InvalidateSortKeys(item);
         input_item_Release(item->media);
         free(item);
     }
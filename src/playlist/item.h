@@ -26,12 +26,16 @@
 
 typedef struct vlc_playlist_item vlc_playlist_item_t;
 typedef struct input_item_t input_item_t;
+struct vlc_playlist_item_meta;
 
 struct vlc_playlist_item
 {
     input_item_t *media;
     uint64_t id;
     vlc_preparser_req *preparser_req;
+    bool preparse_queued;
+    /* cached sort keys, only accessed with the playlist locked */
+    struct vlc_playlist_item_meta *sort_meta;
     vlc_atomic_rc_t rc;
 };
 
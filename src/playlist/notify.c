@@ -24,8 +24,10 @@
 
 #include "notify.h"
 
+#include "content.h"
 #include "item.h"
 #include "playlist.h"
+#include "sort.h"
 
 static void
 vlc_playlist_NotifyCurrentState(vlc_playlist_t *playlist,
@@ -115,13 +117,23 @@ void
 vlc_playlist_NotifyMediaUpdated(vlc_playlist_t *playlist, input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
+
+    bool current = playlist->current != -1 &&
+                   playlist->items.data[playlist->current]->media == media;
+
     if (!vlc_playlist_HasItemUpdatedListeners(playlist))
-        /* no need to find the index if there are no listeners */
+    {
+        /* no need to find the index if there are no listeners, but the
+         * cached sort keys of the current item are dropped for free */
+        if (current)
+            vlc_playlist_item_InvalidateSortKeys(
+                    playlist->items.data[playlist->current]);
         return;
+    }
 
     ssize_t index;
-    if (playlist->current != -1 &&
-            playlist->items.data[playlist->current]->media == media)
+    if (current)
         /* the player typically sends events for the current item, so we can
          * often avoid to search */
         index = playlist->current;
@@ -132,6 +144,8 @@ vlc_playlist_NotifyMediaUpdated(vlc_playlist_t *playlist, input_item_t *media)
         if (index == -1)
             return;
     }
+
+    vlc_playlist_item_InvalidateSortKeys(playlist->items.data[index]);
     vlc_playlist_Notify(playlist, on_items_updated, index,
                         &playlist->items.data[index], 1);
 }
@@ -27,6 +27,7 @@
 
 #include "player.h"
 
+#include "content.h"
 #include "control.h"
 #include "item.h"
 #include "notify.h"
@@ -42,6 +43,7 @@ player_on_current_media_changed(vlc_player_t *player, input_item_t *new_media,
 
     /* the playlist and the player share the lock */
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
 
     input_item_t *media = playlist->current != -1
                         ? playlist->items.data[playlist->current]->media
@@ -205,6 +207,7 @@ vlc_playlist_SetMediaStoppedAction(vlc_playlist_t *playlist,
                                    enum vlc_playlist_media_stopped_action action)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
     playlist->stopped_action = action;
     vlc_playlist_UpdateNextMedia(playlist);
     vlc_playlist_Notify(playlist, on_media_stopped_action_changed, action);
@@ -30,6 +30,7 @@
 #include "content.h"
 #include "item.h"
 #include "player.h"
+#include "preparse.h"
 
 vlc_playlist_t *
 vlc_playlist_New(vlc_object_t *parent, enum vlc_playlist_preparsing rec,
@@ -77,6 +78,11 @@ vlc_playlist_New(vlc_object_t *parent, enum vlc_playlist_preparsing rec,
     playlist->repeat = VLC_PLAYLIST_PLAYBACK_REPEAT_NONE;
     playlist->order = VLC_PLAYLIST_PLAYBACK_ORDER_NORMAL;
     playlist->idgen = 0;
+    playlist->batch.depth = 0;
+    playlist->batch.count = 0;
+    vlc_vector_init(&playlist->preparse_queue);
+    playlist->preparse_queue_head = 0;
+    atomic_init(&playlist->preparse_inflight, 0);
 
     return playlist;
 }
@@ -85,11 +91,15 @@ void
 vlc_playlist_Delete(vlc_playlist_t *playlist)
 {
     assert(vlc_list_is_empty(&playlist->listeners));
+    assert(playlist->batch.depth == 0);
+
+    /* the requests canceled by the deletion of the preparser must not
+     * submit the queued items */
+    vlc_playlist_ClearPreparseQueue(playlist);
 
     if (playlist->parser != NULL) {
         vlc_preparser_Delete(playlist->parser);
     }
-
     vlc_playlist_PlayerDestroy(playlist);
     randomizer_Destroy(&playlist->randomizer);
     vlc_playlist_ClearItems(playlist);
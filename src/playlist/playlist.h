@@ -21,30 +21,75 @@
 #ifndef VLC_PLAYLIST_NEW_INTERNAL_H
 #define VLC_PLAYLIST_NEW_INTERNAL_H
 
+#include <stdatomic.h>
+
 #include <vlc_common.h>
 #include <vlc_playlist.h>
 #include <vlc_preparser.h>
 #include <vlc_vector.h>
 #include "../player/player.h"
+#include "notify.h"
 #include "randomizer.h"
 
 typedef struct input_item_t input_item_t;
 
 #ifdef TEST_PLAYLIST
-/* mock the player in tests */
-# define vlc_player_New(a,b) (VLC_UNUSED(a), malloc(sizeof (vlc_player_t)))
+/* mock the player in tests, only its lock is real */
+static inline vlc_player_t *
+vlc_player_test_New(void)
+{
+    vlc_player_t *player = malloc(sizeof (*player));
+    if (player)
+        vlc_mutex_init(&player->lock);
+    return player;
+}
+# define vlc_player_New(a,b) (VLC_UNUSED(a), vlc_player_test_New())
 # define vlc_player_Delete(p) free(p)
-# define vlc_player_Lock(p) VLC_UNUSED(p)
-# define vlc_player_Unlock(p) VLC_UNUSED(p)
+# define vlc_player_Lock(p) vlc_mutex_lock(&(p)->lock)
+# define vlc_player_Unlock(p) vlc_mutex_unlock(&(p)->lock)
 # define vlc_player_AddListener(a,b,c) (VLC_UNUSED(b), malloc(sizeof(vlc_player_listener_id)))
 # define vlc_player_RemoveListener(a,b) free(b)
 # define vlc_player_SetCurrentMedia(a,b) (VLC_UNUSED(b), VLC_SUCCESS)
 # define vlc_player_SetNextMedia(a,b) VLC_UNUSED(b)
 # define vlc_player_osd_Message(p, fmt...) VLC_UNUSED(p)
+
+/* mock the preparser in tests, implemented in test.c */
+vlc_preparser_req *
+vlc_playlist_test_PreparserPush(vlc_preparser_t *preparser, input_item_t *item,
+                                int options, const struct vlc_preparser_cbs *cbs,
+                                void *userdata);
+size_t
+vlc_playlist_test_PreparserCancel(vlc_preparser_t *preparser,
+                                  vlc_preparser_req *req);
+input_item_t *
+vlc_playlist_test_PreparserGetItem(vlc_preparser_req *req);
+void
+vlc_playlist_test_PreparserRelease(vlc_preparser_req *req);
+# define vlc_preparser_Push vlc_playlist_test_PreparserPush
+# define vlc_preparser_Cancel vlc_playlist_test_PreparserCancel
+# define vlc_preparser_req_GetItem vlc_playlist_test_PreparserGetItem
+# define vlc_preparser_req_Release vlc_playlist_test_PreparserRelease
+# define vlc_preparser_Delete(p) VLC_UNUSED(p)
 #endif /* TEST_PLAYLIST */
 
 typedef struct VLC_VECTOR(vlc_playlist_item_t *) playlist_item_vector_t;
 
+/* insertions not notified yet, see vlc_playlist_BeginBatch() */
+struct vlc_playlist_batch
+{
+    unsigned depth;
+    size_t index;
+    size_t count;
+    bool subitems;
+    struct vlc_playlist_state state; /**< state before the first insertion */
+};
+
+struct vlc_playlist_preparse_task
+{
+    vlc_playlist_item_t *item;
+    bool subitems;
+};
+
 struct vlc_playlist
 {
     vlc_player_t *player;
@@ -63,6 +108,12 @@ struct vlc_playlist
     enum vlc_playlist_playback_repeat repeat;
     enum vlc_playlist_playback_order order;
     uint64_t idgen;
+    struct vlc_playlist_batch batch;
+    /* items waiting to be submitted to the preparser */
+    struct VLC_VECTOR(struct vlc_playlist_preparse_task) preparse_queue;
+    size_t preparse_queue_head;
+    /* decremented without the lock on cancellation */
+    atomic_uint preparse_inflight;
 };
 
 /* Also disable vlc_assert_locked in tests since the symbol is not exported */
@@ -76,4 +127,11 @@ vlc_playlist_AssertLocked(vlc_playlist_t *playlist)
 #define vlc_playlist_AssertLocked(x) ((void) (0))
 #endif
 
+/* whether the calling thread holds the playlist lock */
+static inline bool
+vlc_playlist_IsLockHeld(vlc_playlist_t *playlist)
+{
+    return vlc_mutex_held(&playlist->player->lock);
+}
+
 #endif
@@ -24,13 +24,20 @@
 
 #include "preparse.h"
 
+#include <errno.h>
+
 #include "content.h"
 #include "item.h"
 #include "playlist.h"
 #include "notify.h"
+#include "sort.h"
 
 typedef struct VLC_VECTOR(input_item_t *) media_vector_t;
 
+/* maximum number of requests submitted to the preparser at once, so that
+ * adding a huge number of items does not flood its queue */
+#define PREPARSE_MAX_INFLIGHT 32
+
 static void
 vlc_playlist_CollectChildren(vlc_playlist_t *playlist,
                              media_vector_t *dest,
@@ -94,17 +101,38 @@ on_preparse_ended(vlc_preparser_req *req, int status, void *userdata)
     input_item_t *media = vlc_preparser_req_GetItem(req);
     vlc_playlist_t *playlist = userdata;
 
-    if (status != VLC_SUCCESS)
+    atomic_fetch_sub_explicit(&playlist->preparse_inflight, 1,
+                              memory_order_relaxed);
+
+    if (status == -EINTR)
     {
+        /* A queued request is canceled synchronously, by a playlist thread
+         * (locked) which submits the next queued items by itself. A running
+         * request is only interrupted, and ends later from the preparser
+         * thread: submit the next queued items now. */
+        if (!vlc_playlist_IsLockHeld(playlist))
+        {
+            vlc_playlist_Lock(playlist);
+            vlc_playlist_PreparseNext(playlist);
+            vlc_playlist_Unlock(playlist);
+        }
         vlc_preparser_req_Release(req);
         return;
     }
 
     vlc_playlist_Lock(playlist);
-    ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
-    if (index != -1)
-        vlc_playlist_Notify(playlist, on_items_updated, index,
-                            &playlist->items.data[index], 1);
+    if (status == VLC_SUCCESS)
+    {
+        vlc_playlist_FlushBatch(playlist);
+        ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
+        if (index != -1)
+        {
+            vlc_playlist_item_InvalidateSortKeys(playlist->items.data[index]);
+            vlc_playlist_Notify(playlist, on_items_updated, index,
+                                &playlist->items.data[index], 1);
+        }
+    }
+    vlc_playlist_PreparseNext(playlist);
     vlc_playlist_Unlock(playlist);
     vlc_preparser_req_Release(req);
 }
@@ -114,6 +142,91 @@ static const struct vlc_preparser_cbs preparser_callbacks = {
     .on_subtree_added = on_subtree_added,
 };
 
+void
+vlc_playlist_PreparseItems(vlc_playlist_t *playlist, size_t index, size_t count,
+                           bool parse_subitems)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    if (playlist->parser == NULL)
+        return;
+
+    if (!vlc_vector_reserve(&playlist->preparse_queue,
+                            playlist->preparse_queue.size + count))
+        return;
+
+    for (size_t i = index; i < index + count; ++i)
+    {
+        vlc_playlist_item_t *item = playlist->items.data[i];
+        vlc_playlist_item_Hold(item);
+        item->preparse_queued = true;
+
+        struct vlc_playlist_preparse_task task = { item, parse_subitems };
+        bool ok = vlc_vector_push(&playlist->preparse_queue, task);
+        assert(ok); /* reserved */
+        VLC_UNUSED(ok);
+    }
+
+    vlc_playlist_PreparseNext(playlist);
+}
+
+void
+vlc_playlist_PreparseNext(vlc_playlist_t *playlist)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    while (playlist->preparse_queue_head < playlist->preparse_queue.size
+        && atomic_load_explicit(&playlist->preparse_inflight,
+                                memory_order_relaxed) < PREPARSE_MAX_INFLIGHT)
+    {
+        struct vlc_playlist_preparse_task *task =
+            &playlist->preparse_queue.data[playlist->preparse_queue_head++];
+        vlc_playlist_item_t *item = task->item;
+
+        /* the item may have been removed meanwhile */
+        if (item->preparse_queued)
+        {
+            item->preparse_queued = false;
+            atomic_fetch_add_explicit(&playlist->preparse_inflight, 1,
+                                      memory_order_relaxed);
+            item->preparser_req = vlc_playlist_AutoPreparse(playlist,
+                                                            item->media,
+                                                            task->subitems);
+            if (!item->preparser_req)
+                atomic_fetch_sub_explicit(&playlist->preparse_inflight, 1,
+                                          memory_order_relaxed);
+        }
+        vlc_playlist_item_Release(item);
+    }
+
+    size_t head = playlist->preparse_queue_head;
+    if (head == playlist->preparse_queue.size)
+    {
+        vlc_vector_clear(&playlist->preparse_queue);
+        playlist->preparse_queue_head = 0;
+    }
+    else if (head > 1024 && head > playlist->preparse_queue.size / 2)
+    {
+        /* drop the consumed tasks (amortized) */
+        vlc_vector_remove_slice(&playlist->preparse_queue, 0, head);
+        playlist->preparse_queue_head = 0;
+    }
+}
+
+void
+vlc_playlist_ClearPreparseQueue(vlc_playlist_t *playlist)
+{
+    for (size_t i = playlist->preparse_queue_head;
+         i < playlist->preparse_queue.size; ++i)
+    {
+        vlc_playlist_item_t *item = playlist->preparse_queue.data[i].item;
+        item->preparse_queued = false;
+        vlc_playlist_item_Release(item);
+    }
+    vlc_vector_clear(&playlist->preparse_queue);
+    playlist->preparse_queue_head = 0;
+}
+
 vlc_preparser_req *
 vlc_playlist_AutoPreparse(vlc_playlist_t *playlist, input_item_t *input,
                           bool parse_subitems)
@@ -31,6 +31,18 @@ vlc_preparser_req *
 vlc_playlist_AutoPreparse(vlc_playlist_t *playlist, input_item_t *input,
                           bool parse_subitems);
 
+/* queue the items for preparsing, submitted progressively */
+void
+vlc_playlist_PreparseItems(vlc_playlist_t *playlist, size_t index, size_t count,
+                           bool parse_subitems);
+
+/* submit queued items, up to the limit of running requests */
+void
+vlc_playlist_PreparseNext(vlc_playlist_t *playlist);
+
+void
+vlc_playlist_ClearPreparseQueue(vlc_playlist_t *playlist);
+
 int
 vlc_playlist_ExpandItem(vlc_playlist_t *playlist, size_t index,
                         const input_item_node_t *node);
@@ -24,6 +24,7 @@
 
 #include <vlc_common.h>
 #include <vlc_rand.h>
+#include "content.h"
 #include "control.h"
 #include "item.h"
 #include "notify.h"
@@ -33,6 +34,7 @@ void
 vlc_playlist_Shuffle(vlc_playlist_t *playlist)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
     if (playlist->items.size < 2)
         /* we use size_t (unsigned), so the following loop would be incorrect */
         return;
@@ -26,22 +26,35 @@
 #include <vlc_rand.h>
 #include <vlc_sort.h>
 #include <vlc_strings.h>
+#include "content.h"
 #include "control.h"
 #include "item.h"
 #include "notify.h"
 #include "playlist.h"
+#include "sort.h"
 
 /**
  * Struct containing a copy of (parsed) media metadata, used for sorting
  * without locking all the items.
+ *
+ * It is cached in the playlist item (only accessed with the playlist locked),
+ * and each field is initialized on first use. The cache is invalidated when
+ * the preparser updates the media, and when the player updates it while it is
+ * the current item or while the playlist has on_items_updated() listeners.
+ *
+ * Metadata changed through other paths (input_item_SetMeta() called directly
+ * on a media of the playlist, or the player updating a media which is not the
+ * current item without listeners) is not detected: the item keeps its former
+ * sort keys until it is removed from the playlist.
  */
 struct vlc_playlist_item_meta {
-    vlc_playlist_item_t *item;
-    size_t index;
+    unsigned loaded; /**< bitmask of the initialized keys */
     const char *title_or_name;
+    char *title_or_name_key; /**< collation key, from strxfrm() */
     vlc_tick_t duration;
     const char *artist;
     const char *album;
+    char *album_key; /**< collation key, from strxfrm() */
     const char *album_artist;
     const char *genre;
     const char *url;
@@ -57,6 +70,22 @@ struct vlc_playlist_item_meta {
     int64_t file_modified;
 };
 
+/**
+ * Sorting entry, one per playlist item.
+ */
+struct sort_entry {
+    vlc_playlist_item_t *item;
+    const struct vlc_playlist_item_meta *meta;
+    size_t index;
+};
+
+/* minimal number of items to sort in several threads */
+#define PARALLEL_SORT_MIN_ITEMS 8192
+#define PARALLEL_SORT_MAX_THREADS 8
+
+/* beyond this number of moves, listeners are notified by a reset */
+#define SORT_MAX_MOVES 32
+
 static int
 vlc_playlist_item_meta_CopyString(const char **to, const char *from)
 {
@@ -71,6 +100,25 @@ vlc_playlist_item_meta_CopyString(const char **to, const char *from)
     return VLC_SUCCESS;
 }
 
+static int
+vlc_playlist_item_meta_CopyCollatedString(const char **to, char **key,
+                                          const char *from)
+{
+    *key = NULL;
+    int ret = vlc_playlist_item_meta_CopyString(to, from);
+    if (ret != VLC_SUCCESS || !from)
+        return ret;
+
+    /* precompute the collation key, so that comparisons are a mere strcmp()
+     * instead of a strcoll() */
+    size_t size = strxfrm(NULL, from, 0) + 1;
+    *key = malloc(size);
+    if (unlikely(!*key))
+        return VLC_ENOMEM;
+    strxfrm(*key, from, size);
+    return VLC_SUCCESS;
+}
+
 static int
 vlc_playlist_item_meta_GetNumber(const char * str, int64_t * to)
 {
@@ -96,9 +144,9 @@ vlc_playlist_item_meta_GetNumber(const char * str, int64_t * to)
 
 static int
 vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
+                                 input_item_t *media,
                                  enum vlc_playlist_sort_key key)
 {
-    input_item_t *media = meta->item->media;
     switch (key)
     {
         case VLC_PLAYLIST_SORT_KEY_TITLE:
@@ -106,8 +154,8 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Title);
             if (EMPTY_STR(value))
                 value = media->psz_name;
-            return vlc_playlist_item_meta_CopyString(&meta->title_or_name,
-                                                     value);
+            return vlc_playlist_item_meta_CopyCollatedString(
+                    &meta->title_or_name, &meta->title_or_name_key, value);
         }
         case VLC_PLAYLIST_SORT_KEY_DURATION:
         {
@@ -127,7 +175,9 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
         case VLC_PLAYLIST_SORT_KEY_ALBUM:
         {
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Album);
-            return vlc_playlist_item_meta_CopyString(&meta->album, value);
+            return vlc_playlist_item_meta_CopyCollatedString(&meta->album,
+                                                             &meta->album_key,
+                                                             value);
         }
         case VLC_PLAYLIST_SORT_KEY_ALBUM_ARTIST:
         {
@@ -213,66 +263,76 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
 }
 
 static void
-vlc_playlist_item_meta_DestroyFields(struct vlc_playlist_item_meta *meta)
+vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta)
 {
     free((void *) meta->title_or_name);
+    free(meta->title_or_name_key);
     free((void *) meta->artist);
     free((void *) meta->album);
+    free(meta->album_key);
     free((void *) meta->album_artist);
     free((void *) meta->genre);
     free((void *) meta->url);
+    free(meta);
 }
 
-static int
-vlc_playlist_item_meta_InitFields(struct vlc_playlist_item_meta *meta,
-        const struct vlc_playlist_sort_criterion criteria[], size_t count)
+void
+vlc_playlist_item_InvalidateSortKeys(vlc_playlist_item_t *item)
 {
-    for (size_t i = 0; i < count; ++i)
+    if (item->sort_meta)
     {
-        const struct vlc_playlist_sort_criterion *criterion = &criteria[i];
-        int ret = vlc_playlist_item_meta_InitField(meta, criterion->key);
-        if (unlikely(ret != VLC_SUCCESS))
-        {
-            vlc_playlist_item_meta_DestroyFields(meta);
-            return ret;
-        }
+        vlc_playlist_item_meta_Delete(item->sort_meta);
+        item->sort_meta = NULL;
     }
-    return VLC_SUCCESS;
 }
 
-static struct vlc_playlist_item_meta *
-vlc_playlist_item_meta_New(size_t index, vlc_playlist_item_t *item,
-                           const struct vlc_playlist_sort_criterion criteria[],
-                           size_t count)
+static const struct vlc_playlist_item_meta *
+vlc_playlist_item_GetSortKeys(vlc_playlist_item_t *item,
+                              const struct vlc_playlist_sort_criterion criteria[],
+                              size_t count)
 {
-    /* assume that NULL representation is all-zeros */
-    struct vlc_playlist_item_meta *meta = calloc(1, sizeof(*meta));
-    if (unlikely(!meta))
-        return NULL;
+    struct vlc_playlist_item_meta *meta = item->sort_meta;
+    if (!meta)
+    {
+        /* assume that NULL representation is all-zeros */
+        meta = calloc(1, sizeof(*meta));
+        if (unlikely(!meta))
+            return NULL;
+        item->sort_meta = meta;
+    }
 
-    meta->item = item;
-    meta->index = index;
+    int ret = VLC_SUCCESS;
+    bool locked = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        enum vlc_playlist_sort_key key = criteria[i].key;
+        if (meta->loaded & (1u << key))
+            continue;
 
-    vlc_mutex_lock(&item->media->lock);
-    int ret = vlc_playlist_item_meta_InitFields(meta, criteria, count);
-    vlc_mutex_unlock(&item->media->lock);
+        if (!locked)
+        {
+            vlc_mutex_lock(&item->media->lock);
+            locked = true;
+        }
+
+        ret = vlc_playlist_item_meta_InitField(meta, item->media, key);
+        if (ret != VLC_SUCCESS)
+            break;
+        meta->loaded |= 1u << key;
+    }
+    if (locked)
+        vlc_mutex_unlock(&item->media->lock);
 
-    if (unlikely(ret != VLC_SUCCESS))
+    if (ret != VLC_SUCCESS)
     {
-        free(meta);
+        /* the partially initialized field may not be consistent */
+        vlc_playlist_item_InvalidateSortKeys(item);
         return NULL;
     }
 
     return meta;
 }
 
-static void
-vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta)
-{
-    vlc_playlist_item_meta_DestroyFields(meta);
-    free(meta);
-}
-
 static inline int
 CompareStrings(const char *a, const char *b)
 {
@@ -284,13 +344,23 @@ CompareStrings(const char *a, const char *b)
 }
 
 static inline int
-CompareFilenameStrings(const char *a, const char *b)
+CompareFilenameStrings(const char *a, const char *akey,
+                       const char *b, const char *bkey)
 {
-    if (a && b)
+    if (!a || !b)
+        return a ? 1 : b ? -1 : 0;
+
+    /* same as vlc_filenamecmp(), using the precomputed collation keys */
+    size_t i;
+    for (i = 0; a[i] == b[i]; ++i)
+        if (a[i] == '\0')
+            return 0;
+
+    if ((unsigned)(a[i] - '0') <= 9 && (unsigned)(b[i] - '0') <= 9)
+        /* numerical comparison */
         return vlc_filenamecmp(a, b);
-    if (!a && !b)
-        return 0;
-    return a ? 1 : -1;
+
+    return strcmp(akey, bkey);
 }
 
 static inline int
@@ -333,13 +403,17 @@ CompareMetaByKey(const struct vlc_playlist_item_meta *a,
     switch (key)
     {
         case VLC_PLAYLIST_SORT_KEY_TITLE:
-            return CompareFilenameStrings(a->title_or_name, b->title_or_name);
+            return CompareFilenameStrings(a->title_or_name,
+                                          a->title_or_name_key,
+                                          b->title_or_name,
+                                          b->title_or_name_key);
         case VLC_PLAYLIST_SORT_KEY_DURATION:
             return CompareIntegers(a->duration, b->duration);
         case VLC_PLAYLIST_SORT_KEY_ARTIST:
             return CompareStrings(a->artist, b->artist);
         case VLC_PLAYLIST_SORT_KEY_ALBUM:
-            return CompareFilenameStrings(a->album, b->album);
+            return CompareFilenameStrings(a->album, a->album_key,
+                                          b->album, b->album_key);
         case VLC_PLAYLIST_SORT_KEY_ALBUM_ARTIST:
             return CompareStrings(a->album_artist, b->album_artist);
         case VLC_PLAYLIST_SORT_KEY_GENRE:
@@ -376,18 +450,16 @@ struct sort_request
 };
 
 static int
-compare_meta(const void *lhs, const void *rhs, void *userdata)
+compare_entries(const void *lhs, const void *rhs, void *userdata)
 {
-    struct sort_request *req = userdata;
-    const struct vlc_playlist_item_meta *a =
-            *(const struct vlc_playlist_item_meta **) lhs;
-    const struct vlc_playlist_item_meta *b =
-            *(const struct vlc_playlist_item_meta **) rhs;
+    const struct sort_request *req = userdata;
+    const struct sort_entry *a = lhs;
+    const struct sort_entry *b = rhs;
 
     for (size_t i = 0; i < req->count; ++i)
     {
         const struct vlc_playlist_sort_criterion *criterion = &req->criteria[i];
-        int ret = CompareMetaByKey(a, b, criterion->key);
+        int ret = CompareMetaByKey(a->meta, b->meta, criterion->key);
         if (ret)
         {
             if (criterion->order == VLC_PLAYLIST_SORT_ORDER_DESCENDING)
@@ -403,70 +475,183 @@ compare_meta(const void *lhs, const void *rhs, void *userdata)
     return a->index < b->index ? -1 : 1;
 }
 
+struct sort_task
+{
+    vlc_thread_t thread;
+    struct sort_entry *array;
+    size_t count;
+    const struct sort_request *req;
+};
+
+static void *
+SortThread(void *userdata)
+{
+    struct sort_task *task = userdata;
+    vlc_thread_set_name("vlc-pl-sort");
+
+    vlc_qsort(task->array, task->count, sizeof(*task->array), compare_entries,
+              (void *) task->req);
+    return NULL;
+}
+
 static void
-vlc_playlist_DeleteMetaArray(struct vlc_playlist_item_meta *array[],
-                             size_t count)
+MergeRuns(const struct sort_entry *src, size_t begin, size_t mid, size_t end,
+          struct sort_entry *dest, const struct sort_request *req)
 {
-    for (size_t i = 0; i < count; ++i)
-        vlc_playlist_item_meta_Delete(array[i]);
-    free(array);
+    size_t i = begin;
+    size_t j = mid;
+    size_t k = begin;
+    while (i < mid && j < end)
+    {
+        if (compare_entries(&src[i], &src[j], (void *) req) < 0)
+            dest[k++] = src[i++];
+        else
+            dest[k++] = src[j++];
+    }
+    memcpy(&dest[k], &src[i], (mid - i) * sizeof(*src));
+    k += mid - i;
+    memcpy(&dest[k], &src[j], (end - j) * sizeof(*src));
 }
 
-static struct vlc_playlist_item_meta **
-vlc_playlist_NewMetaArray(vlc_playlist_t *playlist,
-        const struct vlc_playlist_sort_criterion criteria[], size_t count)
+static void
+SortEntries(struct sort_entry *array, size_t count,
+            const struct sort_request *req)
 {
-    struct vlc_playlist_item_meta **array =
-            vlc_alloc(playlist->items.size, sizeof(*array));
+    unsigned nthreads = vlc_GetCPUCount();
+    if (nthreads > PARALLEL_SORT_MAX_THREADS)
+        nthreads = PARALLEL_SORT_MAX_THREADS;
 
-    if (unlikely(!array))
-        return NULL;
+    struct sort_entry *tmp = NULL;
+    if (count >= PARALLEL_SORT_MIN_ITEMS && nthreads > 1)
+        tmp = vlc_alloc(count, sizeof(*tmp));
 
-    size_t i;
-    for (i = 0; i < playlist->items.size; ++i)
+    if (!tmp)
     {
-        array[i] = vlc_playlist_item_meta_New(i, playlist->items.data[i],
-                                              criteria, count);
-        if (unlikely(!array[i]))
-            break;
+        vlc_qsort(array, count, sizeof(*array), compare_entries, (void *) req);
+        return;
     }
 
-    if (i < playlist->items.size)
+    /* sort one chunk per thread, then merge the sorted runs */
+    struct sort_task tasks[PARALLEL_SORT_MAX_THREADS];
+    size_t bounds[PARALLEL_SORT_MAX_THREADS + 1];
+    bool joinable[PARALLEL_SORT_MAX_THREADS];
+    for (unsigned i = 0; i <= nthreads; ++i)
+        bounds[i] = count * i / nthreads;
+
+    for (unsigned i = 0; i < nthreads; ++i)
     {
-        /* allocation failure */
-        vlc_playlist_DeleteMetaArray(array, i);
-        return NULL;
+        struct sort_task *task = &tasks[i];
+        task->array = &array[bounds[i]];
+        task->count = bounds[i + 1] - bounds[i];
+        task->req = req;
+        /* the last chunk is sorted by the calling thread */
+        joinable[i] = i + 1 < nthreads
+                   && vlc_clone(&task->thread, SortThread, task) == 0;
+        if (!joinable[i])
+            vlc_qsort(task->array, task->count, sizeof(*task->array),
+                      compare_entries, (void *) req);
     }
 
-    return array;
+    for (unsigned i = 0; i < nthreads; ++i)
+        if (joinable[i])
+            vlc_join(tasks[i].thread, NULL);
+
+    struct sort_entry *src = array;
+    struct sort_entry *dest = tmp;
+    unsigned runs = nthreads;
+    while (runs > 1)
+    {
+        unsigned merged = 0;
+        for (unsigned i = 0; i < runs; i += 2)
+        {
+            if (i + 1 < runs)
+                MergeRuns(src, bounds[i], bounds[i + 1], bounds[i + 2], dest,
+                          req);
+            else
+                memcpy(&dest[bounds[i]], &src[bounds[i]],
+                       (bounds[i + 1] - bounds[i]) * sizeof(*src));
+            bounds[merged++] = bounds[i];
+        }
+        bounds[merged] = count;
+        runs = merged;
+
+        struct sort_entry *swap = src;
+        src = dest;
+        dest = swap;
+    }
+
+    if (src != array)
+        memcpy(array, src, count * sizeof(*array));
+    free(tmp);
 }
 
-int
-vlc_playlist_Sort(vlc_playlist_t *playlist,
-                  const struct vlc_playlist_sort_criterion criteria[],
-                  size_t count)
+struct sort_move
 {
-    assert(count > 0);
-    vlc_playlist_AssertLocked(playlist);
+    size_t index;
+    size_t count;
+    size_t target;
+};
 
-    vlc_playlist_item_t *current = playlist->current != -1
-                                 ? playlist->items.data[playlist->current]
-                                 : NULL;
+/**
+ * Compute the list of slice moves to apply to the playlist to reach the
+ * sorted order.
+ *
+ * \return the number of moves, or SIZE_MAX if there are too many
+ */
+static size_t
+ComputeMoves(const struct sort_entry *array, size_t count,
+             struct sort_move moves[static SORT_MAX_MOVES])
+{
+    /* initial indices of the items, in their current order */
+    struct VLC_VECTOR(size_t) current = VLC_VECTOR_INITIALIZER;
+    if (unlikely(!vlc_vector_reserve(&current, count)))
+        return SIZE_MAX;
+    for (size_t i = 0; i < count; ++i)
+        current.data[i] = i;
+    current.size = count;
 
-    struct vlc_playlist_item_meta **array =
-        vlc_playlist_NewMetaArray(playlist, criteria, count);
-    if (unlikely(!array))
-        return VLC_ENOMEM;
+    size_t nmoves = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (current.data[i] == array[i].index)
+            continue;
 
-    struct sort_request req = { criteria, count };
+        if (nmoves == SORT_MAX_MOVES)
+        {
+            nmoves = SIZE_MAX;
+            break;
+        }
+
+        /* the expected item is necessarily after */
+        size_t j = i + 1;
+        while (current.data[j] != array[i].index)
+            ++j;
+
+        /* move the longest slice already in the expected order */
+        size_t len = 1;
+        while (j + len < count && current.data[j + len] == array[i + len].index)
+            ++len;
+
+        vlc_vector_move_slice(&current, j, len, i);
+        moves[nmoves++] = (struct sort_move) { j, len, i };
+        i += len - 1;
+    }
+
+    vlc_vector_destroy(&current);
+    return nmoves;
+}
 
-    vlc_qsort(array, playlist->items.size, sizeof(*array), compare_meta, &req);
+static void
+vlc_playlist_ApplySortReset(vlc_playlist_t *playlist,
+                            const struct sort_entry *array)
+{
+    vlc_playlist_item_t *current = playlist->current != -1
+                                 ? playlist->items.data[playlist->current]
+                                 : NULL;
 
     /* apply the sorting result to the playlist */
     for (size_t i = 0; i < playlist->items.size; ++i)
-        playlist->items.data[i] = array[i]->item;
-
-    vlc_playlist_DeleteMetaArray(array, playlist->items.size);
+        playlist->items.data[i] = array[i].item;
 
     struct vlc_playlist_state state;
     if (current)
@@ -482,6 +667,62 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
                         playlist->items.size);
     if (current)
         vlc_playlist_state_NotifyChanges(playlist, &state);
+}
+
+int
+vlc_playlist_Sort(vlc_playlist_t *playlist,
+                  const struct vlc_playlist_sort_criterion criteria[],
+                  size_t count)
+{
+    assert(count > 0);
+    vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_FlushBatch(playlist);
+
+    size_t size = playlist->items.size;
+    if (size < 2)
+        return VLC_SUCCESS;
+
+    struct sort_entry *array = vlc_alloc(size, sizeof(*array));
+    if (unlikely(!array))
+        return VLC_ENOMEM;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        vlc_playlist_item_t *item = playlist->items.data[i];
+        const struct vlc_playlist_item_meta *meta =
+            vlc_playlist_item_GetSortKeys(item, criteria, count);
+        if (unlikely(!meta))
+        {
+            free(array);
+            return VLC_EGENERIC;
+        }
+        array[i] = (struct sort_entry) { item, meta, i };
+    }
+
+    struct sort_request req = { criteria, count };
+    SortEntries(array, size, &req);
+
+    struct sort_move moves[SORT_MAX_MOVES];
+    size_t nmoves = ComputeMoves(array, size, moves);
+    if (nmoves == SIZE_MAX)
+        vlc_playlist_ApplySortReset(playlist, array);
+    else
+    {
+        /* few items moved, do not force the listeners to reload everything */
+        for (size_t i = 0; i < nmoves; ++i)
+        {
+            const struct sort_move *move = &moves[i];
+            vlc_vector_move_slice(&playlist->items, move->index, move->count,
+                                  move->target);
+            vlc_playlist_ItemsMoved(playlist, move->index, move->count,
+                                    move->target);
+        }
+    }
+
+    free(array);
+
+    if (nmoves != 0)
+        vlc_playlist_UpdateNextMedia(playlist);
 
     return VLC_SUCCESS;
 }
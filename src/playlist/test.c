@@ -24,8 +24,11 @@
 # include "config.h"
 #endif
 
+#include <errno.h>
 #include <stdio.h>
+#include "content.h"
 #include "item.h"
+#include "notify.h"
 #include "playlist.h"
 #include "preparse.h"
 
@@ -2269,6 +2272,7 @@ test_sort(void)
 
     struct vlc_playlist_callbacks cbs = {
         .on_items_reset = callback_on_items_reset,
+        .on_items_moved = callback_on_items_moved,
         .on_current_index_changed = callback_on_current_index_changed,
         .on_has_prev_changed = callback_on_has_prev_changed,
         .on_has_next_changed = callback_on_has_next_changed,
@@ -2304,15 +2308,20 @@ test_sort(void)
     assert(index == 7);
     assert(playlist->current == 7);
 
-    assert(ctx.vec_items_reset.size == 1);
-    assert(ctx.vec_items_reset.data[0].count == 10);
-    assert(ctx.vec_items_reset.data[0].state.playlist_size == 10);
-    assert(ctx.vec_items_reset.data[0].state.current == 7);
-    assert(ctx.vec_items_reset.data[0].state.has_prev);
-    assert(ctx.vec_items_reset.data[0].state.has_next);
+    /* only a few items moved, the listeners receive moves */
+    assert(ctx.vec_items_reset.size == 0);
+    assert(ctx.vec_items_moved.size == 8);
 
-    assert(ctx.vec_current_index_changed.size == 1);
-    assert(ctx.vec_current_index_changed.data[0].current == 7);
+    struct items_moved_report *last_move =
+        &ctx.vec_items_moved.data[ctx.vec_items_moved.size - 1];
+    assert(last_move->state.playlist_size == 10);
+    assert(last_move->state.current == 7);
+    assert(last_move->state.has_prev);
+    assert(last_move->state.has_next);
+
+    assert(ctx.vec_current_index_changed.size > 0);
+    assert(ctx.vec_current_index_changed.data[
+                ctx.vec_current_index_changed.size - 1].current == 7);
 
     assert(ctx.vec_has_prev_changed.size == 1);
     assert(ctx.vec_has_prev_changed.data[0].has_prev);
@@ -2339,9 +2348,8 @@ test_sort(void)
     EXPECT_AT(8, 1);
     EXPECT_AT(9, 3);
 
-    assert(ctx.vec_items_reset.size == 1);
-    assert(ctx.vec_items_reset.data[0].count == 10);
-    assert(ctx.vec_items_reset.data[0].state.playlist_size == 10);
+    assert(ctx.vec_items_reset.size == 0);
+    assert(ctx.vec_items_moved.size > 0);
 
     callback_ctx_destroy(&ctx);
     vlc_playlist_RemoveListener(playlist, listener);
@@ -2423,6 +2431,693 @@ test_stable_sort(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_sort_reset(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[100];
+    CreateDummyMediaArray(media, 100);
+
+    int ret = vlc_playlist_Append(playlist, media, 100);
+    assert(ret == VLC_SUCCESS);
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_reset = callback_on_items_reset,
+        .on_items_moved = callback_on_items_moved,
+    };
+
+    struct callback_ctx ctx = CALLBACK_CTX_INITIALIZER;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &ctx, false);
+    assert(listener);
+
+    struct vlc_playlist_sort_criterion criterion =
+        { VLC_PLAYLIST_SORT_KEY_TITLE, VLC_PLAYLIST_SORT_ORDER_DESCENDING };
+
+    /* reversing the playlist would require too many moves */
+    ret = vlc_playlist_Sort(playlist, &criterion, 1);
+    assert(ret == VLC_SUCCESS);
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_AT(i, 99 - i);
+
+    assert(ctx.vec_items_reset.size == 1);
+    assert(ctx.vec_items_reset.data[0].count == 100);
+    assert(ctx.vec_items_moved.size == 0);
+
+    callback_ctx_reset(&ctx);
+
+    /* move a single item, sorting again must move it back */
+    vlc_playlist_Move(playlist, 10, 1, 50);
+    callback_ctx_reset(&ctx);
+
+    ret = vlc_playlist_Sort(playlist, &criterion, 1);
+    assert(ret == VLC_SUCCESS);
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_AT(i, 99 - i);
+
+    assert(ctx.vec_items_reset.size == 0);
+    assert(ctx.vec_items_moved.size == 1);
+
+    callback_ctx_destroy(&ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 100);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+callback_on_items_updated_count(vlc_playlist_t *playlist, size_t index,
+                                vlc_playlist_item_t *const items[],
+                                size_t count, void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(index); VLC_UNUSED(items);
+    unsigned *updated = userdata;
+    *updated += count;
+}
+
+static void
+test_sort_keys_updated(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[5];
+    CreateDummyMediaArray(media, 5);
+
+    int ret = vlc_playlist_Append(playlist, media, 5);
+    assert(ret == VLC_SUCCESS);
+
+    struct vlc_playlist_sort_criterion criterion =
+        { VLC_PLAYLIST_SORT_KEY_TITLE, VLC_PLAYLIST_SORT_ORDER_ASCENDING };
+
+    ret = vlc_playlist_Sort(playlist, &criterion, 1);
+    assert(ret == VLC_SUCCESS);
+    EXPECT_AT(0, 0);
+
+    /* without listeners, the cached sort keys of the current item must be
+     * refreshed */
+    ret = vlc_playlist_GoTo(playlist, 0);
+    assert(ret == VLC_SUCCESS);
+
+    input_item_SetTitle(media[0], "z");
+    vlc_playlist_NotifyMediaUpdated(playlist, media[0]);
+
+    ret = vlc_playlist_Sort(playlist, &criterion, 1);
+    assert(ret == VLC_SUCCESS);
+
+    EXPECT_AT(0, 1);
+    EXPECT_AT(1, 2);
+    EXPECT_AT(2, 3);
+    EXPECT_AT(3, 4);
+    EXPECT_AT(4, 0);
+
+    /* with listeners, the cached sort keys of any item must be refreshed */
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_updated = callback_on_items_updated_count,
+    };
+
+    unsigned updated = 0;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &updated, false);
+    assert(listener);
+
+    input_item_SetTitle(media[1], "y");
+    vlc_playlist_NotifyMediaUpdated(playlist, media[1]);
+    assert(updated == 1);
+
+    ret = vlc_playlist_Sort(playlist, &criterion, 1);
+    assert(ret == VLC_SUCCESS);
+
+    EXPECT_AT(0, 2);
+    EXPECT_AT(1, 3);
+    EXPECT_AT(2, 4);
+    EXPECT_AT(3, 1);
+    EXPECT_AT(4, 0);
+
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 5);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+test_parallel_sort(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    /* enough items to be sorted by several threads */
+    input_item_t **media = vlc_alloc(20000, sizeof(*media));
+    assert(media);
+    CreateDummyMediaArray(media, 20000);
+    for (int i = 0; i < 20000; ++i)
+        media[i]->i_duration = i;
+
+    int ret = vlc_playlist_Append(playlist, media, 20000);
+    assert(ret == VLC_SUCCESS);
+
+    vlc_playlist_Shuffle(playlist);
+
+    struct vlc_playlist_sort_criterion criterion =
+        { VLC_PLAYLIST_SORT_KEY_DURATION, VLC_PLAYLIST_SORT_ORDER_ASCENDING };
+
+    ret = vlc_playlist_Sort(playlist, &criterion, 1);
+    assert(ret == VLC_SUCCESS);
+
+    for (int i = 0; i < 20000; ++i)
+        EXPECT_AT(i, i);
+
+    DestroyMediaArray(media, 20000);
+    free(media);
+    vlc_playlist_Delete(playlist);
+}
+
+static bool
+filter_long_media(vlc_playlist_item_t *item, void *userdata)
+{
+    vlc_tick_t *min_duration = userdata;
+    return vlc_playlist_item_GetMedia(item)->i_duration >= *min_duration;
+}
+
+static void
+test_view(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[10];
+    CreateDummyMediaArray(media, 10);
+    for (int i = 0; i < 10; ++i)
+        media[i]->i_duration = i % 2 ? 100 : 10;
+
+    int ret = vlc_playlist_Append(playlist, media, 10);
+    assert(ret == VLC_SUCCESS);
+
+    vlc_tick_t min_duration = 50;
+    struct vlc_playlist_view *view =
+        vlc_playlist_view_New(playlist, filter_long_media, &min_duration);
+    assert(view);
+
+    struct vlc_playlist_view *all = vlc_playlist_view_New(playlist, NULL, NULL);
+    assert(all);
+
+    assert(vlc_playlist_view_Count(view) == 5);
+    for (size_t i = 0; i < 5; ++i)
+    {
+        assert(vlc_playlist_view_GetPlaylistIndex(view, i) == 2 * i + 1);
+        assert(vlc_playlist_view_Get(view, i)->media == media[2 * i + 1]);
+    }
+
+    assert(vlc_playlist_view_Count(all) == 10);
+    assert(vlc_playlist_view_Get(all, 3)->media == media[3]);
+
+    /* the view follows the playlist changes */
+    vlc_playlist_RemoveOne(playlist, 1);
+    vlc_playlist_Move(playlist, 8, 1, 0);
+
+    assert(vlc_playlist_view_Count(view) == 4);
+    assert(vlc_playlist_view_Get(view, 0)->media == media[9]);
+    assert(vlc_playlist_view_Get(view, 1)->media == media[3]);
+    assert(vlc_playlist_view_GetPlaylistIndex(view, 1) == 3);
+
+    assert(vlc_playlist_view_Count(all) == 9);
+
+    vlc_playlist_view_Delete(all);
+    vlc_playlist_view_Delete(view);
+    DestroyMediaArray(media, 10);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+test_batch(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[10];
+    CreateDummyMediaArray(media, 10);
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_added = callback_on_items_added,
+        .on_items_removed = callback_on_items_removed,
+        .on_current_index_changed = callback_on_current_index_changed,
+        .on_has_next_changed = callback_on_has_next_changed,
+    };
+
+    struct callback_ctx ctx = CALLBACK_CTX_INITIALIZER;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &ctx, false);
+    assert(listener);
+
+    int ret = vlc_playlist_AppendOne(playlist, media[0]);
+    assert(ret == VLC_SUCCESS);
+    playlist->current = 0;
+    playlist->has_prev = false;
+    playlist->has_next = false;
+    callback_ctx_reset(&ctx);
+
+    vlc_playlist_SetPlaybackOrder(playlist, VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM);
+
+    vlc_playlist_BeginBatch(playlist);
+    /* nested batch */
+    vlc_playlist_BeginBatch(playlist);
+    for (int i = 2; i < 6; ++i)
+    {
+        ret = vlc_playlist_AppendOne(playlist, media[i]);
+        assert(ret == VLC_SUCCESS);
+    }
+    vlc_playlist_CommitBatch(playlist);
+    /* insert before the pending range, contiguous to the current item */
+    ret = vlc_playlist_InsertOne(playlist, 1, media[1]);
+    assert(ret == VLC_SUCCESS);
+
+    /* not notified yet */
+    assert(vlc_playlist_Count(playlist) == 6);
+    assert(ctx.vec_items_added.size == 0);
+
+    vlc_playlist_CommitBatch(playlist);
+
+    assert(ctx.vec_items_added.size == 1);
+    assert(ctx.vec_items_added.data[0].index == 1);
+    assert(ctx.vec_items_added.data[0].count == 5);
+    assert(ctx.vec_items_added.data[0].state.playlist_size == 6);
+    assert(ctx.vec_items_added.data[0].state.current == 0);
+    assert(ctx.vec_items_added.data[0].state.has_next);
+
+    assert(ctx.vec_has_next_changed.size == 1);
+    assert(ctx.vec_has_next_changed.data[0].has_next);
+
+    for (int i = 0; i < 6; ++i)
+        EXPECT_AT(i, i);
+
+    /* the randomizer received the inserted items (the current item was not
+     * selected through the randomizer, so it is also part of the cycle) */
+    for (int i = 0; i < 6; ++i)
+    {
+        ret = vlc_playlist_Next(playlist);
+        assert(ret == VLC_SUCCESS);
+    }
+    assert(!vlc_playlist_HasNext(playlist));
+
+    callback_ctx_reset(&ctx);
+
+    /* another modification flushes the pending insertions */
+    vlc_playlist_BeginBatch(playlist);
+    ret = vlc_playlist_Append(playlist, &media[6], 4);
+    assert(ret == VLC_SUCCESS);
+    vlc_playlist_RemoveOne(playlist, 0);
+
+    assert(ctx.vec_items_added.size == 1);
+    assert(ctx.vec_items_added.data[0].index == 6);
+    assert(ctx.vec_items_added.data[0].count == 4);
+    assert(ctx.vec_items_added.data[0].state.playlist_size == 10);
+
+    assert(ctx.vec_items_removed.size == 1);
+    assert(ctx.vec_items_removed.data[0].index == 0);
+    assert(ctx.vec_items_removed.data[0].state.playlist_size == 9);
+
+    vlc_playlist_CommitBatch(playlist);
+    assert(ctx.vec_items_added.size == 1);
+
+    callback_ctx_destroy(&ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 10);
+    vlc_playlist_Delete(playlist);
+}
+
+struct batch_replace_ctx
+{
+    struct callback_ctx ctx; /* must be the first member */
+    size_t updated;
+};
+
+static void
+callback_on_items_updated_known(vlc_playlist_t *playlist, size_t index,
+                                vlc_playlist_item_t *const items[],
+                                size_t count, void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(items);
+    struct batch_replace_ctx *bctx = userdata;
+    struct callback_ctx *ctx = &bctx->ctx;
+
+    /* the listener must already know the updated items */
+    assert(ctx->vec_items_added.size > 0);
+    size_t known = ctx->vec_items_added.data[ctx->vec_items_added.size - 1]
+                                      .state.playlist_size;
+    assert(index + count <= known);
+    bctx->updated++;
+}
+
+static void
+test_batch_replace(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[6];
+    CreateDummyMediaArray(media, 6);
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_added = callback_on_items_added,
+        .on_items_updated = callback_on_items_updated_known,
+        .on_has_prev_changed = callback_on_has_prev_changed,
+        .on_has_next_changed = callback_on_has_next_changed,
+    };
+
+    struct batch_replace_ctx bctx = {
+        .ctx = CALLBACK_CTX_INITIALIZER,
+        .updated = 0,
+    };
+    struct callback_ctx *ctx = &bctx.ctx;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &bctx, false);
+    assert(listener);
+
+    int ret = vlc_playlist_AppendOne(playlist, media[0]);
+    assert(ret == VLC_SUCCESS);
+    playlist->current = 0;
+    playlist->has_prev = false;
+    playlist->has_next = false;
+    callback_ctx_reset(ctx);
+
+    vlc_playlist_BeginBatch(playlist);
+    ret = vlc_playlist_InsertOne(playlist, 0, media[1]);
+    assert(ret == VLC_SUCCESS);
+    /* not contiguous, flushes the pending insertion */
+    ret = vlc_playlist_AppendOne(playlist, media[2]);
+    assert(ret == VLC_SUCCESS);
+
+    assert(ctx->vec_items_added.size == 1);
+    assert(ctx->vec_items_added.data[0].index == 0);
+    assert(ctx->vec_items_added.data[0].count == 1);
+    assert(ctx->vec_items_added.data[0].state.playlist_size == 2);
+    assert(ctx->vec_items_added.data[0].state.current == 1);
+    assert(ctx->vec_has_prev_changed.size == 1);
+
+    /* up to date, but not notified yet */
+    assert(vlc_playlist_Count(playlist) == 3);
+    assert(vlc_playlist_GetCurrentIndex(playlist) == 1);
+    assert(vlc_playlist_HasPrev(playlist));
+    assert(vlc_playlist_HasNext(playlist));
+    assert(ctx->vec_has_next_changed.size == 0);
+
+    /* expanding the pending item notifies it before the update */
+    ret = vlc_playlist_Expand(playlist, 2, &media[3], 3);
+    assert(ret == VLC_SUCCESS);
+
+    assert(bctx.updated == 1);
+    assert(ctx->vec_has_next_changed.size == 1);
+    assert(ctx->vec_has_next_changed.data[0].has_next);
+
+    /* the expanded media are not batched */
+    assert(ctx->vec_items_added.size == 3);
+    assert(ctx->vec_items_added.data[1].index == 2);
+    assert(ctx->vec_items_added.data[1].count == 1);
+    assert(ctx->vec_items_added.data[1].state.playlist_size == 3);
+    assert(ctx->vec_items_added.data[2].index == 3);
+    assert(ctx->vec_items_added.data[2].count == 2);
+    assert(ctx->vec_items_added.data[2].state.playlist_size == 5);
+
+    vlc_playlist_CommitBatch(playlist);
+    assert(ctx->vec_items_added.size == 3);
+
+    assert(vlc_playlist_Count(playlist) == 5);
+    EXPECT_AT(0, 1);
+    EXPECT_AT(1, 0);
+    EXPECT_AT(2, 3);
+    EXPECT_AT(3, 4);
+    EXPECT_AT(4, 5);
+
+    callback_ctx_destroy(ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 6);
+    vlc_playlist_Delete(playlist);
+}
+
+/* mock preparser, requests are started and ended by the tests */
+enum mock_req_state
+{
+    MOCK_REQ_QUEUED,
+    MOCK_REQ_RUNNING,
+    MOCK_REQ_INTERRUPTED,
+    MOCK_REQ_ENDED,
+};
+
+struct vlc_preparser_req
+{
+    input_item_t *media;
+    const struct vlc_preparser_cbs *cbs;
+    void *userdata;
+    enum mock_req_state state;
+    bool released;
+};
+
+static struct VLC_VECTOR(struct vlc_preparser_req *) mock_reqs =
+    VLC_VECTOR_INITIALIZER;
+
+vlc_preparser_req *
+vlc_playlist_test_PreparserPush(vlc_preparser_t *preparser, input_item_t *item,
+                                int options, const struct vlc_preparser_cbs *cbs,
+                                void *userdata)
+{
+    VLC_UNUSED(preparser); VLC_UNUSED(options);
+    struct vlc_preparser_req *req = malloc(sizeof(*req));
+    assert(req);
+    req->media = item;
+    input_item_Hold(item);
+    req->cbs = cbs;
+    req->userdata = userdata;
+    req->state = MOCK_REQ_QUEUED;
+    req->released = false;
+    bool ok = vlc_vector_push(&mock_reqs, req);
+    assert(ok);
+    VLC_UNUSED(ok);
+    return req;
+}
+
+static void
+mock_req_End(struct vlc_preparser_req *req, int status)
+{
+    req->state = MOCK_REQ_ENDED;
+    req->cbs->on_ended(req, status, req->userdata);
+}
+
+static size_t
+mock_req_Cancel(struct vlc_preparser_req *req)
+{
+    switch (req->state)
+    {
+        case MOCK_REQ_QUEUED:
+            /* like the preparser, notify synchronously */
+            mock_req_End(req, -EINTR);
+            return 1;
+        case MOCK_REQ_RUNNING:
+            /* notified when the request actually ends */
+            req->state = MOCK_REQ_INTERRUPTED;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+size_t
+vlc_playlist_test_PreparserCancel(vlc_preparser_t *preparser,
+                                  vlc_preparser_req *req)
+{
+    VLC_UNUSED(preparser);
+    if (req)
+        return mock_req_Cancel(req);
+
+    size_t count = 0;
+    for (size_t i = 0; i < mock_reqs.size; ++i)
+        count += mock_req_Cancel(mock_reqs.data[i]);
+    return count;
+}
+
+input_item_t *
+vlc_playlist_test_PreparserGetItem(vlc_preparser_req *req)
+{
+    return req->media;
+}
+
+void
+vlc_playlist_test_PreparserRelease(vlc_preparser_req *req)
+{
+    assert(!req->released);
+    req->released = true;
+}
+
+static size_t
+mock_reqs_Count(enum mock_req_state state)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < mock_reqs.size; ++i)
+        if (mock_reqs.data[i]->state == state)
+            count++;
+    return count;
+}
+
+static void
+mock_reqs_Clear(void)
+{
+    for (size_t i = 0; i < mock_reqs.size; ++i)
+    {
+        struct vlc_preparser_req *req = mock_reqs.data[i];
+        assert(req->state == MOCK_REQ_ENDED && req->released);
+        input_item_Release(req->media);
+        free(req);
+    }
+    vlc_vector_clear(&mock_reqs);
+}
+
+static void
+test_preparse_cancel(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    /* plug the mock preparser */
+    static char mock_parser;
+    playlist->parser = (vlc_preparser_t *) &mock_parser;
+    playlist->recursive = VLC_PLAYLIST_PREPARSING_ENABLED;
+
+    /* local files, so that they are preparsed */
+    input_item_t *media[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        char url[32];
+        snprintf(url, sizeof(url), "file:///item-%d", i);
+        media[i] = input_item_New(url, NULL);
+        assert(media[i]);
+    }
+
+    int ret = vlc_playlist_Append(playlist, media, 100);
+    assert(ret == VLC_SUCCESS);
+
+    /* the number of requests in flight is limited */
+    assert(mock_reqs.size == 32);
+    for (size_t i = 0; i < mock_reqs.size; ++i)
+    {
+        assert(mock_reqs.data[i]->media == media[i]);
+        mock_reqs.data[i]->state = MOCK_REQ_RUNNING;
+    }
+
+    /* the running requests are only interrupted by the removal */
+    vlc_player_Lock(playlist->player);
+    vlc_playlist_Remove(playlist, 0, 32);
+    vlc_player_Unlock(playlist->player);
+    assert(mock_reqs_Count(MOCK_REQ_INTERRUPTED) == 32);
+    assert(mock_reqs.size == 32);
+
+    /* their end, from the preparser thread, submits the queued items */
+    for (size_t i = 0; i < 32; ++i)
+        mock_req_End(mock_reqs.data[i], -EINTR);
+    assert(mock_reqs.size == 64);
+    assert(mock_reqs_Count(MOCK_REQ_QUEUED) == 32);
+    for (size_t i = 32; i < 64; ++i)
+        assert(mock_reqs.data[i]->media == media[i]);
+
+    /* the queued requests are canceled synchronously, with the playlist
+     * locked, and the removal submits the next queued items */
+    vlc_player_Lock(playlist->player);
+    vlc_playlist_Remove(playlist, 0, 32);
+    vlc_player_Unlock(playlist->player);
+    assert(mock_reqs.size == 96);
+    assert(mock_reqs_Count(MOCK_REQ_QUEUED) == 32);
+    for (size_t i = 64; i < 96; ++i)
+        assert(mock_reqs.data[i]->media == media[i]);
+
+    /* the last items are submitted as the previous ones succeed */
+    for (size_t i = 64; i < 96; ++i)
+        mock_req_End(mock_reqs.data[i], VLC_SUCCESS);
+    assert(mock_reqs.size == 100);
+    for (size_t i = 96; i < 100; ++i)
+        mock_req_End(mock_reqs.data[i], VLC_SUCCESS);
+    assert(atomic_load(&playlist->preparse_inflight) == 0);
+
+    vlc_playlist_Clear(playlist);
+    mock_reqs_Clear();
+
+    playlist->parser = NULL;
+    DestroyMediaArray(media, 100);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+callback_count_items_added(vlc_playlist_t *playlist, size_t index,
+                           vlc_playlist_item_t *const items[], size_t count,
+                           void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(index); VLC_UNUSED(items);
+    VLC_UNUSED(count);
+    size_t *events = userdata;
+    ++*events;
+}
+
+static double
+bench_append(input_item_t *const media[], size_t count, bool batch,
+             size_t *events)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_added = callback_count_items_added,
+    };
+
+    *events = 0;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, events, false);
+    assert(listener);
+
+    vlc_playlist_SetPlaybackOrder(playlist, VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM);
+
+    vlc_tick_t start = vlc_tick_now();
+    if (batch)
+        vlc_playlist_BeginBatch(playlist);
+    for (size_t i = 0; i < count; ++i)
+    {
+        int ret = vlc_playlist_AppendOne(playlist, media[i]);
+        assert(ret == VLC_SUCCESS);
+        VLC_UNUSED(ret);
+    }
+    if (batch)
+        vlc_playlist_CommitBatch(playlist);
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+
+    assert(vlc_playlist_Count(playlist) == count);
+
+    vlc_playlist_RemoveListener(playlist, listener);
+    vlc_playlist_Delete(playlist);
+
+    if (elapsed <= 0)
+        elapsed = 1;
+    return count * (double) CLOCK_FREQ / elapsed;
+}
+
+static void
+bench_insert(void)
+{
+    const size_t count = 100000;
+    input_item_t **media = vlc_alloc(count, sizeof(*media));
+    assert(media);
+    CreateDummyMediaArray(media, count);
+
+    size_t events;
+    double rate = bench_append(media, count, false, &events);
+    assert(events == count);
+    printf("append one by one: %.0f items/s\n", rate);
+
+    rate = bench_append(media, count, true, &events);
+    assert(events == 1);
+    printf("append in a batch: %.0f items/s\n", rate);
+
+    DestroyMediaArray(media, count);
+    free(media);
+}
+
 #undef EXPECT_AT
 
 int main(void)
@@ -2459,6 +3154,16 @@ int main(void)
     test_shuffle();
     test_sort();
     test_stable_sort();
+    test_sort_reset();
+    test_sort_keys_updated();
+    test_parallel_sort();
+    test_view();
+    test_batch();
+    test_batch_replace();
+    test_preparse_cancel();
+    /* too slow to run on every check */
+    if (getenv("VLC_PLAYLIST_BENCH") != NULL)
+        bench_insert();
     return 0;
 }
 
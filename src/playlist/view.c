@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * playlist/view.c
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_playlist.h>
+#include <vlc_vector.h>
+#include "playlist.h"
+
+struct vlc_playlist_view
+{
+    vlc_playlist_t *playlist;
+    bool (*filter)(vlc_playlist_item_t *item, void *userdata);
+    void *userdata;
+    /* indices of the accepted items in the playlist */
+    struct VLC_VECTOR(size_t) indices;
+    vlc_playlist_listener_id *listener;
+    bool dirty;
+};
+
+static void
+vlc_playlist_view_Invalidate(struct vlc_playlist_view *view)
+{
+    /* the indices are recomputed on the next access */
+    view->dirty = true;
+}
+
+static void
+on_items_reset(vlc_playlist_t *playlist, vlc_playlist_item_t *const items[],
+               size_t count, void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(items); VLC_UNUSED(count);
+    vlc_playlist_view_Invalidate(userdata);
+}
+
+static void
+on_items_added(vlc_playlist_t *playlist, size_t index,
+               vlc_playlist_item_t *const items[], size_t count,
+               void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(index); VLC_UNUSED(items);
+    VLC_UNUSED(count);
+    vlc_playlist_view_Invalidate(userdata);
+}
+
+static void
+on_items_moved(vlc_playlist_t *playlist, size_t index, size_t count,
+               size_t target, void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(index); VLC_UNUSED(count);
+    VLC_UNUSED(target);
+    vlc_playlist_view_Invalidate(userdata);
+}
+
+static void
+on_items_removed(vlc_playlist_t *playlist, size_t index, size_t count,
+                 void *userdata)
+{
+    VLC_UNUSED(playlist); VLC_UNUSED(index); VLC_UNUSED(count);
+    vlc_playlist_view_Invalidate(userdata);
+}
+
+static void
+on_items_updated(vlc_playlist_t *playlist, size_t index,
+                 vlc_playlist_item_t *const items[], size_t count,
+                 void *userdata)
+{
+    /* the filter may depend on the media metadata */
+    VLC_UNUSED(playlist); VLC_UNUSED(index); VLC_UNUSED(items);
+    VLC_UNUSED(count);
+    vlc_playlist_view_Invalidate(userdata);
+}
+
+static const struct vlc_playlist_callbacks view_callbacks = {
+    .on_items_reset = on_items_reset,
+    .on_items_added = on_items_added,
+    .on_items_moved = on_items_moved,
+    .on_items_removed = on_items_removed,
+    .on_items_updated = on_items_updated,
+};
+
+struct vlc_playlist_view *
+vlc_playlist_view_New(vlc_playlist_t *playlist,
+                      bool (*filter)(vlc_playlist_item_t *item, void *userdata),
+                      void *userdata)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    struct vlc_playlist_view *view = malloc(sizeof(*view));
+    if (unlikely(!view))
+        return NULL;
+
+    view->playlist = playlist;
+    view->filter = filter;
+    view->userdata = userdata;
+    vlc_vector_init(&view->indices);
+    view->listener = NULL;
+    view->dirty = true;
+
+    if (filter)
+    {
+        /* an unfiltered view directly exposes the playlist items */
+        view->listener = vlc_playlist_AddListener(playlist, &view_callbacks,
+                                                  view, false);
+        if (unlikely(!view->listener))
+        {
+            free(view);
+            return NULL;
+        }
+    }
+
+    return view;
+}
+
+void
+vlc_playlist_view_Delete(struct vlc_playlist_view *view)
+{
+    if (view->listener)
+        vlc_playlist_RemoveListener(view->playlist, view->listener);
+    vlc_vector_destroy(&view->indices);
+    free(view);
+}
+
+static void
+vlc_playlist_view_Update(struct vlc_playlist_view *view)
+{
+    vlc_playlist_t *playlist = view->playlist;
+    vlc_playlist_AssertLocked(playlist);
+    assert(view->filter);
+
+    if (!view->dirty)
+        return;
+
+    vlc_vector_clear(&view->indices);
+    if (unlikely(!vlc_vector_reserve(&view->indices, playlist->items.size)))
+        /* expose an empty view, and retry on the next access */
+        return;
+
+    for (size_t i = 0; i < playlist->items.size; ++i)
+        if (view->filter(playlist->items.data[i], view->userdata))
+            view->indices.data[view->indices.size++] = i;
+
+    view->dirty = false;
+}
+
+size_t
+vlc_playlist_view_Count(struct vlc_playlist_view *view)
+{
+    if (!view->filter)
+        return vlc_playlist_Count(view->playlist);
+
+    vlc_playlist_view_Update(view);
+    return view->indices.size;
+}
+
+size_t
+vlc_playlist_view_GetPlaylistIndex(struct vlc_playlist_view *view,
+                                   size_t index)
+{
+    if (!view->filter)
+        return index;
+
+    vlc_playlist_view_Update(view);
+    assert(index < view->indices.size);
+    return view->indices.data[index];
+}
+
+vlc_playlist_item_t *
+vlc_playlist_view_Get(struct vlc_playlist_view *view, size_t index)
+{
+    size_t playlist_index = vlc_playlist_view_GetPlaylistIndex(view, index);
+    return vlc_playlist_Get(view->playlist, playlist_index);
+}
@@ -15,8 +15,12 @@
 # include <poll.h>
 #endif
 
+#include <assert.h>
+#include <errno.h>
 #include <signal.h>
 #include <sys/poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
 
 #include <vlc_common.h>
 #include <vlc_process.h>
@@ -135,6 +139,44 @@ vlc_process_Terminate(struct vlc_process *process, bool kill_process)
     return status;
 }
 
+int
+vlc_process_Stop(struct vlc_process *process, vlc_tick_t timeout)
+{
+    assert(process != NULL);
+
+    shutdown(process->fd, SHUT_RDWR);
+    net_Close(process->fd);
+
+    /* Give the process some time to exit on its own, then kill it */
+    vlc_tick_t deadline = vlc_tick_now() + timeout;
+    int status;
+    for (;;) {
+        pid_t ret = waitpid(process->pid, &status, WNOHANG);
+        if (ret == process->pid) {
+            break;
+        }
+        assert(ret == 0 || errno == EINTR);
+        if (vlc_tick_now() >= deadline) {
+            kill(process->pid, SIGKILL);
+            status = vlc_waitpid(process->pid);
+            break;
+        }
+        vlc_tick_sleep(VLC_TICK_FROM_MS(10));
+    }
+
+    process->pid = 0;
+    process->fd = -1;
+    free(process);
+    return status;
+}
+
+pid_t
+vlc_process_GetPid(const struct vlc_process *process)
+{
+    assert(process != NULL);
+    return process->pid;
+}
+
 ssize_t
 vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
                     vlc_tick_t timeout_ms)
@@ -161,6 +203,74 @@ vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
     return recv(process->fd, buf, size, 0);
 }
 
+ssize_t
+vlc_process_fd_ReadFd(struct vlc_process *process, uint8_t *buf, size_t size,
+                      vlc_tick_t timeout_ms, int *fd)
+{
+    assert(process != NULL);
+    assert(process->fd != -1);
+    assert(buf != NULL);
+    assert(fd != NULL);
+
+    *fd = -1;
+
+    struct pollfd fds = {
+        .fd = process->fd, .events = POLLIN, .revents = 0
+    };
+
+    int ret = vlc_poll_i11e(&fds, 1, timeout_ms);
+    if (ret < 0) {
+        return -1;
+    } else if (ret == 0) {
+        errno = ETIMEDOUT;
+        return -1;
+    } else if (!(fds.revents & POLLIN)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    struct iovec iov = { .iov_base = buf, .iov_len = size };
+    union {
+        char buf[CMSG_SPACE(4 * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof(control.buf),
+    };
+
+    int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+    flags |= MSG_CMSG_CLOEXEC;
+#endif
+    ssize_t len = recvmsg(process->fd, &msg, flags);
+    if (len < 0) {
+        return -1;
+    }
+
+    /* Keep the first descriptor, close any other one */
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; i++) {
+            int received;
+            memcpy(&received, CMSG_DATA(cmsg) + i * sizeof(int),
+                   sizeof(received));
+            if (*fd == -1) {
+                *fd = received;
+            } else {
+                vlc_close(received);
+            }
+        }
+    }
+    return len;
+}
+
 ssize_t
 vlc_process_fd_Write(struct vlc_process *process, const uint8_t *buf,
                      size_t size, vlc_tick_t timeout_ms)
@@ -14,6 +14,9 @@
 #ifdef HAVE_POLL_H
 # include <poll.h>
 #endif
+#ifdef __linux__
+# include <unistd.h>
+#endif
 
 #include <assert.h>
 
@@ -38,6 +41,9 @@
 
 #define VLC_PREPARSER_PATH "vlc-preparser"
 
+/* Time left to a process to exit on its own before it is killed */
+#define PREPARSER_STOP_TIMEOUT VLC_TICK_FROM_SEC(2)
+
 /*****************************************************************************
  * Preparser serdes callbacks functions
  *****************************************************************************/
@@ -90,6 +96,26 @@ read_cbs(void *data, size_t size, void *userdata)
     return ret;
 }
 
+static ssize_t
+read_fd_cbs(void *data, size_t size, int *fd, void *userdata)
+{
+    struct preparser_serdes_cbs_ctx *ctx = userdata;
+    assert(ctx->start != VLC_TICK_INVALID);
+    assert(ctx->process != NULL);
+
+    int timeout_ms = -1;
+    if (ctx->timeout != VLC_TICK_INVALID) {
+        vlc_tick_t time_elapsed = (vlc_tick_now() - ctx->start);
+        if (time_elapsed >= ctx->timeout) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+        timeout_ms = MS_FROM_VLC_TICK(ctx->timeout - time_elapsed);
+    }
+
+    return vlc_process_fd_ReadFd(ctx->process, data, size, timeout_ms, fd);
+}
+
 /*****************************************************************************
  * preparser_sys structure
  *****************************************************************************/
@@ -118,6 +144,9 @@ struct preparser_process_thread {
     /* The system thread */
     vlc_thread_t thread;
 
+    /* Index of the thread in the pool, for the logs */
+    size_t id;
+
     /* The process_pool owning the thread */
     struct preparser_process_pool *owner;
 
@@ -125,6 +154,12 @@ struct preparser_process_thread {
     struct vlc_process *process;
     bool process_running;
 
+    /* Number of tasks run by the current process */
+    unsigned process_tasks;
+
+    /* Health of the thread, protected by the pool lock */
+    struct vlc_preparser_process_stats stats;
+
     /* The current task */
     struct preparser_task *task;
 
@@ -500,6 +535,12 @@ struct preparser_process_pool {
     vlc_tick_t timeout;
     int types;
 
+    /** A process is restarted after this many tasks (0 = never) */
+    unsigned max_tasks;
+
+    /** A process is restarted above this resident size (0 = never) */
+    size_t max_memory;
+
     char **argv;
     int argc;
 
@@ -565,15 +606,24 @@ preparser_pool_SpawnProcess(struct preparser_process_thread *thread)
         return VLC_ENOMEM;
     }
 
+    /* Both ends of the pipe must agree on the serializer */
+    char *serdes = var_InheritString(pool->parent, "preparser-serdes");
+
     const char *argv[] = {
         "--timeout-tick",
         str_timeout,
         "--types",
         str_types,
         "--daemon",
+        "--serdes",
+        serdes,
         NULL,
     };
     int argc = ARRAY_SIZE(argv);
+    if (serdes == NULL) {
+        argv[5] = NULL;
+        argc -= 2;
+    }
 
     char *path = NULL;
 #ifdef _WIN32
@@ -595,6 +645,7 @@ preparser_pool_SpawnProcess(struct preparser_process_thread *thread)
                          lib_path, static_name) < 0) {
                 free(str_timeout);
                 free(str_types);
+                free(serdes);
                 return VLC_ENOMEM;
             }
         }
@@ -613,13 +664,109 @@ preparser_pool_SpawnProcess(struct preparser_process_thread *thread)
     free(path);
     free(str_timeout);
     free(str_types);
+    free(serdes);
 
     if (thread->process == NULL) {
         return VLC_EGENERIC;
     }
+    thread->process_tasks = 0;
+    thread->stats.spawns++;
     return VLC_SUCCESS;
 }
 
+/**
+ * Get the resident size of a process, in bytes, or 0 if unknown.
+ */
+static size_t
+preparser_process_GetResidentSize(struct vlc_process *process)
+{
+#ifdef __linux__
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/statm",
+             (int)vlc_process_GetPid(process));
+
+    FILE *stream = vlc_fopen(path, "r");
+    if (stream == NULL) {
+        return 0;
+    }
+    unsigned long size, resident;
+    int ret = fscanf(stream, "%lu %lu", &size, &resident);
+    fclose(stream);
+    if (ret != 2) {
+        return 0;
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+#else
+    VLC_UNUSED(process);
+    return 0;
+#endif
+}
+
+/**
+ * Check if the process of a thread reached the limits of the pool, and must
+ * be replaced by a new one.
+ */
+static bool
+preparser_pool_ProcessExhausted(struct preparser_process_thread *thread)
+{
+    struct preparser_process_pool *pool = thread->owner;
+    vlc_mutex_assert(&pool->lock);
+
+    if (pool->max_tasks != 0 && thread->process_tasks >= pool->max_tasks) {
+        msg_Dbg(pool->parent, "preparser process %zu: restarting after %u "
+                "tasks", thread->id, thread->process_tasks);
+        return true;
+    }
+    if (pool->max_memory != 0 && thread->stats.rss >= pool->max_memory) {
+        msg_Dbg(pool->parent, "preparser process %zu: restarting at %zu KiB "
+                "resident", thread->id, thread->stats.rss / 1024);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Stop the process of a thread, and start a new one.
+ *
+ * A process reaching its limits is stopped gracefully, by closing its
+ * input, and killed if it does not exit in time, while a failing one may be
+ * stuck and is killed right away.
+ */
+static int
+preparser_pool_RestartProcess(struct preparser_process_thread *thread,
+                              bool kill_process)
+{
+    struct preparser_process_pool *pool = thread->owner;
+    vlc_mutex_assert(&pool->lock);
+
+    struct vlc_process *process = thread->process;
+    thread->process = NULL;
+    thread->process_running = false;
+
+    /* Waiting for the process to exit must not block the pool */
+    vlc_mutex_unlock(&pool->lock);
+    if (kill_process) {
+        vlc_process_Terminate(process, true);
+    } else {
+        vlc_process_Stop(process, PREPARSER_STOP_TIMEOUT);
+    }
+    vlc_mutex_lock(&pool->lock);
+
+    /* Since the thread is not supposed to exit on its own, it repeatedly
+     * attempts to restart the process every second until it succeeds or
+     * the pool is shutting down. */
+    while (!pool->closing) {
+        if (preparser_pool_SpawnProcess(thread) == VLC_SUCCESS) {
+            thread->process_running = true;
+            return VLC_SUCCESS;
+        }
+        vlc_mutex_unlock(&pool->lock);
+        sleep(1);
+        vlc_mutex_lock(&pool->lock);
+    }
+    return VLC_EGENERIC;
+}
+
 /**
  * Process thread loop.
  * Take a task on the queue, then execute the task and delete it.
@@ -648,7 +795,13 @@ preparser_pool_Run(void *data)
         vlc_interrupt_t *old = vlc_interrupt_set(task->interrupt);
 
         vlc_mutex_unlock(&thread->owner->lock);
+        vlc_tick_t start = vlc_tick_now();
         int status = preparser_task_Run(thread, timeout);
+        vlc_tick_t latency = vlc_tick_now() - start;
+        size_t rss = 0;
+        if (status == VLC_SUCCESS && thread->owner->max_memory != 0) {
+            rss = preparser_process_GetResidentSize(thread->process);
+        }
         vlc_mutex_lock(&thread->owner->lock);
 
         vlc_thread_set_name("vlc-pool-runner");
@@ -661,32 +814,43 @@ preparser_pool_Run(void *data)
         assert(thread->owner->unfinished > 0);
         --thread->owner->unfinished;
 
+        thread->process_tasks++;
+        thread->stats.tasks++;
+        thread->stats.busy += latency;
+        if (latency > thread->stats.max_latency) {
+            thread->stats.max_latency = latency;
+        }
+        if (rss != 0) {
+            thread->stats.rss = rss;
+        }
+
         if (thread->owner->closing) {
             break;
         }
 
         if (status == VLC_SUCCESS) {
+            if (!preparser_pool_ProcessExhausted(thread)) {
+                continue;
+            }
+            /* Replace the process now rather than on the next task, so that
+             * the new one starts up while the pool is idle. */
+            thread->stats.recycles++;
+            if (preparser_pool_RestartProcess(thread, false) != VLC_SUCCESS) {
+                break;
+            }
             continue;
         }
 
         /* If preparser_task_Run fails, it may indicate that the preparser is
          * stuck or not functioning correctly. In this case, the process is
-         * stopped and deleted. Since the thread is not supposed to exit on
-         * its own, it repeatedly attempts to restart the process every second
-         * until it succeeds or the pool is shutting down. */
-        vlc_process_Terminate(thread->process, true);
-        thread->process_running = false;
-        while (preparser_pool_SpawnProcess(thread) != VLC_SUCCESS) {
-            vlc_mutex_unlock(&thread->owner->lock);
-            sleep(1);
-            vlc_mutex_lock(&thread->owner->lock);
-            if (thread->owner->closing) {
-                goto end;
-            }
+         * stopped and deleted. */
+        thread->stats.failures++;
+        msg_Dbg(thread->owner->parent, "preparser process %zu: task failed "
+                "(%d), restarting", thread->id, status);
+        if (preparser_pool_RestartProcess(thread, true) != VLC_SUCCESS) {
+            break;
         }
-        thread->process_running = true;
     }
-end:
     vlc_mutex_unlock(&thread->owner->lock);
     return NULL;
 }
@@ -707,10 +871,13 @@ preparser_pool_SpawnThread(struct preparser_process_pool *pool)
 
     thread->owner = pool;
     thread->task = NULL;
+    thread->process_tasks = 0;
+    thread->stats = (struct vlc_preparser_process_stats) { 0 };
 
     static struct vlc_preparser_msg_serdes_cbs cbs = {
         .write = write_cbs,
         .read = read_cbs,
+        .read_fd = read_fd_cbs,
     };
     thread->serdes = vlc_preparser_msg_serdes_Create(pool->parent, &cbs, true);
     if (thread->serdes == NULL) {
@@ -727,6 +894,7 @@ preparser_pool_SpawnThread(struct preparser_process_pool *pool)
         return VLC_EGENERIC;
     }
     thread->process_running = true;
+    thread->id = pool->nthreads;
 
     int ret = vlc_clone(&thread->thread, preparser_pool_Run, thread);
     if (ret != 0) {
@@ -839,8 +1007,19 @@ preparser_pool_Delete(struct preparser_process_pool *pool)
     struct preparser_process_thread *thread = NULL;
     vlc_list_foreach(thread, &pool->threads, node) {
         vlc_join(thread->thread, NULL);
+
+        const struct vlc_preparser_process_stats *stats = &thread->stats;
+        if (stats->tasks != 0) {
+            msg_Dbg(pool->parent, "preparser process %zu: %zu tasks, "
+                    "%zu failed, %zu processes (%zu recycled), average %"
+                    PRId64 " ms, max %" PRId64 " ms", thread->id, stats->tasks,
+                    stats->failures, stats->spawns, stats->recycles,
+                    MS_FROM_VLC_TICK(stats->busy / stats->tasks),
+                    MS_FROM_VLC_TICK(stats->max_latency));
+        }
+
         if (thread->process != NULL) {
-            vlc_process_Terminate(thread->process, false);
+            vlc_process_Stop(thread->process, PREPARSER_STOP_TIMEOUT);
         }
         vlc_preparser_msg_serdes_Delete(thread->serdes);
         free(thread);
@@ -855,6 +1034,31 @@ preparser_pool_Delete(struct preparser_process_pool *pool)
     free(pool);
 }
 
+/**
+ * Copy the statistics of the threads of the pool, up to `count`, and return
+ * the number of threads.
+ */
+static size_t
+preparser_pool_GetStats(struct preparser_process_pool *pool, int type,
+                        struct vlc_preparser_process_stats *stats,
+                        size_t count)
+{
+    assert(pool != NULL);
+
+    vlc_mutex_lock(&pool->lock);
+    size_t i = 0;
+    struct preparser_process_thread *thread = NULL;
+    vlc_list_foreach(thread, &pool->threads, node) {
+        if (i < count) {
+            stats[i] = thread->stats;
+            stats[i].type = type;
+        }
+        i++;
+    }
+    vlc_mutex_unlock(&pool->lock);
+    return i;
+}
+
 /**
  * Create a new process pool with `max` maximum process.
  */
@@ -877,6 +1081,9 @@ preparser_pool_New(vlc_object_t *obj, size_t max, vlc_tick_t timeout,
     pool->unfinished = 0;
     pool->timeout = timeout;
     pool->types = types;
+    pool->max_tasks = var_InheritInteger(obj, "preparser-process-tasks");
+    pool->max_memory = (size_t)var_InheritInteger(obj,
+                                        "preparser-process-memory") << 20;
 
     vlc_list_init(&pool->threads);
     vlc_list_init(&pool->queue);
@@ -894,6 +1101,14 @@ preparser_pool_New(vlc_object_t *obj, size_t max, vlc_tick_t timeout,
         return NULL;
     }
 
+    /* Start the other processes now, so that they are ready by the time the
+     * requests arrive. Failures are not fatal, threads are also spawned on
+     * demand. */
+    if (var_InheritBool(obj, "preparser-prespawn")) {
+        while (pool->nthreads < pool->max_threads
+            && preparser_pool_SpawnThread(pool) == VLC_SUCCESS);
+    }
+
     return pool;
 }
 
@@ -1045,6 +1260,32 @@ static void preparser_SetTimeout(void *opaque, vlc_tick_t timeout)
     }
 }
 
+/**
+ * Preparser GetProcessStats operation.
+ * (see `vlc_preparser_GetProcessStats`)
+ */
+static size_t preparser_GetProcessStats(void *opaque,
+                                        struct vlc_preparser_process_stats *stats,
+                                        size_t count)
+{
+    struct preparser_sys *sys = opaque;
+    assert(sys != NULL);
+
+    size_t total = 0;
+    if (sys->pool_preparser != NULL) {
+        total += preparser_pool_GetStats(sys->pool_preparser,
+                                         VLC_PREPARSER_TYPE_PARSE,
+                                         stats, count);
+    }
+    if (sys->pool_thumbnailer != NULL) {
+        size_t offset = __MIN(total, count);
+        total += preparser_pool_GetStats(sys->pool_thumbnailer,
+                                         VLC_PREPARSER_TYPE_THUMBNAIL,
+                                         stats + offset, count - offset);
+    }
+    return total;
+}
+
 /**
  * Preparser Delete operation.
  * (see `vlc_preparser_Delete`)
@@ -1127,6 +1368,7 @@ void *vlc_preparser_external_New(vlc_preparser_t *owner, vlc_object_t *parent,
         .cancel = preparser_Cancel,
         .delete = preparser_Delete,
         .set_timeout = preparser_SetTimeout,
+        .get_process_stats = preparser_GetProcessStats,
     };
     owner->ops = &ops;
 
@@ -30,6 +30,7 @@
 #include <vlc_preparser.h>
 #include <vlc_interrupt.h>
 #include <vlc_fs.h>
+#include <vlc_image.h>
 
 #include "preparser.h"
 #include "input/input_interface.h"
@@ -72,6 +73,7 @@ struct vlc_preparser_req_owner
     input_item_t *item;
     int options;
     struct vlc_thumbnailer_arg thumb_arg;
+    struct vlc_thumbnailer_sheet_arg sheet_arg;
     union vlc_preparser_cbs_internal cbs;
     void *userdata;
 
@@ -84,6 +86,12 @@ struct vlc_preparser_req_owner
     int preparse_status;
     atomic_bool interrupted;
 
+    /* Thumbnail sheet state, shared with the input events */
+    vlc_mutex_t sheet_lock;
+    unsigned sheet_seek; /**< generation of the last seek */
+    unsigned sheet_done; /**< generation of the last picture received */
+    bool sheet_ended;
+
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
     struct vlc_list node; /**< node of vlc_preparser_t.submitted_tasks */
@@ -170,6 +178,10 @@ PreparserRequestNew(struct preparser_sys *preparser, void (*run)(void *), input_
     req_owner->preparse_status = VLC_EGENERIC;
     atomic_init(&req_owner->interrupted, false);
 
+    vlc_mutex_init(&req_owner->sheet_lock);
+    req_owner->sheet_seek = req_owner->sheet_done = 0;
+    req_owner->sheet_ended = false;
+
     req_owner->runnable.run = run;
     req_owner->runnable.userdata = &req_owner->req;
     if (options & VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES)
@@ -379,6 +391,10 @@ on_thumbnailer_input_event( input_thread_t *input,
 
     if (event->type == INPUT_EVENT_THUMBNAIL_READY)
     {
+        /* Only the first picture is used, and the runner may already be
+         * reading it */
+        if (req_owner->pic != NULL)
+            return true;
         req_owner->pic = picture_Hold(event->thumbnail);
         req_owner->preparse_status = VLC_SUCCESS;
     }
@@ -386,6 +402,46 @@ on_thumbnailer_input_event( input_thread_t *input,
     return true;
 }
 
+static bool
+on_sheet_input_event(input_thread_t *input,
+                     const struct vlc_input_event *event, void *userdata)
+{
+    VLC_UNUSED(input);
+    struct vlc_preparser_req *req = userdata;
+    struct vlc_preparser_req_owner *req_owner = preparser_req_get_owner(req);
+
+    if (event->type == INPUT_EVENT_THUMBNAIL_READY)
+    {
+        /* The input keeps playing between the seeks: only the first picture
+         * following the last seek is for the current tile. */
+        vlc_mutex_lock(&req_owner->sheet_lock);
+        bool current = req_owner->sheet_done != req_owner->sheet_seek;
+        if (current)
+        {
+            if (req_owner->pic != NULL)
+                picture_Release(req_owner->pic);
+            req_owner->pic = picture_Hold(event->thumbnail);
+            req_owner->sheet_done = req_owner->sheet_seek;
+        }
+        vlc_mutex_unlock(&req_owner->sheet_lock);
+
+        if (current)
+            vlc_sem_post(&req_owner->preparse_ended);
+        return true;
+    }
+
+    if (event->type == INPUT_EVENT_STATE && (event->state.value == ERROR_S ||
+                                             event->state.value == END_S))
+    {
+        vlc_mutex_lock(&req_owner->sheet_lock);
+        req_owner->sheet_ended = true;
+        vlc_mutex_unlock(&req_owner->sheet_lock);
+        vlc_sem_post(&req_owner->preparse_ended);
+        return true;
+    }
+    return false;
+}
+
 static int
 WriteToFile(const block_t *block, const char *path, unsigned mode)
 {
@@ -605,6 +661,258 @@ error:
         vlc_preparser_req_Release(req);
 }
 
+static void
+SheetBlit(picture_t *sheet, const picture_t *thumb, unsigned x, unsigned y,
+          unsigned tile_width, unsigned tile_height)
+{
+    const plane_t *src = &thumb->p[0];
+    plane_t *dst = &sheet->p[0];
+    const unsigned width = thumb->format.i_visible_width;
+    const unsigned height = thumb->format.i_visible_height;
+
+    /* center the thumbnail in its tile */
+    x += (tile_width - width) / 2;
+    y += (tile_height - height) / 2;
+
+    for (unsigned line = 0; line < height; line++)
+        memcpy(&dst->p_pixels[(y + line) * dst->i_pitch + x * dst->i_pixel_pitch],
+               &src->p_pixels[(thumb->format.i_y_offset + line) * src->i_pitch
+                              + thumb->format.i_x_offset * src->i_pixel_pitch],
+               width * src->i_pixel_pitch);
+}
+
+static void
+SheetAddThumbnail(image_handler_t *image, picture_t *sheet, picture_t *pic,
+                  unsigned index, const struct vlc_thumbnailer_sheet_arg *arg,
+                  unsigned columns)
+{
+    video_format_t fmt_out;
+    video_format_Init(&fmt_out, VLC_CODEC_RGBA);
+
+    /* fit in the tile, preserving the display aspect ratio */
+    unsigned sar_num = pic->format.i_sar_num ? pic->format.i_sar_num : 1;
+    unsigned sar_den = pic->format.i_sar_den ? pic->format.i_sar_den : 1;
+    uint64_t src_w = (uint64_t)pic->format.i_visible_width * sar_num;
+    uint64_t src_h = (uint64_t)pic->format.i_visible_height * sar_den;
+    if (src_w == 0 || src_h == 0)
+        return;
+
+    unsigned width = arg->tile_width;
+    unsigned height = src_h * width / src_w;
+    if (height > arg->tile_height)
+    {
+        height = arg->tile_height;
+        width = src_w * height / src_h;
+    }
+    if (width == 0 || height == 0)
+        return;
+
+    fmt_out.i_width = fmt_out.i_visible_width = width;
+    fmt_out.i_height = fmt_out.i_visible_height = height;
+    fmt_out.i_sar_num = fmt_out.i_sar_den = 1;
+
+    picture_t *thumb = image_Convert(image, pic, &pic->format, &fmt_out);
+    if (thumb == NULL)
+        return;
+
+    if (thumb->format.i_chroma == VLC_CODEC_RGBA
+     && thumb->format.i_visible_width <= arg->tile_width
+     && thumb->format.i_visible_height <= arg->tile_height)
+        SheetBlit(sheet, thumb, (index % columns) * arg->tile_width,
+                  (index / columns) * arg->tile_height,
+                  arg->tile_width, arg->tile_height);
+    picture_Release(thumb);
+}
+
+static input_thread_t *
+SheetInputStart(struct vlc_preparser_req_owner *req_owner,
+                const struct vlc_input_thread_cfg *cfg, double position)
+{
+    input_thread_t *input = input_Create(req_owner->preparser->owner,
+                                         req_owner->item, cfg);
+    if (input == NULL)
+        return NULL;
+
+    /* Only the keyframes the fast seeks land on are needed: skip decoding
+     * the other frames, and the loop filter since the thumbnails are
+     * downscaled anyway. */
+    var_Create(input, "avcodec-skip-frame", VLC_VAR_INTEGER);
+    var_SetInteger(input, "avcodec-skip-frame", 3);
+    var_Create(input, "avcodec-skiploopfilter", VLC_VAR_INTEGER);
+    var_SetInteger(input, "avcodec-skiploopfilter", 4);
+
+    vlc_mutex_lock(&req_owner->sheet_lock);
+    req_owner->sheet_ended = false;
+    vlc_mutex_unlock(&req_owner->sheet_lock);
+
+    input_SetPosition(input, position, true);
+    if (input_Start(input) != VLC_SUCCESS)
+    {
+        input_Close(input);
+        return NULL;
+    }
+    return input;
+}
+
+static void
+SheetInputStop(input_thread_t *input)
+{
+    input_Stop(input);
+    input_Close(input);
+}
+
+static void
+ThumbnailerSheetRun(void *userdata)
+{
+    vlc_thread_set_name("vlc-run-sheet");
+
+    struct vlc_preparser_req *req = userdata;
+    struct vlc_preparser_req_owner *req_owner = preparser_req_get_owner(req);
+    struct preparser_sys *preparser = req_owner->preparser;
+    const struct vlc_thumbnailer_sheet_arg *arg = &req_owner->sheet_arg;
+
+    static const struct vlc_input_thread_callbacks cbs = {
+        .on_event = on_sheet_input_event,
+    };
+
+    const struct vlc_input_thread_cfg cfg = {
+        .type = INPUT_TYPE_THUMBNAILING,
+        .hw_dec = arg->hw_dec ? INPUT_CFG_HW_DEC_ENABLED
+                              : INPUT_CFG_HW_DEC_DISABLED,
+        .cbs = &cbs,
+        .cbs_data = req,
+    };
+
+    vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
+                          vlc_tick_now() + preparser->timeout :
+                          VLC_TICK_INVALID;
+
+    unsigned columns = arg->columns;
+    if (columns == 0)
+    {
+        columns = 1;
+        while (columns * columns < arg->count)
+            columns++;
+    }
+    const unsigned rows = (arg->count + columns - 1) / columns;
+
+    picture_t *sheet = NULL;
+    image_handler_t *image = NULL;
+    input_thread_t *input = NULL;
+    unsigned done = 0;
+
+    sheet = picture_New(VLC_CODEC_RGBA, columns * arg->tile_width,
+                        rows * arg->tile_height, 1, 1);
+    if (sheet == NULL)
+        goto end;
+    for (int i = 0; i < sheet->i_planes; i++)
+        memset(sheet->p[i].p_pixels, 0,
+               (size_t)sheet->p[i].i_pitch * sheet->p[i].i_lines);
+
+    image = image_HandlerCreate(preparser->owner);
+    if (image == NULL)
+        goto end;
+
+    for (unsigned i = 0; i < arg->count; i++)
+    {
+        const double position = (i + .5) / arg->count;
+
+        /* Tag the seek, so that the pictures still in flight from the
+         * previous position are dropped */
+        vlc_mutex_lock(&req_owner->sheet_lock);
+        req_owner->sheet_seek = i + 1;
+        bool ended = req_owner->sheet_ended;
+        if (req_owner->pic != NULL)
+        {
+            picture_Release(req_owner->pic);
+            req_owner->pic = NULL;
+        }
+        vlc_mutex_unlock(&req_owner->sheet_lock);
+
+        bool restarted = false;
+        if (input == NULL || ended)
+        {
+            if (input != NULL)
+                SheetInputStop(input);
+            input = SheetInputStart(req_owner, &cfg, position);
+            if (input == NULL)
+                break;
+            restarted = true;
+        }
+        else
+            input_SetPosition(input, position, true);
+
+        picture_t *pic = NULL;
+        for (;;)
+        {
+            if (deadline == VLC_TICK_INVALID)
+                vlc_sem_wait(&req_owner->preparse_ended);
+            else if (vlc_sem_timedwait(&req_owner->preparse_ended, deadline))
+            {
+                req_owner->preparse_status = VLC_ETIMEOUT;
+                break;
+            }
+
+            if (atomic_load(&req_owner->interrupted))
+                break;
+
+            vlc_mutex_lock(&req_owner->sheet_lock);
+            pic = req_owner->pic;
+            req_owner->pic = NULL;
+            ended = req_owner->sheet_ended;
+            vlc_mutex_unlock(&req_owner->sheet_lock);
+
+            if (pic != NULL)
+                break;
+            if (!ended)
+                continue; /* stale wakeup */
+
+            /* The input may have reached the end before handling the seek:
+             * start it again from this tile once. */
+            if (restarted)
+                break;
+            SheetInputStop(input);
+            input = SheetInputStart(req_owner, &cfg, position);
+            if (input == NULL)
+                break;
+            restarted = true;
+        }
+
+        if (pic == NULL)
+            break; /* end of stream, error, timeout or interruption */
+
+        SheetAddThumbnail(image, sheet, pic, i, arg, columns);
+        picture_Release(pic);
+        done++;
+    }
+
+end:
+    if (input != NULL)
+        SheetInputStop(input);
+    if (image != NULL)
+        image_HandlerDelete(image);
+    if (req_owner->pic != NULL)
+    {
+        picture_Release(req_owner->pic);
+        req_owner->pic = NULL;
+    }
+
+    if (atomic_load(&req_owner->interrupted))
+        req_owner->preparse_status = -EINTR;
+    else if (done > 0 && req_owner->preparse_status != VLC_ETIMEOUT)
+        req_owner->preparse_status = VLC_SUCCESS;
+    else if (req_owner->preparse_status == VLC_SUCCESS)
+        req_owner->preparse_status = VLC_EGENERIC;
+
+    PreparserRemoveTask(preparser, req);
+    req_owner->cbs.thumbnailer->on_ended(req, req_owner->preparse_status,
+                                         req_owner->preparse_status == VLC_SUCCESS ?
+                                         sheet : NULL, req_owner->userdata);
+    if (sheet != NULL)
+        picture_Release(sheet);
+    vlc_preparser_req_Release(req);
+}
+
 static void
 Interrupt(struct vlc_preparser_req *req)
 {
@@ -701,6 +1009,44 @@ preparser_GenerateThumbnail( void *opaque, input_item_t *item,
     return PreparserRequestRetain(req);
 }
 
+static vlc_preparser_req *
+preparser_GenerateThumbnailSheet( void *opaque, input_item_t *item,
+                                  const struct vlc_thumbnailer_sheet_arg *sheet_arg,
+                                  const struct vlc_thumbnailer_cbs *cbs,
+                                  void *cbs_userdata )
+{
+    assert(opaque != NULL);
+    struct preparser_sys *preparser = opaque;
+
+    assert(preparser->thumbnailer != NULL);
+    assert(cbs != NULL && cbs->on_ended != NULL);
+    assert(sheet_arg != NULL);
+
+    if (sheet_arg->count == 0
+     || sheet_arg->tile_width == 0 || sheet_arg->tile_height == 0)
+        return NULL;
+
+    union vlc_preparser_cbs_internal req_cbs = {
+        .thumbnailer = cbs,
+    };
+
+    struct vlc_preparser_req *req =
+        PreparserRequestNew(preparser, ThumbnailerSheetRun, item,
+                            VLC_PREPARSER_TYPE_THUMBNAIL, NULL, req_cbs,
+                            cbs_userdata);
+    if (req == NULL)
+        return NULL;
+
+    struct vlc_preparser_req_owner *req_owner = preparser_req_get_owner(req);
+    req_owner->sheet_arg = *sheet_arg;
+
+    PreparserAddTask(preparser, req);
+
+    vlc_executor_Submit(preparser->thumbnailer, &req_owner->runnable);
+
+    return PreparserRequestRetain(req);
+}
+
 static int
 CheckThumbnailerFormat(enum vlc_thumbnailer_format format,
                        enum vlc_thumbnailer_format *out_format,
@@ -1024,6 +1370,7 @@ vlc_preparser_internal_New(vlc_preparser_t *owner, vlc_object_t *parent,
         .push = preparser_Push,
         .generate_thumbnail = preparser_GenerateThumbnail,
         .generate_thumbnail_to_files = preparser_GenerateThumbnailToFiles,
+        .generate_thumbnail_sheet = preparser_GenerateThumbnailSheet,
         .cancel = preparser_Cancel,
         .delete = preparser_Delete,
         .set_timeout = preparser_SetTimeout,
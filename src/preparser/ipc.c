@@ -41,10 +41,13 @@ vlc_preparser_msg_serdes_Create(vlc_object_t *obj,
     }
     msg_serdes->owner.cbs = cbs;
 
+    char *names = var_InheritString(obj, "preparser-serdes");
     module_t **mods = NULL;
     size_t strict = 0;
-    ssize_t n = vlc_module_match("preparser msg serdes", "any", true, &mods,
+    ssize_t n = vlc_module_match("preparser msg serdes",
+                                 names != NULL ? names : "any", true, &mods,
                                  &strict);
+    free(names);
 
     for (ssize_t i = 0; i < n; i++) {
         vlc_preparser_msg_serdes_module cb = vlc_module_map(obj->logger,
@@ -96,6 +96,22 @@ vlc_preparser_GenerateThumbnailToFiles(vlc_preparser_t *preparser,
                                                        cbs_userdata);
 }
 
+struct vlc_preparser_req *
+vlc_preparser_GenerateThumbnailSheet(vlc_preparser_t *preparser,
+                                input_item_t *item,
+                                const struct vlc_thumbnailer_sheet_arg *sheet_arg,
+                                const struct vlc_thumbnailer_cbs *cbs,
+                                void *cbs_userdata)
+{
+    assert(preparser != NULL);
+    assert(preparser->ops != NULL);
+    if (preparser->ops->generate_thumbnail_sheet == NULL)
+        return NULL;
+    return preparser->ops->generate_thumbnail_sheet(preparser->sys, item,
+                                                    sheet_arg, cbs,
+                                                    cbs_userdata);
+}
+
 size_t vlc_preparser_Cancel(vlc_preparser_t *preparser,
                             struct vlc_preparser_req *req)
 {
@@ -122,6 +138,17 @@ void vlc_preparser_SetTimeout(vlc_preparser_t *preparser, vlc_tick_t timeout)
     preparser->ops->set_timeout(preparser->sys, timeout);
 }
 
+size_t vlc_preparser_GetProcessStats(vlc_preparser_t *preparser,
+                                     struct vlc_preparser_process_stats *stats,
+                                     size_t count)
+{
+    assert(preparser != NULL);
+    assert(preparser->ops != NULL);
+    if (preparser->ops->get_process_stats == NULL)
+        return 0;
+    return preparser->ops->get_process_stats(preparser->sys, stats, count);
+}
+
 input_item_t *vlc_preparser_req_GetItem(struct vlc_preparser_req *req)
 {
     assert(req != NULL);
@@ -40,6 +40,13 @@ struct vlc_preparser_operations {
                                 const struct vlc_thumbnailer_to_files_cbs *cbs,
                                 void *cbs_userdata);
 
+    /** Called by `vlc_preparser_GenerateThumbnailSheet`, optional. */
+    struct vlc_preparser_req *(*generate_thumbnail_sheet)
+                               (void *opaque, input_item_t *item,
+                                const struct vlc_thumbnailer_sheet_arg *sheet_arg,
+                                const struct vlc_thumbnailer_cbs *cbs,
+                                void *cbs_userdata);
+
     /** Called by `vlc_preparser_Cancel`. */
     size_t (*cancel)(void *opaque, struct vlc_preparser_req *req);
 
@@ -48,6 +55,11 @@ struct vlc_preparser_operations {
 
     /** Called by `vlc_preparser_SetTimeout`. */
     void (*set_timeout)(void *opaque, vlc_tick_t timeout);
+
+    /** Called by `vlc_preparser_GetProcessStats`, optional. */
+    size_t (*get_process_stats)(void *opaque,
+                                struct vlc_preparser_process_stats *stats,
+                                size_t count);
 };
 
 struct vlc_preparser_t {
@@ -157,6 +157,7 @@ typedef struct vout_thread_sys_t
         vlc_mutex_t     lock;
         bool            changed;
         bool            new_interlaced;
+        bool            trick_play;
         char            *configuration;
         video_format_t    src_fmt;
         vlc_video_context *src_vctx;
@@ -1561,10 +1562,12 @@ static int RenderPicture(vout_thread_sys_t *sys,
 static void UpdateDeinterlaceFilter(vout_thread_sys_t *sys)
 {
     vlc_mutex_lock(&sys->filter.lock);
+    /* Deinterlacing is not worth it for the few frames shown in trick-play */
+    const bool has_deint = sys->filter.new_interlaced && !sys->filter.trick_play;
     if (sys->filter.changed ||
-        sys->interlacing.has_deint != sys->filter.new_interlaced)
+        sys->interlacing.has_deint != has_deint)
     {
-        sys->interlacing.has_deint = sys->filter.new_interlaced;
+        sys->interlacing.has_deint = has_deint;
         ChangeFilters(sys);
     }
     vlc_mutex_unlock(&sys->filter.lock);
@@ -1833,6 +1836,16 @@ void vout_ChangeRate(vout_thread_t *vout, float rate)
     vout_control_Release(&sys->control);
 }
 
+void vout_ChangeTrickPlay(vout_thread_t *vout, bool trick_play)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    assert(!sys->dummy);
+
+    vlc_mutex_lock(&sys->filter.lock);
+    sys->filter.trick_play = trick_play;
+    vlc_mutex_unlock(&sys->filter.lock);
+}
+
 void vout_ChangeSpuDelay(vout_thread_t *vout, size_t channel_id,
                          vlc_tick_t delay)
 {
@@ -2436,6 +2449,7 @@ int vout_Request(const vout_configuration_t *cfg, vlc_video_context *vctx, input
 
     sys->delay = 0;
     sys->rate = 1.f;
+    sys->filter.trick_play = false;
     sys->str_id = cfg->str_id;
     sys->clock_id = 0;
 
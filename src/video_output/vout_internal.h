@@ -211,6 +211,7 @@ void vout_ChangePause( vout_thread_t *, bool b_paused, vlc_tick_t i_date );
  * It is thread safe
  */
 void vout_ChangeRate( vout_thread_t *, float rate );
+void vout_ChangeTrickPlay( vout_thread_t *, bool trick_play );
 
 /**
  * This function will change the delay of the vout
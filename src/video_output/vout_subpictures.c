@@ -84,6 +84,25 @@ struct subtitle_position_cache
 };
 typedef struct VLC_VECTOR(struct subtitle_position_cache) subtitles_positions_vector;
 
+/* Rendered region along with the content version of its source region */
+struct spu_region_rendered
+{
+    struct subpicture_region_rendered rendered; /* must be first: freed by
+                                                   vlc_render_subpicture_Delete */
+    uint64_t version;
+};
+
+struct spu_rendered_state
+{
+    uint64_t version;
+    vlc_fourcc_t chroma;
+    unsigned x_offset, y_offset;
+    unsigned visible_width, visible_height;
+    vout_display_place_t place;
+    int alpha;
+};
+typedef struct VLC_VECTOR(struct spu_rendered_state) spu_rendered_state_vector;
+
 typedef struct spu_private_t spu_private_t;
 
 struct spu_private_t {
@@ -117,6 +136,9 @@ struct spu_private_t {
     int secondary_alignment;       /**< Force alignment for secondary subs */
     subtitles_positions_vector subs_pos;
 
+    /* Regions output by the previous rendering, for damage tracking */
+    spu_rendered_state_vector last_rendered;
+
     video_palette_t palette;              /**< force palette of subpicture */
 
     /* Subpiture filters */
@@ -1253,15 +1275,17 @@ static struct subpicture_region_rendered *SpuRenderRegion(spu_t *spu,
         y_offset = __MAX(y, 0);
     }
 
-    struct subpicture_region_rendered *dst = calloc(1, sizeof(*dst));
-    if (unlikely(dst == NULL))
+    struct spu_region_rendered *priv = calloc(1, sizeof(*priv));
+    if (unlikely(priv == NULL))
         return NULL;
+    struct subpicture_region_rendered *dst = &priv->rendered;
     dst->p_picture = picture_Clone(region_picture);
     if (unlikely(dst->p_picture == NULL))
     {
-        free(dst);
+        free(priv);
         return NULL;
     }
+    priv->version = subpicture_region_GetVersion(region);
     assert(region_fmt.i_x_offset + region_fmt.i_visible_width  <= dst->p_picture->format.i_width);
     assert(region_fmt.i_y_offset + region_fmt.i_visible_height <= dst->p_picture->format.i_height);
     dst->p_picture->format.i_x_offset       = region_fmt.i_x_offset;
@@ -1527,6 +1551,126 @@ static vlc_render_subpicture *SpuRenderSubpictures(spu_t *spu,
     return output;
 }
 
+/**
+ * Damage tracking helpers.
+ *
+ * Static overlays produce the same rendered regions frame after frame: the
+ * scaled pictures come from the region cache and only their placement may
+ * change. Each region carries a content version, bumped by the core
+ * whenever the pixels it renders from are replaced, so that comparing an
+ * output with the previous one does not depend on the picture buffers.
+ * Displays compositing subpictures themselves can then skip unchanged
+ * frames and only refresh the changed rectangles.
+ */
+static void spu_DamageAdd(vout_display_place_t *damage,
+                          const vout_display_place_t *area)
+{
+    if (area->width == 0 || area->height == 0)
+        return;
+    if (damage->width == 0 || damage->height == 0)
+    {
+        *damage = *area;
+        return;
+    }
+
+    int x_end = __MAX(damage->x + (int)damage->width,  area->x + (int)area->width);
+    int y_end = __MAX(damage->y + (int)damage->height, area->y + (int)area->height);
+    damage->x = __MIN(damage->x, area->x);
+    damage->y = __MIN(damage->y, area->y);
+    damage->width  = x_end - damage->x;
+    damage->height = y_end - damage->y;
+}
+
+static struct spu_rendered_state
+spu_GetRenderedState(const struct subpicture_region_rendered *r)
+{
+    const struct spu_region_rendered *priv =
+        container_of(r, const struct spu_region_rendered, rendered);
+    const video_format_t *fmt = &r->p_picture->format;
+
+    return (struct spu_rendered_state) {
+        .version        = priv->version,
+        .chroma         = fmt->i_chroma,
+        .x_offset       = fmt->i_x_offset,
+        .y_offset       = fmt->i_y_offset,
+        .visible_width  = fmt->i_visible_width,
+        .visible_height = fmt->i_visible_height,
+        .place          = r->place,
+        .alpha          = r->i_alpha,
+    };
+}
+
+static bool spu_RenderedStateEquals(const struct spu_rendered_state *a,
+                                    const struct spu_rendered_state *b)
+{
+    /* palettes can be patched in place (dvd menus) */
+    if (b->chroma == VLC_CODEC_YUVP)
+        return false;
+
+    return a->version == b->version &&
+           a->x_offset == b->x_offset && a->y_offset == b->y_offset &&
+           a->visible_width  == b->visible_width &&
+           a->visible_height == b->visible_height &&
+           vout_display_PlaceEquals(&a->place, &b->place) &&
+           a->alpha == b->alpha;
+}
+
+static void spu_UpdateDamage(spu_private_t *sys, vlc_render_subpicture *output)
+{
+    if (output == NULL)
+    {
+        vlc_vector_clear(&sys->last_rendered);
+        return;
+    }
+
+    vout_display_place_t damage = { 0 };
+    const size_t old_count = sys->last_rendered.size;
+    const size_t new_count = output->regions.size;
+    bool changed = old_count != new_count;
+
+    for (size_t i = 0; i < __MAX(old_count, new_count); i++)
+    {
+        const struct spu_rendered_state *old =
+            i < old_count ? &sys->last_rendered.data[i] : NULL;
+        const struct subpicture_region_rendered *r =
+            i < new_count ? output->regions.data[i] : NULL;
+
+        if (r == NULL)
+        {
+            changed = true;
+            spu_DamageAdd(&damage, &old->place);
+            continue;
+        }
+
+        struct spu_rendered_state cur = spu_GetRenderedState(r);
+        if (old != NULL && spu_RenderedStateEquals(old, &cur))
+            continue;
+
+        changed = true;
+        if (old != NULL)
+            spu_DamageAdd(&damage, &old->place);
+        spu_DamageAdd(&damage, &cur.place);
+    }
+
+    output->b_changed = changed;
+    output->damage    = damage;
+
+    if (!changed)
+        return;
+
+    vlc_vector_clear(&sys->last_rendered);
+    if (!vlc_vector_reserve(&sys->last_rendered, new_count))
+        return;
+
+    const struct subpicture_region_rendered *r;
+    vlc_vector_foreach(r, &output->regions)
+    {
+        bool ok = vlc_vector_push(&sys->last_rendered, spu_GetRenderedState(r));
+        assert(ok); /* reserved */
+        VLC_UNUSED(ok);
+    }
+}
+
 /*****************************************************************************
  * Object variables callbacks
  *****************************************************************************/
@@ -1862,6 +2006,8 @@ static void spu_Cleanup(spu_t *spu)
 
     vlc_vector_destroy(&sys->subs_pos);
 
+    vlc_vector_destroy(&sys->last_rendered);
+
     vlc_vector_destroy(&sys->channels);
 
     vlc_vector_clear(&sys->prerender.vector);
@@ -1928,6 +2074,7 @@ spu_t *spu_Create(vlc_object_t *object, vout_thread_t *vout)
     sys->secondary_alignment = var_InheritInteger(spu,
                                                   "secondary-sub-alignment");
     vlc_vector_init(&sys->subs_pos);
+    vlc_vector_init(&sys->last_rendered);
 
     sys->source_chain_update = NULL;
     sys->filter_chain_update = NULL;
@@ -2343,6 +2490,7 @@ vlc_render_subpicture *spu_Render(spu_t *spu,
                                                 system_now,
                                                 render_subtitle_date,
                                                 external_scale);
+    spu_UpdateDamage(sys, render);
     free(subpicture_array);
     vlc_mutex_unlock(&sys->lock);
 
@@ -192,6 +192,38 @@ vlc_process_Terminate(struct vlc_process *process, bool kill_process)
     return status;
 }
 
+int
+vlc_process_Stop(struct vlc_process *process, vlc_tick_t timeout)
+{
+    assert(process != NULL);
+
+    vlc_close(process->fd_in);
+    vlc_close(process->fd_out);
+    CloseHandle(process->hEvent);
+
+    HANDLE hProcess = OpenProcess(SYNCHRONIZE | PROCESS_TERMINATE, FALSE,
+                                  process->pid);
+    if (hProcess) {
+        if (WaitForSingleObject(hProcess, MS_FROM_VLC_TICK(timeout))
+                == WAIT_TIMEOUT) {
+            TerminateProcess(hProcess, 9);
+        }
+        CloseHandle(hProcess);
+    }
+
+    int status = vlc_waitpid(process->pid);
+    process->pid = 0;
+    free(process);
+    return status;
+}
+
+pid_t
+vlc_process_GetPid(const struct vlc_process *process)
+{
+    assert(process != NULL);
+    return process->pid;
+}
+
 ssize_t
 vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
                     vlc_tick_t timeout_ms)
@@ -233,6 +265,17 @@ vlc_process_fd_Read(struct vlc_process *process, uint8_t *buf, size_t size,
     return -1;
 }
 
+ssize_t
+vlc_process_fd_ReadFd(struct vlc_process *process, uint8_t *buf, size_t size,
+                      vlc_tick_t timeout_ms, int *fd)
+{
+    assert(fd != NULL);
+
+    /* File descriptors can't be passed through pipes */
+    *fd = -1;
+    return vlc_process_fd_Read(process, buf, size, timeout_ms);
+}
+
 ssize_t
 vlc_process_fd_Write(struct vlc_process *process, const uint8_t *buf, size_t size,
                      vlc_tick_t timeout_ms)
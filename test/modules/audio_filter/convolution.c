@@ -0,0 +1,168 @@
+/*****************************************************************************
+ * convolution.c: partitioned convolution tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <math.h>
+
+#include <vlc_common.h>
+#include <vlc_threads.h>
+#include "../../../modules/audio_filter/convolution.h"
+
+static float Noise(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (float)((*seed >> 8) & 0xffff) / 32768.f - 1.f;
+}
+
+/* Compares with the direct convolution, over several partitions */
+static void test_convolve(unsigned partition, unsigned inputs,
+                          unsigned outputs, size_t ir_frames)
+{
+    const size_t frames = 5 * partition;
+    const unsigned paths = inputs * outputs;
+
+    float *ir = malloc(ir_frames * paths * sizeof (*ir));
+    float *in = malloc(frames * inputs * sizeof (*in));
+    float *out = malloc(frames * outputs * sizeof (*out));
+    assert(ir != NULL && in != NULL && out != NULL);
+
+    unsigned seed = partition + inputs * 16 + outputs;
+    for (size_t i = 0; i < ir_frames * paths; i++)
+        ir[i] = Noise(&seed) * expf(-4.f * (i / paths) / ir_frames);
+    for (size_t i = 0; i < frames * inputs; i++)
+        in[i] = Noise(&seed);
+
+    audio_conv_t *conv = audio_conv_New(partition, inputs, outputs,
+                                        ir_frames);
+    assert(conv != NULL);
+    assert(audio_conv_Partition(conv) == partition);
+
+    /* Leave the last path silent, unless it is the only one */
+    const unsigned active = paths > 1 ? paths - 1 : 1;
+    for (unsigned p = 0; p < active; p++)
+        audio_conv_SetResponse(conv, p / outputs, p % outputs, &ir[p],
+                               ir_frames, paths);
+
+    for (size_t i = 0; i < frames; i += partition)
+        audio_conv_Process(conv, &in[i * inputs], &out[i * outputs]);
+
+    for (size_t i = 0; i < frames; i++)
+        for (unsigned o = 0; o < outputs; o++)
+        {
+            double sum = 0.;
+            for (unsigned ch = 0; ch < inputs; ch++)
+            {
+                const unsigned p = ch * outputs + o;
+                if (p >= active)
+                    continue;
+                for (size_t j = 0; j < ir_frames && j <= i; j++)
+                    sum += ir[j * paths + p] * in[(i - j) * inputs + ch];
+            }
+            assert(fabs(out[i * outputs + o] - sum) < 1e-4 * sqrt(ir_frames));
+        }
+
+    /* Once reset, the first partition comes out the same again */
+    float *first = malloc(partition * outputs * sizeof (*first));
+    assert(first != NULL);
+    memcpy(first, out, partition * outputs * sizeof (*first));
+
+    audio_conv_Reset(conv);
+    audio_conv_Process(conv, in, out);
+    for (size_t i = 0; i < partition * outputs; i++)
+        assert(fabsf(out[i] - first[i]) < 1e-6f);
+    free(first);
+
+    audio_conv_Delete(conv);
+    free(out);
+    free(in);
+    free(ir);
+}
+
+#define RATE 48000
+#define SECONDS 2
+
+/* 7.1 to binaural with a room response of ~340 ms */
+static void test_binaural(unsigned partition)
+{
+    const unsigned inputs = 8, outputs = 2;
+    const size_t ir_frames = 16384;
+
+    float *ir = malloc(ir_frames * sizeof (*ir));
+    float *in = malloc(partition * inputs * sizeof (*in));
+    float *out = malloc(partition * outputs * sizeof (*out));
+    assert(ir != NULL && in != NULL && out != NULL);
+
+    unsigned seed = partition;
+    for (size_t i = 0; i < ir_frames; i++)
+        ir[i] = Noise(&seed) * expf(-6.f * i / ir_frames);
+    for (size_t i = 0; i < partition * inputs; i++)
+        in[i] = Noise(&seed);
+
+    audio_conv_t *conv = audio_conv_New(partition, inputs, outputs,
+                                        ir_frames);
+    assert(conv != NULL);
+    for (unsigned ch = 0; ch < inputs; ch++)
+        for (unsigned o = 0; o < outputs; o++)
+            audio_conv_SetResponse(conv, ch, o, ir, ir_frames, 1);
+
+    const unsigned rounds = RATE * SECONDS / partition;
+    vlc_tick_t start = vlc_tick_now();
+    for (unsigned r = 0; r < rounds; r++)
+        audio_conv_Process(conv, in, out);
+    vlc_tick_t time = vlc_tick_now() - start;
+
+    for (size_t i = 0; i < partition * outputs; i++)
+        assert(isfinite(out[i]));
+
+    printf("8 -> 2 ch, %5zu frames response, %4u frames partition: "
+           "%.1f ms latency, %5.1fx real time\n", ir_frames, partition,
+           1000. * partition / RATE,
+           (double)VLC_TICK_FROM_SEC(SECONDS) / (time > 0 ? time : 1));
+
+    audio_conv_Delete(conv);
+    free(out);
+    free(in);
+    free(ir);
+}
+
+int main(void)
+{
+    static const unsigned partitions[] = { 1, 16, 64 };
+    static const unsigned layouts[][2] = {
+        { 1, 1 }, { 1, 2 }, { 2, 2 }, { 3, 1 }, { 6, 2 }, { 8, 2 },
+    };
+    static const size_t lengths[] = { 1, 50, 200 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(partitions); i++)
+        for (size_t j = 0; j < ARRAY_SIZE(layouts); j++)
+            for (size_t k = 0; k < ARRAY_SIZE(lengths); k++)
+                test_convolve(partitions[i], layouts[j][0], layouts[j][1],
+                              lengths[k]);
+
+    for (unsigned partition = 64; partition <= 1024; partition <<= 1)
+        test_binaural(partition);
+
+    return 0;
+}
@@ -0,0 +1,459 @@
+/*****************************************************************************
+ * dsp.c: audio filter DSP kernels tests and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+
+#include <vlc_common.h>
+#include <vlc_threads.h>
+#include "../../../modules/audio_filter/dsp.h"
+
+#define RATE   48000
+#define FRAMES 1024   /* frames per block, as a typical audio output buffer */
+#define BLOCKS 200
+
+static float Noise(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (float)((*seed >> 8) & 0xffff) / 32768.f - 1.f;
+}
+
+static float *NewSignal(unsigned frames, unsigned channels, unsigned seed)
+{
+    float *buf = malloc(frames * channels * sizeof (*buf));
+    assert(buf != NULL);
+    for (unsigned i = 0; i < frames * channels; i++)
+        buf[i] = Noise(&seed) * .5f;
+    return buf;
+}
+
+static void CheckClose(const float *a, const float *b, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        assert(fabsf(a[i] - b[i]) <= 1e-4f * (1.f + fabsf(b[i])));
+}
+
+static void Report(const char *name, unsigned channels, vlc_tick_t ref,
+                   vlc_tick_t dsp)
+{
+    const double samples = (double)FRAMES * BLOCKS * channels;
+
+    printf("%-12s %u ch: scalar %7.1f Msamples/s, dsp %7.1f Msamples/s\n",
+           name, channels, samples / US_FROM_VLC_TICK(ref),
+           samples / US_FROM_VLC_TICK(dsp));
+}
+
+/* Graphic equalizer: 10 resonators per channel, as equalizer.c */
+#define EQZ_BANDS 10
+
+struct eqz_ref
+{
+    float x[2];
+    float y[EQZ_BANDS][2];
+};
+
+static void EqzRef(const struct dsp_resonator_bank *bank, struct eqz_ref *st,
+                   float *buf, unsigned frames, unsigned channels, float dry)
+{
+    for (unsigned i = 0; i < frames; i++)
+        for (unsigned ch = 0; ch < channels; ch++)
+        {
+            float *x = &buf[i * channels + ch];
+            struct eqz_ref *s = &st[ch];
+            float o = 0.f;
+
+            for (unsigned j = 0; j < EQZ_BANDS; j++)
+            {
+                float y = bank->alpha[j] * (*x - s->x[1])
+                        + bank->gamma[j] * s->y[j][0]
+                        - bank->beta[j] * s->y[j][1];
+                s->y[j][1] = s->y[j][0];
+                s->y[j][0] = y;
+                o += y * bank->gain[j];
+            }
+            s->x[1] = s->x[0];
+            s->x[0] = *x;
+            *x = dry * *x + o;
+        }
+}
+
+static void test_equalizer(unsigned channels)
+{
+    static const float freqs[EQZ_BANDS] = {
+        60, 170, 310, 600, 1000, 3000, 6000, 12000, 14000, 16000
+    };
+    struct dsp_resonator_bank bank;
+
+    memset(&bank, 0, sizeof (bank));
+    bank.count = EQZ_BANDS;
+    for (unsigned j = 0; j < EQZ_BANDS; j++)
+    {
+        /* Same design as the equalizer, one octave wide */
+        const float theta1 = 2.f * (float)M_PI * freqs[j] / RATE;
+        const float theta2 = theta1 / sqrtf(2.f);
+        const float sin_prd = sinf(theta2 * .5f * (sqrtf(2.f) + 1.f))
+                            * sinf(theta2 * .5f * (sqrtf(2.f) - 1.f));
+        const float sin_hlf = sinf(theta2) * .5f;
+        const float den = sin_hlf + sin_prd;
+
+        bank.alpha[j] = sin_prd / den;
+        bank.beta[j] = (sin_hlf - sin_prd) / den;
+        bank.gamma[j] = sinf(theta2) * cosf(theta1) / den;
+        bank.gain[j] = .25f * (j & 1 ? .5f : -.3f);
+    }
+
+    const size_t samples = FRAMES * BLOCKS * channels;
+    float *ref = NewSignal(FRAMES * BLOCKS, channels, channels);
+    float *buf = malloc(samples * sizeof (*buf));
+    assert(buf != NULL);
+    memcpy(buf, ref, samples * sizeof (*buf));
+
+    struct eqz_ref ref_state[DSP_CHANNELS_MAX] = { 0 };
+    struct dsp_resonator_state state[DSP_CHANNELS_MAX];
+    memset(state, 0, sizeof (state));
+
+    vlc_tick_t start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        EqzRef(&bank, ref_state, &ref[b * FRAMES * channels], FRAMES,
+               channels, .25f);
+    vlc_tick_t time_ref = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+    {
+        float *block = &buf[b * FRAMES * channels];
+
+        for (unsigned ch = 0; ch < channels; ch++)
+            dsp_ResonatorBank(&bank, &state[ch], &block[ch], &block[ch],
+                              FRAMES, channels, .25f, 1.f);
+    }
+    vlc_tick_t time_dsp = vlc_tick_now() - start;
+
+    CheckClose(buf, ref, samples);
+    Report("equalizer", channels, time_ref, time_dsp);
+    free(buf);
+    free(ref);
+}
+
+/* Parametric equalizer: cascade of 5 biquads, as param_eq.c */
+#define PEQ_STAGES 5
+
+static void BiquadRef(const struct dsp_biquad *c, float *state, float *buf,
+                      unsigned frames, unsigned channels)
+{
+    for (unsigned i = 0; i < frames; i++)
+    {
+        float *s = state;
+        for (unsigned ch = 0; ch < channels; ch++)
+        {
+            float x = buf[i * channels + ch], y = 0.f;
+
+            for (unsigned eq = 0; eq < PEQ_STAGES; eq++)
+            {
+                y = x * c[eq].b0 + s[0] * c[eq].b1 + s[1] * c[eq].b2
+                  - s[2] * c[eq].a1 - s[3] * c[eq].a2;
+                s[1] = s[0];
+                s[0] = x;
+                s[3] = s[2];
+                s[2] = y;
+                x = y;
+                s += 4;
+            }
+            buf[i * channels + ch] = y;
+        }
+    }
+}
+
+static void test_param_eq(unsigned channels)
+{
+    struct dsp_biquad c[PEQ_STAGES];
+
+    for (unsigned eq = 0; eq < PEQ_STAGES; eq++)
+    {
+        /* RBJ peaking sections */
+        const float A = powf(10.f, (eq & 1 ? 6.f : -4.f) / 40.f);
+        const float w0 = 2.f * (float)M_PI * (100.f * (eq + 1) * (eq + 1)) / RATE;
+        const float alpha = sinf(w0) / (2.f * 3.f);
+        const float a0 = 1.f + alpha / A;
+
+        c[eq].b0 = (1.f + alpha * A) / a0;
+        c[eq].b1 = -2.f * cosf(w0) / a0;
+        c[eq].b2 = (1.f - alpha * A) / a0;
+        c[eq].a1 = -2.f * cosf(w0) / a0;
+        c[eq].a2 = (1.f - alpha / A) / a0;
+    }
+
+    const size_t samples = FRAMES * BLOCKS * channels;
+    float *ref = NewSignal(FRAMES * BLOCKS, channels, 2 * channels);
+    float *buf = malloc(samples * sizeof (*buf));
+    float *ref_state = calloc(channels * PEQ_STAGES * 4, sizeof (*ref_state));
+    struct dsp_biquad_state *state = calloc(1, sizeof (*state));
+    assert(buf != NULL && ref_state != NULL && state != NULL);
+    memcpy(buf, ref, samples * sizeof (*buf));
+
+    vlc_tick_t start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        BiquadRef(c, ref_state, &ref[b * FRAMES * channels], FRAMES,
+                  channels);
+    vlc_tick_t time_ref = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        dsp_BiquadCascade(c, PEQ_STAGES, state, &buf[b * FRAMES * channels],
+                          FRAMES, channels);
+    vlc_tick_t time_dsp = vlc_tick_now() - start;
+
+    CheckClose(buf, ref, samples);
+    Report("param_eq", channels, time_ref, time_dsp);
+    free(state);
+    free(ref_state);
+    free(buf);
+    free(ref);
+}
+
+/* Spatializer: 8 parallel combs into 4 serial allpasses, per side */
+static const unsigned comb_sizes[] = {
+    1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617
+};
+static const unsigned allpass_sizes[] = { 556, 441, 341, 225 };
+
+#define COMBS     ARRAY_SIZE(comb_sizes)
+#define ALLPASSES ARRAY_SIZE(allpass_sizes)
+#define DAMP      .2f
+#define ROOM      .84f
+
+struct reverb
+{
+    float *comb[COMBS];
+    unsigned comb_idx[COMBS];
+    float *allpass[ALLPASSES];
+    unsigned allpass_idx[ALLPASSES];
+};
+
+static void ReverbInit(struct reverb *r)
+{
+    for (unsigned i = 0; i < COMBS; i++)
+    {
+        r->comb[i] = calloc(comb_sizes[i], sizeof (float));
+        assert(r->comb[i] != NULL);
+        r->comb_idx[i] = 0;
+    }
+    for (unsigned i = 0; i < ALLPASSES; i++)
+    {
+        r->allpass[i] = calloc(allpass_sizes[i], sizeof (float));
+        assert(r->allpass[i] != NULL);
+        r->allpass_idx[i] = 0;
+    }
+}
+
+static void ReverbClean(struct reverb *r)
+{
+    for (unsigned i = 0; i < COMBS; i++)
+        free(r->comb[i]);
+    for (unsigned i = 0; i < ALLPASSES; i++)
+        free(r->allpass[i]);
+}
+
+static float Undenormalise(float f)
+{
+    return fpclassify(f) == FP_SUBNORMAL ? 0.f : f;
+}
+
+static void ReverbRef(struct reverb *r, const float *in, float *out,
+                      unsigned frames)
+{
+    for (unsigned i = 0; i < frames; i++)
+    {
+        float acc = 0.f;
+
+        for (unsigned k = 0; k < COMBS; k++)
+        {
+            float *line = &r->comb[k][r->comb_idx[k]];
+            const float o = Undenormalise(*line);
+
+            *line = in[i] + Undenormalise(o * (1.f - DAMP)) * ROOM;
+            if (++r->comb_idx[k] >= comb_sizes[k])
+                r->comb_idx[k] = 0;
+            acc += o;
+        }
+        for (unsigned k = 0; k < ALLPASSES; k++)
+        {
+            float *line = &r->allpass[k][r->allpass_idx[k]];
+            const float o = Undenormalise(*line);
+
+            *line = acc + o * .5f;
+            if (++r->allpass_idx[k] >= allpass_sizes[k])
+                r->allpass_idx[k] = 0;
+            acc = -acc + o;
+        }
+        out[i] = acc;
+    }
+}
+
+/* Same processing as the spatializer revmodel blocks */
+static void ReverbDsp(struct reverb *r, const float *in, float *out,
+                      unsigned frames)
+{
+    memset(out, 0, frames * sizeof (*out));
+
+    for (unsigned k = 0; k < COMBS; k++)
+        for (unsigned i = 0; i < frames;)
+        {
+            unsigned len = comb_sizes[k] - r->comb_idx[k];
+            if (len > frames - i)
+                len = frames - i;
+            dsp_CombAccumulate(&r->comb[k][r->comb_idx[k]], &in[i], &out[i],
+                               len, 1.f - DAMP, ROOM);
+            i += len;
+            r->comb_idx[k] = (r->comb_idx[k] + len) % comb_sizes[k];
+        }
+
+    for (unsigned k = 0; k < ALLPASSES; k++)
+        for (unsigned i = 0; i < frames;)
+        {
+            unsigned len = allpass_sizes[k] - r->allpass_idx[k];
+            if (len > frames - i)
+                len = frames - i;
+            dsp_Allpass(&r->allpass[k][r->allpass_idx[k]], &out[i], len, .5f);
+            i += len;
+            r->allpass_idx[k] = (r->allpass_idx[k] + len) % allpass_sizes[k];
+        }
+}
+
+static void test_spatializer(void)
+{
+    /* The revmodel processes blocks of 256 frames */
+    enum { BLOCK = 256 };
+    float *in = NewSignal(FRAMES, 1, 3);
+    float *ref = malloc(FRAMES * sizeof (*ref));
+    float *buf = malloc(FRAMES * sizeof (*buf));
+    assert(ref != NULL && buf != NULL);
+
+    struct reverb r_ref, r_dsp;
+    ReverbInit(&r_ref);
+    ReverbInit(&r_dsp);
+
+    vlc_tick_t start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        ReverbRef(&r_ref, in, ref, FRAMES);
+    vlc_tick_t time_ref = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        for (unsigned i = 0; i < FRAMES; i += BLOCK)
+            ReverbDsp(&r_dsp, &in[i], &buf[i], BLOCK);
+    vlc_tick_t time_dsp = vlc_tick_now() - start;
+
+    CheckClose(buf, ref, FRAMES);
+    Report("spatializer", 1, time_ref, time_dsp);
+
+    ReverbClean(&r_dsp);
+    ReverbClean(&r_ref);
+    free(buf);
+    free(ref);
+    free(in);
+}
+
+/* Noise gate: per channel power and gain envelopes, as gate.c */
+static void GateRef(const struct dsp_gate *g, float *power, float *gain,
+                    float *buf, unsigned frames, unsigned channels)
+{
+    for (unsigned ch = 0; ch < channels; ch++)
+        for (unsigned i = ch; i < frames * channels; i += channels)
+        {
+            const float x = buf[i];
+
+            power[ch] = (1.f - g->alpha) * power[ch] + (x * x) * g->alpha;
+
+            const float target = power[ch] < g->threshold ? 0.f : 1.f;
+            const float delta = target - gain[ch];
+
+            gain[ch] += (delta > 0.f ? g->attack : g->release) * delta;
+            buf[i] = x * gain[ch];
+        }
+}
+
+static void test_gate(unsigned channels)
+{
+    const struct dsp_gate gate = {
+        .alpha = 1.f - expf(-1.f / (RATE * .01f)),
+        .threshold = .01f,
+        .attack = 1.f / (RATE * .05f),
+        .release = 1.f / (RATE * .3f),
+    };
+
+    const size_t samples = FRAMES * BLOCKS * channels;
+    float *ref = NewSignal(FRAMES * BLOCKS, channels, 4 * channels);
+    float *buf = malloc(samples * sizeof (*buf));
+    assert(buf != NULL);
+
+    /* Fade some parts out so that the gate closes and opens again */
+    for (unsigned i = 0; i < FRAMES * BLOCKS; i++)
+        if ((i / (RATE / 4)) & 1)
+            for (unsigned ch = 0; ch < channels; ch++)
+                ref[i * channels + ch] *= .01f;
+    memcpy(buf, ref, samples * sizeof (*buf));
+
+    float power[DSP_CHANNELS_MAX], gain[DSP_CHANNELS_MAX];
+    struct dsp_gate_state state;
+    for (unsigned ch = 0; ch < DSP_CHANNELS_MAX; ch++)
+    {
+        power[ch] = state.power[ch] = 0.f;
+        gain[ch] = state.gain[ch] = 1.f;
+    }
+
+    vlc_tick_t start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        GateRef(&gate, power, gain, &ref[b * FRAMES * channels], FRAMES,
+                channels);
+    vlc_tick_t time_ref = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    for (unsigned b = 0; b < BLOCKS; b++)
+        dsp_Gate(&gate, &state, &buf[b * FRAMES * channels], FRAMES,
+                 channels);
+    vlc_tick_t time_dsp = vlc_tick_now() - start;
+
+    CheckClose(buf, ref, samples);
+    Report("gate", channels, time_ref, time_dsp);
+    free(buf);
+    free(ref);
+}
+
+int main(void)
+{
+    static const unsigned layouts[] = { 1, 2, 6, 8 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(layouts); i++)
+        test_equalizer(layouts[i]);
+    for (size_t i = 0; i < ARRAY_SIZE(layouts); i++)
+        test_param_eq(layouts[i]);
+    test_spatializer();
+    for (size_t i = 0; i < ARRAY_SIZE(layouts); i++)
+        test_gate(layouts[i]);
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*****************************************************************************
+ * fft.c: audio filter FFT helpers tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <math.h>
+
+#include <vlc_common.h>
+#include <vlc_threads.h>
+#include "../../../modules/audio_filter/fft.h"
+
+static float Noise(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (float)((*seed >> 8) & 0xffff) / 32768.f - 1.f;
+}
+
+static void test_transform(unsigned size)
+{
+    audio_fft_t *fft = audio_fft_New(size);
+    assert(fft != NULL);
+    assert(audio_fft_Size(fft) == size);
+
+    float *data = malloc(2 * size * sizeof (*data));
+    float *ref = malloc(2 * size * sizeof (*ref));
+    assert(data != NULL && ref != NULL);
+
+    unsigned seed = size;
+    for (unsigned i = 0; i < 2 * size; i++)
+        data[i] = Noise(&seed);
+
+    /* naive DFT */
+    for (unsigned k = 0; k < size; k++)
+    {
+        double re = 0., im = 0.;
+        for (unsigned i = 0; i < size; i++)
+        {
+            double phase = -2. * M_PI * ((uint64_t)i * k % size) / size;
+            re += data[2 * i] * cos(phase) - data[2 * i + 1] * sin(phase);
+            im += data[2 * i] * sin(phase) + data[2 * i + 1] * cos(phase);
+        }
+        ref[2 * k] = re;
+        ref[2 * k + 1] = im;
+    }
+
+    float *orig = malloc(2 * size * sizeof (*orig));
+    assert(orig != NULL);
+    memcpy(orig, data, 2 * size * sizeof (*orig));
+
+    audio_fft_Forward(fft, data);
+    for (unsigned i = 0; i < 2 * size; i++)
+        assert(fabsf(data[i] - ref[i]) < 1e-3f * size);
+
+    audio_fft_Inverse(fft, data);
+    for (unsigned i = 0; i < 2 * size; i++)
+        assert(fabsf(data[i] / size - orig[i]) < 1e-4f);
+
+    free(orig);
+    free(ref);
+    free(data);
+    audio_fft_Delete(fft);
+}
+
+/* Same parameters as the scaletempo defaults */
+#define STRIDE_MS 30
+#define OVERLAP .20
+#define SEARCH_MS 14
+#define ROUNDS 50
+
+static void test_correlate(unsigned rate, unsigned channels)
+{
+    const unsigned frames_overlap = STRIDE_MS * rate / 1000 * OVERLAP;
+    const unsigned ref_frames = frames_overlap - 1;
+    const unsigned lags = SEARCH_MS * rate / 1000;
+    const unsigned sig_frames = lags + ref_frames - 1;
+
+    audio_fft_t *fft = audio_fft_New(audio_fft_SizeFor(sig_frames));
+    assert(fft != NULL);
+    const unsigned size = audio_fft_Size(fft);
+
+    float *ref = malloc(ref_frames * channels * sizeof (*ref));
+    float *sig = malloc(sig_frames * channels * sizeof (*sig));
+    float *work = malloc(2 * size * sizeof (*work));
+    float *acc = malloc(2 * size * sizeof (*acc));
+    float *corr = malloc(lags * sizeof (*corr));
+    float *direct = malloc(lags * sizeof (*direct));
+    assert(ref && sig && work && acc && corr && direct);
+
+    unsigned seed = rate + channels;
+    for (unsigned i = 0; i < ref_frames * channels; i++)
+        ref[i] = Noise(&seed);
+    for (unsigned i = 0; i < sig_frames * channels; i++)
+        sig[i] = Noise(&seed);
+
+    /* Plant the reference so that the best lag is known */
+    const unsigned best = lags / 3;
+    for (unsigned i = 0; i < ref_frames * channels; i++)
+        sig[best * channels + i] = ref[i];
+
+    vlc_tick_t start = vlc_tick_now();
+    unsigned best_direct = 0;
+    for (unsigned r = 0; r < ROUNDS; r++)
+    {
+        float best_corr = -INFINITY;
+        for (unsigned lag = 0; lag < lags; lag++)
+        {
+            float sum = 0.f;
+            for (unsigned i = 0; i < ref_frames * channels; i++)
+                sum += ref[i] * sig[lag * channels + i];
+            direct[lag] = sum;
+            if (sum > best_corr)
+            {
+                best_corr = sum;
+                best_direct = lag;
+            }
+        }
+    }
+    vlc_tick_t time_direct = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    unsigned best_fft = 0;
+    for (unsigned r = 0; r < ROUNDS; r++)
+    {
+        audio_fft_Correlate(fft, ref, ref_frames, sig, lags, channels,
+                            work, acc, corr);
+        float best_corr = -INFINITY;
+        for (unsigned lag = 0; lag < lags; lag++)
+            if (corr[lag] > best_corr)
+            {
+                best_corr = corr[lag];
+                best_fft = lag;
+            }
+    }
+    vlc_tick_t time_fft = vlc_tick_now() - start;
+
+    assert(best_direct == best);
+    assert(best_fft == best);
+
+    float peak = direct[best];
+    for (unsigned lag = 0; lag < lags; lag++)
+        assert(fabsf(corr[lag] - direct[lag]) < 1e-4f * peak);
+
+    printf("%6u Hz %u ch: %4u lags, direct %"PRId64" us, fft %"PRId64" us\n",
+           rate, channels, lags, US_FROM_VLC_TICK(time_direct / ROUNDS),
+           US_FROM_VLC_TICK(time_fft / ROUNDS));
+
+    free(direct);
+    free(corr);
+    free(acc);
+    free(work);
+    free(sig);
+    free(ref);
+    audio_fft_Delete(fft);
+}
+
+int main(void)
+{
+    for (unsigned size = 1; size <= 1024; size <<= 1)
+        test_transform(size);
+
+    static const unsigned rates[] = { 44100, 48000, 96000 };
+    static const unsigned channels[] = { 1, 2, 6, 8 };
+    for (size_t i = 0; i < ARRAY_SIZE(rates); i++)
+        for (size_t j = 0; j < ARRAY_SIZE(channels); j++)
+            test_correlate(rates[i], channels[j]);
+
+    return 0;
+}
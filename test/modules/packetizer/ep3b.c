@@ -0,0 +1,281 @@
+/*****************************************************************************
+ * ep3b.c: emulation prevention bitstream reader test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_threads.h>
+#include "../modules/packetizer/hxxx_ep3b.h"
+
+/* Byte by byte reference, reading through the slow path of bs_t */
+struct ref_ctx
+{
+    unsigned i_prev;
+    size_t i_bytepos;
+};
+
+static size_t ref_forward( bs_t *s, size_t i_count )
+{
+    struct ref_ctx *ctx = s->p_priv;
+    if( s->p == NULL )
+    {
+        s->p = s->p_start;
+        ctx->i_bytepos = 1;
+        return 1;
+    }
+
+    if( s->p >= s->p_end )
+        return 0;
+
+    for( size_t i = 0; i < i_count; i++ )
+    {
+        if( ++s->p >= s->p_end )
+            break;
+
+        ctx->i_prev = (ctx->i_prev << 1) | (!*s->p);
+        if( *s->p == 0x03 && s->p + 1 != s->p_end
+         && (ctx->i_prev & 0x06) == 0x06 )
+        {
+            ++s->p;
+            ctx->i_prev = !*s->p;
+        }
+    }
+    ctx->i_bytepos += i_count;
+    return i_count;
+}
+
+static size_t ref_pos( const bs_t *s )
+{
+    const struct ref_ctx *ctx = s->p_priv;
+    return ctx->i_bytepos;
+}
+
+static const bs_byte_callbacks_t ref_callbacks = { ref_forward, ref_pos };
+
+/* Reads syntax elements the way headers do, mixing the element kinds */
+static uint64_t Parse( bs_t *bs, unsigned *seed, uint32_t *values, size_t max )
+{
+    uint64_t sum = 0;
+    size_t n = 0;
+
+    while( !bs_eof( bs ) && n < max )
+    {
+        uint32_t v;
+
+        *seed = *seed * 1103515245u + 12345u;
+        switch( (*seed >> 16) % 4 )
+        {
+            case 0:  v = bs_read_ue( bs ); break;
+            case 1:  v = bs_read_se( bs ); break;
+            case 2:  v = bs_read1( bs ); break;
+            default: v = bs_read( bs, 1 + (*seed >> 20) % 32 ); break;
+        }
+        if( values != NULL )
+            values[n++] = v;
+        sum += v;
+    }
+    return sum;
+}
+
+static void test_nal( const uint8_t *nal, size_t size, const uint8_t *rbsp,
+                      size_t rbsp_size )
+{
+    bs_t bs, ref;
+    struct hxxx_bsfw_ep3b_ctx_s ctx;
+    struct ref_ctx refctx = { 0, 0 };
+
+    /* Byte reads give the unescaped payload */
+    if( rbsp != NULL )
+    {
+        hxxx_bsfw_ep3b_ctx_init( &ctx );
+        bs_init_custom( &bs, nal, size, &hxxx_bsfw_ep3b_callbacks, &ctx );
+        for( size_t i = 0; i < rbsp_size; i++ )
+        {
+            assert( bs_pos( &bs ) == 8 * i );
+            assert( bs_read( &bs, 8 ) == rbsp[i] );
+        }
+        assert( bs_eof( &bs ) );
+    }
+
+    /* Every element and position matches the reference */
+    for( unsigned run = 0; run < 4; run++ )
+    {
+        hxxx_bsfw_ep3b_ctx_init( &ctx );
+        bs_init_custom( &bs, nal, size, &hxxx_bsfw_ep3b_callbacks, &ctx );
+        bs_init_custom( &ref, nal, size, &ref_callbacks, &refctx );
+        refctx.i_prev = 0;
+
+        unsigned seed = run, refseed = run;
+        while( !bs_eof( &ref ) )
+        {
+            uint32_t v, refv;
+
+            Parse( &bs, &seed, &v, 1 );
+            Parse( &ref, &refseed, &refv, 1 );
+            assert( v == refv );
+            assert( bs_eof( &ref ) || bs_pos( &bs ) == bs_pos( &ref ) );
+            assert( bs_error( &bs ) == bs_error( &ref ) );
+        }
+        assert( bs_eof( &bs ) );
+    }
+}
+
+/* Escapes a payload the way an encoder does */
+static size_t Escape( const uint8_t *rbsp, size_t size, uint8_t *nal )
+{
+    size_t n = 0;
+    unsigned zeros = 0;
+
+    for( size_t i = 0; i < size; i++ )
+    {
+        if( zeros >= 2 && rbsp[i] <= 3 )
+        {
+            nal[n++] = 0x03;
+            zeros = 0;
+        }
+        nal[n++] = rbsp[i];
+        zeros = rbsp[i] ? 0 : zeros + 1;
+    }
+    return n;
+}
+
+#define SLICE_SIZE (1 << 20)
+#define ROUNDS 16
+
+static void Bench( const char *name, const uint8_t *nal, size_t size )
+{
+    static uint32_t values[SLICE_SIZE];
+    bs_t bs;
+    struct hxxx_bsfw_ep3b_ctx_s ctx;
+    struct ref_ctx refctx;
+    uint64_t sum = 0, refsum = 0;
+    unsigned seed;
+
+    vlc_tick_t start = vlc_tick_now();
+    for( unsigned r = 0; r < ROUNDS; r++ )
+    {
+        refctx.i_prev = 0;
+        bs_init_custom( &bs, nal, size, &ref_callbacks, &refctx );
+        seed = 0;
+        refsum += Parse( &bs, &seed, NULL, SIZE_MAX );
+    }
+    vlc_tick_t reftime = vlc_tick_now() - start;
+
+    start = vlc_tick_now();
+    for( unsigned r = 0; r < ROUNDS; r++ )
+    {
+        hxxx_bsfw_ep3b_ctx_init( &ctx );
+        bs_init_custom( &bs, nal, size, &hxxx_bsfw_ep3b_callbacks, &ctx );
+        seed = 0;
+        sum += Parse( &bs, &seed, NULL, SIZE_MAX );
+    }
+    vlc_tick_t time = vlc_tick_now() - start;
+    assert( sum == refsum );
+
+    /* Header parsing only reads the beginning of the slices */
+    start = vlc_tick_now();
+    for( unsigned r = 0; r < ROUNDS * 64; r++ )
+    {
+        hxxx_bsfw_ep3b_ctx_init( &ctx );
+        bs_init_custom( &bs, nal, size, &hxxx_bsfw_ep3b_callbacks, &ctx );
+        seed = r;
+        sum += Parse( &bs, &seed, values, 64 );
+    }
+    vlc_tick_t headtime = vlc_tick_now() - start;
+
+    printf( "%-10s %8zu bytes: reference %7.1f MB/s, reader %7.1f MB/s, "
+            "%.2f us per header\n", name, size,
+            (double)size * ROUNDS / (reftime > 0 ? reftime : 1),
+            (double)size * ROUNDS / (time > 0 ? time : 1),
+            (double)headtime / (ROUNDS * 64) );
+}
+
+int main( void )
+{
+    /* real world HEVC VPS and SEI */
+    static const uint8_t vpsnal[] = {
+        0x40, 0x01, 0x0C, 0x01, 0xFF, 0xFF, 0x01, 0x60,
+        0x00, 0x00, 0x03, 0x00, 0x40, 0x00, 0x00, 0x03,
+        0x00, 0x00, 0x03, 0x00, 0x78, 0x10, 0x90, 0x24 };
+    static const uint8_t vpsnalunesc[] = {
+        0x40, 0x01, 0x0C, 0x01, 0xFF, 0xFF, 0x01, 0x60,
+        0x00, 0x00,       0x00, 0x40, 0x00, 0x00,
+        0x00, 0x00,       0x00, 0x78, 0x10, 0x90, 0x24 };
+    static const uint8_t seinal[] = {
+        0x4E, 0x01, 0x01, 0x09, 0xB0, 0x00, 0x25, 0x70,
+        0xE2, 0x00, 0x00, 0x03, 0x00, 0x03, 0x88, 0x06,
+        0x60, 0x40, 0xF1, 0x4C, 0xB8, 0x10, 0x05, 0x1C,
+        0xA8, 0x68, 0x7D, 0xD4, 0xD7, 0x59, 0x37, 0x58,
+        0xA5, 0xCE, 0xF0, 0x33, 0x8B, 0x65, 0x45, 0xF1,
+        0x1F, 0x00, 0x05, 0xFF, 0xA3, 0x55, 0xFF, 0x15,
+        0x6D, 0xFF, 0xB0, 0x9D, 0x05, 0x1C, 0xDA, 0x84,
+        0x22, 0x1F, 0x18, 0xEC, 0x53, 0x1A, 0x8E, 0x05,
+        0x2C, 0x6D, 0xD1, 0xBF, 0x54, 0x3A, 0x1F, 0x16,
+        0x06, 0xFF, 0x04, 0x5B, 0xFF, 0xB4, 0x79, 0xFF,
+        0xE8, 0x14, 0x80 };
+    /* escape sequences at both ends and back to back */
+    static const uint8_t edgenal[] = {
+        0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x03, 0x00,
+        0x00, 0x03, 0x00, 0x03, 0x03, 0x00, 0x00, 0x03 };
+
+    test_nal( vpsnal, sizeof (vpsnal), vpsnalunesc, sizeof (vpsnalunesc) );
+    test_nal( seinal, sizeof (seinal), NULL, 0 );
+    test_nal( edgenal, sizeof (edgenal), NULL, 0 );
+
+    /* Synthetic slices, with payloads from sparse (many escapes) to dense */
+    uint8_t *rbsp = malloc( SLICE_SIZE );
+    uint8_t *nal = malloc( SLICE_SIZE * 3 / 2 + 1 );
+    assert( rbsp != NULL && nal != NULL );
+
+    static const unsigned densities[] = { 2, 16, 256 };
+    for( size_t d = 0; d < ARRAY_SIZE(densities); d++ )
+    {
+        unsigned seed = d;
+        for( size_t i = 0; i < SLICE_SIZE; i++ )
+        {
+            seed = seed * 1103515245u + 12345u;
+            rbsp[i] = (seed >> 16) % densities[d] ? (seed >> 24) : 0;
+        }
+        rbsp[0] = 0x26; /* IDR slice header */
+
+        for( size_t size = 1; size < 256; size += 7 )
+        {
+            size_t nalsize = Escape( rbsp, size, nal );
+            test_nal( nal, nalsize, rbsp, size );
+        }
+
+        size_t nalsize = Escape( rbsp, SLICE_SIZE, nal );
+        test_nal( nal, nalsize, rbsp, SLICE_SIZE );
+
+        char name[16];
+        snprintf( name, sizeof (name), "slice 1/%u", densities[d] );
+        Bench( name, nal, nalsize );
+    }
+    Bench( "sei", seinal, sizeof (seinal) );
+
+    free( nal );
+    free( rbsp );
+    return 0;
+}
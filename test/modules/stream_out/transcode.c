@@ -241,13 +241,24 @@ static int OpenErrorChecker(vlc_object_t *obj)
     return VLC_SUCCESS;
 }
 
+struct output_checker_id
+{
+    char *es_id;
+};
+
 static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 {
-    (void)stream; (void)id;
+    (void)stream;
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+    struct output_checker_id *checker_id = id;
 
-    assert(scenario->report_output != NULL);
-    scenario->report_output(f);
+    if (scenario->report_es_output != NULL)
+        scenario->report_es_output(checker_id->es_id, f);
+    else
+    {
+        assert(scenario->report_output != NULL);
+        scenario->report_output(f);
+    }
 
     vlc_frame_ChainRelease(f);
 
@@ -257,12 +268,20 @@ static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 static void *OutputCheckerAdd(sout_stream_t *stream, const es_format_t *fmt,
                               const char *es_id)
 {
-    (void)stream; (void)fmt; (void)es_id;
-    return (void*)0x42;
+    (void)stream; (void)fmt;
+    struct output_checker_id *id = malloc(sizeof(*id));
+    assert(id);
+    id->es_id = es_id != NULL ? strdup(es_id) : NULL;
+    return id;
 }
 
-static void OutputCheckerDel(sout_stream_t *stream, void *id)
-    { (void)stream; (void)id; }
+static void OutputCheckerDel(sout_stream_t *stream, void *_id)
+{
+    (void)stream;
+    struct output_checker_id *id = _id;
+    free(id->es_id);
+    free(id);
+}
 
 static int OpenOutputChecker(vlc_object_t *obj)
 {
@@ -314,8 +333,20 @@ static void play_scenario(intf_thread_t *intf, struct transcode_scenario *scenar
     vlc_player_Lock(player);
     vlc_player_listener_id *listener =
         vlc_player_AddListener(player, &player_cbs, NULL);
+    vlc_player_SetPlayAndPause(player, scenario->restart_after_eos);
     vlc_player_SetCurrentMedia(player, media);
     vlc_player_Start(player);
+
+    if (scenario->restart_after_eos)
+    {
+        /* The player pauses once the decoders are drained */
+        while (vlc_player_GetState(player) != VLC_PLAYER_STATE_PAUSED)
+            vlc_player_CondWait(player, &player_cond);
+
+        transcode_scenario_restart(scenario);
+        vlc_player_SetTime(player, 0);
+        vlc_player_Resume(player);
+    }
     vlc_player_Unlock(player);
 
     transcode_scenario_wait(scenario);
@@ -37,11 +37,16 @@ struct transcode_scenario {
     void (*converter_setup)(filter_t *);
     void (*report_error)(sout_stream_t *);
     void (*report_output)(const vlc_frame_t *);
+    void (*report_es_output)(const char *es_id, const vlc_frame_t *);
+    /* Seek back to the start once the decoders are drained at the end of
+     * the source, and keep transcoding from there */
+    bool restart_after_eos;
 };
 
 
 void transcode_scenario_init(void);
 void transcode_scenario_wait(struct transcode_scenario *scenario);
+void transcode_scenario_restart(struct transcode_scenario *scenario);
 void transcode_scenario_check(struct transcode_scenario *scenario);
 extern size_t transcode_scenarios_count;
 extern struct transcode_scenario transcode_scenarios[];
@@ -40,6 +40,9 @@ static struct scenario_data
     bool encoder_opened;
     bool encoder_closed;
     bool error_reported;
+    bool rendition_opened;
+    unsigned rendition_frame_count;
+    bool restarted;
 } scenario_data;
 
 static void decoder_fixed_size(decoder_t *dec, vlc_fourcc_t chroma,
@@ -194,6 +197,32 @@ static void encoder_i420_800_600_no_vctx(encoder_t *enc)
 }
 #endif
 
+/* Accepts the size configured by transcode: the main encoder, or a
+ * rendition of the ladder */
+static void encoder_i420_ladder(encoder_t *enc)
+{
+    msg_Info(enc, "Setting up the encoder I420: %ux%u",
+             enc->fmt_in.video.i_width, enc->fmt_in.video.i_height);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+    if (enc->fmt_in.video.i_width == 400)
+    {
+        assert(enc->fmt_in.video.i_height == 300);
+        scenario_data.rendition_opened = true;
+    }
+    else
+    {
+        enc->fmt_in.video.i_visible_width
+            = enc->fmt_in.video.i_width
+            = 800;
+        enc->fmt_in.video.i_visible_height
+            = enc->fmt_in.video.i_height
+            = 600;
+        scenario_data.encoder_opened = true;
+    }
+}
+
 static void encoder_encode_dummy(encoder_t *enc, picture_t *pic)
 {
     (void)enc; (void)pic;
@@ -216,6 +245,30 @@ static void wait_output_10_frames_reported(const vlc_frame_t *out)
         vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static void wait_rendition_10_frames_reported(const char *es_id,
+                                             const vlc_frame_t *out)
+{
+    /* The renditions of "<es_id>" are "<es_id>/1", "<es_id>/2"... */
+    assert(es_id != NULL);
+    size_t len = strlen(es_id);
+    if (len < 2 || strcmp(&es_id[len - 2], "/1") != 0)
+        return;
+
+    for (; out != NULL; out = out->p_next)
+        ++scenario_data.rendition_frame_count;
+
+    if (scenario_data.rendition_frame_count == 10)
+        vlc_sem_post(&scenario_data.wait_stop);
+}
+
+static void wait_rendition_10_frames_restarted(const char *es_id,
+                                              const vlc_frame_t *out)
+{
+    /* Only count the frames encoded after the drain and the flush */
+    if (scenario_data.restarted)
+        wait_rendition_10_frames_reported(es_id, out);
+}
+
 static void wait_output_reported(const vlc_frame_t *out)
 {
     (void)out;
@@ -241,6 +294,17 @@ static void converter_fixed_size(filter_t *filter, vlc_fourcc_t chroma_in,
     scenario_data.converter_opened = true;
 }
 
+static void converter_i420_800_600_to_400_300(filter_t *filter)
+{
+    assert(filter->fmt_in.video.i_width == 800);
+    assert(filter->fmt_in.video.i_height == 600);
+    assert(filter->fmt_out.video.i_width == 400);
+    assert(filter->fmt_out.video.i_height == 300);
+    assert(filter->fmt_in.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_out.video.i_chroma == VLC_CODEC_I420);
+    scenario_data.converter_opened = true;
+}
+
 static void converter_i420_to_nv12_800_600(filter_t *filter)
     { converter_fixed_size(filter, VLC_CODEC_I420, VLC_CODEC_NV12, 800, 600); }
 
@@ -260,6 +324,7 @@ static void converter_i420_to_nv12_800_600_vctx(filter_t *filter)
 }
 
 const char source_800_600[] = "mock://video_track_count=1;length=100000000000;video_width=800;video_height=600";
+const char source_800_600_1s[] = "mock://video_track_count=1;length=1000000;video_width=800;video_height=600";
 struct transcode_scenario transcode_scenarios[] =
 {{
     .source = source_800_600,
@@ -356,6 +421,32 @@ struct transcode_scenario transcode_scenarios[] =
     .encoder_close = encoder_close,
     .converter_setup = converter_nv12_to_i420_800_600_vctx,
     .report_output = wait_output_10_frames_reported,
+},{
+    /* Encode a rendition of the video, scaled from the pictures of the main
+     * encoder, and check that its frames reach the output through the PCR
+     * helper of its own track. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{ladder=400x300@500}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_ladder,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_800_600_to_400_300,
+    .report_es_output = wait_rendition_10_frames_reported,
+},{
+    /* The renditions must be encoded again after the end of the source
+     * drained the ladder and a seek flushed it. */
+    .source = source_800_600_1s,
+    .sout = "sout=#transcode{ladder=400x300@500}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_ladder,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_800_600_to_400_300,
+    .report_es_output = wait_rendition_10_frames_restarted,
+    .restart_after_eos = true,
 },{
     /* Ensure that error are correctly forwarded back to the stream output
      * pipeline. */
@@ -374,6 +465,9 @@ void transcode_scenario_init(void)
     scenario_data.output_frame_count = 0;
     scenario_data.converter_opened = false;
     scenario_data.encoder_opened = false;
+    scenario_data.rendition_opened = false;
+    scenario_data.rendition_frame_count = 0;
+    scenario_data.restarted = false;
     vlc_sem_init(&scenario_data.wait_stop, 0);
 }
 
@@ -383,6 +477,12 @@ void transcode_scenario_wait(struct transcode_scenario *scenario)
     vlc_sem_wait(&scenario_data.wait_stop);
 }
 
+void transcode_scenario_restart(struct transcode_scenario *scenario)
+{
+    (void)scenario;
+    scenario_data.restarted = true;
+}
+
 void transcode_scenario_check(struct transcode_scenario *scenario)
 {
     if (scenario->converter_setup != NULL)
@@ -393,4 +493,7 @@ void transcode_scenario_check(struct transcode_scenario *scenario)
 
     if (scenario_data.encoder_opened && scenario->encoder_close != NULL)
         assert(scenario_data.encoder_closed);
+
+    if (scenario->report_es_output != NULL)
+        assert(scenario_data.rendition_opened);
 }
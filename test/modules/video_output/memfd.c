@@ -0,0 +1,220 @@
+/*****************************************************************************
+ * memfd.c: shared memory video output test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../libvlc/test.h"
+
+#include <vlc_common.h>
+#include <vlc_fourcc.h>
+#include <vlc_tick.h>
+
+#include <vlc/vlc.h>
+
+#include "../../../modules/video_output/memfd.h"
+
+#define WIDTH  64
+#define HEIGHT 48
+#define SLOTS  3
+#define FRAMES 8
+
+#define MOCK_MRL "mock://video_track_count=1;length=100000000;" \
+                 "video_width=64;video_height=48;video_chroma=I420"
+
+/* Maps the file once the display wrote its header */
+static const struct vlc_memfd_video_header *MapHeader(const char *path,
+                                                      size_t *size)
+{
+    for (;;)
+    {
+        int fd = open(path, O_RDONLY);
+        assert(fd != -1);
+
+        struct stat st;
+        assert(fstat(fd, &st) == 0);
+        if ((size_t)st.st_size < sizeof(struct vlc_memfd_video_header))
+        {
+            close(fd);
+            vlc_tick_sleep(VLC_TICK_FROM_MS(10));
+            continue;
+        }
+
+        void *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        assert(base != MAP_FAILED);
+        close(fd);
+
+        const struct vlc_memfd_video_header *hdr = base;
+        if (atomic_load_explicit(&hdr->sequence, memory_order_acquire) > 0)
+        {
+            *size = st.st_size;
+            return hdr;
+        }
+        munmap(base, st.st_size);
+        vlc_tick_sleep(VLC_TICK_FROM_MS(10));
+    }
+}
+
+static void CheckHeader(const struct vlc_memfd_video_header *hdr, size_t size)
+{
+    assert(memcmp(hdr->magic, VLC_MEMFD_VIDEO_MAGIC,
+                  sizeof(VLC_MEMFD_VIDEO_MAGIC)) == 0);
+    assert(hdr->version == VLC_MEMFD_VIDEO_VERSION);
+    assert(hdr->slot_count == SLOTS);
+    assert(hdr->chroma == VLC_CODEC_I420);
+    assert(hdr->visible_width == WIDTH && hdr->visible_height == HEIGHT);
+    assert(hdr->width >= WIDTH && hdr->height >= HEIGHT);
+
+    assert(hdr->plane_count == 3);
+    for (unsigned i = 0; i < hdr->plane_count; i++)
+    {
+        assert(hdr->pitch[i] > 0 && hdr->lines[i] > 0);
+        if (i > 0)
+            assert(hdr->plane_offset[i] >= hdr->plane_offset[i - 1]
+                   + (uint64_t)hdr->pitch[i - 1] * hdr->lines[i - 1]);
+    }
+    assert(hdr->plane_offset[2] + (uint64_t)hdr->pitch[2] * hdr->lines[2]
+           <= hdr->slot_size);
+
+    assert(hdr->slot_offset >= sizeof(*hdr)
+           + SLOTS * sizeof(struct vlc_memfd_video_slot));
+    assert(hdr->slot_offset + SLOTS * hdr->slot_size <= size);
+}
+
+/* Reads the latest frame with the sequence lock, returns its sequence */
+static uint64_t ReadLatest(const struct vlc_memfd_video_header *hdr,
+                           int64_t *date)
+{
+    const struct vlc_memfd_video_slot *slots =
+        (const struct vlc_memfd_video_slot *)(hdr + 1);
+
+    for (;;)
+    {
+        uint64_t n = atomic_load_explicit(&hdr->sequence,
+                                          memory_order_acquire);
+        assert(n > 0);
+        const struct vlc_memfd_video_slot *slot = &slots[(n - 1) % SLOTS];
+
+        uint64_t fence = atomic_load_explicit(&slot->fence,
+                                              memory_order_acquire);
+        if (fence != 2 * n)
+        {
+            /* Only a newer frame can be in the slot already */
+            assert(fence > 2 * n);
+            continue;
+        }
+
+        *date = slot->date;
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->fence, memory_order_relaxed) != fence)
+            continue; /* recycled meanwhile */
+        return n;
+    }
+}
+
+/* Every fence must match the frame its slot holds, or is being filled with */
+static void CheckFences(const struct vlc_memfd_video_header *hdr)
+{
+    const struct vlc_memfd_video_slot *slots =
+        (const struct vlc_memfd_video_slot *)(hdr + 1);
+
+    for (unsigned i = 0; i < SLOTS; i++)
+    {
+        uint64_t fence = atomic_load_explicit(&slots[i].fence,
+                                              memory_order_acquire);
+        if (fence == 0)
+            continue; /* never written */
+
+        /* sequence s is stored in slot s % SLOTS, with the fence set to
+         * 2 * s + 1 while it is written, and to 2 * (s + 1) when done */
+        uint64_t sequence = (fence & 1) ? (fence - 1) / 2 : fence / 2 - 1;
+        assert(sequence % SLOTS == i);
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    char path[] = "/tmp/vlc-memfd-test-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    char path_arg[sizeof("--memfd-path=") + sizeof(path)];
+    snprintf(path_arg, sizeof(path_arg), "--memfd-path=%s", path);
+
+    const char *argv[] = {
+        "-v", "--ignore-config", "--vout=memfd", "--window=dummy",
+        "--aout=dummy", "--text-renderer=dummy", "--no-spu",
+        "--memfd-slots=3", path_arg,
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location(MOCK_MRL);
+    assert(md != NULL);
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media(vlc, md);
+    assert(mp != NULL);
+    libvlc_media_release(md);
+
+    assert(libvlc_media_player_play(mp) == 0);
+
+    size_t size;
+    const struct vlc_memfd_video_header *hdr = MapHeader(path, &size);
+    CheckHeader(hdr, size);
+
+    uint64_t last = 0;
+    int64_t last_date = INT64_MIN;
+    while (last < FRAMES)
+    {
+        int64_t date;
+        uint64_t n = ReadLatest(hdr, &date);
+        CheckFences(hdr);
+
+        /* Frames are published in order */
+        assert(n >= last);
+        if (n > last)
+            assert(date > last_date);
+        last = n;
+        last_date = date;
+        vlc_tick_sleep(VLC_TICK_FROM_MS(5));
+    }
+
+    libvlc_media_player_stop_async(mp);
+    libvlc_media_player_release(mp);
+    libvlc_release(vlc);
+
+    /* The display removed its file on close */
+    munmap((void *)hdr, size);
+    assert(access(path, F_OK) == -1);
+    return 0;
+}
@@ -75,15 +75,19 @@ static int OpenDecoderDevice(
 
 static int DecoderDecode(decoder_t *dec, block_t *block)
 {
+    struct input_decoder_scenario *scenario = &input_decoder_scenarios[current_scenario];
     if (block == NULL)
+    {
+        if (scenario->decoder_drain != NULL)
+            scenario->decoder_drain(dec);
         return VLC_SUCCESS;
+    }
 
     picture_t *pic = picture_NewFromFormat(&dec->fmt_out.video);
     assert(pic);
     pic->date = block->i_pts;
     pic->b_progressive = true;
 
-    struct input_decoder_scenario *scenario = &input_decoder_scenarios[current_scenario];
     assert(scenario->decoder_decode != NULL);
     int ret = scenario->decoder_decode(dec, pic);
     if (ret != VLCDEC_RELOAD)
@@ -134,7 +138,10 @@ static void CloseCcDecoder(vlc_object_t *obj)
 
 static vlc_frame_t *PacketizerPacketize(decoder_t *dec, vlc_frame_t **in)
 {
-    (void)dec;
+    struct input_decoder_scenario *scenario = &input_decoder_scenarios[current_scenario];
+    if (scenario->packetizer_packetize != NULL)
+        scenario->packetizer_packetize(dec, in);
+
     if (in == NULL)
         return NULL;
 
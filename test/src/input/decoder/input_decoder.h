@@ -41,7 +41,9 @@ struct input_decoder_scenario {
     void (*cc_decoder_destroy)(decoder_t *);
     int (*cc_decoder_decode)(decoder_t *, vlc_frame_t *in);
     vlc_frame_t * (*packetizer_getcc)(decoder_t *, decoder_cc_desc_t *);
+    void (*packetizer_packetize)(decoder_t *, vlc_frame_t **in);
     void (*decoder_flush)(decoder_t *);
+    void (*decoder_drain)(decoder_t *);
     void (*display_prepare)(vout_display_t *vd, picture_t *pic);
     void (*text_renderer_render)(filter_t *filter, const subpicture_region_t *region_in);
     void (*player_setup_before_start)(vlc_player_t *);
@@ -47,6 +47,11 @@ static struct scenario_data
     bool stream_out_sent;
     size_t decoder_image_sent;
     size_t cc_track_idx;
+    vlc_sem_t wait_flush_requested;
+    unsigned long packetizer_thread;
+    unsigned packetizer_drains;
+    unsigned decoder_drains;
+    bool decoder_flushed;
 } scenario_data;
 
 static void decoder_fixed_size(decoder_t *dec, vlc_fourcc_t chroma,
@@ -252,6 +257,52 @@ static void decoder_flush_signal(decoder_t *dec)
     vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static int decoder_decode_wait_flush(decoder_t *dec, picture_t *pic)
+{
+    (void)dec;
+    picture_Release(pic);
+
+    if (scenario_data.decoder_image_sent++ == 0)
+    {
+        /* Hold the input until the seek is queued, so that the flush
+         * happens before the end of stream */
+        vlc_sem_post(&scenario_data.wait_ready_to_flush);
+        vlc_sem_wait(&scenario_data.wait_flush_requested);
+    }
+    return VLC_SUCCESS;
+}
+
+static void decoder_flush_lookahead(decoder_t *dec)
+{
+    (void)dec;
+    scenario_data.decoder_flushed = true;
+}
+
+static void decoder_drain_lookahead(decoder_t *dec)
+{
+    (void)dec;
+    /* The packetizer thread drained its packetizer exactly once, before
+     * the decoder */
+    assert(scenario_data.decoder_flushed);
+    assert(scenario_data.packetizer_drains == 1);
+    assert(scenario_data.decoder_drains == 0);
+    scenario_data.decoder_drains++;
+    vlc_sem_post(&scenario_data.wait_stop);
+}
+
+static void packetizer_packetize_lookahead(decoder_t *dec, vlc_frame_t **in)
+{
+    (void)dec;
+    /* Only the lookahead thread runs the packetizer */
+    unsigned long thread = vlc_thread_id();
+    if (scenario_data.packetizer_thread == 0)
+        scenario_data.packetizer_thread = thread;
+    assert(scenario_data.packetizer_thread == thread);
+
+    if (in == NULL)
+        scenario_data.packetizer_drains++;
+}
+
 static void* SendUpdateOutput(void *opaque)
 {
     decoder_t *dec = opaque;
@@ -344,6 +395,18 @@ static void interface_setup_check_flush(intf_thread_t *intf)
     vlc_player_Unlock(player);
 }
 
+static void interface_setup_request_flush(intf_thread_t *intf)
+{
+    vlc_player_t *player = (vlc_player_t *)intf->p_sys;
+    vlc_sem_wait(&scenario_data.wait_ready_to_flush);
+
+    vlc_player_Lock(player);
+    vlc_player_SetPosition(player, 0);
+    vlc_player_Unlock(player);
+
+    vlc_sem_post(&scenario_data.wait_flush_requested);
+}
+
 static int sout_filter_send(sout_stream_t *stream, void *id, block_t *block)
 {
     (void)stream; (void)id;
@@ -644,6 +707,22 @@ struct input_decoder_scenario input_decoder_scenarios[] =
     .sout_filter_flush = sout_filter_flush,
     .interface_setup = interface_setup_check_flush,
 },
+{
+    /* Check the packetizer lookahead thread:
+     * - the first decoded frame waits for the interface to seek
+     * - the seek flushes the decoder and the lookahead
+     * - the end of stream drains the packetizer, on its thread only, then
+     *   the decoder, which ends the test */
+    .name = "decoder is flushed and drained with a packetizer lookahead",
+    .source = "mock://video_track_count=1;length=5000000;video_packetized=false",
+    .item_option = ":dec-lookahead=4",
+    .packetizer_packetize = packetizer_packetize_lookahead,
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_wait_flush,
+    .decoder_flush = decoder_flush_lookahead,
+    .decoder_drain = decoder_drain_lookahead,
+    .interface_setup = interface_setup_request_flush,
+},
 {
     /* Check that releasing a decoder while it is triggering an update
      * of the video output format doesn't lead to a crash. Non-regression
@@ -771,6 +850,11 @@ void input_decoder_scenario_init(void)
     scenario_data.stream_out_sent = false;
     scenario_data.decoder_image_sent = 0;
     scenario_data.cc_track_idx = 1;
+    scenario_data.packetizer_thread = 0;
+    scenario_data.packetizer_drains = 0;
+    scenario_data.decoder_drains = 0;
+    scenario_data.decoder_flushed = false;
+    vlc_sem_init(&scenario_data.wait_flush_requested, 0);
     vlc_sem_init(&scenario_data.wait_stop, 0);
     vlc_sem_init(&scenario_data.wait_ready_to_flush, 0);
 }
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * decoder_threads.c: decoder thread budget test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_codec.h>
+#include "../../../lib/libvlc_internal.h"
+#include "../../libvlc/test.h"
+
+#include <vlc/vlc.h>
+
+#define BUDGET 8
+
+static vlc_object_t *parent;
+
+struct test_decoder
+{
+    decoder_t dec;
+    es_format_t fmt_in;
+};
+
+static decoder_t *Create(void)
+{
+    struct test_decoder *owner = vlc_object_create(parent, sizeof (*owner));
+    assert(owner != NULL);
+
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_H264);
+    decoder_Init(&owner->dec, &owner->fmt_in, &fmt);
+    es_format_Clean(&fmt);
+    return &owner->dec;
+}
+
+static void Destroy(decoder_t *dec)
+{
+    struct test_decoder *owner = container_of(dec, struct test_decoder, dec);
+
+    es_format_Clean(&owner->fmt_in);
+    decoder_Destroy(dec);
+}
+
+int main(void)
+{
+    static const char *argv[] = { "--dec-threads=8" };
+    decoder_t *decs[BUDGET + 1];
+
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc != NULL);
+    parent = VLC_OBJECT(vlc->p_libvlc_int);
+
+    /* A lone decoder gets the whole budget, but never more than wanted */
+    decs[0] = Create();
+    assert(decoder_RequestThreads(decs[0], 16) == BUDGET);
+    assert(decoder_RequestThreads(decs[0], 3) == 3);
+    assert(decoder_RequestThreads(decs[0], 0) == 1);
+    assert(decoder_RequestThreads(decs[0], BUDGET) == BUDGET);
+
+    /* The budget is split equally... */
+    decs[1] = Create();
+    assert(decoder_RequestThreads(decs[1], BUDGET) == BUDGET / 2);
+
+    /* ...the decoders wanting less leaving the rest to the others */
+    decs[2] = Create();
+    assert(decoder_RequestThreads(decs[2], 2) == 2);
+    decs[3] = Create();
+    assert(decoder_RequestThreads(decs[3], BUDGET) == 2);
+
+    /* A closed decoder gives its threads back */
+    Destroy(decs[0]);
+    assert(decoder_RequestThreads(decs[3], BUDGET) == 3);
+    assert(decoder_RequestThreads(decs[1], BUDGET) == 3);
+
+    for (unsigned i = 1; i < 4; i++)
+        Destroy(decs[i]);
+
+    /* Past the budget, every decoder still gets one thread */
+    for (unsigned i = 0; i < ARRAY_SIZE(decs); i++)
+    {
+        decs[i] = Create();
+        assert(decoder_RequestThreads(decs[i], BUDGET) >= 1);
+    }
+    assert(decoder_RequestThreads(decs[0], BUDGET) == 1);
+
+    for (unsigned i = 0; i < ARRAY_SIZE(decs); i++)
+        Destroy(decs[i]);
+
+    libvlc_release(vlc);
+    return 0;
+}
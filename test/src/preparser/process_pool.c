@@ -0,0 +1,204 @@
+/*****************************************************************************
+ * process_pool.c: test the limits of the external preparser processes
+ *****************************************************************************
+ * Copyright (C) 2025 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_preparser.h>
+#include <vlc_input_item.h>
+
+#define MOCK_MRL "mock://length=1000000;video_track_count=1;audio_track_count=1"
+
+#define MAX_SLOTS 4
+
+struct test_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    int status;
+    bool done;
+};
+
+static void preparser_callback(struct vlc_preparser_req *req, int status, void *userdata)
+{
+    (void)req;
+    struct test_ctx *ctx = userdata;
+    vlc_mutex_lock(&ctx->lock);
+    ctx->status = status;
+    ctx->done = true;
+    vlc_cond_signal(&ctx->cond);
+    vlc_mutex_unlock(&ctx->lock);
+}
+
+static vlc_preparser_t *test_preparser_New(vlc_object_t *obj, unsigned threads)
+{
+    const struct vlc_preparser_cfg cfg = {
+        .types = VLC_PREPARSER_TYPE_PARSE,
+        .max_parser_threads = threads,
+        .timeout = VLC_TICK_INVALID,
+        .external_process = true,
+    };
+
+    vlc_preparser_t *preparser = vlc_preparser_New(obj, &cfg);
+    assert(preparser != NULL);
+    return preparser;
+}
+
+static void test_preparser_Parse(vlc_preparser_t *preparser)
+{
+    struct test_ctx ctx;
+    vlc_cond_init(&ctx.cond);
+    vlc_mutex_init(&ctx.lock);
+    ctx.status = VLC_EGENERIC;
+    ctx.done = false;
+
+    input_item_t *item = input_item_New(MOCK_MRL, "mock item");
+    assert(item != NULL);
+
+    static const struct vlc_preparser_cbs cbs = {
+        .on_ended = preparser_callback,
+    };
+
+    vlc_mutex_lock(&ctx.lock);
+    struct vlc_preparser_req *req =
+        vlc_preparser_Push(preparser, item, VLC_PREPARSER_TYPE_PARSE,
+                           &cbs, &ctx);
+    assert(req != NULL);
+    vlc_preparser_req_Release(req);
+
+    while (!ctx.done)
+        vlc_cond_wait(&ctx.cond, &ctx.lock);
+    vlc_mutex_unlock(&ctx.lock);
+
+    assert(ctx.status == VLC_SUCCESS);
+    input_item_Release(item);
+}
+
+/* The request ends before the slot accounts for it and replaces its process,
+ * so wait for the statistics to settle. */
+static void test_wait_stats(vlc_preparser_t *preparser, size_t tasks,
+                            size_t spawns,
+                            struct vlc_preparser_process_stats *stats)
+{
+    for (;;) {
+        size_t count = vlc_preparser_GetProcessStats(preparser, stats, 1);
+        assert(count == 1);
+        if (stats->tasks == tasks && stats->spawns == spawns)
+            return;
+        assert(stats->tasks <= tasks && stats->spawns <= spawns);
+        vlc_tick_sleep(VLC_TICK_FROM_MS(10));
+    }
+}
+
+static void test_task_limit(vlc_object_t *obj)
+{
+    var_Create(obj, "preparser-process-tasks", VLC_VAR_INTEGER);
+    var_SetInteger(obj, "preparser-process-tasks", 2);
+
+    vlc_preparser_t *preparser = test_preparser_New(obj, 1);
+
+    for (size_t i = 0; i < 5; ++i)
+        test_preparser_Parse(preparser);
+
+    /* Processes are replaced after the 2nd and 4th tasks */
+    struct vlc_preparser_process_stats stats;
+    test_wait_stats(preparser, 5, 3, &stats);
+    assert(stats.type == VLC_PREPARSER_TYPE_PARSE);
+    assert(stats.recycles == 2);
+    assert(stats.failures == 0);
+    assert(stats.busy > 0);
+    assert(stats.max_latency > 0 && stats.max_latency <= stats.busy);
+
+    vlc_preparser_Delete(preparser);
+    var_Destroy(obj, "preparser-process-tasks");
+}
+
+static void test_memory_limit(vlc_object_t *obj)
+{
+#ifdef __linux__
+    /* Any process is larger than 1 MiB, and is replaced after each task */
+    var_Create(obj, "preparser-process-memory", VLC_VAR_INTEGER);
+    var_SetInteger(obj, "preparser-process-memory", 1);
+
+    vlc_preparser_t *preparser = test_preparser_New(obj, 1);
+
+    for (size_t i = 0; i < 3; ++i)
+        test_preparser_Parse(preparser);
+
+    struct vlc_preparser_process_stats stats;
+    test_wait_stats(preparser, 3, 4, &stats);
+    assert(stats.recycles == 3);
+    assert(stats.failures == 0);
+    assert(stats.rss >= 1 << 20);
+
+    vlc_preparser_Delete(preparser);
+    var_Destroy(obj, "preparser-process-memory");
+#else
+    (void)obj;
+#endif
+}
+
+static void test_prespawn(vlc_object_t *obj)
+{
+    var_Create(obj, "preparser-prespawn", VLC_VAR_BOOL);
+    var_SetBool(obj, "preparser-prespawn", true);
+
+    vlc_preparser_t *preparser = test_preparser_New(obj, 3);
+
+    /* All the slots run a process before any request */
+    struct vlc_preparser_process_stats stats[MAX_SLOTS];
+    size_t count = vlc_preparser_GetProcessStats(preparser, stats, MAX_SLOTS);
+    assert(count == 3);
+    for (size_t i = 0; i < count; ++i) {
+        assert(stats[i].type == VLC_PREPARSER_TYPE_PARSE);
+        assert(stats[i].spawns == 1);
+        assert(stats[i].tasks == 0);
+    }
+
+    vlc_preparser_Delete(preparser);
+    var_Destroy(obj, "preparser-prespawn");
+}
+
+int main( void )
+{
+    test_init();
+
+    static const char * argv[] = {
+        "-v",
+        "--ignore-config",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc);
+
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    /* Without prespawn, only one slot is started */
+    vlc_preparser_t *preparser = test_preparser_New(obj, 3);
+    struct vlc_preparser_process_stats stats[MAX_SLOTS];
+    assert(vlc_preparser_GetProcessStats(preparser, stats, MAX_SLOTS) == 1);
+    vlc_preparser_Delete(preparser);
+
+    test_task_limit(obj);
+    test_memory_limit(obj);
+    test_prespawn(obj);
+
+    libvlc_release( vlc );
+}
@@ -0,0 +1,448 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*****************************************************************************
+ * serdes.c: test the preparser message serializers
+ *****************************************************************************
+ * Copyright © 2026 VideoLAN and VLC authors
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_fs.h>
+#include <vlc_input_item.h>
+#include <vlc_picture.h>
+#include <vlc_preparser_ipc.h>
+#include <vlc_tick.h>
+#include <vlc_variables.h>
+
+#include <errno.h>
+
+#define SUBTREE_COUNT 500
+#define LOOP_COUNT 20
+
+#define TEST_BIN_MAGIC 0x56504231
+
+/* In-memory pipe shared by both ends */
+struct test_pipe {
+    uint8_t *data;
+    size_t size;
+    size_t cap;
+    size_t offset;
+    size_t written;
+
+    /* File descriptor passed with the byte at fd_offset, like SCM_RIGHTS */
+    int fd;
+    size_t fd_offset;
+    /* Lose the file descriptors, as a peer unable to pass them */
+    bool drop_fd;
+};
+
+static void test_pipe_Reset(struct test_pipe *pipe)
+{
+    pipe->offset = pipe->size = 0;
+    if (pipe->fd != -1) {
+        vlc_close(pipe->fd);
+        pipe->fd = -1;
+    }
+}
+
+static ssize_t test_pipe_Write(const void *data, size_t size, void *userdata)
+{
+    struct test_pipe *pipe = userdata;
+    assert(pipe != NULL);
+
+    if (size > pipe->cap - pipe->size) {
+        size_t cap = (pipe->size + size) * 2;
+        uint8_t *buf = realloc(pipe->data, cap);
+        if (buf == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        pipe->data = buf;
+        pipe->cap = cap;
+    }
+    memcpy(pipe->data + pipe->size, data, size);
+    pipe->size += size;
+    pipe->written += size;
+    return size;
+}
+
+static ssize_t test_pipe_Read(void *data, size_t size, void *userdata)
+{
+    struct test_pipe *pipe = userdata;
+    assert(pipe != NULL);
+
+    size_t avail = pipe->size - pipe->offset;
+    if (size > avail) {
+        size = avail;
+    }
+    memcpy(data, pipe->data + pipe->offset, size);
+    pipe->offset += size;
+    if (pipe->offset == pipe->size) {
+        pipe->offset = pipe->size = 0;
+    }
+    return size;
+}
+
+static ssize_t test_pipe_WriteFd(const void *data, size_t size, int fd,
+                                 void *userdata)
+{
+    struct test_pipe *pipe = userdata;
+    assert(pipe != NULL);
+    assert(size > 0);
+
+    if (!pipe->drop_fd) {
+        assert(pipe->fd == -1);
+        pipe->fd = vlc_dup(fd);
+        assert(pipe->fd != -1);
+        pipe->fd_offset = pipe->size;
+    }
+    return test_pipe_Write(data, size, userdata);
+}
+
+static ssize_t test_pipe_ReadFd(void *data, size_t size, int *fd,
+                                void *userdata)
+{
+    struct test_pipe *pipe = userdata;
+    assert(pipe != NULL);
+
+    *fd = -1;
+    size_t start = pipe->offset;
+    size_t avail = pipe->size - pipe->offset;
+    if (pipe->fd != -1 && pipe->fd_offset >= start
+     && pipe->fd_offset < start + (size < avail ? size : avail)) {
+        *fd = pipe->fd;
+        pipe->fd = -1;
+    }
+    return test_pipe_Read(data, size, userdata);
+}
+
+static const struct vlc_preparser_msg_serdes_cbs test_cbs = {
+    .write = test_pipe_Write,
+    .read = test_pipe_Read,
+    .write_fd = test_pipe_WriteFd,
+    .read_fd = test_pipe_ReadFd,
+};
+
+static void test_pipe_WriteVarint(struct test_pipe *pipe, uint64_t value)
+{
+    do {
+        uint8_t b = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            b |= 0x80;
+        }
+        assert(test_pipe_Write(&b, 1, pipe) == 1);
+    } while (value != 0);
+}
+
+static void test_pipe_WriteHeader(struct test_pipe *pipe)
+{
+    uint8_t magic[4];
+    SetDWLE(magic, TEST_BIN_MAGIC);
+    assert(test_pipe_Write(magic, sizeof(magic), pipe) == 4);
+    test_pipe_WriteVarint(pipe, 2); /* response, zigzag */
+    test_pipe_WriteVarint(pipe, 0); /* parse */
+}
+
+static input_item_t *test_create_item(int i)
+{
+    char *uri, *name;
+    assert(asprintf(&uri, "file:///tmp/test/%04d.mkv", i) > 0);
+    assert(asprintf(&name, "Item %04d", i) > 0);
+    input_item_t *item = input_item_New(uri, name);
+    assert(item != NULL);
+    free(uri);
+    free(name);
+
+    item->i_duration = VLC_TICK_FROM_SEC(60 + i);
+    input_item_SetTitle(item, "Title");
+    input_item_SetArtist(item, "Artist");
+    input_item_SetTrackNumber(item, "7");
+
+    struct input_item_es es = { .id = strdup("video/0"), .id_stable = true };
+    es_format_Init(&es.es, VIDEO_ES, VLC_CODEC_H264);
+    es.es.video.i_width = es.es.video.i_visible_width = 1920;
+    es.es.video.i_height = es.es.video.i_visible_height = 1080;
+    es.es.psz_language = strdup("eng");
+    assert(vlc_vector_push(&item->es_vec, es));
+
+    es.id = strdup("audio/0");
+    es_format_Init(&es.es, AUDIO_ES, VLC_CODEC_MP4A);
+    es.es.audio.i_channels = 2;
+    es.es.audio.i_rate = 48000;
+    assert(vlc_vector_push(&item->es_vec, es));
+    return item;
+}
+
+static void test_check_item(const input_item_t *a, const input_item_t *b)
+{
+    assert(a != NULL && b != NULL);
+    assert(strcmp(a->psz_uri, b->psz_uri) == 0);
+    assert(strcmp(a->psz_name, b->psz_name) == 0);
+    assert(a->i_duration == b->i_duration);
+    assert(b->p_meta != NULL);
+    assert(strcmp(vlc_meta_Get(b->p_meta, vlc_meta_Title), "Title") == 0);
+    assert(strcmp(vlc_meta_Get(b->p_meta, vlc_meta_TrackNumber), "7") == 0);
+    assert(a->es_vec.size == b->es_vec.size);
+    for (size_t i = 0; i < a->es_vec.size; i++) {
+        const struct input_item_es *ea = &a->es_vec.data[i];
+        const struct input_item_es *eb = &b->es_vec.data[i];
+        assert(strcmp(ea->id, eb->id) == 0);
+        assert(ea->id_stable == eb->id_stable);
+        assert(es_format_IsSimilar(&ea->es, &eb->es));
+    }
+}
+
+static picture_t *test_create_picture(int width, int height)
+{
+    picture_t *pic = picture_New(VLC_CODEC_I420, width, height, 1, 1);
+    assert(pic != NULL);
+    for (int i = 0; i < pic->i_planes; i++) {
+        plane_t *p = &pic->p[i];
+        for (int y = 0; y < p->i_lines; y++) {
+            for (int x = 0; x < p->i_pitch; x++) {
+                p->p_pixels[y * p->i_pitch + x] = (x + y * 3 + i * 5) & 0xff;
+            }
+        }
+    }
+    pic->date = VLC_TICK_FROM_SEC(42);
+    return pic;
+}
+
+static void test_check_picture(const picture_t *a, const picture_t *b)
+{
+    assert(a != NULL && b != NULL);
+    assert(video_format_IsSimilar(&a->format, &b->format));
+    assert(a->i_planes == b->i_planes);
+    assert(a->date == b->date);
+    for (int i = 0; i < a->i_planes; i++) {
+        const plane_t *pa = &a->p[i];
+        const plane_t *pb = &b->p[i];
+        assert(pa->i_visible_lines == pb->i_visible_lines);
+        assert(pa->i_visible_pitch == pb->i_visible_pitch);
+        for (int y = 0; y < pa->i_visible_lines; y++) {
+            assert(memcmp(pa->p_pixels + y * pa->i_pitch,
+                          pb->p_pixels + y * pb->i_pitch,
+                          pa->i_visible_pitch) == 0);
+        }
+    }
+}
+
+/* Send `in` from one end and read it back on the other end */
+static vlc_tick_t test_roundtrip(struct vlc_preparser_msg_serdes *tx,
+                                 struct vlc_preparser_msg_serdes *rx,
+                                 struct test_pipe *pipe,
+                                 const struct vlc_preparser_msg *in,
+                                 struct vlc_preparser_msg *out)
+{
+    pipe->written = 0;
+    vlc_tick_t start = vlc_tick_now();
+    int ret = vlc_preparser_msg_serdes_Serialize(tx, in, pipe);
+    assert(ret == VLC_SUCCESS);
+    ret = vlc_preparser_msg_serdes_Deserialize(rx, out, pipe);
+    assert(ret == VLC_SUCCESS);
+    assert(out->type == in->type);
+    assert(out->req_type == in->req_type);
+    return vlc_tick_now() - start;
+}
+
+/* Read a message that must be rejected, and drop what is left of it */
+static void test_reject(struct vlc_preparser_msg_serdes *rx,
+                        struct test_pipe *pipe)
+{
+    struct vlc_preparser_msg out;
+    int ret = vlc_preparser_msg_serdes_Deserialize(rx, &out, pipe);
+    assert(ret != VLC_SUCCESS);
+    test_pipe_Reset(pipe);
+}
+
+/* The binary serializer reads what an untrusted process writes */
+static void test_binary_errors(struct vlc_preparser_msg_serdes *host,
+                               struct vlc_preparser_msg_serdes *worker,
+                               struct test_pipe *pipe)
+{
+    struct vlc_preparser_msg req, res, out;
+
+    /* Shared pixels without a descriptor: the response is lost, then the
+     * host asks for inline pixels */
+    vlc_preparser_msg_Init(&res, VLC_PREPARSER_MSG_TYPE_RES,
+                           VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL);
+    res.res.status = VLC_SUCCESS;
+    res.res.item = test_create_item(0);
+    res.res.pic = test_create_picture(1280, 720);
+
+    pipe->drop_fd = true;
+    assert(vlc_preparser_msg_serdes_Serialize(worker, &res, pipe)
+           == VLC_SUCCESS);
+    test_reject(host, pipe);
+
+    vlc_preparser_msg_Init(&req, VLC_PREPARSER_MSG_TYPE_REQ,
+                           VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL);
+    req.req.uri = strdup("file:///tmp/test/video.mkv");
+    test_roundtrip(host, worker, pipe, &req, &out);
+    vlc_preparser_msg_Clean(&out);
+    vlc_preparser_msg_Clean(&req);
+
+    test_roundtrip(worker, host, pipe, &res, &out);
+    test_check_picture(res.res.pic, out.res.pic);
+    vlc_preparser_msg_Clean(&out);
+    pipe->drop_fd = false;
+
+    /* Inconsistent plane geometry */
+    picture_Release(res.res.pic);
+    res.res.pic = test_create_picture(64, 64);
+    res.res.pic->p[0].i_visible_lines = res.res.pic->p[0].i_lines + 1;
+    assert(vlc_preparser_msg_serdes_Serialize(worker, &res, pipe)
+           == VLC_SUCCESS);
+    test_reject(host, pipe);
+
+    res.res.pic->p[0].i_visible_lines = res.res.pic->p[0].i_lines;
+    res.res.pic->p[0].i_visible_pitch = res.res.pic->p[0].i_pitch + 1;
+    assert(vlc_preparser_msg_serdes_Serialize(worker, &res, pipe)
+           == VLC_SUCCESS);
+    test_reject(host, pipe);
+    vlc_preparser_msg_Clean(&res);
+
+    /* Bad magic */
+    assert(test_pipe_Write("JSON{}", 6, pipe) == 6);
+    test_reject(host, pipe);
+
+    /* Truncated stream */
+    vlc_preparser_msg_Init(&res, VLC_PREPARSER_MSG_TYPE_RES,
+                           VLC_PREPARSER_MSG_REQ_TYPE_PARSE);
+    res.res.status = VLC_SUCCESS;
+    res.res.item = test_create_item(0);
+    assert(vlc_preparser_msg_serdes_Serialize(worker, &res, pipe)
+           == VLC_SUCCESS);
+    vlc_preparser_msg_Clean(&res);
+    pipe->size /= 2;
+    test_reject(host, pipe);
+
+    /* Oversized count of attachments */
+    test_pipe_WriteHeader(pipe);
+    test_pipe_WriteVarint(pipe, UINT64_C(1) << 32);
+    test_reject(host, pipe);
+
+    /* Oversized string, rejected before any allocation */
+    test_pipe_WriteHeader(pipe);
+    test_pipe_WriteVarint(pipe, 0); /* no attachment */
+    test_pipe_WriteVarint(pipe, 1); /* subtree */
+    test_pipe_WriteVarint(pipe, 1); /* item */
+    test_pipe_WriteVarint(pipe, UINT64_C(1) << 40); /* name */
+    test_reject(host, pipe);
+
+    /* Overlong varint */
+    test_pipe_WriteHeader(pipe);
+    for (int i = 0; i < 11; i++) {
+        uint8_t b = 0x80;
+        assert(test_pipe_Write(&b, 1, pipe) == 1);
+    }
+    test_reject(host, pipe);
+}
+
+static void test_serdes(vlc_object_t *obj, const char *name)
+{
+    var_SetString(obj, "preparser-serdes", name);
+
+    /* One serializer per end, as in the host and the external process */
+    struct vlc_preparser_msg_serdes *host =
+        vlc_preparser_msg_serdes_Create(obj, &test_cbs, true);
+    struct vlc_preparser_msg_serdes *worker =
+        vlc_preparser_msg_serdes_Create(obj, &test_cbs, true);
+    assert(host != NULL && worker != NULL);
+
+    struct test_pipe pipe = { .fd = -1 };
+    struct vlc_preparser_msg req, out;
+
+    /* Parse request, the worker learns what the host accepts */
+    vlc_preparser_msg_Init(&req, VLC_PREPARSER_MSG_TYPE_REQ,
+                           VLC_PREPARSER_MSG_REQ_TYPE_PARSE);
+    req.req.options = 0x3;
+    req.req.uri = strdup("file:///tmp/test/playlist.m3u");
+    test_roundtrip(host, worker, &pipe, &req, &out);
+    assert(out.req.options == req.req.options);
+    assert(strcmp(out.req.uri, req.req.uri) == 0);
+    vlc_preparser_msg_Clean(&out);
+    vlc_preparser_msg_Clean(&req);
+
+    /* Parse response with a large subtree */
+    struct vlc_preparser_msg res;
+    vlc_preparser_msg_Init(&res, VLC_PREPARSER_MSG_TYPE_RES,
+                           VLC_PREPARSER_MSG_REQ_TYPE_PARSE);
+    res.res.status = VLC_SUCCESS;
+    res.res.item = test_create_item(0);
+    res.res.subtree = input_item_node_Create(res.res.item);
+    assert(res.res.subtree != NULL);
+    for (int i = 1; i <= SUBTREE_COUNT; i++) {
+        input_item_t *child = test_create_item(i);
+        assert(input_item_node_AppendItem(res.res.subtree, child) != NULL);
+        input_item_Release(child);
+    }
+
+    vlc_tick_t parse_time = 0;
+    size_t parse_size = 0;
+    for (int loop = 0; loop < LOOP_COUNT; loop++) {
+        parse_time += test_roundtrip(worker, host, &pipe, &res, &out);
+        parse_size = pipe.written;
+        assert(out.res.status == res.res.status);
+        test_check_item(res.res.item, out.res.item);
+        assert(out.res.subtree != NULL);
+        assert(out.res.subtree->i_children == SUBTREE_COUNT);
+        for (int i = 0; i < SUBTREE_COUNT; i++) {
+            test_check_item(res.res.subtree->pp_children[i]->p_item,
+                            out.res.subtree->pp_children[i]->p_item);
+        }
+        vlc_preparser_msg_Clean(&out);
+    }
+    vlc_preparser_msg_Clean(&res);
+
+    /* Thumbnail response */
+    vlc_preparser_msg_Init(&res, VLC_PREPARSER_MSG_TYPE_RES,
+                           VLC_PREPARSER_MSG_REQ_TYPE_THUMBNAIL);
+    res.res.status = VLC_SUCCESS;
+    res.res.item = test_create_item(0);
+    res.res.pic = test_create_picture(1280, 720);
+
+    vlc_tick_t thumb_time = 0;
+    for (int loop = 0; loop < LOOP_COUNT; loop++) {
+        thumb_time += test_roundtrip(worker, host, &pipe, &res, &out);
+        test_check_picture(res.res.pic, out.res.pic);
+        vlc_preparser_msg_Clean(&out);
+    }
+    vlc_preparser_msg_Clean(&res);
+
+    test_log("%s: parse %" PRId64 " us (%zu bytes), thumbnail %" PRId64
+             " us\n", name, US_FROM_VLC_TICK(parse_time) / LOOP_COUNT,
+             parse_size, US_FROM_VLC_TICK(thumb_time) / LOOP_COUNT);
+
+    if (strcmp(name, "binary") == 0) {
+        test_binary_errors(host, worker, &pipe);
+    }
+
+    vlc_preparser_msg_serdes_Delete(worker);
+    vlc_preparser_msg_serdes_Delete(host);
+    test_pipe_Reset(&pipe);
+    free(pipe.data);
+}
+
+int main(void)
+{
+    test_init();
+
+    static const char *argv[] = {
+        "-v",
+        "--ignore-config",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc != NULL);
+
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+    var_Create(obj, "preparser-serdes", VLC_VAR_STRING);
+    test_serdes(obj, "json");
+    test_serdes(obj, "binary");
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -234,6 +234,104 @@ static void test_cancel_thumbnail( libvlc_instance_t* p_vlc, bool external )
     vlc_preparser_Delete( p_thumbnailer );
 }
 
+#define SHEET_COUNT 5
+#define SHEET_COLUMNS 3
+#define SHEET_TILE_WIDTH 64
+#define SHEET_TILE_HEIGHT 48
+
+/* Return the colour filling a tile of the sheet, asserting that the tile is
+ * a solid colour */
+static uint32_t sheet_tile_color( const picture_t* p_sheet, unsigned index )
+{
+    const plane_t *p = &p_sheet->p[0];
+    const unsigned x = (index % SHEET_COLUMNS) * SHEET_TILE_WIDTH;
+    const unsigned y = (index / SHEET_COLUMNS) * SHEET_TILE_HEIGHT;
+
+    uint32_t color;
+    memcpy( &color, &p->p_pixels[y * p->i_pitch + x * 4], 4 );
+    for ( unsigned line = 0; line < SHEET_TILE_HEIGHT; line++ )
+    {
+        const uint8_t *row = &p->p_pixels[(y + line) * p->i_pitch + x * 4];
+        for ( unsigned col = 0; col < SHEET_TILE_WIDTH; col++ )
+            assert( memcmp( &row[col * 4], &color, 4 ) == 0 &&
+                    "The tile is not a solid colour" );
+    }
+    return color;
+}
+
+static void thumbnailer_callback_sheet( vlc_preparser_req *req, int status,
+                                        picture_t* p_sheet, void *data )
+{
+    assert( status == VLC_SUCCESS );
+    assert( p_sheet != NULL );
+    assert( p_sheet->format.i_chroma == VLC_CODEC_RGBA );
+    /* 5 thumbnails on 3 columns: 2 rows */
+    assert( p_sheet->format.i_visible_width == SHEET_COLUMNS * SHEET_TILE_WIDTH );
+    assert( p_sheet->format.i_visible_height == 2 * SHEET_TILE_HEIGHT );
+
+    /* The mock frames are filled with a value depending on their date, and
+     * have the aspect ratio of the tiles: each tile must be filled with the
+     * solid colour of a frame taken at a different time. */
+    uint32_t colors[SHEET_COUNT];
+    for ( unsigned i = 0; i < SHEET_COUNT; i++ )
+    {
+        colors[i] = sheet_tile_color( p_sheet, i );
+        assert( colors[i] != 0 && "Missing thumbnail in the sheet" );
+        for ( unsigned j = 0; j < i; j++ )
+            assert( colors[i] != colors[j] && "Thumbnails taken at the same time" );
+    }
+
+    /* The last cell, past the thumbnails, is left transparent */
+    assert( sheet_tile_color( p_sheet, SHEET_COUNT ) == 0 );
+
+    vlc_sem_t *sem = data;
+    vlc_sem_post(sem);
+    vlc_preparser_req_Release(req);
+}
+
+static void test_thumbnail_sheet( libvlc_instance_t* p_vlc )
+{
+    const struct vlc_preparser_cfg cfg = {
+        .types = VLC_PREPARSER_TYPE_THUMBNAIL,
+        .timeout = VLC_TICK_INVALID,
+    };
+    vlc_preparser_t* p_thumbnailer = vlc_preparser_New(
+                VLC_OBJECT( p_vlc->p_libvlc_int ), &cfg );
+    assert( p_thumbnailer != NULL );
+
+    char* psz_mrl;
+    if ( asprintf( &psz_mrl, "mock://video_track_count=1;audio_track_count=0"
+                   ";length=%" PRId64 ";video_chroma=ARGB", MOCK_DURATION ) < 0 )
+        assert( !"Failed to allocate mock mrl" );
+    input_item_t* p_item = input_item_New( psz_mrl, "mock item" );
+    assert( p_item != NULL );
+
+    static const struct vlc_thumbnailer_cbs cbs = {
+        .on_ended = thumbnailer_callback_sheet,
+    };
+    const struct vlc_thumbnailer_sheet_arg sheet_arg = {
+        .count = SHEET_COUNT,
+        .columns = SHEET_COLUMNS,
+        .tile_width = SHEET_TILE_WIDTH,
+        .tile_height = SHEET_TILE_HEIGHT,
+        .hw_dec = false,
+    };
+
+    vlc_sem_t sem;
+    vlc_sem_init(&sem, 0);
+    vlc_preparser_req *req =
+        vlc_preparser_GenerateThumbnailSheet( p_thumbnailer, p_item, &sheet_arg,
+                                              &cbs, &sem );
+    assert( req != NULL );
+
+    vlc_sem_wait(&sem);
+
+    input_item_Release( p_item );
+    free( psz_mrl );
+
+    vlc_preparser_Delete( p_thumbnailer );
+}
+
 int main( void )
 {
     test_init();
@@ -248,6 +346,7 @@ int main( void )
     fprintf(stderr, "Run with internal preparser...\n");
     test_thumbnails( vlc, false );
     test_cancel_thumbnail( vlc, false );
+    test_thumbnail_sheet( vlc );
 
     fprintf(stderr, "Run with external preparser...\n");
     test_thumbnails( vlc, true );